@@ -0,0 +1,163 @@
+#ifndef AERODATABASE_H
+#define AERODATABASE_H
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+#include <dlfdm/defines.h>
+
+namespace dlfdm {
+
+///
+/// \brief The AeroTable class is a coefficient table over
+/// alpha x beta x Mach x control deflection, stored contiguously with alpha
+/// as the fastest varying axis. Axes with a single breakpoint are constant.
+///
+/// Lookups are branch free multilinear interpolations over the corners of the
+/// bracketing cell, only the axes with more than one breakpoint take part.
+/// The bracket indices of every axis are cached by the caller so consecutive
+/// steps usually find them without searching.
+///
+class AeroTable
+{
+public:
+    enum Axis {
+        ALPHA = 0,
+        BETA,
+        MACH,
+        CONTROL,
+        NUM_AXES
+    };
+
+    static constexpr int kNumCorners = 1 << NUM_AXES;
+
+    struct Cache {
+        int index[NUM_AXES] = {0, 0, 0, 0};
+    };
+
+    AeroTable();
+
+    ///
+    /// \brief set Define the table
+    /// \param breakpoints Strictly increasing breakpoints of each axis (at least one)
+    /// \param data Values, size must be the product of the breakpoint counts
+    /// \return false if the dimensions are inconsistent
+    ///
+    bool set(const std::vector<float> breakpoints[NUM_AXES], const std::vector<float>& data);
+
+    bool empty(void) const { return storage_.empty(); }
+
+    float lookup(const float x[NUM_AXES], Cache& cache) const;
+
+    ///
+    /// \brief scale Multiply every value of the table by factor
+    ///
+    void scale(float factor);
+
+    std::vector<float> get_breakpoints(int axis) const;
+
+private:
+    template <int N>
+    float interpolate(const float x[NUM_AXES], Cache& cache) const;
+
+    // Single contiguous block: breakpoints and 1 / (bp[i+1] - bp[i]) of every
+    // axis followed by the table values
+    std::vector<float> storage_;
+    std::size_t data_offset_;
+
+    struct AxisLayout {
+        std::size_t breakpoints;    // Offset in storage_
+        std::size_t inv_width;      // Offset in storage_
+        int count;
+        std::size_t stride;
+    };
+    AxisLayout axes_[NUM_AXES];
+
+    // Axes with more than one breakpoint, in storage order
+    int num_active_;
+    int active_axis_[NUM_AXES];
+    std::size_t corner_offset_[kNumCorners];
+};
+
+///
+/// \brief The AeroDatabase class holds the static aerodynamic coefficient
+/// tables of an aircraft. Damping derivatives (Cm_q, Cl_p, ...) are still
+/// taken from AircraftParameters.
+///
+/// Text file format ('#' starts a comment, angles in radians):
+///
+///     table CL
+///     control elevator        # none | elevator | aileron | rudder
+///     alpha -0.17 0.0 0.26 0.35
+///     beta 0
+///     mach 0.1 0.6
+///     delta -0.26 0.0 0.35
+///     data
+///     ... values, alpha fastest, then beta, mach and delta ...
+///     end
+///
+/// Every coefficient (CL, CD, CY, Cl, Cm, Cn) must be defined.
+///
+class AeroDatabase
+{
+public:
+    enum Coefficient {
+        CL = 0,
+        CD,
+        CY,
+        Cl,
+        Cm,
+        Cn,
+        NUM_COEFFICIENTS
+    };
+
+    enum Control {
+        NONE = 0,
+        ELEVATOR,
+        AILERON,
+        RUDDER
+    };
+
+    struct Cache {
+        AeroTable::Cache tables[NUM_COEFFICIENTS];
+    };
+
+    AeroDatabase();
+
+    bool load(const std::string& path);
+    bool load(std::istream& is);
+
+    bool set_table(Coefficient coefficient, Control control, const AeroTable& table);
+
+    bool is_complete(void) const;
+
+    ///
+    /// \brief scale Multiply the table of one coefficient by factor
+    /// (dispersions of the tabulated aerodynamics)
+    ///
+    void scale(Coefficient coefficient, float factor);
+
+    ///
+    /// \brief evaluate Static coefficients for the given flight condition
+    ///
+    void evaluate(float alpha, float beta, float mach,
+                  const ControlInputs& controls,
+                  Cache& cache,
+                  float coefficients[NUM_COEFFICIENTS]) const;
+
+    ///
+    /// \brief from_linear Sample the linear model of AircraftParameters into
+    /// tables (useful as a starting point and to validate the table path)
+    ///
+    static AeroDatabase from_linear(const AircraftParameters& p);
+
+private:
+    AeroTable tables_[NUM_COEFFICIENTS];
+    Control controls_[NUM_COEFFICIENTS];
+};
+
+} // namespace dlfdm
+
+#endif // AERODATABASE_H
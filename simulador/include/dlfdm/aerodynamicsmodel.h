@@ -1,11 +1,15 @@
 ﻿#ifndef AERODYNAMICSMODEL_H
 #define AERODYNAMICSMODEL_H
 
+#include <cstddef>
 #include <ostream>
 
 #include <glm/glm.hpp>
 
 #include <dlfdm/defines.h>
+#include <dlfdm/aircraftconstants.h>
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/atmosphere.h>
 
 namespace dlfdm {
 
@@ -15,6 +19,35 @@ public:
     struct AeroDynamicForces {
         glm::vec3 body_forces;       /// [N] - Body frame
         glm::vec3 body_moments;      /// [N·m] - Body frame - [x=L, y=M, z=N]
+        glm::vec3 wind_forces;       /// [N] - Wind axes - [x=-D, y=Y, z=-L]
+        glm::vec2 angles;            /// [rad] - [x=alpha, y=beta]
+    };
+
+    ///
+    /// \brief The BatchInput struct holds flight conditions in SoA layout:
+    /// one array per variable, all with the same number of points
+    ///
+    struct BatchInput {
+        const float* u;                 /// [m/s] - Body velocity
+        const float* v;
+        const float* w;
+        const float* p;                 /// [rad/s] - Body rates
+        const float* q;
+        const float* r;
+        const float* elevator;          /// [rad]
+        const float* aileron;           /// [rad]
+        const float* rudder;            /// [rad]
+        const float* density;           /// [kg/m^3]
+        const float* speed_of_sound;    /// [m/s] - Only read with a database
+    };
+
+    struct BatchOutput {
+        float* fx;                      /// [N] - Body frame
+        float* fy;
+        float* fz;
+        float* mx;                      /// [N·m] - Body frame - L, M, N
+        float* my;
+        float* mz;
     };
 
     AerodynamicsModel(const AircraftParameters& p);
@@ -25,7 +58,28 @@ public:
     // Calculate aerodynamic forces and moments
     AeroDynamicForces calculate(const glm::vec3& body_velocity,
                                 const glm::vec3& body_omega,
-                                const ControlInputs& controls);
+                                const ControlInputs& controls,
+                                const Atmosphere::Properties& air);
+
+    ///
+    /// \brief calculate Forces and moments of count flight conditions (carpet
+    /// plots, envelope maps, training data)
+    ///
+    /// Stateless: it does not update the state logged by the single point
+    /// calculate(), so one model can be swept from several threads. Matches
+    /// calculate() within float rounding, the wind to body rotation is built
+    /// from the velocity components instead of cos/sin of alpha and beta.
+    ///
+    void calculate(const BatchInput& in, const BatchOutput& out, std::size_t count) const;
+
+    ///
+    /// \brief set_database Use tabulated static coefficients instead of the
+    /// linear model of AircraftParameters
+    /// \param database Coefficient tables (not owned, can be shared between
+    /// aircraft), nullptr to go back to the linear model
+    ///
+    void set_database(const AeroDatabase* database) { database_ = database; }
+    const AeroDatabase* get_database(void) const    { return database_; }
 
     void log_all_titles(std::ostream& os, const char& sep = ',') const;
     void log_all(std::ostream& os, const char& sep = ',') const;
@@ -39,7 +93,10 @@ public:
 
 private:
     const AircraftParameters& aircraft_data_;
-    const float rho = 1.225f;  // Air density sea level [kg/m^3]
+    const AircraftConstants constants_;
+
+    const AeroDatabase* database_;
+    AeroDatabase::Cache database_cache_;    // Bracket indices of the last lookup
 
     glm::vec3 wind_forces_;         // Forces in wind axis
     glm::vec3 aero_moments_;
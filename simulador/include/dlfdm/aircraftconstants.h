@@ -0,0 +1,72 @@
+#ifndef AIRCRAFTCONSTANTS_H
+#define AIRCRAFTCONSTANTS_H
+
+#include <dlfdm/defines.h>
+
+namespace dlfdm {
+
+///
+/// \brief The AircraftConstants struct holds every term of the step that only
+/// depends on AircraftParameters (inertia combinations, reference geometry
+/// products, damping derivatives scaled by the reference lengths). It is
+/// compiled once when the models are built so the step does not recompute
+/// them.
+///
+/// compile() is constexpr: for an aircraft known at compile time
+///     constexpr AircraftConstants k = AircraftConstants::compile(params);
+/// folds everything into constants.
+///
+struct AircraftConstants {
+    // Mass properties
+    float inv_mass;         // [1/kg]
+
+    // Angular acceleration coefficients
+    // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
+    // Eq. 2.4-5 pag. 81 (pdf 103)
+    float c1, c2, c3, c4, c5, c6, c7, c8, c9;
+
+    // Aerodynamic reference
+    float half_wing_area;   // [m2] 0.5 * S, qbar * S = half_wing_area * rho * V^2
+    float wing_span;        // [m]
+    float wing_chord;       // [m]
+
+    // Damping derivatives times the reference length over 2, divided by V in the step
+    float Cm_q_c2;
+    float Cl_p_b2, Cl_r_b2;
+    float Cn_p_b2, Cn_r_b2;
+
+    static constexpr AircraftConstants compile(const AircraftParameters& p)
+    {
+        const float gamma = p.Ixx * p.Izz - p.Ixz * p.Ixz;
+
+        AircraftConstants k {};
+
+        k.inv_mass = 1.0f / p.mass;
+
+        k.c1 = (p.Izz * (p.Iyy - p.Izz) - p.Ixz * p.Ixz) / gamma;
+        k.c2 = (p.Ixz * (p.Ixx - p.Iyy + p.Izz)) / gamma;
+        k.c3 = p.Izz / gamma;
+        k.c4 = p.Ixz / gamma;
+        k.c5 = (p.Izz - p.Ixx) / p.Iyy;
+        k.c6 = p.Ixz / p.Iyy;
+        k.c7 = 1.0f / p.Iyy;
+        k.c8 = (p.Ixx * (p.Ixx - p.Iyy) + p.Ixz * p.Ixz) / gamma;
+        k.c9 = p.Ixx / gamma;
+
+        k.half_wing_area = 0.5f * p.wingArea;
+        k.wing_span = p.wingSpan;
+        k.wing_chord = p.wingChord;
+
+        k.Cm_q_c2 = 0.5f * p.Cm_q * p.wingChord;
+        k.Cl_p_b2 = 0.5f * p.Cl_p * p.wingSpan;
+        k.Cl_r_b2 = 0.5f * p.Cl_r * p.wingSpan;
+        k.Cn_p_b2 = 0.5f * p.Cn_p * p.wingSpan;
+        k.Cn_r_b2 = 0.5f * p.Cn_r * p.wingSpan;
+
+        return k;
+    }
+};
+
+} // namespace dlfdm
+
+#endif // AIRCRAFTCONSTANTS_H
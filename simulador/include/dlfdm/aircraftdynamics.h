@@ -4,7 +4,9 @@
 #include <glm/glm.hpp>
 
 #include <dlfdm/defines.h>
+#include <dlfdm/aircraftconstants.h>
 #include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/atmosphere.h>
 
 namespace dlfdm {
 
@@ -17,19 +19,30 @@ public:
         glm::vec3 body_velocity_dot;
         glm::vec3 euler_dot;
         glm::vec3 body_omega_dot;
+        glm::quat attitude_dot;         // Only in AttitudeMode::QUATERNION
     };
 
     AircraftDynamics(const AircraftParameters& p);
 
     StateDerivatives compute_derivatives(const AircraftState& state,
                                          const AerodynamicsModel::AeroDynamicForces& aero,
-                                         const ControlInputs& controls);
+                                         const ControlInputs& controls,
+                                         const Atmosphere::Properties& air);
+
+    ///
+    /// \brief set_attitude_mode Select which attitude representation of
+    /// AircraftState drives the kinematics (and gets a derivative)
+    ///
+    void set_attitude_mode(AttitudeMode mode)   { attitude_mode_ = mode; }
+    AttitudeMode get_attitude_mode(void) const  { return attitude_mode_; }
 
     void log_state_titles(std::ostream& os, const char& sep = ',') const;
     void log_state_derivatives(std::ostream& os, const char& sep = ',') const;
 
 private:
     const AircraftParameters& aircraft_data_;
+    const AircraftConstants constants_;
+    AttitudeMode attitude_mode_;
 
     StateDerivatives state_derv_;
     glm::vec3 body_total_force_;
@@ -0,0 +1,68 @@
+#ifndef ATMOSPHERE_H
+#define ATMOSPHERE_H
+
+#include <cstddef>
+#include <vector>
+
+namespace dlfdm {
+
+///
+/// \brief The Atmosphere class is the International Standard Atmosphere
+/// (ISA, 1976) up to 32 km: troposphere, isothermal tropopause and lower
+/// stratosphere. Altitude is treated as geopotential.
+///
+/// The properties are precomputed on a fine altitude grid, so a query is one
+/// linear interpolation instead of pow/exp. Outside the table the values of
+/// the nearest end are returned.
+///
+class Atmosphere
+{
+public:
+    struct Properties {
+        float density;          // [kg/m^3]
+        float temperature;      // [K]
+        float pressure;         // [Pa]
+        float speed_of_sound;   // [m/s]
+        float density_ratio;    // [-] density / sea level density
+    };
+
+    static constexpr float kMinAltitude = -500.0f;      // [m]
+    static constexpr float kMaxAltitude = 32000.0f;     // [m]
+    static constexpr float kTableStep = 25.0f;          // [m]
+
+    Atmosphere();
+
+    ///
+    /// \brief standard Shared table, built on first use
+    ///
+    static const Atmosphere& standard(void);
+
+    ///
+    /// \brief get Interpolated properties
+    /// \param altitude Altitude above mean sea level [m]
+    ///
+    Properties get(float altitude) const;
+
+    ///
+    /// \brief get Batch query (e.g. every aircraft of a multi-aircraft step)
+    /// \param altitudes Altitudes [m]
+    /// \param properties Output, same size as altitudes
+    /// \param count Number of altitudes
+    ///
+    void get(const float* altitudes, Properties* properties, std::size_t count) const;
+
+    ///
+    /// \brief compute Closed form ISA properties (reference, not for the step loop)
+    ///
+    static Properties compute(float altitude);
+
+    static Properties sea_level(void) { return compute(0.0f); }
+
+private:
+    std::vector<Properties> table_;
+    int last_;      // Last valid lower index
+};
+
+} // namespace dlfdm
+
+#endif // ATMOSPHERE_H
@@ -0,0 +1,87 @@
+#ifndef DLFDM_ATTITUDE_H
+#define DLFDM_ATTITUDE_H
+
+#include <cmath>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
+
+#include <dlfdm/fastmath.h>
+
+namespace dlfdm {
+
+// Quaternion helpers, q rotates body axes into NED axes and the Euler angles
+// follow the aerospace Z-Y-X (psi, theta, phi) sequence.
+
+inline glm::quat euler_to_quat(float phi, float theta, float psi)
+{
+    float cp, sp, ct, st, cy, sy;
+    math::sincos(0.5f * phi, sp, cp);
+    math::sincos(0.5f * theta, st, ct);
+    math::sincos(0.5f * psi, sy, cy);
+
+    return glm::quat(cp * ct * cy + sp * st * sy,   // w
+                     sp * ct * cy - cp * st * sy,   // x
+                     cp * st * cy + sp * ct * sy,   // y
+                     cp * ct * sy - sp * st * cy);  // z
+}
+
+inline void quat_to_euler(const glm::quat& q, float& phi, float& theta, float& psi)
+{
+    const float sin_theta = 2.0f * (q.w * q.y - q.z * q.x);
+
+    phi   = math::atan2(2.0f * (q.w * q.x + q.y * q.z), 1.0f - 2.0f * (q.x * q.x + q.y * q.y));
+    theta = math::asin(sin_theta < -1.0f ? -1.0f : (sin_theta > 1.0f ? 1.0f : sin_theta));
+    psi   = math::atan2(2.0f * (q.w * q.z + q.x * q.y), 1.0f - 2.0f * (q.y * q.y + q.z * q.z));
+}
+
+///
+/// \brief quat_to_body_to_ned Direction cosine matrix without trigonometry
+/// (glm column major: column i is body axis i expressed in NED)
+///
+inline glm::mat3 quat_to_body_to_ned(const glm::quat& q)
+{
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return glm::mat3(1.0f - 2.0f * (yy + zz),   2.0f * (xy + wz),           2.0f * (xz - wy),
+                     2.0f * (xy - wz),          1.0f - 2.0f * (xx + zz),    2.0f * (yz + wx),
+                     2.0f * (xz + wy),          2.0f * (yz - wx),           1.0f - 2.0f * (xx + yy));
+}
+
+///
+/// \brief quat_rate Attitude quaternion derivative, q_dot = 1/2 q x [0, p, q, r]
+///
+inline glm::quat quat_rate(const glm::quat& q, const glm::vec3& omega)
+{
+    const float p = omega.x;
+    const float r = omega.z;
+    const float qq = omega.y;
+
+    return glm::quat(0.5f * (-q.x * p - q.y * qq - q.z * r),    // w
+                     0.5f * ( q.w * p + q.y * r  - q.z * qq),   // x
+                     0.5f * ( q.w * qq + q.z * p - q.x * r),    // y
+                     0.5f * ( q.w * r + q.x * qq - q.y * p));   // z
+}
+
+///
+/// \brief euler_rates Euler angle derivatives from the body rates
+/// (Stevens & Lewis, Eq. 2.4-3), singular at theta = +-90 deg
+///
+inline glm::vec3 euler_rates(float phi, float theta, const glm::vec3& omega)
+{
+    float sp, cp;
+    math::sincos(phi, sp, cp);
+    const float ct = std::cos(theta);
+    const float tt = std::tan(theta);
+
+    const float q_sp_r_cp = omega.y * sp + omega.z * cp;
+    return glm::vec3(omega.x + q_sp_r_cp * tt,
+                     omega.y * cp - omega.z * sp,
+                     q_sp_r_cp / ct);
+}
+
+} // namespace dlfdm
+
+#endif // DLFDM_ATTITUDE_H
@@ -3,6 +3,7 @@
 
 #pragma once
 #include <glm/glm.hpp>
+#include <glm/gtc/quaternion.hpp>
 
 namespace dlfdm {
 
@@ -22,6 +23,20 @@ struct AircraftState {
     float phi;                          // [rad] - Roll angle
     float theta;                        // [rad] - Pitch angle
     float psi;                          // [rad] - Yaw angle psi
+
+    // Attitude (quaternion, body to NED), integrated in AttitudeMode::QUATERNION
+    glm::quat attitude;
+};
+
+enum class AttitudeMode {
+    EULER,          // Integrate phi, theta, psi (singular at theta = +-90 deg)
+    QUATERNION      // Integrate the attitude quaternion, Euler angles on demand
+};
+
+enum class IntegrationMethod {
+    EULER,          // Forward Euler, 1 derivative evaluation per step
+    RK2,            // Midpoint Runge-Kutta, 2 evaluations per step
+    RK4             // Classic Runge-Kutta, 4 evaluations per step
 };
 
 struct AircraftParameters {
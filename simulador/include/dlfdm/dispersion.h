@@ -0,0 +1,183 @@
+#ifndef DLFDM_DISPERSION_H
+#define DLFDM_DISPERSION_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <vector>
+
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/defines.h>
+
+namespace dlfdm {
+
+class WindField;
+
+///
+/// \brief The Dispersion class runs Monte Carlo dispersions of a scenario:
+/// every sample perturbs the aircraft parameters, the initial state and the
+/// control inputs, flies an FDMSolver until touchdown or the end of the
+/// scenario and keeps the terminal state and the envelope extremes.
+///
+/// Samples run on a work-stealing pool: each worker owns a block of sample
+/// indices and, when it runs out, steals from the back of another worker's
+/// block (runs ending early at touchdown leave workers idle otherwise).
+///
+/// Each sample draws its random numbers from its own generator seeded with
+/// (seed, sample index), so results do not depend on the number of threads
+/// or on which worker ran the sample, and any sample can be re-flown alone
+/// with run_sample().
+///
+class Dispersion
+{
+public:
+    ///
+    /// \brief Nominal scenario. controls() is called concurrently from every
+    /// worker and must be thread safe (a pure function of time).
+    ///
+    struct Scenario {
+        AircraftParameters params;
+        const AeroDatabase* database = nullptr;     // Not owned, nullptr = linear model
+        const WindField* wind = nullptr;            // Not owned, shared by all samples, nullptr = still air
+        AircraftState initial_state;
+        std::function<ControlInputs(float time)> controls;
+        float duration = 60.0f;                     // [s]
+        float time_step = 1.0f / 120.0f;            // [s]
+        AttitudeMode attitude_mode = AttitudeMode::QUATERNION;
+        IntegrationMethod integration_method = IntegrationMethod::EULER;
+        bool stop_at_touchdown = true;              // Stop when altitude <= 0
+    };
+
+    ///
+    /// \brief Perturbations. Parameter scatter is uniform in +-fraction, each
+    /// coefficient independently; state and control scatter is gaussian.
+    ///
+    struct Uncertainty {
+        float aero_coefficients = 0.0f;     // [-] fraction, linear model coefficients and
+                                            // each table of the database as a whole
+        float mass = 0.0f;                  // [-] fraction
+        float inertia = 0.0f;               // [-] fraction, Ixx, Iyy, Izz, Ixz
+        float thrust = 0.0f;                // [-] fraction
+
+        float position = 0.0f;              // [m] 1 sigma, each axis
+        float airspeed = 0.0f;              // [m/s] 1 sigma
+        float attitude = 0.0f;              // [rad] 1 sigma, phi, theta, psi
+        float body_rates = 0.0f;            // [rad/s] 1 sigma, p, q, r
+
+        float control_noise = 0.0f;         // [rad] 1 sigma, every step, surfaces
+        float throttle_noise = 0.0f;        // [-] 1 sigma, every step
+    };
+
+    ///
+    /// \brief Envelope limits counted as exceedances when crossed at any time
+    ///
+    struct Envelope {
+        float max_load_factor = 7.0f;       // [g]
+        float min_load_factor = -3.5f;      // [g]
+        float min_airspeed = 50.0f;         // [m/s]
+        float max_airspeed = 205.0f;        // [m/s]
+        float max_alpha = 0.26f;            // [rad]
+        float max_bank = 1.05f;             // [rad]
+    };
+
+    enum Exceedance : unsigned int {
+        LOAD_FACTOR_HIGH    = 1u << 0,
+        LOAD_FACTOR_LOW     = 1u << 1,
+        AIRSPEED_LOW        = 1u << 2,
+        AIRSPEED_HIGH       = 1u << 3,
+        ALPHA               = 1u << 4,
+        BANK                = 1u << 5,
+        NUM_EXCEEDANCES     = 6
+    };
+
+    struct Sample {
+        std::uint64_t index;
+        float time;                         // [s] touchdown or end of scenario
+        AircraftState final_state;          // Euler angles valid
+        bool touchdown;
+        float sink_rate;                    // [m/s] vertical speed at the end (down positive)
+        float airspeed;                     // [m/s] at the end
+
+        // Extremes along the run
+        float max_load_factor, min_load_factor;     // [g]
+        float min_airspeed, max_airspeed;           // [m/s]
+        float max_alpha;                            // [rad]
+        float max_bank;                             // [rad] absolute
+        unsigned int exceedances;                   // Exceedance bits
+    };
+
+    struct Distribution {
+        std::size_t count;
+        double mean, stddev;
+        double min, p05, p50, p95, max;
+    };
+
+    struct Summary {
+        std::size_t num_samples;
+        std::size_t num_touchdowns;
+        std::size_t exceedances[NUM_EXCEEDANCES];   // Samples crossing each limit
+        std::size_t any_exceedance;                 // Samples crossing any limit
+
+        // Terminal state (all samples)
+        Distribution time, north, east, altitude, airspeed, sink_rate;
+
+        // At touchdown (touchdown samples only)
+        Distribution touchdown_range, touchdown_sink_rate, touchdown_airspeed, touchdown_pitch;
+
+        // Envelope extremes (all samples)
+        Distribution max_load_factor, min_airspeed, max_alpha, max_bank;
+    };
+
+    ///
+    /// \param num_threads Worker threads (0 = hardware concurrency)
+    ///
+    Dispersion(unsigned int num_threads = 0);
+
+    ///
+    /// \brief run Fly num_samples dispersed samples
+    /// \return One result per sample, in sample index order
+    ///
+    std::vector<Sample> run(const Scenario& scenario, const Uncertainty& uncertainty,
+                            const Envelope& envelope, std::size_t num_samples,
+                            std::uint64_t seed) const;
+
+    ///
+    /// \brief run_sample Fly a single sample (same result as inside run())
+    ///
+    static Sample run_sample(const Scenario& scenario, const Uncertainty& uncertainty,
+                             const Envelope& envelope, std::uint64_t seed,
+                             std::uint64_t index);
+
+    ///
+    /// \brief disperse_parameters Aircraft parameters of a sample
+    ///
+    static AircraftParameters disperse_parameters(const AircraftParameters& p,
+                                                  const Uncertainty& uncertainty,
+                                                  std::uint64_t seed, std::uint64_t index);
+
+    ///
+    /// \brief disperse_database Aerodynamic tables of a sample: every static
+    /// coefficient table (CL, CD, CY, Cl, Cm, Cn) scaled by its own factor.
+    /// The damping derivatives come from disperse_parameters().
+    ///
+    static AeroDatabase disperse_database(const AeroDatabase& database,
+                                          const Uncertainty& uncertainty,
+                                          std::uint64_t seed, std::uint64_t index);
+
+    static Summary summarize(const std::vector<Sample>& samples);
+
+    static void write_csv(std::ostream& os, const std::vector<Sample>& samples);
+    static void write_json(std::ostream& os, const Summary& summary);
+
+    static const char* exceedance_name(unsigned int bit);
+
+    unsigned int get_num_threads(void) const    { return num_threads_; }
+
+private:
+    unsigned int num_threads_;
+};
+
+} // namespace dlfdm
+
+#endif // DLFDM_DISPERSION_H
@@ -9,29 +9,152 @@
 #include <dlfdm/defines.h>
 #include <dlfdm/aerodynamicsmodel.h>
 #include <dlfdm/aircraftdynamics.h>
+#include <dlfdm/atmosphere.h>
 
 namespace dlfdm {
 
+class FlightRecorder;
+class WindField;
+
 class FDMSolver
 {
 public:
+    ///
+    /// \brief The Snapshot struct holds everything the integration depends on,
+    /// restoring a snapshot and feeding the same controls reproduces the same
+    /// trajectory bit by bit.
+    ///
+    struct Snapshot {
+        AircraftState state;
+        float time;
+
+        // Held between steps when the split steps run at different rates
+        Atmosphere::Properties air;
+        AerodynamicsModel::AeroDynamicForces aero;
+        ControlInputs controls;
+        glm::vec3 wind;         // [m/s] NED
+    };
+
     FDMSolver(const AircraftParameters& p, float dt = 1.0f / 120.0f);
 
+    // The models refer to aircraft_data_, a copy would point to the original
+    FDMSolver(const FDMSolver&) = delete;
+    FDMSolver& operator=(const FDMSolver&) = delete;
+
+    ///
+    /// \brief update Full step: update_atmosphere(), update_aerodynamics()
+    /// and integrate()
+    ///
     void update(const ControlInputs& controls);
 
-    const AircraftState& getState() const { return aircraft_state_; }
-    void setState(const AircraftState& newState) { aircraft_state_ = newState; }
+    // Split step, for multi-rate scheduling. Atmosphere and aerodynamic loads
+    // are held until the next call, integrate() advances one time step.
+
+    ///
+    /// \brief update_atmosphere Air properties at the current altitude
+    ///
+    void update_atmosphere(void);
+
+    ///
+    /// \brief update_aerodynamics Clamp the controls and compute the
+    /// aerodynamic forces and moments with the current air properties
+    ///
+    void update_aerodynamics(const ControlInputs& controls);
+
+    ///
+    /// \brief integrate Advance the state one time step with the held
+    /// aerodynamic loads and controls
+    ///
+    void integrate(void);
+
+    ///
+    /// \brief getState Current state. In AttitudeMode::QUATERNION the Euler
+    /// angles are derived from the quaternion here, not on every step.
+    ///
+    const AircraftState& getState() const;
+
+    ///
+    /// \brief get_integrated_state State as integrated, without deriving the
+    /// Euler angles: in AttitudeMode::QUATERNION they may be stale and only
+    /// the quaternion is valid (in EULER mode the quaternion is not updated)
+    ///
+    const AircraftState& get_integrated_state(void) const   { return aircraft_state_; }
+
+    ///
+    /// \brief setState Set the state, the attitude is taken from the Euler
+    /// angles (the quaternion is initialized from them)
+    ///
+    void setState(const AircraftState& newState);
+
+    ///
+    /// \brief set_attitude_mode Integrate Euler angles (default) or the
+    /// attitude quaternion (no gimbal lock, full aerobatics)
+    ///
+    void set_attitude_mode(AttitudeMode mode);
+    AttitudeMode get_attitude_mode(void) const { return dynamics.get_attitude_mode(); }
+
+    ///
+    /// \brief set_integration_method Integration scheme of integrate(). The
+    /// first stage uses the held aerodynamic loads, the intermediate stages of
+    /// RK2/RK4 recompute them at the stage state (same controls and air).
+    ///
+    void set_integration_method(IntegrationMethod method) { integration_method_ = method; }
+    IntegrationMethod get_integration_method(void) const { return integration_method_; }
+
+    ///
+    /// \brief getEulerAngles [phi, theta, psi] in radians
+    ///
+    glm::vec3 getEulerAngles() const;
 
     const AircraftDynamics::StateDerivatives get_state_dot() const {
         return state_deriv_;
     }
 
+    Snapshot snapshot(void) const           { return {getState(), time_, air_, aero_fm_, controls_, wind_}; }
+    void restore(const Snapshot& snapshot);
+
     void setTimeStep(float dt) { time_step_ = dt; }
+    float getTimeStep(void) const       { return time_step_; }
 
     float get_sim_time(void) const      { return time_; }
 
+    /// \brief get_position NED position without refreshing the Euler angles
+    const glm::vec3& get_position(void) const { return aircraft_state_.intertial_position; }
+
     glm::mat4 getModelMatrix() const;
 
+    ///
+    /// \brief set_aero_database Use tabulated aerodynamic coefficients
+    /// \param database Tables (not owned), nullptr for the linear model
+    ///
+    void set_aero_database(const AeroDatabase* database) { aerodynamics.set_database(database); }
+
+    ///
+    /// \brief set_wind_field Fly through moving air: the aerodynamics see the
+    /// velocity relative to the air, sampled at the aircraft position by
+    /// update_aerodynamics() and held for the step like the loads
+    /// \param field Wind and turbulence (not owned, may be shared by several
+    /// solvers), nullptr for still air
+    ///
+    void set_wind_field(const WindField* field) { wind_field_ = field; }
+
+    ///
+    /// \brief get_wind Wind of the last update_aerodynamics() [m/s], NED
+    ///
+    const glm::vec3& get_wind(void) const { return wind_; }
+
+    ///
+    /// \brief get_air_velocity Current body velocity relative to the air [m/s]
+    /// (the body velocity in still air)
+    ///
+    glm::vec3 get_air_velocity(void) const { return air_velocity(aircraft_state_); }
+
+    ///
+    /// \brief set_recorder Attach a flight data recorder fed after every step
+    /// \param recorder Recorder (not owned), nullptr to detach
+    ///
+    void set_recorder(FlightRecorder* recorder) { recorder_ = recorder; }
+
     void log_titles(std::ostream& os, const char& sep = ',') const;
     void log_state(std::ostream& os, const char& sep = ',') const;
 
@@ -41,17 +164,40 @@ public:
     ///
     AerodynamicsModel::AeroDynamicForces get_aero_fm(void) { return aero_fm_; }
 
+    ///
+    /// \brief get_atmosphere Air properties used in the last step
+    ///
+    const Atmosphere::Properties& get_atmosphere(void) const { return air_; }
+
 private:
-    AircraftState aircraft_state_;
+    // Euler angles are refreshed lazily from the quaternion by getState()
+    mutable AircraftState aircraft_state_;
+    mutable bool euler_stale_;
+
+    // Owned copy, the models keep a reference to it (not to the constructor
+    // argument, which may be a temporary)
     AircraftParameters aircraft_data_;
     AerodynamicsModel aerodynamics;
     AircraftDynamics dynamics;
 
     float time_step_;
     float time_;
+    IntegrationMethod integration_method_;
 
     AerodynamicsModel::AeroDynamicForces aero_fm_;
     AircraftDynamics::StateDerivatives state_deriv_;
+    Atmosphere::Properties air_;
+    ControlInputs controls_;    // Clamped controls of the last update_aerodynamics()
+
+    FlightRecorder* recorder_;
+
+    const WindField* wind_field_;
+    glm::vec3 wind_;            // [m/s] NED, held for the step
+
+    glm::vec3 air_velocity(const AircraftState& state) const;
+
+    AircraftDynamics::StateDerivatives evaluate(const AircraftState& state);
+    void advance(AircraftState& state, const AircraftDynamics::StateDerivatives& derivatives, float dt) const;
 
     void log_state_titles(std::ostream& os, const char& sep = ',') const;
     void log_aircraft_state(std::ostream& os, const char& sep = ',') const;
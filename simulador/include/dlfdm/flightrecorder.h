@@ -0,0 +1,177 @@
+#ifndef FLIGHTRECORDER_H
+#define FLIGHTRECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <dlfdm/defines.h>
+#include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/aircraftdynamics.h>
+
+namespace dlfdm {
+
+///
+/// \brief The FlightRecorder class is an always-on flight data recorder.
+///
+/// record() is called from the physics step and only copies raw floats into a
+/// preallocated single-producer/single-consumer ring buffer. A background
+/// thread drains the ring, compresses blocks of records (XOR against the
+/// previous record, storing only the significant bytes) and writes them to disk.
+/// The state is stored as integrated: in AttitudeMode::QUATERNION the Euler
+/// angles are not derived on the physics step, convert_to_csv() computes them
+/// from the recorded quaternion. The Euler angle rates are not recorded
+/// either, the CSV derives them from the attitude and body rates of each
+/// record in both modes.
+///
+/// CSV columns: the 33 columns of FDMSolver::log_state(), same titles and
+/// order (t, x y z, phi theta psi, u v w, p q r, D Y L, Xb Yb Zb, L M N,
+/// Alpha Beta, p_dot2 q_dot2 r_dot2, u_dot v_dot w_dot, xdot_ned ydot_ned
+/// zdot_ned), followed by throttle, elevator, aileron, rudder and phi_dot,
+/// theta_dot, psi_dot. As in log_state() the D, Y, L columns hold the wind
+/// axes force vector (-D, Y, -L).
+///
+class FlightRecorder
+{
+public:
+    // [t, x, y, z, phi, theta, psi, u, v, w, p, q, r,
+    //  throttle, elevator, aileron, rudder,
+    //  Xb, Yb, Zb, L, M, N,
+    //  D, Y, L (wind axes, stored as -D, Y, -L), alpha, beta,
+    //  p_dot, q_dot, r_dot, u_dot, v_dot, w_dot, xdot_ned, ydot_ned, zdot_ned,
+    //  qw, qx, qy, qz, attitude_mode]
+    static constexpr int kNumChannels = 42;
+    // CSV columns: log_state() columns, controls, phi_dot, theta_dot, psi_dot
+    static constexpr int kNumCsvChannels = 40;
+
+    struct Record {
+        float channels[kNumChannels];
+    };
+
+    ///
+    /// \param capacity Ring buffer size in records (rounded up to a power of two)
+    /// \param block_records Records per compressed block written to disk
+    ///
+    FlightRecorder(std::size_t capacity = 8192, std::size_t block_records = 256);
+    ~FlightRecorder();
+
+    FlightRecorder(const FlightRecorder&) = delete;
+    FlightRecorder& operator=(const FlightRecorder&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+    bool is_open(void) const            { return running_.load(std::memory_order_relaxed); }
+
+    ///
+    /// \brief record Push one sample. Never blocks nor allocates, if the
+    /// writer thread falls behind the sample is dropped and counted.
+    /// \param mode Representation being integrated; in QUATERNION mode the
+    /// Euler angles of state may be stale and only the quaternion is used.
+    ///
+    inline void record(float time,
+                       const AircraftState& state,
+                       AttitudeMode mode,
+                       const ControlInputs& controls,
+                       const AerodynamicsModel::AeroDynamicForces& aero,
+                       const AircraftDynamics::StateDerivatives& deriv);
+
+    std::uint64_t get_recorded(void) const  { return head_.load(std::memory_order_relaxed); }
+    std::uint64_t get_dropped(void) const   { return dropped_.load(std::memory_order_relaxed); }
+
+    static void log_titles(std::ostream& os, const char& sep = ',');
+
+    ///
+    /// \brief convert_to_csv Decode a recording file into CSV
+    /// \return false if the stream is not a flight recording
+    ///
+    static bool convert_to_csv(std::istream& is, std::ostream& os, const char& sep = ',');
+
+private:
+    std::vector<Record> ring_;
+    std::size_t mask_;
+    std::size_t block_records_;
+
+    // head_ is only written by the producer, tail_ only by the writer thread
+    alignas(64) std::atomic<std::uint64_t> head_;
+    alignas(64) std::atomic<std::uint64_t> tail_;
+    alignas(64) std::atomic<std::uint64_t> dropped_;
+
+    std::atomic<bool> running_;
+    std::thread writer_;
+    std::ofstream file_;
+
+    void writer_loop();
+    void write_block(std::uint64_t first, std::size_t count);
+};
+
+inline void FlightRecorder::record(float time,
+                                   const AircraftState& state,
+                                   AttitudeMode mode,
+                                   const ControlInputs& controls,
+                                   const AerodynamicsModel::AeroDynamicForces& aero,
+                                   const AircraftDynamics::StateDerivatives& deriv)
+{
+    if (!running_.load(std::memory_order_relaxed)) {
+        return;
+    }
+
+    const std::uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_.load(std::memory_order_acquire) > mask_) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    float* c = ring_[head & mask_].channels;
+    c[0]  = time;
+    c[1]  = state.intertial_position.x;
+    c[2]  = state.intertial_position.y;
+    c[3]  = state.intertial_position.z;
+    c[4]  = state.phi;
+    c[5]  = state.theta;
+    c[6]  = state.psi;
+    c[7]  = state.boby_velocity.x;
+    c[8]  = state.boby_velocity.y;
+    c[9]  = state.boby_velocity.z;
+    c[10] = state.body_omega.x;
+    c[11] = state.body_omega.y;
+    c[12] = state.body_omega.z;
+    c[13] = controls.throttle;
+    c[14] = controls.elevator;
+    c[15] = controls.aileron;
+    c[16] = controls.rudder;
+    c[17] = aero.body_forces.x;
+    c[18] = aero.body_forces.y;
+    c[19] = aero.body_forces.z;
+    c[20] = aero.body_moments.x;
+    c[21] = aero.body_moments.y;
+    c[22] = aero.body_moments.z;
+    c[23] = aero.wind_forces.x;
+    c[24] = aero.wind_forces.y;
+    c[25] = aero.wind_forces.z;
+    c[26] = aero.angles.x;
+    c[27] = aero.angles.y;
+    c[28] = deriv.body_omega_dot.x;
+    c[29] = deriv.body_omega_dot.y;
+    c[30] = deriv.body_omega_dot.z;
+    c[31] = deriv.body_velocity_dot.x;
+    c[32] = deriv.body_velocity_dot.y;
+    c[33] = deriv.body_velocity_dot.z;
+    c[34] = deriv.ned_position_dot.x;
+    c[35] = deriv.ned_position_dot.y;
+    c[36] = deriv.ned_position_dot.z;
+    c[37] = state.attitude.w;
+    c[38] = state.attitude.x;
+    c[39] = state.attitude.y;
+    c[40] = state.attitude.z;
+    c[41] = (mode == AttitudeMode::QUATERNION) ? 1.0f : 0.0f;
+
+    head_.store(head + 1, std::memory_order_release);
+}
+
+} // namespace dlfdm
+
+#endif // FLIGHTRECORDER_H
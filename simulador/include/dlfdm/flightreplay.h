@@ -0,0 +1,82 @@
+#ifndef FLIGHTREPLAY_H
+#define FLIGHTREPLAY_H
+
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+#include <dlfdm/defines.h>
+#include <dlfdm/fdmsolver.h>
+
+namespace dlfdm {
+
+///
+/// \brief The FlightReplay class records the control inputs fed to an
+/// FDMSolver plus periodic full snapshots (keyframes) and replays them.
+///
+/// Seeking restores the closest keyframe at or before the target step and
+/// re-simulates at most keyframe_interval steps, so any point of a long
+/// recording is reached in (much) less than a millisecond. Since the solver
+/// is deterministic, replay is bit exact for the same build.
+///
+class FlightReplay
+{
+public:
+    ///
+    /// \brief StepFunction Re-simulates recorded step `step` with its controls.
+    /// The default one calls FDMSolver::update(), a multi-rate loop passes its
+    /// own so the replay goes through the same sequence of split steps.
+    ///
+    using StepFunction = std::function<void(FDMSolver& solver,
+                                            const ControlInputs& controls,
+                                            std::uint64_t step)>;
+
+    ///
+    /// \param keyframe_interval Steps between keyframes (120 -> 1 s at 120 Hz)
+    ///
+    FlightReplay(std::uint32_t keyframe_interval = 120);
+
+    ///
+    /// \brief capture Call right before each step (FDMSolver::update() or the
+    /// steps of a StepFunction) with the same controls
+    ///
+    void capture(const FDMSolver& solver, const ControlInputs& controls);
+
+    void clear();
+
+    ///
+    /// \brief seek Move the solver to the state reached after `step` updates
+    /// from the start of the recording
+    /// \return false if there is nothing recorded
+    ///
+    bool seek(FDMSolver& solver, std::uint64_t step) const;
+    bool seek(FDMSolver& solver, std::uint64_t step, const StepFunction& step_function) const;
+
+    ///
+    /// \brief seek_time Move the solver to the recorded step closest to time t
+    ///
+    bool seek_time(FDMSolver& solver, float t) const;
+    bool seek_time(FDMSolver& solver, float t, const StepFunction& step_function) const;
+
+    std::uint64_t get_num_steps(void) const     { return controls_.size(); }
+    float get_time_step(void) const             { return time_step_; }
+    float get_start_time(void) const;
+    float get_end_time(void) const;
+
+    const ControlInputs& get_controls(std::uint64_t step) const { return controls_[step]; }
+
+    bool save(std::ostream& os) const;
+    bool load(std::istream& is);
+
+private:
+    std::uint32_t keyframe_interval_;
+    float time_step_;
+
+    std::vector<ControlInputs> controls_;
+    std::vector<FDMSolver::Snapshot> keyframes_;   // keyframes_[k] -> before step k * interval
+};
+
+} // namespace dlfdm
+
+#endif // FLIGHTREPLAY_H
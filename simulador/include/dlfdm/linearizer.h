@@ -0,0 +1,112 @@
+#ifndef LINEARIZER_H
+#define LINEARIZER_H
+
+#include <ostream>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <dlfdm/defines.h>
+
+namespace dlfdm {
+
+class AeroDatabase;
+
+///
+/// \brief The Linearizer class extracts state-space matrices (A, B) of the
+/// nonlinear model x_dot = f(x, u) around an operating point using central
+/// finite differences on AerodynamicsModel::calculate() +
+/// AircraftDynamics::compute_derivatives(), the same force and moment path
+/// as FDMSolver (Euler attitude, still air). With set_aero_database() the
+/// coefficients come from the same tables as the solver that flies them.
+///
+/// State vector order (same as FDMSolver::log_state):
+///     x = [x, y, z, phi, theta, psi, u, v, w, p, q, r]
+/// Input vector order (same as ControlInputs):
+///     u = [throttle, elevator, aileron, rudder]
+///
+class Linearizer
+{
+public:
+    static constexpr int kNumStates = 12;
+    static constexpr int kNumInputs = 4;
+
+    struct OperatingPoint {
+        AircraftState state;
+        ControlInputs controls;
+    };
+
+    struct StateSpace {
+        float A[kNumStates][kNumStates];    // d(x_dot)/dx
+        float B[kNumStates][kNumInputs];    // d(x_dot)/du
+    };
+
+    ///
+    /// \param p Aircraft parameters (copied)
+    /// \param num_threads Worker threads for batch evaluation (0 = hardware concurrency)
+    ///
+    Linearizer(const AircraftParameters& p, unsigned int num_threads = 0);
+
+    ///
+    /// \brief linearize Jacobians around a single operating point. The
+    /// 2 * (kNumStates + kNumInputs) perturbed points are evaluated serially
+    /// on the calling thread: the whole point costs a few microseconds, less
+    /// than starting a thread. Use linearize_batch() to spread work over the
+    /// worker threads.
+    ///
+    StateSpace linearize(const OperatingPoint& op) const;
+
+    ///
+    /// \brief linearize_batch Jacobians for every point of an envelope grid,
+    /// the points are split among the worker threads.
+    ///
+    std::vector<StateSpace> linearize_batch(const std::vector<OperatingPoint>& points) const;
+
+    ///
+    /// \brief envelope_grid Build operating points by sweeping true airspeed
+    /// and altitude around a base point. Angle of attack, sideslip, attitude and
+    /// controls are kept from the base point (the points are not re-trimmed).
+    ///
+    static std::vector<OperatingPoint> envelope_grid(const OperatingPoint& base,
+                                                     const std::vector<float>& airspeeds,
+                                                     const std::vector<float>& altitudes);
+
+    ///
+    /// \brief set_aero_database Use tabulated aerodynamic coefficients, as
+    /// FDMSolver::set_aero_database()
+    /// \param database Tables (not owned), nullptr for the linear model
+    ///
+    void set_aero_database(const AeroDatabase* database) { database_ = database; }
+    const AeroDatabase* get_aero_database(void) const { return database_; }
+
+    void setRelativeStep(float step)    { relative_step_ = step; }
+    float getRelativeStep(void) const   { return relative_step_; }
+
+    static void pack_state(const AircraftState& state, float x[kNumStates]);
+    static AircraftState unpack_state(const float x[kNumStates]);
+    static void pack_controls(const ControlInputs& controls, float u[kNumInputs]);
+    static ControlInputs unpack_controls(const float u[kNumInputs]);
+
+    ///
+    /// \brief write_binary Compact binary dump: header followed by one record
+    /// per point with x0, u0, A (row major) and B (row major) as float32.
+    ///
+    static void write_binary(std::ostream& os,
+                             const std::vector<OperatingPoint>& points,
+                             const std::vector<StateSpace>& results);
+
+    static void write_csv(std::ostream& os,
+                          const std::vector<OperatingPoint>& points,
+                          const std::vector<StateSpace>& results,
+                          const char& sep = ',');
+
+private:
+    AircraftParameters aircraft_data_;
+    const AeroDatabase* database_;
+    unsigned int num_threads_;
+    float relative_step_;
+};
+
+} // namespace dlfdm
+
+#endif // LINEARIZER_H
@@ -0,0 +1,40 @@
+#ifndef DLFDM_TRIM_H
+#define DLFDM_TRIM_H
+
+#include <dlfdm/defines.h>
+
+namespace dlfdm {
+
+class AeroDatabase;
+
+///
+/// \brief trim_level_flight Wings level, constant altitude trim: solves angle
+/// of attack (= pitch), elevator and throttle so that u_dot = w_dot = q_dot = 0
+/// (Newton iteration, finite difference Jacobian).
+/// \param p Aircraft parameters
+/// \param database Aerodynamic tables, nullptr for the linear model
+/// \param speed True airspeed [m/s]
+/// \param altitude Altitude [m]
+/// \param state Trimmed state (north = east = 0, heading north)
+/// \param controls Trimmed controls
+/// \return false if the iteration did not converge or the trimmed throttle
+/// or elevator is beyond its limits ([0, 1], [min_elevator, max_elevator])
+///
+bool trim_level_flight(const AircraftParameters& p, const AeroDatabase* database,
+                       float speed, float altitude,
+                       AircraftState& state, ControlInputs& controls);
+
+///
+/// \brief trim_steady_flight Wings level, straight climb or descent at a
+/// constant flight path angle (pitch = angle of attack + flight path angle).
+/// Same solver and parameters as trim_level_flight().
+/// \param flight_path_angle [rad], negative descending (-0.0524 for a 3 deg
+/// approach)
+///
+bool trim_steady_flight(const AircraftParameters& p, const AeroDatabase* database,
+                        float speed, float altitude, float flight_path_angle,
+                        AircraftState& state, ControlInputs& controls);
+
+} // namespace dlfdm
+
+#endif // DLFDM_TRIM_H
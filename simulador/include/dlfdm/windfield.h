@@ -0,0 +1,113 @@
+#ifndef DLFDM_WINDFIELD_H
+#define DLFDM_WINDFIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace dlfdm {
+
+///
+/// \brief The WindField class is the air mass the aircraft flies through:
+/// a mean wind that depends on altitude plus frozen Dryden turbulence.
+///
+/// Everything is precomputed, a query is table lookups only:
+///
+/// - The mean wind profile is resampled on the altitude grid of Atmosphere.
+/// - The gusts are white noise filtered once with the Dryden spatial filters
+///   (MIL-F-8785C, medium/high altitude: L = 1750 ft, isotropic intensity)
+///   into periodic tables of distance. A table is built per seed and
+///   intensity and shared by every field that asks for the same pair.
+///
+/// The turbulence is frozen (Taylor's hypothesis) and the whole pattern
+/// drifts with one reference wind, the mean wind averaged over the altitudes
+/// of the profile. A single drift keeps the gust continuous when the aircraft
+/// climbs or descends through a sheared profile (a drift per altitude would
+/// move the pattern by the shear times the elapsed time at every altitude
+/// change). The gust depends on position and time only: several aircraft in
+/// one field, or a replay, see the same gusts at the same place. Three
+/// patterns along horizontal axes 60 degrees apart are summed so that every
+/// heading crosses the turbulence.
+///
+/// A field is immutable once built: one instance can be shared by any
+/// number of solvers and threads.
+///
+class WindField
+{
+public:
+    ///
+    /// \brief Mean wind at one altitude, linear in between, constant beyond
+    /// the first and last layers
+    ///
+    struct Layer {
+        float altitude;         // [m]
+        float speed;            // [m/s]
+        float direction;        // [rad] where the wind blows from, clockwise from north
+    };
+
+    struct Turbulence {
+        float intensity = 0.0f;     // [m/s] gust standard deviation, 0 = none
+        std::uint64_t seed = 1;
+    };
+
+    // MIL-F-8785C medium/high altitude intensities (1e-2, 1e-3 and 1e-5
+    // probability of exceedance)
+    static constexpr float kLightTurbulence = 1.5f;      // [m/s]
+    static constexpr float kModerateTurbulence = 3.0f;   // [m/s]
+    static constexpr float kSevereTurbulence = 6.0f;     // [m/s]
+
+    static constexpr float kScaleLength = 533.4f;       // [m] 1750 ft
+    static constexpr float kGustSpacing = 4.0f;         // [m]
+    static constexpr std::size_t kGustSamples = 8192;   // Power of 2, 32.8 km period
+
+    ///
+    /// \brief WindField Calm air
+    ///
+    WindField();
+
+    WindField(const std::vector<Layer>& profile, const Turbulence& turbulence);
+
+    ///
+    /// \brief mean Mean wind [m/s], NED
+    /// \param altitude Altitude above mean sea level [m]
+    ///
+    glm::vec3 mean(float altitude) const;
+
+    ///
+    /// \brief gust Turbulence [m/s], NED
+    /// \param ned_position Position [m]
+    /// \param time Simulation time [s], the turbulence drifts with drift_wind()
+    ///
+    glm::vec3 gust(const glm::vec3& ned_position, float time) const;
+
+    ///
+    /// \brief get Mean wind plus turbulence [m/s], NED
+    ///
+    glm::vec3 get(const glm::vec3& ned_position, float time) const;
+
+    ///
+    /// \brief drift_wind Velocity of the frozen turbulence pattern [m/s], NED
+    ///
+    const glm::vec3& get_drift_wind(void) const { return drift_wind_; }
+
+    const Turbulence& get_turbulence(void) const { return turbulence_; }
+
+private:
+    class GustTable;
+
+    std::vector<glm::vec3> mean_table_;     // On the Atmosphere altitude grid
+    int last_;                              // Last valid lower index
+    glm::vec3 drift_wind_;                  // Reference wind that carries the gusts
+    Turbulence turbulence_;
+    std::shared_ptr<const GustTable> gusts_;
+
+    // Gust at a position, the pattern displaced by drift_wind_ * time
+    glm::vec3 frozen_gust(const glm::vec3& ned_position, float time) const;
+};
+
+} // namespace dlfdm
+
+#endif // DLFDM_WINDFIELD_H
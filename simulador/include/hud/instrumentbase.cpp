@@ -7,6 +7,8 @@ extern "C"
 
 #include <iostream>
 
+#include "graphics/rendering/gl_state.h"
+
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace hud
@@ -39,19 +41,19 @@ namespace hud
     {
         if (vbo_ > 0)
         {
-            glDeleteBuffers(1, &vbo_);
+            Graphics::Rendering::GLState::getInstance().deleteBuffer(vbo_);
             vbo_ = 0;
         }
 
         if (ebo_ > 0)
         {
-            glDeleteBuffers(1, &ebo_);
+            Graphics::Rendering::GLState::getInstance().deleteBuffer(ebo_);
             ebo_ = 0;
         }
 
         if (vao_ > 0)
         {
-            glDeleteVertexArrays(1, &vao_);
+            Graphics::Rendering::GLState::getInstance().deleteVertexArray(vao_);
             vao_ = 0;
         }
     }
@@ -0,0 +1,54 @@
+// Luces puntuales por cluster (Lighting::ClusteredLights). El frustum se
+// divide en clusterCount celdas (x e y en pantalla, profundidad en escala
+// logarítmica) y cada fragmento sólo recorre las luces de su celda.
+// Requiere frame_data.glsl.
+
+uniform usamplerBuffer clusterGrid;         // (primer índice, número de luces) por cluster
+uniform usamplerBuffer clusterLightIndices; // Índices de luz de todos los clusters
+uniform samplerBuffer pointLightData;       // 4 texels por luz
+
+int clusterIndex(vec3 fragPos) {
+    vec4 viewSpace = view * vec4(fragPos, 1.0);
+    vec4 clip = projection * viewSpace;
+    vec2 screen = (clip.xy / clip.w) * 0.5 + 0.5;
+    float slice = log(max(-viewSpace.z, 1e-4)) * clusterDepthScale + clusterDepthBias;
+
+    ivec3 cell = ivec3(ivec2(floor(screen * vec2(clusterCount.xy))), int(floor(slice)));
+    cell = clamp(cell, ivec3(0), clusterCount - 1);
+    return (cell.z * clusterCount.y + cell.y) * clusterCount.x + cell.x;
+}
+
+vec3 CalcClusteredPointLights(vec3 normal, vec3 fragPos, vec3 baseColor) {
+    vec3 result = vec3(0.0);
+    if (numPointLights == 0) return result;
+
+    uvec2 range = texelFetch(clusterGrid, clusterIndex(fragPos)).xy;
+
+    for (uint i = 0u; i < range.y; i++) {
+        int light = int(texelFetch(clusterLightIndices, int(range.x + i)).r) * 4;
+        vec4 positionRange = texelFetch(pointLightData, light);          // posición, alcance
+        vec4 ambientConstant = texelFetch(pointLightData, light + 1);
+        vec4 diffuseLinear = texelFetch(pointLightData, light + 2);
+        float quadratic = texelFetch(pointLightData, light + 3).w;      // xyz: especular
+
+        vec3 toLight = positionRange.xyz - fragPos;
+        float distance = length(toLight);
+        if (distance > positionRange.w) continue;
+
+        vec3 lightDir = toLight / distance;
+
+        // Ambient
+        vec3 ambient = ambientConstant.rgb * baseColor;
+
+        // Diffuse
+        float diff = max(dot(normal, lightDir), 0.0);
+        vec3 diffuse = diffuseLinear.rgb * diff * baseColor;
+
+        // Atenuación
+        float attenuation = 1.0 / (ambientConstant.w + diffuseLinear.w * distance + quadratic * (distance * distance));
+
+        result += (ambient + diffuse) * attenuation;
+    }
+
+    return result;
+}
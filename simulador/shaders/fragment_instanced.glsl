@@ -8,22 +8,9 @@ in vec2 TexCoords;
 
 uniform sampler2D ourTexture;
 uniform bool useTexture;
-uniform vec3 viewPos;
 
-// Fog
-uniform bool fogEnabled = true;
-uniform float fogDensity = 0.05;
-uniform vec3 fogColor = vec3(0.7, 0.8, 0.9);
-
-// Directional light
-struct DirLight {
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    bool enabled;
-};
-uniform DirLight dirLight;
+// Camera, fog and directional light of the frame
+#include "frame_data.glsl"
 
 uniform float shininess = 32.0;
 
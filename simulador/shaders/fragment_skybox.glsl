@@ -5,10 +5,8 @@ in vec3 TexCoords;
 
 uniform samplerCube skybox;
 
-// Niebla
-uniform bool fogEnabled = true;
-uniform float fogDensity = 0.0001;         // misma magnitud que el terreno
-uniform vec3 fogColor = vec3(0.85, 0.90, 0.95);
+// Niebla (fogEnabled, fogDensity y fogColor del frame)
+#include "frame_data.glsl"
 
 // Controles específicos del skybox para mapear densidad a ángulo de horizonte
 uniform float skyFogScale = 15000.0;       // escala para mapear densidad a mezcla visible
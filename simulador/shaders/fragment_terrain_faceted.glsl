@@ -5,20 +5,8 @@ in vec3 FragPos;
 in vec3 Normal;
 in vec2 TexCoords;
 
-uniform vec3 viewPos;
-uniform bool fogEnabled = true;
-uniform float fogDensity = 0.05;
-uniform vec3 fogColor = vec3(0.7, 0.8, 0.9);
-
-// Directional light
-struct DirLight {
-    vec3 direction;
-    vec3 ambient;
-    vec3 diffuse;
-    vec3 specular;
-    bool enabled;
-};
-uniform DirLight dirLight;
+// Cámara, niebla y luz direccional del frame
+#include "frame_data.glsl"
 
 // Simple pseudo-random function
 float pseudoRandom(vec3 pos) {
@@ -0,0 +1,27 @@
+// Datos por frame compartidos por los shaders de escena: cámara, niebla y
+// luces. Bloque std140 que se sube una vez por frame (FrameUniforms en
+// src/graphics/rendering/frame_uniforms.h, el orden debe coincidir).
+
+struct DirLight {
+    vec3 direction;
+    bool enabled;
+    vec3 ambient;
+    vec3 diffuse;
+    vec3 specular;
+};
+
+layout (std140) uniform FrameData {
+    mat4 view;
+    mat4 projection;
+    vec3 viewPos;           // Posición de la cámara
+    bool fogEnabled;
+    vec3 fogColor;
+    float fogDensity;
+    DirLight dirLight;      // Luz direccional (sol)
+
+    // Luces puntuales por cluster (clustered_lights.glsl)
+    ivec3 clusterCount;     // Clusters en x, y y profundidad
+    int numPointLights;     // Luces visibles, 0 = ninguna
+    float clusterDepthScale;
+    float clusterDepthBias;
+};
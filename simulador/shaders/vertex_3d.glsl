@@ -2,8 +2,8 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
-layout (location = 4) in vec3 aBitangent;
+layout (location = 3) in vec4 aTangent;     // w = signo de la bitangente (compacto)
+layout (location = 4) in vec3 aBitangent;   // sólo VertexFormat::FULL
 layout (location = 5) in vec3 aColor;
 
 out vec3 ourColor;
@@ -11,13 +11,14 @@ out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
+#include "frame_data.glsl"
+#include "vertex_packing.glsl"
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main() {
     FragPos = vec3(model * vec4(aPos, 1.0));
-    Normal = mat3(transpose(inverse(model))) * aNormal;
+    Normal = mat3(transpose(inverse(model))) * vertexNormal();
     TexCoords = aTexCoords;
     
     gl_Position = projection * view * vec4(FragPos, 1.0);
@@ -2,34 +2,37 @@
 layout (location = 0) in vec3 aPos;
 layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec2 aTexCoords;
-layout (location = 3) in vec3 aTangent;
-layout (location = 4) in vec3 aBitangent;
+layout (location = 3) in vec4 aTangent;     // w = signo de la bitangente (compacto)
+layout (location = 4) in vec3 aBitangent;   // sólo VertexFormat::FULL
+layout (location = 5) in vec3 aColor;
 
-// Instance attributes
-layout (location = 5) in vec3 aInstancePos;
-layout (location = 6) in vec3 aInstanceScale;
-layout (location = 7) in float aInstanceRotY;
-layout (location = 8) in float aInstanceBillboard;
+// Instance attributes (Mesh::setInstanceData)
+layout (location = 6) in vec3 aInstancePos;
+layout (location = 7) in vec3 aInstanceScale;
+layout (location = 8) in float aInstanceRotY;
+layout (location = 9) in float aInstanceBillboard;
 
 out vec3 ourColor;
 out vec3 FragPos;
 out vec3 Normal;
 out vec2 TexCoords;
 
-uniform mat4 view;
-uniform mat4 projection;
-uniform vec3 cameraPos;
-uniform vec3 cameraRight;
-uniform vec3 cameraUp;
+#include "frame_data.glsl"
+#include "vertex_packing.glsl"
+
+// Color del tipo de objeto (un draw instanciado por tipo)
+uniform vec3 objectColor = vec3(0.5);
 
 void main() {
     vec3 world_pos = aPos * aInstanceScale;
+    // Escala no uniforme: la normal se divide por la escala (inversa transpuesta)
+    vec3 normal = vertexNormal() / aInstanceScale;
     
     // Si es billboard, orientar hacia la cámara
     if (aInstanceBillboard > 0.5) {
         // Billboard cilíndrico: mantener base en suelo, rotar solo alrededor de Y
         // Construir matriz de billboard (sin rotación Y del mesh)
-        vec3 to_camera = normalize(cameraPos - aInstancePos);
+        vec3 to_camera = normalize(viewPos - aInstancePos);
         vec3 right = normalize(cross(vec3(0, 1, 0), to_camera));
         vec3 up = vec3(0, 1, 0);
         
@@ -49,16 +52,19 @@ void main() {
         );
         
         world_pos = rotated;
+        normal = vec3(normal.x * cos_ry - normal.z * sin_ry,
+                      normal.y,
+                      normal.x * sin_ry + normal.z * cos_ry);
     }
     
     // Agregar posición de instancia
     world_pos += aInstancePos;
     
     // Normal (para mallas no-billboard; para billboard, calcular en fragment)
-    Normal = aNormal;
+    Normal = normal;
     TexCoords = aTexCoords;
     FragPos = world_pos;
     
     gl_Position = projection * view * vec4(world_pos, 1.0);
-    ourColor = vec3(0.5, 0.5, 0.5);
+    ourColor = objectColor;
 }
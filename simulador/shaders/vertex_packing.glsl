@@ -0,0 +1,24 @@
+// Lectura de los formatos de vértice compactos (VertexFormat en
+// src/scene/vertex_format.h). Se incluye después de declarar aNormal.
+//
+// Con los formatos compactos la normal llega octaédrica en la location 10 y
+// la location 1 queda deshabilitada a 0; con FULL la normal es unitaria.
+// La tangente compacta lleva en w el signo de la bitangente.
+
+layout (location = 10) in vec2 aNormalOct;
+
+vec3 decodeOctahedral(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return normalize(n);
+}
+
+vec3 vertexNormal() {
+    return dot(aNormal, aNormal) > 0.0 ? aNormal : decodeOctahedral(aNormalOct);
+}
+
+vec3 vertexBitangent(vec3 normal, vec4 tangent) {
+    return cross(normal, tangent.xyz) * (tangent.w < 0.0 ? -1.0 : 1.0);
+}
@@ -1,4 +1,5 @@
 #include "opengl_context.h"
+#include "../graphics/rendering/gl_state.h"
 #include <iostream>
 
 namespace Graphics {
@@ -134,29 +135,20 @@ namespace Graphics {
         }
 
         void OpenGLContext::enableDepthTest(bool enable) {
-            if (enable) {
-                glEnable(GL_DEPTH_TEST);
-            } else {
-                glDisable(GL_DEPTH_TEST);
-            }
+            Rendering::GLState::getInstance().setEnabled(GL_DEPTH_TEST, enable);
         }
 
         void OpenGLContext::enableFaceCulling(bool enable) {
+            Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+            gl_state.setEnabled(GL_CULL_FACE, enable);
             if (enable) {
-                glEnable(GL_CULL_FACE);
-                glCullFace(GL_BACK);
+                gl_state.cullFace(GL_BACK);
                 glFrontFace(GL_CCW);
-            } else {
-                glDisable(GL_CULL_FACE);
             }
         }
 
         void OpenGLContext::setWireframeMode(bool enable) {
-            if (enable) {
-                glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-            } else {
-                glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-            }
+            Rendering::GLState::getInstance().polygonMode(enable ? GL_LINE : GL_FILL);
         }
 
         void OpenGLContext::printContextInfo() const {
@@ -0,0 +1,412 @@
+#include <dlfdm/aerodatabase.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+
+namespace dlfdm {
+
+namespace {
+
+const char* const kCoefficientNames[AeroDatabase::NUM_COEFFICIENTS] = {
+    "CL", "CD", "CY", "Cl", "Cm", "Cn"
+};
+
+const char* const kAxisNames[AeroTable::NUM_AXES] = {
+    "alpha", "beta", "mach", "delta"
+};
+
+const char* const kControlNames[] = {
+    "none", "elevator", "aileron", "rudder"
+};
+
+template <class T, std::size_t N>
+int find_name(const T (&names)[N], const std::string& name)
+{
+    for (std::size_t i = 0; i < N; ++i) {
+        if (name == names[i]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+// Fill a table sampling f(alpha, beta, mach, delta) at the breakpoints
+AeroTable sample_table(const std::vector<float> breakpoints[AeroTable::NUM_AXES],
+                       const std::function<float(float, float, float, float)>& f)
+{
+    std::vector<float> data;
+    for (float delta : breakpoints[AeroTable::CONTROL]) {
+        for (float mach : breakpoints[AeroTable::MACH]) {
+            for (float beta : breakpoints[AeroTable::BETA]) {
+                for (float alpha : breakpoints[AeroTable::ALPHA]) {
+                    data.push_back(f(alpha, beta, mach, delta));
+                }
+            }
+        }
+    }
+
+    AeroTable table;
+    table.set(breakpoints, data);
+    return table;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// AeroTable
+// -----------------------------------------------------------------------------
+
+AeroTable::AeroTable()
+    : data_offset_(0), num_active_(0)
+{
+    for (AxisLayout& axis : axes_) {
+        axis = {0, 0, 0, 0};
+    }
+    std::fill(active_axis_, active_axis_ + NUM_AXES, 0);
+    std::fill(corner_offset_, corner_offset_ + kNumCorners, 0);
+}
+
+bool AeroTable::set(const std::vector<float> breakpoints[NUM_AXES], const std::vector<float>& data)
+{
+    std::size_t size = 1;
+    for (int a = 0; a < NUM_AXES; ++a) {
+        const std::vector<float>& bp = breakpoints[a];
+        if (bp.empty()) {
+            return false;
+        }
+        for (std::size_t i = 1; i < bp.size(); ++i) {
+            if (!(bp[i] > bp[i - 1])) {
+                return false;
+            }
+        }
+        size *= bp.size();
+    }
+
+    if (data.size() != size) {
+        return false;
+    }
+
+    storage_.clear();
+
+    std::size_t stride = 1;
+    num_active_ = 0;
+    for (int a = 0; a < NUM_AXES; ++a) {
+        const std::vector<float>& bp = breakpoints[a];
+        AxisLayout& axis = axes_[a];
+
+        axis.count = static_cast<int>(bp.size());
+        axis.stride = stride;
+        stride *= bp.size();
+
+        axis.breakpoints = storage_.size();
+        storage_.insert(storage_.end(), bp.begin(), bp.end());
+
+        axis.inv_width = storage_.size();
+        for (std::size_t i = 0; i + 1 < bp.size(); ++i) {
+            storage_.push_back(1.0f / (bp[i + 1] - bp[i]));
+        }
+
+        if (bp.size() > 1) {
+            active_axis_[num_active_++] = a;
+        }
+    }
+
+    data_offset_ = storage_.size();
+    storage_.insert(storage_.end(), data.begin(), data.end());
+
+    // Corner c of a cell: bit k selects the upper breakpoint of active axis k
+    for (int c = 0; c < kNumCorners; ++c) {
+        corner_offset_[c] = 0;
+        for (int k = 0; k < num_active_; ++k) {
+            if (c & (1 << k)) {
+                corner_offset_[c] += axes_[active_axis_[k]].stride;
+            }
+        }
+    }
+
+    return true;
+}
+
+float AeroTable::lookup(const float x[NUM_AXES], Cache& cache) const
+{
+    // Dispatch once so the per axis loops below are fully unrolled
+    switch (num_active_) {
+    case 0:  return storage_[data_offset_];
+    case 1:  return interpolate<1>(x, cache);
+    case 2:  return interpolate<2>(x, cache);
+    case 3:  return interpolate<3>(x, cache);
+    default: return interpolate<4>(x, cache);
+    }
+}
+
+template <int N>
+float AeroTable::interpolate(const float x[NUM_AXES], Cache& cache) const
+{
+    const float* storage = storage_.data();
+    std::size_t base = data_offset_;
+    float t[N];
+
+    for (int k = 0; k < N; ++k) {
+        const int a = active_axis_[k];
+        const AxisLayout& axis = axes_[a];
+        const float* bp = storage + axis.breakpoints;
+        const int last = axis.count - 2;    // Last valid lower index
+
+        // Start from the bracket of the previous lookup, normally no iteration runs
+        int i = std::min(cache.index[a], last);
+        while (i > 0 && x[a] < bp[i]) {
+            --i;
+        }
+        while (i < last && x[a] >= bp[i + 1]) {
+            ++i;
+        }
+        cache.index[a] = i;
+
+        // Clamp to the table limits (no extrapolation)
+        t[k] = std::min(std::max((x[a] - bp[i]) * storage[axis.inv_width + i], 0.0f), 1.0f);
+        base += static_cast<std::size_t>(i) * axis.stride;
+    }
+
+    constexpr int num_corners = 1 << N;
+    float v[num_corners];
+    const float* cell = storage + base;
+    for (int c = 0; c < num_corners; ++c) {
+        v[c] = cell[corner_offset_[c]];
+    }
+
+    // Reduce one axis at a time: corners 2j and 2j+1 differ only in axis k
+    int n = num_corners;
+    for (int k = 0; k < N; ++k) {
+        n >>= 1;
+        for (int j = 0; j < n; ++j) {
+            v[j] = v[2 * j] + t[k] * (v[2 * j + 1] - v[2 * j]);
+        }
+    }
+
+    return v[0];
+}
+
+void AeroTable::scale(float factor)
+{
+    if (storage_.empty()) {
+        return;
+    }
+
+    for (std::size_t i = data_offset_; i < storage_.size(); ++i) {
+        storage_[i] *= factor;
+    }
+}
+
+std::vector<float> AeroTable::get_breakpoints(int axis) const
+{
+    if (axis < 0 || axis >= NUM_AXES || storage_.empty()) {
+        return {};
+    }
+
+    const float* bp = storage_.data() + axes_[axis].breakpoints;
+    return std::vector<float>(bp, bp + axes_[axis].count);
+}
+
+// -----------------------------------------------------------------------------
+// AeroDatabase
+// -----------------------------------------------------------------------------
+
+AeroDatabase::AeroDatabase()
+{
+    std::fill(controls_, controls_ + NUM_COEFFICIENTS, NONE);
+}
+
+bool AeroDatabase::load(const std::string& path)
+{
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "AeroDatabase: cannot open " << path << std::endl;
+        return false;
+    }
+
+    if (!load(file)) {
+        std::cerr << "AeroDatabase: invalid aerodynamic data in " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool AeroDatabase::load(std::istream& is)
+{
+    // Strip comments, the remaining format is whitespace separated tokens
+    std::stringstream tokens;
+    std::string line;
+    while (std::getline(is, line)) {
+        tokens << line.substr(0, line.find('#')) << '\n';
+    }
+
+    AeroDatabase db;
+    std::string token;
+    while (tokens >> token) {
+        if (token != "table") {
+            std::cerr << "AeroDatabase: expected 'table', found '" << token << "'" << std::endl;
+            return false;
+        }
+
+        std::string name;
+        tokens >> name;
+        const int coefficient = find_name(kCoefficientNames, name);
+        if (coefficient < 0) {
+            std::cerr << "AeroDatabase: unknown coefficient '" << name << "'" << std::endl;
+            return false;
+        }
+
+        Control control = NONE;
+        std::vector<float> breakpoints[AeroTable::NUM_AXES];
+        std::vector<float> data;
+
+        while (tokens >> token && token != "end") {
+            if (token == "control") {
+                tokens >> name;
+                const int c = find_name(kControlNames, name);
+                if (c < 0) {
+                    std::cerr << "AeroDatabase: unknown control '" << name << "'" << std::endl;
+                    return false;
+                }
+                control = static_cast<Control>(c);
+            }
+            else if (token == "data") {
+                float value;
+                while (tokens >> value) {
+                    data.push_back(value);
+                }
+                tokens.clear();     // Stopped at the 'end' keyword
+            }
+            else {
+                const int axis = find_name(kAxisNames, token);
+                if (axis < 0) {
+                    std::cerr << "AeroDatabase: unknown keyword '" << token << "'" << std::endl;
+                    return false;
+                }
+
+                float value;
+                while (tokens >> value) {
+                    breakpoints[axis].push_back(value);
+                }
+                tokens.clear();
+            }
+        }
+
+        // Undefined axes are constant
+        for (auto& bp : breakpoints) {
+            if (bp.empty()) {
+                bp.push_back(0.0f);
+            }
+        }
+
+        AeroTable table;
+        if (!table.set(breakpoints, data)) {
+            std::cerr << "AeroDatabase: table " << kCoefficientNames[coefficient]
+                      << " has inconsistent breakpoints/data" << std::endl;
+            return false;
+        }
+
+        db.set_table(static_cast<Coefficient>(coefficient), control, table);
+    }
+
+    if (!db.is_complete()) {
+        std::cerr << "AeroDatabase: missing coefficient tables" << std::endl;
+        return false;
+    }
+
+    *this = db;
+    return true;
+}
+
+bool AeroDatabase::set_table(Coefficient coefficient, Control control, const AeroTable& table)
+{
+    if (coefficient < 0 || coefficient >= NUM_COEFFICIENTS || table.empty()) {
+        return false;
+    }
+
+    tables_[coefficient] = table;
+    controls_[coefficient] = control;
+    return true;
+}
+
+void AeroDatabase::scale(Coefficient coefficient, float factor)
+{
+    if (coefficient >= 0 && coefficient < NUM_COEFFICIENTS) {
+        tables_[coefficient].scale(factor);
+    }
+}
+
+bool AeroDatabase::is_complete(void) const
+{
+    for (const AeroTable& table : tables_) {
+        if (table.empty()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void AeroDatabase::evaluate(float alpha, float beta, float mach,
+                            const ControlInputs& controls,
+                            Cache& cache,
+                            float coefficients[NUM_COEFFICIENTS]) const
+{
+    const float deflection[] = {0.0f, controls.elevator, controls.aileron, controls.rudder};
+
+    for (int c = 0; c < NUM_COEFFICIENTS; ++c) {
+        const float x[AeroTable::NUM_AXES] = {alpha, beta, mach, deflection[controls_[c]]};
+        coefficients[c] = tables_[c].lookup(x, cache.tables[c]);
+    }
+}
+
+AeroDatabase AeroDatabase::from_linear(const AircraftParameters& p)
+{
+    // A linear function is represented exactly by the end points of each axis
+    const std::vector<float> alpha = {-1.0f, 1.0f};
+    const std::vector<float> beta = {-0.5f, 0.5f};
+    const std::vector<float> none = {0.0f};
+
+    const std::vector<float> elevator = {p.min_elevator, p.max_elevator};
+    const std::vector<float> aileron = {p.min_aileron, p.max_aileron};
+    const std::vector<float> rudder = {-p.max_rudder, p.max_rudder};
+
+    AeroDatabase db;
+
+    const std::vector<float> bp_CL[] = {alpha, none, none, elevator};
+    db.set_table(CL, ELEVATOR, sample_table(bp_CL, [&p](float a, float, float, float de) {
+        return p.CL0 + p.CLa * a + p.CL_delta_e * de;
+    }));
+
+    const std::vector<float> bp_CD[] = {alpha, none, none, none};
+    db.set_table(CD, NONE, sample_table(bp_CD, [&p](float a, float, float, float) {
+        return p.CD0 + p.CDa * a;
+    }));
+
+    const std::vector<float> bp_CY[] = {none, beta, none, rudder};
+    db.set_table(CY, RUDDER, sample_table(bp_CY, [&p](float, float b, float, float dr) {
+        return p.CY_beta * b + p.CY_delta_r * dr;
+    }));
+
+    const std::vector<float> bp_Cl[] = {none, beta, none, aileron};
+    db.set_table(Cl, AILERON, sample_table(bp_Cl, [&p](float, float b, float, float da) {
+        return p.Cl_beta * b + p.Cl_delta_a * da;
+    }));
+
+    const std::vector<float> bp_Cm[] = {alpha, none, none, elevator};
+    db.set_table(Cm, ELEVATOR, sample_table(bp_Cm, [&p](float a, float, float, float de) {
+        return p.Cm0 + p.Cma * a + p.Cm_delta_e * de;
+    }));
+
+    const std::vector<float> bp_Cn[] = {none, beta, none, rudder};
+    db.set_table(Cn, RUDDER, sample_table(bp_Cn, [&p](float, float b, float, float dr) {
+        return p.Cn_beta * b + p.Cn_delta_r * dr;
+    }));
+
+    return db;
+}
+
+} // namespace dlfdm
@@ -1,11 +1,17 @@
 #include <dlfdm/aerodynamicsmodel.h>
 
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
+#include <dlfdm/fastmath.h>
 #include <dlfdm/tools.h>
 
 namespace dlfdm {
 
+// Points per block of the batch calculate(), every temporary of a block fits in L1
+static constexpr std::size_t kBatchBlock = 256;
+
 static std::ostream& operator<<(std::ostream& os, const glm::vec2 v){
     os << v.x << "," << v.y;
     return os;
@@ -17,7 +23,7 @@ static std::ostream& operator<<(std::ostream& os, const glm::vec3 v){
 }
 
 AerodynamicsModel::AerodynamicsModel(const AircraftParameters& p)
-    : aircraft_data_(p)
+    : aircraft_data_(p), constants_(AircraftConstants::compile(p)), database_(nullptr)
 {
     wind_forces_    = glm::vec3(0.0f);
     aero_moments_   = glm::vec3(0.0f);
@@ -39,13 +45,14 @@ void AerodynamicsModel::calculate_angles(const glm::vec3 &vel, float &alpha, flo
         return;
     }
 
-    alpha = std::atan2(w, u);
-    beta = glm::asin(glm::clamp(v / V, -1.0f, 1.0f));
+    alpha = math::atan2(w, u);
+    beta = math::asin(glm::clamp(v / V, -1.0f, 1.0f));
 }
 
 AerodynamicsModel::AeroDynamicForces AerodynamicsModel::calculate(const glm::vec3 &body_velocity,
                                                                   const glm::vec3 &body_omega,
-                                                                  const ControlInputs &controls)
+                                                                  const ControlInputs &controls,
+                                                                  const Atmosphere::Properties &air)
 {
     float p = body_omega.x;
     float q = body_omega.y;
@@ -54,62 +61,81 @@ AerodynamicsModel::AeroDynamicForces AerodynamicsModel::calculate(const glm::vec
     float V = glm::length(body_velocity);
 
     if (V < 0.1f) {
-        return {{0, 0, 0}, {0, 0, 0}};
+        return {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}, {0, 0}};
     }
 
     float alpha, beta;
     calculate_angles(body_velocity, alpha, beta);
     aero_angles_ = glm::vec2(alpha,beta);
 
-    // Dynamic pressure
-    float qbar = 0.5f * rho * V * V;
+    // Dynamic pressure times wing area
+    const float qbar_S = constants_.half_wing_area * air.density * V * V;
+    const float inv_V = 1.0f / V;
 
     // Characteristic lengths for moment non-dimensionalization
-    float c_bar = aircraft_data_.wingChord;
-    float b = aircraft_data_.wingSpan;
+    const float c_bar = constants_.wing_chord;
+    const float b = constants_.wing_span;
+
+    // Static coefficients
+    float CL, CD, CY, Cl, Cm, Cn;
+
+    if (database_) {
+        float coefficients[AeroDatabase::NUM_COEFFICIENTS];
+        database_->evaluate(alpha, beta, V / air.speed_of_sound, controls, database_cache_, coefficients);
+
+        CL = coefficients[AeroDatabase::CL];
+        CD = coefficients[AeroDatabase::CD];
+        CY = coefficients[AeroDatabase::CY];
+        Cl = coefficients[AeroDatabase::Cl];
+        Cm = coefficients[AeroDatabase::Cm];
+        Cn = coefficients[AeroDatabase::Cn];
+    }
+    else {
+        // Longitudinal aerodynamics forces and moments
+        // Lift and Drag coefficients
+//        float elevator = clamp(controls.elevator, aircraft_data_.min_elevator, aircraft_data_.max_elevator);
+
+        CL = aircraft_data_.CL0
+                + aircraft_data_.CLa * alpha
+                + aircraft_data_.CL_delta_e * controls.elevator;
 
-    // Longitudinal aerodynamics forces and moments
-    // Lift and Drag coefficients
-//    float elevator = clamp(controls.elevator, aircraft_data_.min_elevator, aircraft_data_.max_elevator);
+        CD = aircraft_data_.CD0 + aircraft_data_.CDa * alpha;
 
-    float CL = aircraft_data_.CL0
-            + aircraft_data_.CLa * alpha
-            + aircraft_data_.CL_delta_e * controls.elevator;
+        // Pitch moment
+        Cm = aircraft_data_.Cm0
+                + aircraft_data_.Cma * alpha
+                + aircraft_data_.Cm_delta_e * controls.elevator;
 
-    float CD = aircraft_data_.CD0 + aircraft_data_.CDa * alpha;
+        // Lateral aerodynamics forces and moments
+        // Side force
+//        float rudder = clamp(controls.rudder, -aircraft_data_.max_rudder, aircraft_data_.max_rudder);
 
-    // Pitch moment
-    float Cm = aircraft_data_.Cm0
-            + aircraft_data_.Cma * alpha
-            + (aircraft_data_.Cm_q * q * c_bar) / (2.0f * V)
-            + aircraft_data_.Cm_delta_e * controls.elevator;
+        CY = aircraft_data_.CY_beta * beta
+                + aircraft_data_.CY_delta_r * controls.rudder;
+//                + params.CY_r * r;
 
-    // Lateral aerodynamics forces and moments
-    // Side force
-//    float rudder = clamp(controls.rudder, -aircraft_data_.max_rudder, aircraft_data_.max_rudder);
+        // Roll moment from sideslip and control
+//        float aileron = clamp(controls.aileron, aircraft_data_.min_aileron, aircraft_data_.max_aileron);
 
-    float CY = aircraft_data_.CY_beta * beta
-            + aircraft_data_.CY_delta_r * controls.rudder;
-//            + params.CY_r * r;
+        Cl = aircraft_data_.Cl_beta * beta
+                + aircraft_data_.Cl_delta_a * controls.aileron;
+
+        // Yaw moment from sideslip and control
+        Cn = aircraft_data_.Cn_beta * beta
+                + aircraft_data_.Cn_delta_r * controls.rudder;
+    }
 
-    // Roll moment from sideslip and control
-//    float aileron = clamp(controls.aileron, aircraft_data_.min_aileron, aircraft_data_.max_aileron);
+    // Dynamic (damping) terms, Cx_y * rate * length / (2 V)
+    Cm += constants_.Cm_q_c2 * q * inv_V;
 
-    float Cl = aircraft_data_.Cl_beta * beta
-            + aircraft_data_.Cl_delta_a * controls.aileron
-            + (aircraft_data_.Cl_p * p * b) / (2.0f * V)
-            + (aircraft_data_.Cl_r * r * b) / (2.0f * V);
+    Cl += (constants_.Cl_p_b2 * p + constants_.Cl_r_b2 * r) * inv_V;
 
-    // Yaw moment from sideslip and control
-    float Cn = aircraft_data_.Cn_beta * beta
-            + aircraft_data_.Cn_delta_r * controls.rudder
-            + (aircraft_data_.Cn_r * r * b) / (2.0f * V)
-            + (aircraft_data_.Cn_p * p * b) / (2.0f * V);
+    Cn += (constants_.Cn_r_b2 * r + constants_.Cn_p_b2 * p) * inv_V;
 
     // Forces in aerodynamic axes (lift up, drag back)
-    float D = qbar * aircraft_data_.wingArea * CD;
-    float Y = qbar * aircraft_data_.wingArea * CY;
-    float L = qbar * aircraft_data_.wingArea * CL;
+    float D = qbar_S * CD;
+    float Y = qbar_S * CY;
+    float L = qbar_S * CL;
 
     // The negative sign corresponds to the wind axes definition
     // x_w -> fordward, y_w -> right , z_w -> down
@@ -120,10 +146,9 @@ AerodynamicsModel::AeroDynamicForces AerodynamicsModel::calculate(const glm::vec
     // Transform to body axes
     // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
     // Eq. (2.3-2b) pag. 63 (pdf 85)
-    const float ca = glm::cos(alpha);
-    const float sa = glm::sin(alpha);
-    const float cb = glm::cos(beta);
-    const float sb = glm::sin(beta);
+    float ca, sa, cb, sb;
+    math::sincos(alpha, sa, ca);
+    math::sincos(beta, sb, cb);
 
     // Important! glm matrix are row mayor order as per opengl standard, but the
     // body to wing transformation prsented in the book is given in column mayor
@@ -136,19 +161,155 @@ AerodynamicsModel::AeroDynamicForces AerodynamicsModel::calculate(const glm::vec
     body_forces_ = windToBody * wind_forces_;
 
     // Moments in body frame
-    float L_moment = qbar * aircraft_data_.wingArea * b * Cl;
-    float M_moment = qbar * aircraft_data_.wingArea * c_bar * Cm;
-    float N_moment = qbar * aircraft_data_.wingArea * b * Cn;
+    float L_moment = qbar_S * b * Cl;
+    float M_moment = qbar_S * c_bar * Cm;
+    float N_moment = qbar_S * b * Cn;
 
     body_moments_ = glm::vec3(L_moment, M_moment, N_moment);
 
     AeroDynamicForces aero;
     aero.body_forces = body_forces_;
     aero.body_moments = body_moments_;
+    aero.wind_forces = wind_forces_;
+    aero.angles = aero_angles_;
 
     return aero;
 }
 
+void AerodynamicsModel::calculate(const BatchInput &in, const BatchOutput &out, std::size_t count) const
+{
+    // Every block is copied into local arrays padded to kBatchBlock points, so
+    // each pass is a fixed length loop with no aliasing the compiler can
+    // vectorize; atan2/asin are vectorized only with DLFDM_FAST_MATH and the
+    // table lookups stay scalar
+    float u[kBatchBlock], v[kBatchBlock], w[kBatchBlock];
+    float p[kBatchBlock], q[kBatchBlock], r[kBatchBlock];
+    float elevator[kBatchBlock], aileron[kBatchBlock], rudder[kBatchBlock];
+    float rho[kBatchBlock];
+
+    float V[kBatchBlock], inv_V[kBatchBlock], qbar_S[kBatchBlock];
+    float ca[kBatchBlock], sa[kBatchBlock], cb[kBatchBlock], sb[kBatchBlock];
+    float alpha[kBatchBlock], beta[kBatchBlock];
+    float CL[kBatchBlock], CD[kBatchBlock], CY[kBatchBlock];
+    float Cl[kBatchBlock], Cm[kBatchBlock], Cn[kBatchBlock];
+
+    float fx[kBatchBlock], fy[kBatchBlock], fz[kBatchBlock];
+    float mx[kBatchBlock], my[kBatchBlock], mz[kBatchBlock];
+
+    const AircraftParameters& k = aircraft_data_;
+    const float half_wing_area = constants_.half_wing_area;
+    const float c_bar = constants_.wing_chord;
+    const float b = constants_.wing_span;
+
+    AeroDatabase::Cache cache;
+
+    for (std::size_t start = 0; start < count; start += kBatchBlock) {
+        const std::size_t n = std::min(kBatchBlock, count - start);
+
+        const auto load = [start, n](const float* src, float* dst) {
+            std::copy(src + start, src + start + n, dst);
+            std::fill(dst + n, dst + kBatchBlock, 0.0f);
+        };
+        load(in.u, u);
+        load(in.v, v);
+        load(in.w, w);
+        load(in.p, p);
+        load(in.q, q);
+        load(in.r, r);
+        load(in.elevator, elevator);
+        load(in.aileron, aileron);
+        load(in.rudder, rudder);
+        load(in.density, rho);
+
+        // Airspeed, dynamic pressure and direction cosines of the relative wind
+        // ca = cos(alpha) = u / |(u, w)|, cb = cos(beta) = |(u, w)| / V
+        for (std::size_t i = 0; i < kBatchBlock; ++i) {
+            const float uw2 = u[i] * u[i] + w[i] * w[i];
+            const float V2 = uw2 + v[i] * v[i];
+            const float uw = std::sqrt(uw2);
+            V[i] = std::sqrt(V2);
+
+            // Everything is computed unconditionally and then selected, so the
+            // loop has no branches. Zero loads below 0.1 m/s, as calculate()
+            const bool moving = V2 >= 0.01f;
+            const float inv_speed = 1.0f / std::max(V[i], 0.1f);
+            inv_V[i] = moving ? inv_speed : 0.0f;
+
+            const float dynamic_pressure = half_wing_area * rho[i] * V2;
+            qbar_S[i] = moving ? dynamic_pressure : 0.0f;
+
+            const bool forward = uw2 > 0.0f;
+            const float inv_uw = 1.0f / std::max(uw, 1e-20f);
+            ca[i] = forward ? u[i] * inv_uw : 1.0f;
+            sa[i] = forward ? w[i] * inv_uw : 0.0f;
+            cb[i] = moving ? uw * inv_speed : 1.0f;
+            sb[i] = std::min(std::max(v[i] * inv_V[i], -1.0f), 1.0f);
+        }
+
+        math::atan2(w, u, alpha, kBatchBlock);
+        math::asin(sb, beta, kBatchBlock);
+
+        // Static coefficients
+        if (database_) {
+            const float* a = in.speed_of_sound + start;
+            float coefficients[AeroDatabase::NUM_COEFFICIENTS];
+
+            for (std::size_t i = 0; i < n; ++i) {
+                const ControlInputs controls = {0.0f, elevator[i], aileron[i], rudder[i]};
+                database_->evaluate(alpha[i], beta[i], V[i] / a[i], controls, cache, coefficients);
+
+                CL[i] = coefficients[AeroDatabase::CL];
+                CD[i] = coefficients[AeroDatabase::CD];
+                CY[i] = coefficients[AeroDatabase::CY];
+                Cl[i] = coefficients[AeroDatabase::Cl];
+                Cm[i] = coefficients[AeroDatabase::Cm];
+                Cn[i] = coefficients[AeroDatabase::Cn];
+            }
+            for (std::size_t i = n; i < kBatchBlock; ++i) {
+                CL[i] = CD[i] = CY[i] = Cl[i] = Cm[i] = Cn[i] = 0.0f;
+            }
+        }
+        else {
+            for (std::size_t i = 0; i < kBatchBlock; ++i) {
+                CL[i] = k.CL0 + k.CLa * alpha[i] + k.CL_delta_e * elevator[i];
+                CD[i] = k.CD0 + k.CDa * alpha[i];
+                Cm[i] = k.Cm0 + k.Cma * alpha[i] + k.Cm_delta_e * elevator[i];
+                CY[i] = k.CY_beta * beta[i] + k.CY_delta_r * rudder[i];
+                Cl[i] = k.Cl_beta * beta[i] + k.Cl_delta_a * aileron[i];
+                Cn[i] = k.Cn_beta * beta[i] + k.Cn_delta_r * rudder[i];
+            }
+        }
+
+        // Damping terms, forces to body axes and moments
+        for (std::size_t i = 0; i < kBatchBlock; ++i) {
+            const float Cm_i = Cm[i] + constants_.Cm_q_c2 * q[i] * inv_V[i];
+            const float Cl_i = Cl[i] + (constants_.Cl_p_b2 * p[i] + constants_.Cl_r_b2 * r[i]) * inv_V[i];
+            const float Cn_i = Cn[i] + (constants_.Cn_r_b2 * r[i] + constants_.Cn_p_b2 * p[i]) * inv_V[i];
+
+            // Wind axes (x forward, y right, z down)
+            const float Xw = -qbar_S[i] * CD[i];
+            const float Yw = qbar_S[i] * CY[i];
+            const float Zw = -qbar_S[i] * CL[i];
+
+            // Same rotation as the windToBody matrix of calculate()
+            fx[i] = ca[i] * cb[i] * Xw - ca[i] * sb[i] * Yw - sa[i] * Zw;
+            fy[i] = sb[i] * Xw + cb[i] * Yw;
+            fz[i] = sa[i] * cb[i] * Xw - sa[i] * sb[i] * Yw + ca[i] * Zw;
+
+            mx[i] = qbar_S[i] * b * Cl_i;
+            my[i] = qbar_S[i] * c_bar * Cm_i;
+            mz[i] = qbar_S[i] * b * Cn_i;
+        }
+
+        std::copy(fx, fx + n, out.fx + start);
+        std::copy(fy, fy + n, out.fy + start);
+        std::copy(fz, fz + n, out.fz + start);
+        std::copy(mx, mx + n, out.mx + start);
+        std::copy(my, my + n, out.my + start);
+        std::copy(mz, mz + n, out.mz + start);
+    }
+}
+
 void AerodynamicsModel::log_all_titles(std::ostream &os, const char &sep) const
 {
     log_forces_titles(os,sep);
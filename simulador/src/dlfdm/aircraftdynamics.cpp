@@ -2,6 +2,8 @@
 
 #include <iostream>
 
+#include <dlfdm/attitude.h>
+#include <dlfdm/fastmath.h>
 #include <dlfdm/tools.h>
 
 namespace dlfdm {
@@ -16,19 +18,23 @@ static std::ostream& operator<<(std::ostream& os, const glm::vec3 v){
     return os;
 }
 
-AircraftDynamics::AircraftDynamics(const AircraftParameters& p) : aircraft_data_(p)
+AircraftDynamics::AircraftDynamics(const AircraftParameters& p)
+    : aircraft_data_(p), constants_(AircraftConstants::compile(p)),
+      attitude_mode_(AttitudeMode::EULER)
 {
     state_derv_.euler_dot           = glm::vec3(0.0f,0.0f,0.0f);
     state_derv_.ned_position_dot    = glm::vec3(0.0f,0.0f,0.0f);
     state_derv_.body_velocity_dot   = glm::vec3(0.0f,0.0f,0.0f);
     state_derv_.body_omega_dot      = glm::vec3(0.0f,0.0f,0.0f);
+    state_derv_.attitude_dot        = glm::quat(0.0f,0.0f,0.0f,0.0f);
 
     body_total_force_ = glm::vec3(0.0f,0.0f,0.0f);
 }
 
 AircraftDynamics::StateDerivatives AircraftDynamics::compute_derivatives(const AircraftState &state,
                                                                         const AerodynamicsModel::AeroDynamicForces &aero,
-                                                                        const ControlInputs &controls)
+                                                                        const ControlInputs &controls,
+                                                                        const Atmosphere::Properties &air)
 {
     // Boby frame velocities
     float u = state.boby_velocity.x;
@@ -38,33 +44,52 @@ AircraftDynamics::StateDerivatives AircraftDynamics::compute_derivatives(const A
     float q = state.body_omega.y;
     float r = state.body_omega.z;
 
-    float phi   = state.phi;
-    float theta = state.theta;
-    float psi   = state.psi;
-
-    float cp = glm::cos(phi);
-    float sp = glm::sin(phi);
-    float ct = glm::cos(theta);
-    float st = glm::sin(theta);
-    float tt = glm::tan(theta);
-
-    // Position derivative (inertial frame)
-    float cy = glm::cos(psi);
-    float sy = glm::sin(psi);
-
-    // Transform NED to Body axes
-    // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
-    // Eq. (1.4-10) pag. 37 (pdf 59)
-
-    // Important! glm matrix are row mayor order as per opengl standard, but the
-    // ned to body transformation presented in the book is given in column mayor
-    // order so it has to be written as a transponse in glm:
-    // ie. glm::mat3 ned_to_body = glm::transpose(body_to_ned);
-    glm::mat3 body_to_ned(
-                ct * cy,                    ct * sy,                   -st,
-                sp * st * cy - cp * sy,     sp * st * sy + cp * cy,    sp * ct,
-                cp * st * cy + sp * sy,     cp * st * sy - sp * cy,    cp * ct
-                );
+    glm::mat3 body_to_ned;
+
+    if (attitude_mode_ == AttitudeMode::QUATERNION) {
+        // No trigonometry and no singularity at theta = +-90 deg
+        body_to_ned = quat_to_body_to_ned(state.attitude);
+
+        state_derv_.attitude_dot = quat_rate(state.attitude, state.body_omega);
+        state_derv_.euler_dot = glm::vec3(0.0f);
+    }
+    else {
+        float phi   = state.phi;
+        float theta = state.theta;
+        float psi   = state.psi;
+
+        float cp, sp, ct, st;
+        math::sincos(phi, sp, cp);
+        math::sincos(theta, st, ct);
+        float tt = math::tan(theta);
+
+        // Position derivative (inertial frame)
+        float cy, sy;
+        math::sincos(psi, sy, cy);
+
+        // Transform NED to Body axes
+        // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
+        // Eq. (1.4-10) pag. 37 (pdf 59)
+
+        // Important! glm matrix are row mayor order as per opengl standard, but the
+        // ned to body transformation presented in the book is given in column mayor
+        // order so it has to be written as a transponse in glm:
+        // ie. glm::mat3 ned_to_body = glm::transpose(body_to_ned);
+        body_to_ned = glm::mat3(
+                    ct * cy,                    ct * sy,                   -st,
+                    sp * st * cy - cp * sy,     sp * st * sy + cp * cy,    sp * ct,
+                    cp * st * cy + sp * sy,     cp * st * sy - sp * cy,    cp * ct
+                    );
+
+        // Attitude rate (Euler angles)
+        // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
+        // Eq. 2.4-3 pag. 81 (pdf 103)
+        state_derv_.euler_dot.x = p + (q * sp + r * cp) * tt;
+        state_derv_.euler_dot.y = q * cp - r * sp;
+        state_derv_.euler_dot.z = (q * sp + r * cp) / ct;
+
+        state_derv_.attitude_dot = glm::quat(0.0f, 0.0f, 0.0f, 0.0f);
+    }
 
     // -------------------------------------------------------------------------
     // Flat earth aproximation
@@ -82,38 +107,34 @@ AircraftDynamics::StateDerivatives AircraftDynamics::compute_derivatives(const A
 
     // Add non aerodynamics forces and moments
     float throttle = clamp(controls.throttle, 0.0f, 1.0f);
-    float thrust_force = aircraft_data_.maxThrust * throttle;
+    // Thrust lapse with altitude proportional to the density ratio
+    float thrust_force = aircraft_data_.maxThrust * air.density_ratio * throttle;
 
     body_total_force_ = aero.body_forces + glm::vec3(thrust_force, 0.0f, 0.0f);
 
-    state_derv_.body_velocity_dot.x = (body_total_force_.x / aircraft_data_.mass - kGravityAcc * st) - q * w + r * v;
-    state_derv_.body_velocity_dot.y = (body_total_force_.y / aircraft_data_.mass + kGravityAcc * sp * ct) - r * u + p * w;
-    state_derv_.body_velocity_dot.z = (body_total_force_.z / aircraft_data_.mass + kGravityAcc * cp * ct) - p * v + q * u;
+    // Gravity direction in body axes, last row of body_to_ned:
+    // [-sin(theta), sin(phi) * cos(theta), cos(phi) * cos(theta)]
+    const glm::vec3 down(body_to_ned[0].z, body_to_ned[1].z, body_to_ned[2].z);
 
-    // Attitude rate (Euler angles)
-    // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
-    // Eq. 2.4-3 pag. 81 (pdf 103)
-    state_derv_.euler_dot.x = p + (q * sp + r * cp) * tt;
-    state_derv_.euler_dot.y = q * cp - r * sp;
-    state_derv_.euler_dot.z = (q * sp + r * cp) / ct;
+    const float inv_mass = constants_.inv_mass;
+
+    state_derv_.body_velocity_dot.x = (body_total_force_.x * inv_mass + kGravityAcc * down.x) - q * w + r * v;
+    state_derv_.body_velocity_dot.y = (body_total_force_.y * inv_mass + kGravityAcc * down.y) - r * u + p * w;
+    state_derv_.body_velocity_dot.z = (body_total_force_.z * inv_mass + kGravityAcc * down.z) - p * v + q * u;
 
     // Angular acceleration (body frame)
     // Aircraft simulation and control, 1st Ed. - Stevens & Lewis
     // Eq. 2.4-5 pag. 81 (pdf 103)
-    const float Ixx = aircraft_data_.Ixx;
-    const float Iyy = aircraft_data_.Iyy;
-    const float Izz = aircraft_data_.Izz;
-    const float Ixz = aircraft_data_.Ixz;
-
-    const float gamma = Ixx * Izz - Ixz * Ixz;
-    const float c1 = (Izz * (Iyy - Izz) - Ixz * Ixz) / gamma;
-    const float c2 = (Ixz * (Ixx - Iyy + Izz)) / gamma;
-    const float c3 = Izz / gamma;
-    const float c4 = Ixz / gamma;
-    const float c5 = (Izz - Ixx) / Iyy;
-    const float c6 = Ixz / Iyy;
-    const float c8 = (Ixx * (Ixx - Iyy) + Ixz * Ixz) / gamma;
-    const float c9 = Ixx / gamma;
+    // Inertia combinations precompiled in AircraftConstants
+    const float c1 = constants_.c1;
+    const float c2 = constants_.c2;
+    const float c3 = constants_.c3;
+    const float c4 = constants_.c4;
+    const float c5 = constants_.c5;
+    const float c6 = constants_.c6;
+    const float c7 = constants_.c7;
+    const float c8 = constants_.c8;
+    const float c9 = constants_.c9;
 
     // p dot
     state_derv_.body_omega_dot.x = (c1 * r + c2 * p) * q
@@ -123,7 +144,7 @@ AircraftDynamics::StateDerivatives AircraftDynamics::compute_derivatives(const A
     // q dot
     state_derv_.body_omega_dot.y = c5 * p * r
             - c6 * (p * p - r * r)
-            + aero.body_moments.y / Iyy;
+            + c7 * aero.body_moments.y;
 
     // r dot
     state_derv_.body_omega_dot.z = (c8 * p - c2 * r) * q
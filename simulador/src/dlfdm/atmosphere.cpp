@@ -0,0 +1,118 @@
+#include <dlfdm/atmosphere.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr double kGravityAcc = 9.80665;         // [m/s2]
+constexpr double kGasConstant = 287.05287;      // [J/(kg·K)] Dry air
+constexpr double kGamma = 1.4;                  // Heat capacity ratio
+
+constexpr double kSeaLevelTemperature = 288.15;     // [K]
+constexpr double kSeaLevelPressure = 101325.0;      // [Pa]
+
+constexpr double kTropopause = 11000.0;         // [m]
+constexpr double kStratosphere = 20000.0;       // [m]
+constexpr double kTroposphereLapse = -0.0065;   // [K/m]
+constexpr double kStratosphereLapse = 0.001;    // [K/m]
+
+constexpr float kInvTableStep = 1.0f / Atmosphere::kTableStep;
+
+// Temperature and pressure at h inside a layer with constant lapse rate
+void layer(double h, double h_base, double T_base, double P_base, double lapse,
+           double& T, double& P)
+{
+    const double dh = h - h_base;
+    if (lapse == 0.0) {
+        T = T_base;
+        P = P_base * std::exp(-kGravityAcc * dh / (kGasConstant * T_base));
+    }
+    else {
+        T = T_base + lapse * dh;
+        P = P_base * std::pow(T / T_base, -kGravityAcc / (kGasConstant * lapse));
+    }
+}
+
+} // namespace
+
+Atmosphere::Atmosphere()
+{
+    const int num_points = static_cast<int>(std::lround((kMaxAltitude - kMinAltitude) / kTableStep)) + 1;
+
+    table_.reserve(num_points);
+    for (int i = 0; i < num_points; ++i) {
+        table_.push_back(compute(kMinAltitude + kTableStep * static_cast<float>(i)));
+    }
+
+    last_ = num_points - 2;
+}
+
+const Atmosphere& Atmosphere::standard(void)
+{
+    static const Atmosphere atmosphere;
+    return atmosphere;
+}
+
+Atmosphere::Properties Atmosphere::get(float altitude) const
+{
+    const float x = (altitude - kMinAltitude) * kInvTableStep;
+    const int i = std::min(std::max(static_cast<int>(x), 0), last_);
+    const float t = std::min(std::max(x - static_cast<float>(i), 0.0f), 1.0f);
+
+    const Properties& a = table_[i];
+    const Properties& b = table_[i + 1];
+
+    Properties air;
+    air.density         = a.density + t * (b.density - a.density);
+    air.temperature     = a.temperature + t * (b.temperature - a.temperature);
+    air.pressure        = a.pressure + t * (b.pressure - a.pressure);
+    air.speed_of_sound  = a.speed_of_sound + t * (b.speed_of_sound - a.speed_of_sound);
+    air.density_ratio   = a.density_ratio + t * (b.density_ratio - a.density_ratio);
+    return air;
+}
+
+void Atmosphere::get(const float* altitudes, Properties* properties, std::size_t count) const
+{
+    for (std::size_t n = 0; n < count; ++n) {
+        properties[n] = get(altitudes[n]);
+    }
+}
+
+Atmosphere::Properties Atmosphere::compute(float altitude)
+{
+    const double h = std::min(std::max(static_cast<double>(altitude),
+                                       static_cast<double>(kMinAltitude)),
+                              static_cast<double>(kMaxAltitude));
+
+    // Layer base values
+    double T11, P11, T20, P20;
+    layer(kTropopause, 0.0, kSeaLevelTemperature, kSeaLevelPressure, kTroposphereLapse, T11, P11);
+    layer(kStratosphere, kTropopause, T11, P11, 0.0, T20, P20);
+
+    double T, P;
+    if (h < kTropopause) {
+        layer(h, 0.0, kSeaLevelTemperature, kSeaLevelPressure, kTroposphereLapse, T, P);
+    }
+    else if (h < kStratosphere) {
+        layer(h, kTropopause, T11, P11, 0.0, T, P);
+    }
+    else {
+        layer(h, kStratosphere, T20, P20, kStratosphereLapse, T, P);
+    }
+
+    const double rho = P / (kGasConstant * T);
+    const double rho0 = kSeaLevelPressure / (kGasConstant * kSeaLevelTemperature);
+
+    Properties air;
+    air.density         = static_cast<float>(rho);
+    air.temperature     = static_cast<float>(T);
+    air.pressure        = static_cast<float>(P);
+    air.speed_of_sound  = static_cast<float>(std::sqrt(kGamma * kGasConstant * T));
+    air.density_ratio   = static_cast<float>(rho / rho0);
+    return air;
+}
+
+} // namespace dlfdm
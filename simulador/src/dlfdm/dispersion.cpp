@@ -0,0 +1,507 @@
+#include <dlfdm/dispersion.h>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <iomanip>
+#include <mutex>
+#include <thread>
+
+#include <dlfdm/attitude.h>
+#include <dlfdm/fdmsolver.h>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr float kGravityAcc = 9.80665f;     // [m/s2]
+
+// Independent random streams of a sample
+enum Stream : std::uint64_t {
+    STREAM_PARAMETERS = 1,
+    STREAM_INITIAL_STATE = 2,
+    STREAM_CONTROLS = 3,
+    STREAM_AERO_TABLES = 4
+};
+
+///
+/// splitmix64 generator: fully specified (unlike std::*_distribution), so a
+/// seed gives the same samples with any compiler and standard library
+///
+class Random
+{
+public:
+    Random(std::uint64_t seed, std::uint64_t index, std::uint64_t stream)
+        : state_(seed)
+    {
+        state_ = next() ^ index;
+        state_ = next() ^ stream;
+    }
+
+    std::uint64_t next(void)
+    {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // [0, 1)
+    double uniform(void)
+    {
+        return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    // [-1, 1)
+    float symmetric(void)
+    {
+        return static_cast<float>(2.0 * uniform() - 1.0);
+    }
+
+    // Standard normal (Box-Muller, one value per call)
+    float gaussian(void)
+    {
+        const double u1 = 1.0 - uniform();      // (0, 1]
+        const double u2 = uniform();
+        return static_cast<float>(std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2));
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+///
+/// Per-worker block of sample indices. The owner takes from the front, thieves
+/// take from the back. Samples last milliseconds, a mutex per queue is cheap.
+///
+class WorkQueue
+{
+public:
+    void push(std::size_t index)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        items_.push_back(index);
+    }
+
+    bool pop(std::size_t& index)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        index = items_.front();
+        items_.pop_front();
+        return true;
+    }
+
+    bool steal(std::size_t& index)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (items_.empty()) {
+            return false;
+        }
+        index = items_.back();
+        items_.pop_back();
+        return true;
+    }
+
+private:
+    std::mutex mutex_;
+    std::deque<std::size_t> items_;
+};
+
+Dispersion::Distribution make_distribution(std::vector<double> values)
+{
+    Dispersion::Distribution d = {values.size(), 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+    if (values.empty()) {
+        return d;
+    }
+
+    std::sort(values.begin(), values.end());
+
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    d.mean = sum / static_cast<double>(values.size());
+
+    double sum2 = 0.0;
+    for (double v : values) {
+        sum2 += (v - d.mean) * (v - d.mean);
+    }
+    d.stddev = values.size() > 1 ? std::sqrt(sum2 / static_cast<double>(values.size() - 1)) : 0.0;
+
+    // Nearest rank percentiles
+    auto percentile = [&values](double p) {
+        const std::size_t rank = static_cast<std::size_t>(std::ceil(p * static_cast<double>(values.size())));
+        return values[std::min(values.size() - 1, rank > 0 ? rank - 1 : 0)];
+    };
+
+    d.min = values.front();
+    d.p05 = percentile(0.05);
+    d.p50 = percentile(0.50);
+    d.p95 = percentile(0.95);
+    d.max = values.back();
+    return d;
+}
+
+void write_distribution(std::ostream& os, const char* name, const Dispersion::Distribution& d, bool last = false)
+{
+    os << "    \"" << name << "\": {\"count\": " << d.count
+       << ", \"mean\": " << d.mean << ", \"stddev\": " << d.stddev
+       << ", \"min\": " << d.min << ", \"p05\": " << d.p05 << ", \"p50\": " << d.p50
+       << ", \"p95\": " << d.p95 << ", \"max\": " << d.max << "}"
+       << (last ? "" : ",") << "\n";
+}
+
+} // namespace
+
+Dispersion::Dispersion(unsigned int num_threads)
+    : num_threads_(num_threads)
+{
+    if (num_threads_ == 0) {
+        num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+AircraftParameters Dispersion::disperse_parameters(const AircraftParameters& p,
+                                                   const Uncertainty& uncertainty,
+                                                   std::uint64_t seed, std::uint64_t index)
+{
+    Random random(seed, index, STREAM_PARAMETERS);
+    AircraftParameters d = p;
+
+    // Mass properties
+    d.mass *= 1.0f + uncertainty.mass * random.symmetric();
+    d.Ixx *= 1.0f + uncertainty.inertia * random.symmetric();
+    d.Iyy *= 1.0f + uncertainty.inertia * random.symmetric();
+    d.Izz *= 1.0f + uncertainty.inertia * random.symmetric();
+    d.Ixz *= 1.0f + uncertainty.inertia * random.symmetric();
+
+    d.maxThrust *= 1.0f + uncertainty.thrust * random.symmetric();
+
+    // Every coefficient of the linear model scatters independently
+    float* coefficients[] = {
+        &d.CL0, &d.CLa, &d.CL_delta_e,
+        &d.CD0, &d.CDa,
+        &d.Cm0, &d.Cma, &d.Cm_q,
+        &d.CY_beta, &d.CY_r, &d.CY_delta_r,
+        &d.Cl_beta, &d.Cn_beta,
+        &d.Cl_p, &d.Cn_r, &d.Cl_r, &d.Cn_p,
+        &d.Cm_delta_e, &d.Cl_delta_a, &d.Cn_delta_r
+    };
+    for (float* c : coefficients) {
+        *c *= 1.0f + uncertainty.aero_coefficients * random.symmetric();
+    }
+
+    return d;
+}
+
+AeroDatabase Dispersion::disperse_database(const AeroDatabase& database,
+                                           const Uncertainty& uncertainty,
+                                           std::uint64_t seed, std::uint64_t index)
+{
+    // Own stream: a database does not change the draws of the parameters
+    Random random(seed, index, STREAM_AERO_TABLES);
+    AeroDatabase d = database;
+
+    for (int c = 0; c < AeroDatabase::NUM_COEFFICIENTS; ++c) {
+        d.scale(static_cast<AeroDatabase::Coefficient>(c), 1.0f + uncertainty.aero_coefficients * random.symmetric());
+    }
+
+    return d;
+}
+
+Dispersion::Sample Dispersion::run_sample(const Scenario& scenario, const Uncertainty& uncertainty,
+                                          const Envelope& envelope, std::uint64_t seed,
+                                          std::uint64_t index)
+{
+    const AircraftParameters params = disperse_parameters(scenario.params, uncertainty, seed, index);
+
+    // Initial state. One draw per statement: the evaluation order of function
+    // arguments is unspecified and would change the sequence between compilers.
+    Random random_state(seed, index, STREAM_INITIAL_STATE);
+    AircraftState initial = scenario.initial_state;
+
+    initial.intertial_position.x += uncertainty.position * random_state.gaussian();
+    initial.intertial_position.y += uncertainty.position * random_state.gaussian();
+    initial.intertial_position.z += uncertainty.position * random_state.gaussian();
+
+    const float V0 = glm::length(initial.boby_velocity);
+    if (V0 > 0.0f) {
+        initial.boby_velocity *= (V0 + uncertainty.airspeed * random_state.gaussian()) / V0;
+    }
+
+    initial.phi += uncertainty.attitude * random_state.gaussian();
+    initial.theta += uncertainty.attitude * random_state.gaussian();
+    initial.psi += uncertainty.attitude * random_state.gaussian();
+
+    initial.body_omega.x += uncertainty.body_rates * random_state.gaussian();
+    initial.body_omega.y += uncertainty.body_rates * random_state.gaussian();
+    initial.body_omega.z += uncertainty.body_rates * random_state.gaussian();
+
+    AeroDatabase database;
+    if (scenario.database) {
+        database = disperse_database(*scenario.database, uncertainty, seed, index);
+    }
+
+    FDMSolver solver(params, scenario.time_step);
+    solver.set_aero_database(scenario.database ? &database : nullptr);
+    solver.set_wind_field(scenario.wind);
+    solver.set_attitude_mode(scenario.attitude_mode);
+    solver.set_integration_method(scenario.integration_method);
+    solver.setState(initial);
+
+    Random random_controls(seed, index, STREAM_CONTROLS);
+    const float weight = params.mass * kGravityAcc;
+    const std::uint64_t num_steps = static_cast<std::uint64_t>(std::ceil(scenario.duration / scenario.time_step));
+
+    Sample sample;
+    sample.index = index;
+    sample.touchdown = false;
+    sample.max_load_factor = -1.0e9f;
+    sample.min_load_factor = 1.0e9f;
+    sample.min_airspeed = 1.0e9f;
+    sample.max_airspeed = 0.0f;
+    sample.max_alpha = 0.0f;
+    sample.max_bank = 0.0f;
+    sample.exceedances = 0u;
+
+    for (std::uint64_t step = 0; step < num_steps; ++step) {
+        const float t = static_cast<float>(step) * scenario.time_step;
+
+        ControlInputs controls = scenario.controls ? scenario.controls(t) : ControlInputs{0.0f, 0.0f, 0.0f, 0.0f};
+        controls.throttle += uncertainty.throttle_noise * random_controls.gaussian();
+        controls.elevator += uncertainty.control_noise * random_controls.gaussian();
+        controls.aileron += uncertainty.control_noise * random_controls.gaussian();
+        controls.rudder += uncertainty.control_noise * random_controls.gaussian();
+
+        solver.update(controls);
+
+        const AircraftState& s = solver.getState();
+        const glm::vec3 air_velocity = solver.get_air_velocity();
+        const float V = glm::length(air_velocity);
+        const float alpha = std::atan2(air_velocity.z, air_velocity.x);
+        const float n = -solver.get_aero_fm().body_forces.z / weight;   // Normal load factor
+
+        sample.max_load_factor = std::max(sample.max_load_factor, n);
+        sample.min_load_factor = std::min(sample.min_load_factor, n);
+        sample.min_airspeed = std::min(sample.min_airspeed, V);
+        sample.max_airspeed = std::max(sample.max_airspeed, V);
+        sample.max_alpha = std::max(sample.max_alpha, alpha);
+        sample.max_bank = std::max(sample.max_bank, std::fabs(s.phi));
+
+        if (scenario.stop_at_touchdown && s.intertial_position.z >= 0.0f) {
+            sample.touchdown = true;
+            break;
+        }
+    }
+
+    const AircraftState& final_state = solver.getState();
+    const glm::quat attitude = euler_to_quat(final_state.phi, final_state.theta, final_state.psi);
+    const glm::vec3 ned_velocity = quat_to_body_to_ned(attitude) * final_state.boby_velocity;
+
+    sample.time = solver.get_sim_time();
+    sample.final_state = final_state;
+    sample.sink_rate = ned_velocity.z;
+    sample.airspeed = glm::length(solver.get_air_velocity());
+
+    if (sample.max_load_factor > envelope.max_load_factor)  sample.exceedances |= LOAD_FACTOR_HIGH;
+    if (sample.min_load_factor < envelope.min_load_factor)  sample.exceedances |= LOAD_FACTOR_LOW;
+    if (sample.min_airspeed < envelope.min_airspeed)        sample.exceedances |= AIRSPEED_LOW;
+    if (sample.max_airspeed > envelope.max_airspeed)        sample.exceedances |= AIRSPEED_HIGH;
+    if (sample.max_alpha > envelope.max_alpha)              sample.exceedances |= ALPHA;
+    if (sample.max_bank > envelope.max_bank)                sample.exceedances |= BANK;
+
+    return sample;
+}
+
+std::vector<Dispersion::Sample> Dispersion::run(const Scenario& scenario, const Uncertainty& uncertainty,
+                                                const Envelope& envelope, std::size_t num_samples,
+                                                std::uint64_t seed) const
+{
+    std::vector<Sample> samples(num_samples);
+
+    const std::size_t num_workers = std::min<std::size_t>(num_threads_, num_samples);
+    if (num_workers <= 1) {
+        for (std::size_t i = 0; i < num_samples; ++i) {
+            samples[i] = run_sample(scenario, uncertainty, envelope, seed, i);
+        }
+        return samples;
+    }
+
+    // Contiguous blocks to start with, idle workers steal from the others
+    std::vector<WorkQueue> queues(num_workers);
+    const std::size_t chunk = (num_samples + num_workers - 1) / num_workers;
+    for (std::size_t i = 0; i < num_samples; ++i) {
+        queues[i / chunk].push(i);
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t w = 0; w < num_workers; ++w) {
+        workers.emplace_back([&, w]() {
+            std::size_t index;
+            for (;;) {
+                bool found = queues[w].pop(index);
+
+                // Nothing is ever pushed again: a full sweep of empty queues means done
+                for (std::size_t k = 1; !found && k < num_workers; ++k) {
+                    found = queues[(w + k) % num_workers].steal(index);
+                }
+                if (!found) {
+                    return;
+                }
+
+                // Each worker writes only the slots of the samples it runs
+                samples[index] = run_sample(scenario, uncertainty, envelope, seed, index);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return samples;
+}
+
+Dispersion::Summary Dispersion::summarize(const std::vector<Sample>& samples)
+{
+    Summary summary;
+    summary.num_samples = samples.size();
+    summary.num_touchdowns = 0;
+    summary.any_exceedance = 0;
+    std::fill(std::begin(summary.exceedances), std::end(summary.exceedances), 0u);
+
+    std::vector<double> time, north, east, altitude, airspeed, sink_rate;
+    std::vector<double> td_range, td_sink_rate, td_airspeed, td_pitch;
+    std::vector<double> max_load_factor, min_airspeed, max_alpha, max_bank;
+
+    for (const Sample& s : samples) {
+        const glm::vec3& position = s.final_state.intertial_position;
+
+        time.push_back(s.time);
+        north.push_back(position.x);
+        east.push_back(position.y);
+        altitude.push_back(-position.z);
+        airspeed.push_back(s.airspeed);
+        sink_rate.push_back(s.sink_rate);
+
+        if (s.touchdown) {
+            ++summary.num_touchdowns;
+            td_range.push_back(std::sqrt(position.x * position.x + position.y * position.y));
+            td_sink_rate.push_back(s.sink_rate);
+            td_airspeed.push_back(s.airspeed);
+            td_pitch.push_back(s.final_state.theta);
+        }
+
+        max_load_factor.push_back(s.max_load_factor);
+        min_airspeed.push_back(s.min_airspeed);
+        max_alpha.push_back(s.max_alpha);
+        max_bank.push_back(s.max_bank);
+
+        for (unsigned int b = 0; b < NUM_EXCEEDANCES; ++b) {
+            if (s.exceedances & (1u << b)) {
+                ++summary.exceedances[b];
+            }
+        }
+        if (s.exceedances) {
+            ++summary.any_exceedance;
+        }
+    }
+
+    summary.time = make_distribution(time);
+    summary.north = make_distribution(north);
+    summary.east = make_distribution(east);
+    summary.altitude = make_distribution(altitude);
+    summary.airspeed = make_distribution(airspeed);
+    summary.sink_rate = make_distribution(sink_rate);
+    summary.touchdown_range = make_distribution(td_range);
+    summary.touchdown_sink_rate = make_distribution(td_sink_rate);
+    summary.touchdown_airspeed = make_distribution(td_airspeed);
+    summary.touchdown_pitch = make_distribution(td_pitch);
+    summary.max_load_factor = make_distribution(max_load_factor);
+    summary.min_airspeed = make_distribution(min_airspeed);
+    summary.max_alpha = make_distribution(max_alpha);
+    summary.max_bank = make_distribution(max_bank);
+
+    return summary;
+}
+
+const char* Dispersion::exceedance_name(unsigned int bit)
+{
+    switch (bit) {
+    case LOAD_FACTOR_HIGH:  return "load_factor_high";
+    case LOAD_FACTOR_LOW:   return "load_factor_low";
+    case AIRSPEED_LOW:      return "airspeed_low";
+    case AIRSPEED_HIGH:     return "airspeed_high";
+    case ALPHA:             return "alpha";
+    case BANK:              return "bank";
+    default:                return "unknown";
+    }
+}
+
+void Dispersion::write_csv(std::ostream& os, const std::vector<Sample>& samples)
+{
+    os << "sample,time,x,y,z,phi,theta,psi,u,v,w,p,q,r,touchdown,sink_rate,airspeed,"
+          "max_load_factor,min_load_factor,min_airspeed,max_airspeed,max_alpha,max_bank,exceedances\n";
+
+    for (const Sample& s : samples) {
+        const AircraftState& st = s.final_state;
+        os << s.index << ',' << s.time << ','
+           << st.intertial_position.x << ',' << st.intertial_position.y << ',' << st.intertial_position.z << ','
+           << st.phi << ',' << st.theta << ',' << st.psi << ','
+           << st.boby_velocity.x << ',' << st.boby_velocity.y << ',' << st.boby_velocity.z << ','
+           << st.body_omega.x << ',' << st.body_omega.y << ',' << st.body_omega.z << ','
+           << (s.touchdown ? 1 : 0) << ',' << s.sink_rate << ',' << s.airspeed << ','
+           << s.max_load_factor << ',' << s.min_load_factor << ','
+           << s.min_airspeed << ',' << s.max_airspeed << ','
+           << s.max_alpha << ',' << s.max_bank << ',' << s.exceedances << '\n';
+    }
+}
+
+void Dispersion::write_json(std::ostream& os, const Summary& summary)
+{
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+
+    os << std::setprecision(6);
+    os << "{\n";
+    os << "  \"samples\": " << summary.num_samples << ",\n";
+    os << "  \"touchdowns\": " << summary.num_touchdowns << ",\n";
+    os << "  \"exceedances\": {";
+    for (unsigned int b = 0; b < NUM_EXCEEDANCES; ++b) {
+        os << "\"" << exceedance_name(1u << b) << "\": " << summary.exceedances[b] << ", ";
+    }
+    os << "\"any\": " << summary.any_exceedance << "},\n";
+
+    os << "  \"terminal\": {\n";
+    write_distribution(os, "time_s", summary.time);
+    write_distribution(os, "north_m", summary.north);
+    write_distribution(os, "east_m", summary.east);
+    write_distribution(os, "altitude_m", summary.altitude);
+    write_distribution(os, "airspeed_mps", summary.airspeed);
+    write_distribution(os, "sink_rate_mps", summary.sink_rate, true);
+    os << "  },\n";
+
+    os << "  \"touchdown\": {\n";
+    write_distribution(os, "range_m", summary.touchdown_range);
+    write_distribution(os, "sink_rate_mps", summary.touchdown_sink_rate);
+    write_distribution(os, "airspeed_mps", summary.touchdown_airspeed);
+    write_distribution(os, "pitch_rad", summary.touchdown_pitch, true);
+    os << "  },\n";
+
+    os << "  \"envelope\": {\n";
+    write_distribution(os, "max_load_factor_g", summary.max_load_factor);
+    write_distribution(os, "min_airspeed_mps", summary.min_airspeed);
+    write_distribution(os, "max_alpha_rad", summary.max_alpha);
+    write_distribution(os, "max_bank_rad", summary.max_bank, true);
+    os << "  }\n";
+    os << "}" << std::endl;
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace dlfdm
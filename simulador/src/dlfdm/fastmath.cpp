@@ -0,0 +1,85 @@
+#include <dlfdm/fastmath.h>
+
+#include <algorithm>
+
+namespace dlfdm {
+namespace fastmath {
+
+// The inputs of each block are copied to local arrays padded to kBlock
+// values: the loops over the inline kernels have a constant trip count and no
+// aliasing, so they vectorize even with the cheap cost model of -O2 (the
+// object is built without errno and floating point traps, see the Makefile)
+static constexpr std::size_t kBlock = 256;
+
+template <typename Kernel>
+static void unary(const float* x, float* out, std::size_t count, Kernel kernel)
+{
+    float in[kBlock], result[kBlock];
+
+    for (std::size_t start = 0; start < count; start += kBlock) {
+        const std::size_t n = std::min(kBlock, count - start);
+        std::copy(x + start, x + start + n, in);
+        std::fill(in + n, in + kBlock, 0.0f);
+
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            result[i] = kernel(in[i]);
+        }
+
+        std::copy(result, result + n, out + start);
+    }
+}
+
+void sin(const float* x, float* out, std::size_t count)
+{
+    unary(x, out, count, [](float v) { return sin(v); });
+}
+
+void cos(const float* x, float* out, std::size_t count)
+{
+    unary(x, out, count, [](float v) { return cos(v); });
+}
+
+void asin(const float* x, float* out, std::size_t count)
+{
+    unary(x, out, count, [](float v) { return asin(v); });
+}
+
+void sincos(const float* x, float* s, float* c, std::size_t count)
+{
+    float in[kBlock], sines[kBlock], cosines[kBlock];
+
+    for (std::size_t start = 0; start < count; start += kBlock) {
+        const std::size_t n = std::min(kBlock, count - start);
+        std::copy(x + start, x + start + n, in);
+        std::fill(in + n, in + kBlock, 0.0f);
+
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            sincos(in[i], sines[i], cosines[i]);
+        }
+
+        std::copy(sines, sines + n, s + start);
+        std::copy(cosines, cosines + n, c + start);
+    }
+}
+
+void atan2(const float* y, const float* x, float* out, std::size_t count)
+{
+    float in_y[kBlock], in_x[kBlock], result[kBlock];
+
+    for (std::size_t start = 0; start < count; start += kBlock) {
+        const std::size_t n = std::min(kBlock, count - start);
+        std::copy(y + start, y + start + n, in_y);
+        std::copy(x + start, x + start + n, in_x);
+        std::fill(in_y + n, in_y + kBlock, 0.0f);
+        std::fill(in_x + n, in_x + kBlock, 1.0f);
+
+        for (std::size_t i = 0; i < kBlock; ++i) {
+            result[i] = atan2(in_y[i], in_x[i]);
+        }
+
+        std::copy(result, result + n, out + start);
+    }
+}
+
+} // namespace fastmath
+} // namespace dlfdm
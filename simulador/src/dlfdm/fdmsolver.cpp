@@ -1,5 +1,9 @@
 #include <dlfdm/fdmsolver.h>
 
+#include <dlfdm/attitude.h>
+#include <dlfdm/flightrecorder.h>
+#include <dlfdm/windfield.h>
+
 namespace dlfdm {
 
 static std::ostream& operator<<(std::ostream& os, const glm::vec2 v){
@@ -13,7 +17,9 @@ static std::ostream& operator<<(std::ostream& os, const glm::vec3 v){
 }
 
 FDMSolver::FDMSolver(const AircraftParameters& p, float dt)
-    : aircraft_data_(p), aerodynamics(p), dynamics(p), time_step_(dt), time_(0.0f)
+    : euler_stale_(false), aircraft_data_(p), aerodynamics(aircraft_data_), dynamics(aircraft_data_),
+      time_step_(dt), time_(0.0f), integration_method_(IntegrationMethod::EULER),
+      recorder_(nullptr), wind_field_(nullptr), wind_(0.0f)
 {
     // Initialize state
     aircraft_state_.intertial_position = glm::vec3(0.0f);
@@ -22,63 +28,221 @@ FDMSolver::FDMSolver(const AircraftParameters& p, float dt)
     aircraft_state_.theta = 0.0f;
     aircraft_state_.psi = 0.0f;
     aircraft_state_.body_omega = glm::vec3(0.0f);
+    aircraft_state_.attitude = glm::quat(1.0f, 0.0f, 0.0f, 0.0f);
+
+    air_ = Atmosphere::sea_level();
+    aero_fm_ = {glm::vec3(0.0f), glm::vec3(0.0f), glm::vec3(0.0f), glm::vec2(0.0f)};
+    controls_ = {0.0f, 0.0f, 0.0f, 0.0f};
 }
 
 void FDMSolver::update(const ControlInputs &controls) {
+    update_atmosphere();
+    update_aerodynamics(controls);
+    integrate();
+}
+
+void FDMSolver::update_atmosphere(void) {
+    // Standard atmosphere at the current altitude (NED: down positive)
+    air_ = Atmosphere::standard().get(-aircraft_state_.intertial_position.z);
+}
+
+void FDMSolver::update_aerodynamics(const ControlInputs &controls) {
     // Clamp controls
-    ControlInputs clamped_controls = controls;
-
-    clamped_controls.throttle   = glm::clamp(clamped_controls.throttle,
-                                             0.0f,
-                                             1.0f);
-    clamped_controls.elevator   = glm::clamp(clamped_controls.elevator,
-                                             aircraft_data_.min_elevator,
-                                             aircraft_data_.max_elevator);
-    clamped_controls.aileron    = glm::clamp(clamped_controls.aileron,
-                                             aircraft_data_.min_aileron,
-                                             aircraft_data_.max_aileron);
-    clamped_controls.rudder     = glm::clamp(clamped_controls.rudder,
-                                             -aircraft_data_.max_rudder,
-                                             aircraft_data_.max_rudder);
+    controls_ = controls;
+
+    controls_.throttle  = glm::clamp(controls_.throttle,
+                                     0.0f,
+                                     1.0f);
+    controls_.elevator  = glm::clamp(controls_.elevator,
+                                     aircraft_data_.min_elevator,
+                                     aircraft_data_.max_elevator);
+    controls_.aileron   = glm::clamp(controls_.aileron,
+                                     aircraft_data_.min_aileron,
+                                     aircraft_data_.max_aileron);
+    controls_.rudder    = glm::clamp(controls_.rudder,
+                                     -aircraft_data_.max_rudder,
+                                     aircraft_data_.max_rudder);
+
+    // Wind at the aircraft, held for the stages of the step
+    wind_ = wind_field_ ? wind_field_->get(aircraft_state_.intertial_position, time_) : glm::vec3(0.0f);
 
     // Calculate aerodynamic forces and moments
-    aero_fm_ = aerodynamics.calculate(aircraft_state_.boby_velocity,
+    aero_fm_ = aerodynamics.calculate(air_velocity(aircraft_state_),
                                       aircraft_state_.body_omega,
-                                      clamped_controls);
+                                      controls_,
+                                      air_);
+}
 
+void FDMSolver::integrate(void) {
     // TODO: move thrust calculation here
 
-    // Compute state derivatives
-    state_deriv_ = dynamics.compute_derivatives(aircraft_state_, aero_fm_, clamped_controls);
+    // Compute state derivatives (first stage, with the held aerodynamic loads)
+    state_deriv_ = dynamics.compute_derivatives(aircraft_state_, aero_fm_, controls_, air_);
+
+    switch (integration_method_) {
+    case IntegrationMethod::EULER:
+        advance(aircraft_state_, state_deriv_, time_step_);
+        break;
+
+    case IntegrationMethod::RK2: {
+        // Midpoint: derivatives at half step
+        AircraftState mid = aircraft_state_;
+        advance(mid, state_deriv_, 0.5f * time_step_);
+
+        advance(aircraft_state_, evaluate(mid), time_step_);
+        break;
+    }
+
+    case IntegrationMethod::RK4: {
+        const AircraftDynamics::StateDerivatives& k1 = state_deriv_;
+
+        AircraftState stage = aircraft_state_;
+        advance(stage, k1, 0.5f * time_step_);
+        const AircraftDynamics::StateDerivatives k2 = evaluate(stage);
+
+        stage = aircraft_state_;
+        advance(stage, k2, 0.5f * time_step_);
+        const AircraftDynamics::StateDerivatives k3 = evaluate(stage);
+
+        stage = aircraft_state_;
+        advance(stage, k3, time_step_);
+        const AircraftDynamics::StateDerivatives k4 = evaluate(stage);
+
+        // k = (k1 + 2 k2 + 2 k3 + k4) / 6
+        const float sixth = 1.0f / 6.0f;
+        AircraftDynamics::StateDerivatives k;
+        k.ned_position_dot  = (k1.ned_position_dot + 2.0f * (k2.ned_position_dot + k3.ned_position_dot) + k4.ned_position_dot) * sixth;
+        k.body_velocity_dot = (k1.body_velocity_dot + 2.0f * (k2.body_velocity_dot + k3.body_velocity_dot) + k4.body_velocity_dot) * sixth;
+        k.euler_dot         = (k1.euler_dot + 2.0f * (k2.euler_dot + k3.euler_dot) + k4.euler_dot) * sixth;
+        k.body_omega_dot    = (k1.body_omega_dot + 2.0f * (k2.body_omega_dot + k3.body_omega_dot) + k4.body_omega_dot) * sixth;
+        k.attitude_dot      = (k1.attitude_dot + (k2.attitude_dot + k3.attitude_dot) * 2.0f + k4.attitude_dot) * sixth;
+
+        advance(aircraft_state_, k, time_step_);
+        break;
+    }
+    }
 
-    // Euler integration
     time_ += time_step_;
 
+    if (get_attitude_mode() == AttitudeMode::QUATERNION) {
+        euler_stale_ = true;
+    }
+
+    if (recorder_) {
+        // Raw state: the recorder keeps the quaternion, no Euler derivation per step
+        recorder_->record(time_, aircraft_state_, get_attitude_mode(), controls_, aero_fm_, state_deriv_);
+    }
+}
+
+AircraftDynamics::StateDerivatives FDMSolver::evaluate(const AircraftState& state)
+{
+    // Intermediate stage: loads at the stage state, air held for the step
+    const AerodynamicsModel::AeroDynamicForces aero =
+            aerodynamics.calculate(air_velocity(state), state.body_omega, controls_, air_);
+    return dynamics.compute_derivatives(state, aero, controls_, air_);
+}
+
+glm::vec3 FDMSolver::air_velocity(const AircraftState& state) const
+{
+    if (!wind_field_) {
+        return state.boby_velocity;
+    }
+
+    // Wind from NED to body axes (transpose of body to NED)
+    const glm::quat attitude = (get_attitude_mode() == AttitudeMode::QUATERNION)
+            ? state.attitude
+            : euler_to_quat(state.phi, state.theta, state.psi);
+    return state.boby_velocity - glm::transpose(quat_to_body_to_ned(attitude)) * wind_;
+}
+
+void FDMSolver::advance(AircraftState& state, const AircraftDynamics::StateDerivatives& derivatives, float dt) const
+{
     // Positions in inertial frame
-    aircraft_state_.intertial_position += state_deriv_.ned_position_dot * time_step_;
+    state.intertial_position += derivatives.ned_position_dot * dt;
 
     // Velocities in body frame
-    aircraft_state_.boby_velocity += state_deriv_.body_velocity_dot * time_step_;
-    aircraft_state_.body_omega    += state_deriv_.body_omega_dot * time_step_;
+    state.boby_velocity += derivatives.body_velocity_dot * dt;
+    state.body_omega    += derivatives.body_omega_dot * dt;
+
+    if (get_attitude_mode() == AttitudeMode::QUATERNION) {
+        // Integrate and renormalize to keep a pure rotation
+        glm::quat& q = state.attitude;
+        const glm::quat& q_dot = derivatives.attitude_dot;
+
+        q = glm::normalize(glm::quat(q.w + q_dot.w * dt,
+                                     q.x + q_dot.x * dt,
+                                     q.y + q_dot.y * dt,
+                                     q.z + q_dot.z * dt));
+    }
+    else {
+        // Attitude in body frame
+        state.phi   += derivatives.euler_dot.x * dt;
+        state.theta += derivatives.euler_dot.y * dt;
+        state.psi   += derivatives.euler_dot.z * dt;
+
+        // Clamp pitch to avoid singularities
+        state.theta = glm::clamp(state.theta, -1.5f, 1.5f);
+
+        // Normalize yaw to [-pi, pi]
+        while (state.psi > 3.14159f) state.psi -= 6.28318f;
+        while (state.psi < -3.14159f) state.psi += 6.28318f;
+    }
+}
+
+const AircraftState& FDMSolver::getState() const
+{
+    if (euler_stale_) {
+        quat_to_euler(aircraft_state_.attitude,
+                      aircraft_state_.phi, aircraft_state_.theta, aircraft_state_.psi);
+        euler_stale_ = false;
+    }
+    return aircraft_state_;
+}
 
-    // Attitude in body frame
-    aircraft_state_.phi   += state_deriv_.euler_dot.x * time_step_;
-    aircraft_state_.theta += state_deriv_.euler_dot.y * time_step_;
-    aircraft_state_.psi   += state_deriv_.euler_dot.z * time_step_;
+void FDMSolver::setState(const AircraftState& newState)
+{
+    aircraft_state_ = newState;
+    aircraft_state_.attitude = euler_to_quat(newState.phi, newState.theta, newState.psi);
+    euler_stale_ = false;
+}
+
+void FDMSolver::set_attitude_mode(AttitudeMode mode)
+{
+    if (mode == get_attitude_mode()) {
+        return;
+    }
+
+    // Carry the current attitude over to the other representation
+    const AircraftState& state = getState();
+    aircraft_state_.attitude = euler_to_quat(state.phi, state.theta, state.psi);
+
+    dynamics.set_attitude_mode(mode);
+}
 
-    // Clamp pitch to avoid singularities
-    aircraft_state_.theta = glm::clamp(aircraft_state_.theta, -1.5f, 1.5f);
+glm::vec3 FDMSolver::getEulerAngles() const
+{
+    const AircraftState& state = getState();
+    return glm::vec3(state.phi, state.theta, state.psi);
+}
 
-    // Normalize yaw to [-pi, pi]
-    while (aircraft_state_.psi > 3.14159f) aircraft_state_.psi -= 6.28318f;
-    while (aircraft_state_.psi < -3.14159f) aircraft_state_.psi += 6.28318f;
+void FDMSolver::restore(const Snapshot& snapshot)
+{
+    aircraft_state_ = snapshot.state;
+    time_ = snapshot.time;
+    air_ = snapshot.air;
+    aero_fm_ = snapshot.aero;
+    controls_ = snapshot.controls;
+    wind_ = snapshot.wind;
+    euler_stale_ = (get_attitude_mode() == AttitudeMode::QUATERNION);
 }
 
 glm::mat4 FDMSolver::getModelMatrix() const {
-    glm::mat4 model = glm::translate(glm::mat4(1.0f), aircraft_state_.intertial_position);
-    model = glm::rotate(model, aircraft_state_.psi, glm::vec3(0.0f, 1.0f, 0.0f));
-    model = glm::rotate(model, aircraft_state_.theta, glm::vec3(0.0f, 0.0f, 1.0f));
-    model = glm::rotate(model, aircraft_state_.phi, glm::vec3(1.0f, 0.0f, 0.0f));
+    const AircraftState& state = getState();
+
+    glm::mat4 model = glm::translate(glm::mat4(1.0f), state.intertial_position);
+    model = glm::rotate(model, state.psi, glm::vec3(0.0f, 1.0f, 0.0f));
+    model = glm::rotate(model, state.theta, glm::vec3(0.0f, 0.0f, 1.0f));
+    model = glm::rotate(model, state.phi, glm::vec3(1.0f, 0.0f, 0.0f));
     return model;
 }
 
@@ -113,10 +277,12 @@ void FDMSolver::log_state_titles(std::ostream &os, const char &sep) const
 
 void FDMSolver::log_aircraft_state(std::ostream &os, const char &sep) const
 {
-    os << aircraft_state_.intertial_position << sep;
-    os << aircraft_state_.phi << sep << aircraft_state_.theta << sep << aircraft_state_.psi << sep;
-    os << aircraft_state_.boby_velocity << sep;
-    os << aircraft_state_.body_omega;
+    const AircraftState& state = getState();
+
+    os << state.intertial_position << sep;
+    os << state.phi << sep << state.theta << sep << state.psi << sep;
+    os << state.boby_velocity << sep;
+    os << state.body_omega;
 }
 
 } // namespace dlfdm
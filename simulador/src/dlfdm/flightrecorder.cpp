@@ -0,0 +1,264 @@
+#include <dlfdm/flightrecorder.h>
+#include <dlfdm/attitude.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'F', 'D', 'R'};
+constexpr std::uint32_t kVersion = 3;
+
+// CSV columns: the FDMSolver::log_state() columns in its order, then the
+// controls and the Euler angle rates. Each column names the decoded channel
+// it comes from (37..39 hold the Euler rates once decoded).
+struct CsvColumn {
+    const char* title;
+    int channel;
+};
+
+const CsvColumn kCsvColumns[FlightRecorder::kNumCsvChannels] = {
+    {"t [seg]", 0},
+    {"x [m]", 1}, {"y [m]", 2}, {"z [m]", 3},
+    {"phi [rad]", 4}, {"theta [rad]", 5}, {"psi [rad]", 6},
+    {"u [m/s]", 7}, {"v [m/s]", 8}, {"w [m/s]", 9},
+    {"p [rad/s]", 10}, {"q [rad/s]", 11}, {"r [rad/s]", 12},
+    {"D [N]", 23}, {"Y [N]", 24}, {"L [N]", 25},
+    {"Xb [N]", 17}, {"Yb [N]", 18}, {"Zb [N]", 19},
+    {"L [N·m]", 20}, {"M [N·m]", 21}, {"N [N·m]", 22},
+    {"Alpha [rad]", 26}, {"Beta [rad]", 27},
+    {"p_dot2 [rad/s2]", 28}, {"q_dot2 [rad/s2]", 29}, {"r_dot2 [rad/s2]", 30},
+    {"u_dot [m/s2]", 31}, {"v_dot [m/s2]", 32}, {"w_dot [m/s2]", 33},
+    {"xdot_ned [m/s]", 34}, {"ydot_ned [m/s]", 35}, {"zdot_ned [m/s]", 36},
+    {"throttle [-]", 13}, {"elevator [rad]", 14}, {"aileron [rad]", 15}, {"rudder [rad]", 16},
+    {"phi_dot [rad/s]", 37}, {"theta_dot [rad/s]", 38}, {"psi_dot [rad/s]", 39}
+};
+
+// 2 bit code per channel -> number of low order bytes stored for the XOR delta
+constexpr int kCodeLength[4] = {0, 2, 3, 4};
+constexpr std::size_t kCodeBytes = (FlightRecorder::kNumChannels + 3) / 4;
+
+std::size_t next_power_of_two(std::size_t v)
+{
+    std::size_t p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+template <class T>
+void write_raw(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read_raw(std::istream& is, T& value)
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+FlightRecorder::FlightRecorder(std::size_t capacity, std::size_t block_records)
+    : ring_(next_power_of_two(std::max<std::size_t>(capacity, 2))),
+      block_records_(std::max<std::size_t>(block_records, 1)),
+      head_(0), tail_(0), dropped_(0), running_(false)
+{
+    mask_ = ring_.size() - 1;
+    block_records_ = std::min(block_records_, ring_.size());
+}
+
+FlightRecorder::~FlightRecorder()
+{
+    close();
+}
+
+bool FlightRecorder::open(const std::string& path)
+{
+    close();
+
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    if (!file_) {
+        std::cerr << "FlightRecorder: cannot open " << path << std::endl;
+        return false;
+    }
+
+    file_.write(kMagic, sizeof(kMagic));
+    write_raw(file_, kVersion);
+    write_raw(file_, static_cast<std::uint32_t>(kNumChannels));
+
+    running_.store(true, std::memory_order_release);
+    writer_ = std::thread(&FlightRecorder::writer_loop, this);
+    return true;
+}
+
+void FlightRecorder::close()
+{
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (writer_.joinable()) {
+        writer_.join();
+    }
+    file_.close();
+}
+
+void FlightRecorder::writer_loop()
+{
+    for (;;) {
+        const bool running = running_.load(std::memory_order_acquire);
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t available = head_.load(std::memory_order_acquire) - tail;
+
+        if (available >= block_records_) {
+            write_block(tail, block_records_);
+            tail_.store(tail + block_records_, std::memory_order_release);
+        }
+        else if (!running) {
+            // Flush the partial block on close
+            if (available > 0) {
+                write_block(tail, static_cast<std::size_t>(available));
+                tail_.store(tail + available, std::memory_order_release);
+            }
+            break;
+        }
+        else {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    }
+
+    file_.flush();
+}
+
+void FlightRecorder::write_block(std::uint64_t first, std::size_t count)
+{
+    // Each block is self-contained: the first record is XORed against zero.
+    // Per record: kCodeBytes of 2 bit codes (significant bytes of every XORed
+    // channel) followed by the low significant bytes of each channel.
+    std::vector<std::uint8_t> payload;
+    payload.reserve(count * (kCodeBytes + kNumChannels * sizeof(std::uint32_t)));
+
+    std::uint32_t previous[kNumChannels] = {};
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint32_t words[kNumChannels];
+        std::memcpy(words, ring_[(first + i) & mask_].channels, sizeof(words));
+
+        const std::size_t codes_pos = payload.size();
+        payload.resize(codes_pos + kCodeBytes, 0);
+
+        for (int c = 0; c < kNumChannels; ++c) {
+            const std::uint32_t delta = words[c] ^ previous[c];
+            previous[c] = words[c];
+
+            const std::uint32_t code = (delta == 0u)         ? 0u
+                                     : (delta <= 0xFFFFu)    ? 1u
+                                     : (delta <= 0xFFFFFFu)  ? 2u
+                                                             : 3u;
+            payload[codes_pos + c / 4] |= static_cast<std::uint8_t>(code << (2 * (c % 4)));
+
+            for (int b = 0; b < kCodeLength[code]; ++b) {
+                payload.push_back(static_cast<std::uint8_t>(delta >> (8 * b)));
+            }
+        }
+    }
+
+    write_raw(file_, static_cast<std::uint32_t>(count));
+    write_raw(file_, static_cast<std::uint32_t>(payload.size()));
+    file_.write(reinterpret_cast<const char*>(payload.data()),
+                static_cast<std::streamsize>(payload.size()));
+}
+
+void FlightRecorder::log_titles(std::ostream& os, const char& sep)
+{
+    for (int c = 0; c < kNumCsvChannels; ++c) {
+        os << kCsvColumns[c].title;
+        if (c != kNumCsvChannels - 1) {
+            os << sep;
+        }
+    }
+    os << std::endl;
+}
+
+bool FlightRecorder::convert_to_csv(std::istream& is, std::ostream& os, const char& sep)
+{
+    char magic[sizeof(kMagic)];
+    std::uint32_t version = 0;
+    std::uint32_t channels = 0;
+
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    if (!read_raw(is, version) || version != kVersion) {
+        return false;
+    }
+    if (!read_raw(is, channels) || channels != static_cast<std::uint32_t>(kNumChannels)) {
+        return false;
+    }
+
+    log_titles(os, sep);
+
+    std::vector<std::uint8_t> payload;
+    std::uint32_t count = 0;
+    std::uint32_t bytes = 0;
+    while (read_raw(is, count) && read_raw(is, bytes)) {
+        payload.resize(bytes);
+        if (!is.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(bytes))) {
+            break;  // Truncated block (e.g. recorder killed while writing)
+        }
+
+        std::uint32_t current[kNumChannels] = {};
+        std::size_t pos = 0;
+        for (std::uint32_t i = 0; i < count && pos + kCodeBytes <= payload.size(); ++i) {
+            const std::uint8_t* codes = &payload[pos];
+            pos += kCodeBytes;
+
+            for (int c = 0; c < kNumChannels; ++c) {
+                const int length = kCodeLength[(codes[c / 4] >> (2 * (c % 4))) & 3u];
+                if (pos + length > payload.size()) {
+                    return true;
+                }
+
+                std::uint32_t delta = 0;
+                for (int b = 0; b < length; ++b) {
+                    delta |= std::uint32_t(payload[pos++]) << (8 * b);
+                }
+                current[c] ^= delta;
+            }
+
+            float values[kNumChannels];
+            std::memcpy(values, current, sizeof(values));
+
+            // Quaternion integration: derive phi, theta, psi here instead of on every step
+            if (values[41] != 0.0f) {
+                const glm::quat attitude(values[37], values[38], values[39], values[40]);
+                quat_to_euler(attitude, values[4], values[5], values[6]);
+            }
+
+            // Euler angle rates of the recorded attitude, written over the
+            // quaternion channels (phi_dot, theta_dot, psi_dot columns)
+            const glm::vec3 rates = euler_rates(values[4], values[5],
+                                                glm::vec3(values[10], values[11], values[12]));
+            values[37] = rates.x;
+            values[38] = rates.y;
+            values[39] = rates.z;
+
+            for (int c = 0; c < kNumCsvChannels; ++c) {
+                os << values[kCsvColumns[c].channel];
+                if (c != kNumCsvChannels - 1) {
+                    os << sep;
+                }
+            }
+            os << '\n';
+        }
+    }
+
+    return true;
+}
+
+} // namespace dlfdm
@@ -0,0 +1,168 @@
+#include <dlfdm/flightreplay.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <type_traits>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'L', 'R', 'P'};
+constexpr std::uint32_t kVersion = 4;
+
+static_assert(std::is_trivially_copyable<ControlInputs>::value, "ControlInputs is stored raw");
+static_assert(std::is_trivially_copyable<FDMSolver::Snapshot>::value, "Snapshot is stored raw");
+
+template <class T>
+void write_raw(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <class T>
+bool read_raw(std::istream& is, T& value)
+{
+    return static_cast<bool>(is.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
+} // namespace
+
+FlightReplay::FlightReplay(std::uint32_t keyframe_interval)
+    : keyframe_interval_(std::max<std::uint32_t>(keyframe_interval, 1)), time_step_(0.0f)
+{
+}
+
+void FlightReplay::capture(const FDMSolver& solver, const ControlInputs& controls)
+{
+    if (controls_.empty()) {
+        time_step_ = solver.getTimeStep();
+    }
+
+    if (controls_.size() % keyframe_interval_ == 0) {
+        keyframes_.push_back(solver.snapshot());
+    }
+
+    controls_.push_back(controls);
+}
+
+void FlightReplay::clear()
+{
+    controls_.clear();
+    keyframes_.clear();
+}
+
+bool FlightReplay::seek(FDMSolver& solver, std::uint64_t step) const
+{
+    return seek(solver, step, [](FDMSolver& s, const ControlInputs& controls, std::uint64_t) {
+        s.update(controls);
+    });
+}
+
+bool FlightReplay::seek(FDMSolver& solver, std::uint64_t step, const StepFunction& step_function) const
+{
+    if (keyframes_.empty()) {
+        return false;
+    }
+
+    step = std::min<std::uint64_t>(step, controls_.size());
+
+    const std::size_t k = std::min<std::size_t>(step / keyframe_interval_, keyframes_.size() - 1);
+
+    solver.setTimeStep(time_step_);
+    solver.restore(keyframes_[k]);
+
+    for (std::uint64_t s = std::uint64_t(k) * keyframe_interval_; s < step; ++s) {
+        step_function(solver, controls_[s], s);
+    }
+
+    return true;
+}
+
+bool FlightReplay::seek_time(FDMSolver& solver, float t) const
+{
+    return seek_time(solver, t, [](FDMSolver& s, const ControlInputs& controls, std::uint64_t) {
+        s.update(controls);
+    });
+}
+
+bool FlightReplay::seek_time(FDMSolver& solver, float t, const StepFunction& step_function) const
+{
+    if (keyframes_.empty() || time_step_ <= 0.0f) {
+        return false;
+    }
+
+    const float steps = std::round((t - get_start_time()) / time_step_);
+    const std::uint64_t step = (steps <= 0.0f) ? 0u : static_cast<std::uint64_t>(steps);
+    return seek(solver, step, step_function);
+}
+
+float FlightReplay::get_start_time(void) const
+{
+    return keyframes_.empty() ? 0.0f : keyframes_.front().time;
+}
+
+float FlightReplay::get_end_time(void) const
+{
+    return get_start_time() + time_step_ * static_cast<float>(controls_.size());
+}
+
+bool FlightReplay::save(std::ostream& os) const
+{
+    os.write(kMagic, sizeof(kMagic));
+    write_raw(os, kVersion);
+    write_raw(os, keyframe_interval_);
+    write_raw(os, time_step_);
+    write_raw(os, static_cast<std::uint64_t>(controls_.size()));
+    write_raw(os, static_cast<std::uint64_t>(keyframes_.size()));
+
+    os.write(reinterpret_cast<const char*>(controls_.data()),
+             static_cast<std::streamsize>(controls_.size() * sizeof(ControlInputs)));
+    os.write(reinterpret_cast<const char*>(keyframes_.data()),
+             static_cast<std::streamsize>(keyframes_.size() * sizeof(FDMSolver::Snapshot)));
+
+    return static_cast<bool>(os);
+}
+
+bool FlightReplay::load(std::istream& is)
+{
+    char magic[sizeof(kMagic)];
+    std::uint32_t version = 0;
+    std::uint32_t interval = 0;
+    float dt = 0.0f;
+    std::uint64_t num_controls = 0;
+    std::uint64_t num_keyframes = 0;
+
+    if (!is.read(magic, sizeof(magic)) || std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+    if (!read_raw(is, version) || version != kVersion) {
+        return false;
+    }
+    if (!read_raw(is, interval) || !read_raw(is, dt) ||
+        !read_raw(is, num_controls) || !read_raw(is, num_keyframes)) {
+        return false;
+    }
+    if (interval == 0 || num_keyframes != (num_controls + interval - 1) / interval) {
+        return false;
+    }
+
+    std::vector<ControlInputs> controls(num_controls);
+    std::vector<FDMSolver::Snapshot> keyframes(num_keyframes);
+
+    if (!is.read(reinterpret_cast<char*>(controls.data()),
+                 static_cast<std::streamsize>(num_controls * sizeof(ControlInputs))) ||
+        !is.read(reinterpret_cast<char*>(keyframes.data()),
+                 static_cast<std::streamsize>(num_keyframes * sizeof(FDMSolver::Snapshot)))) {
+        return false;
+    }
+
+    keyframe_interval_ = interval;
+    time_step_ = dt;
+    controls_.swap(controls);
+    keyframes_.swap(keyframes);
+    return true;
+}
+
+} // namespace dlfdm
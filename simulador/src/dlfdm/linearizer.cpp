@@ -0,0 +1,336 @@
+#include <dlfdm/linearizer.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+
+#include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/aircraftdynamics.h>
+#include <dlfdm/atmosphere.h>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr int kNumStates = Linearizer::kNumStates;
+constexpr int kNumInputs = Linearizer::kNumInputs;
+
+// Binary file header
+constexpr char kMagic[4] = {'D', 'L', 'L', 'N'};
+constexpr std::uint32_t kVersion = 1;
+
+const char* const kStateNames[kNumStates] = {
+    "x", "y", "z", "phi", "theta", "psi", "u", "v", "w", "p", "q", "r"
+};
+
+const char* const kInputNames[kNumInputs] = {
+    "throttle", "elevator", "aileron", "rudder"
+};
+
+// Non linear model x_dot = f(x, u) for a given pair of model instances
+void evaluate_model(AerodynamicsModel& aerodynamics,
+                    AircraftDynamics& dynamics,
+                    const float x[kNumStates],
+                    const float u[kNumInputs],
+                    float x_dot[kNumStates])
+{
+    const AircraftState state = Linearizer::unpack_state(x);
+    const ControlInputs controls = Linearizer::unpack_controls(u);
+
+    // Altitude enters through the atmosphere (density, Mach, thrust lapse)
+    const Atmosphere::Properties air = Atmosphere::standard().get(-state.intertial_position.z);
+
+    AerodynamicsModel::AeroDynamicForces aero = aerodynamics.calculate(state.boby_velocity,
+                                                                       state.body_omega,
+                                                                       controls,
+                                                                       air);
+
+    AircraftDynamics::StateDerivatives deriv = dynamics.compute_derivatives(state, aero, controls, air);
+
+    x_dot[0]  = deriv.ned_position_dot.x;
+    x_dot[1]  = deriv.ned_position_dot.y;
+    x_dot[2]  = deriv.ned_position_dot.z;
+    x_dot[3]  = deriv.euler_dot.x;
+    x_dot[4]  = deriv.euler_dot.y;
+    x_dot[5]  = deriv.euler_dot.z;
+    x_dot[6]  = deriv.body_velocity_dot.x;
+    x_dot[7]  = deriv.body_velocity_dot.y;
+    x_dot[8]  = deriv.body_velocity_dot.z;
+    x_dot[9]  = deriv.body_omega_dot.x;
+    x_dot[10] = deriv.body_omega_dot.y;
+    x_dot[11] = deriv.body_omega_dot.z;
+}
+
+template <class T>
+void write_raw(std::ostream& os, const T& value)
+{
+    os.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+} // namespace
+
+Linearizer::Linearizer(const AircraftParameters& p, unsigned int num_threads)
+    : aircraft_data_(p), database_(nullptr), num_threads_(num_threads), relative_step_(1.0e-3f)
+{
+    if (num_threads_ == 0) {
+        num_threads_ = std::max(1u, std::thread::hardware_concurrency());
+    }
+}
+
+Linearizer::StateSpace Linearizer::linearize(const OperatingPoint& op) const
+{
+    constexpr int kNumColumns = kNumStates + kNumInputs;
+
+    // Model instances are local so concurrent calls never share member state
+    // (the database lookup caches its bracket indices)
+    AerodynamicsModel aerodynamics(aircraft_data_);
+    aerodynamics.set_database(database_);
+    AircraftDynamics dynamics(aircraft_data_);
+
+    float x0[kNumStates];
+    float u0[kNumInputs];
+    pack_state(op.state, x0);
+    pack_controls(op.controls, u0);
+
+    // Build every perturbed point first (+h and -h for each column), then
+    // evaluate them in a single serial sweep
+    float xs[2 * kNumColumns][kNumStates];
+    float us[2 * kNumColumns][kNumInputs];
+
+    for (int c = 0; c < kNumColumns; ++c) {
+        const float nominal = (c < kNumStates) ? x0[c] : u0[c - kNumStates];
+        const float h = relative_step_ * std::max(1.0f, std::fabs(nominal));
+
+        for (int s = 0; s < 2; ++s) {
+            float* x = xs[2 * c + s];
+            float* u = us[2 * c + s];
+            std::copy(x0, x0 + kNumStates, x);
+            std::copy(u0, u0 + kNumInputs, u);
+
+            const float delta = (s == 0) ? h : -h;
+            if (c < kNumStates) {
+                x[c] += delta;
+            }
+            else {
+                u[c - kNumStates] += delta;
+            }
+        }
+    }
+
+    float x_dots[2 * kNumColumns][kNumStates];
+    for (int i = 0; i < 2 * kNumColumns; ++i) {
+        evaluate_model(aerodynamics, dynamics, xs[i], us[i], x_dots[i]);
+    }
+
+    // Central differences
+    StateSpace ss;
+    for (int c = 0; c < kNumColumns; ++c) {
+        // Use the step actually applied after float rounding
+        const float applied = (c < kNumStates)
+                ? xs[2 * c][c] - xs[2 * c + 1][c]
+                : us[2 * c][c - kNumStates] - us[2 * c + 1][c - kNumStates];
+        const float inv_step = (applied != 0.0f) ? 1.0f / applied : 0.0f;
+
+        for (int r = 0; r < kNumStates; ++r) {
+            const float d = (x_dots[2 * c][r] - x_dots[2 * c + 1][r]) * inv_step;
+            if (c < kNumStates) {
+                ss.A[r][c] = d;
+            }
+            else {
+                ss.B[r][c - kNumStates] = d;
+            }
+        }
+    }
+
+    return ss;
+}
+
+std::vector<Linearizer::StateSpace> Linearizer::linearize_batch(const std::vector<OperatingPoint>& points) const
+{
+    std::vector<StateSpace> results(points.size());
+
+    const std::size_t num_workers = std::min<std::size_t>(num_threads_, points.size());
+    if (num_workers <= 1) {
+        for (std::size_t i = 0; i < points.size(); ++i) {
+            results[i] = linearize(points[i]);
+        }
+        return results;
+    }
+
+    // Contiguous chunks, each worker writes only its own slots of results
+    const std::size_t chunk = (points.size() + num_workers - 1) / num_workers;
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_workers);
+    for (std::size_t w = 0; w < num_workers; ++w) {
+        const std::size_t begin = w * chunk;
+        const std::size_t end = std::min(points.size(), begin + chunk);
+        workers.emplace_back([this, &points, &results, begin, end]() {
+            for (std::size_t i = begin; i < end; ++i) {
+                results[i] = linearize(points[i]);
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    return results;
+}
+
+std::vector<Linearizer::OperatingPoint> Linearizer::envelope_grid(const OperatingPoint& base,
+                                                                  const std::vector<float>& airspeeds,
+                                                                  const std::vector<float>& altitudes)
+{
+    std::vector<OperatingPoint> grid;
+    grid.reserve(airspeeds.size() * altitudes.size());
+
+    // Keep the aerodynamic angles of the base point, scale airspeed only
+    const float V0 = glm::length(base.state.boby_velocity);
+    const glm::vec3 direction = (V0 > 0.0f) ? base.state.boby_velocity / V0
+                                            : glm::vec3(1.0f, 0.0f, 0.0f);
+
+    for (float h : altitudes) {
+        for (float V : airspeeds) {
+            OperatingPoint op = base;
+            op.state.boby_velocity = direction * V;
+            op.state.intertial_position.z = -h;     // NED: down positive
+            grid.push_back(op);
+        }
+    }
+
+    return grid;
+}
+
+void Linearizer::pack_state(const AircraftState& state, float x[kNumStates])
+{
+    x[0]  = state.intertial_position.x;
+    x[1]  = state.intertial_position.y;
+    x[2]  = state.intertial_position.z;
+    x[3]  = state.phi;
+    x[4]  = state.theta;
+    x[5]  = state.psi;
+    x[6]  = state.boby_velocity.x;
+    x[7]  = state.boby_velocity.y;
+    x[8]  = state.boby_velocity.z;
+    x[9]  = state.body_omega.x;
+    x[10] = state.body_omega.y;
+    x[11] = state.body_omega.z;
+}
+
+AircraftState Linearizer::unpack_state(const float x[kNumStates])
+{
+    AircraftState state;
+    state.intertial_position = glm::vec3(x[0], x[1], x[2]);
+    state.phi   = x[3];
+    state.theta = x[4];
+    state.psi   = x[5];
+    state.boby_velocity = glm::vec3(x[6], x[7], x[8]);
+    state.body_omega = glm::vec3(x[9], x[10], x[11]);
+    return state;
+}
+
+void Linearizer::pack_controls(const ControlInputs& controls, float u[kNumInputs])
+{
+    u[0] = controls.throttle;
+    u[1] = controls.elevator;
+    u[2] = controls.aileron;
+    u[3] = controls.rudder;
+}
+
+ControlInputs Linearizer::unpack_controls(const float u[kNumInputs])
+{
+    ControlInputs controls;
+    controls.throttle = u[0];
+    controls.elevator = u[1];
+    controls.aileron  = u[2];
+    controls.rudder   = u[3];
+    return controls;
+}
+
+void Linearizer::write_binary(std::ostream& os,
+                              const std::vector<OperatingPoint>& points,
+                              const std::vector<StateSpace>& results)
+{
+    const std::uint32_t count = static_cast<std::uint32_t>(std::min(points.size(), results.size()));
+
+    os.write(kMagic, sizeof(kMagic));
+    write_raw(os, kVersion);
+    write_raw(os, static_cast<std::uint32_t>(kNumStates));
+    write_raw(os, static_cast<std::uint32_t>(kNumInputs));
+    write_raw(os, count);
+
+    float x0[kNumStates];
+    float u0[kNumInputs];
+    for (std::uint32_t i = 0; i < count; ++i) {
+        pack_state(points[i].state, x0);
+        pack_controls(points[i].controls, u0);
+        os.write(reinterpret_cast<const char*>(x0), sizeof(x0));
+        os.write(reinterpret_cast<const char*>(u0), sizeof(u0));
+        os.write(reinterpret_cast<const char*>(results[i].A), sizeof(results[i].A));
+        os.write(reinterpret_cast<const char*>(results[i].B), sizeof(results[i].B));
+    }
+}
+
+void Linearizer::write_csv(std::ostream& os,
+                           const std::vector<OperatingPoint>& points,
+                           const std::vector<StateSpace>& results,
+                           const char& sep)
+{
+    const std::size_t count = std::min(points.size(), results.size());
+
+    // Titles
+    for (int i = 0; i < kNumStates; ++i) {
+        os << kStateNames[i] << "_0" << sep;
+    }
+    for (int i = 0; i < kNumInputs; ++i) {
+        os << kInputNames[i] << "_0" << sep;
+    }
+    for (int r = 0; r < kNumStates; ++r) {
+        for (int c = 0; c < kNumStates; ++c) {
+            os << "A_" << kStateNames[r] << "_" << kStateNames[c] << sep;
+        }
+    }
+    for (int r = 0; r < kNumStates; ++r) {
+        for (int c = 0; c < kNumInputs; ++c) {
+            os << "B_" << kStateNames[r] << "_" << kInputNames[c];
+            if (r != kNumStates - 1 || c != kNumInputs - 1) {
+                os << sep;
+            }
+        }
+    }
+    os << std::endl;
+
+    // Values
+    float x0[kNumStates];
+    float u0[kNumInputs];
+    for (std::size_t i = 0; i < count; ++i) {
+        pack_state(points[i].state, x0);
+        pack_controls(points[i].controls, u0);
+
+        for (int k = 0; k < kNumStates; ++k) {
+            os << x0[k] << sep;
+        }
+        for (int k = 0; k < kNumInputs; ++k) {
+            os << u0[k] << sep;
+        }
+        for (int r = 0; r < kNumStates; ++r) {
+            for (int c = 0; c < kNumStates; ++c) {
+                os << results[i].A[r][c] << sep;
+            }
+        }
+        for (int r = 0; r < kNumStates; ++r) {
+            for (int c = 0; c < kNumInputs; ++c) {
+                os << results[i].B[r][c];
+                if (r != kNumStates - 1 || c != kNumInputs - 1) {
+                    os << sep;
+                }
+            }
+        }
+        os << '\n';
+    }
+}
+
+} // namespace dlfdm
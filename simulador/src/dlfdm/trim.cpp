@@ -0,0 +1,144 @@
+#include <dlfdm/trim.h>
+
+#include <cmath>
+#include <utility>
+
+#include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/aircraftdynamics.h>
+#include <dlfdm/atmosphere.h>
+#include <dlfdm/attitude.h>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr int kMaxIterations = 30;
+constexpr double kStep = 1.0e-4;           // Finite difference step
+constexpr double kTolerance = 1.0e-5;      // Sum of |residuals| to stop
+constexpr double kAcceptance = 1.0e-3;     // Sum of |residuals| to accept
+
+AircraftState steady_state(float speed, float altitude, float alpha, float gamma)
+{
+    AircraftState s;
+    s.intertial_position = glm::vec3(0.0f, 0.0f, -altitude);   // NED: down positive
+    s.boby_velocity = glm::vec3(speed * std::cos(alpha), 0.0f, speed * std::sin(alpha));
+    s.body_omega = glm::vec3(0.0f);
+    s.phi = 0.0f;
+    s.theta = alpha + gamma;
+    s.psi = 0.0f;
+    s.attitude = euler_to_quat(s.phi, s.theta, s.psi);
+    return s;
+}
+
+// Solve J dx = b in place (Gaussian elimination with partial pivoting)
+bool solve3(double J[3][4], double dx[3])
+{
+    for (int k = 0; k < 3; ++k) {
+        int pivot = k;
+        for (int i = k + 1; i < 3; ++i) {
+            if (std::fabs(J[i][k]) > std::fabs(J[pivot][k])) {
+                pivot = i;
+            }
+        }
+        std::swap(J[k], J[pivot]);
+
+        if (std::fabs(J[k][k]) < 1.0e-12) {
+            return false;
+        }
+
+        for (int i = k + 1; i < 3; ++i) {
+            const double f = J[i][k] / J[k][k];
+            for (int j = k; j < 4; ++j) {
+                J[i][j] -= f * J[k][j];
+            }
+        }
+    }
+
+    for (int k = 2; k >= 0; --k) {
+        dx[k] = J[k][3];
+        for (int j = k + 1; j < 3; ++j) {
+            dx[k] -= J[k][j] * dx[j];
+        }
+        dx[k] /= J[k][k];
+    }
+    return true;
+}
+
+} // namespace
+
+bool trim_level_flight(const AircraftParameters& p, const AeroDatabase* database,
+                       float speed, float altitude,
+                       AircraftState& state, ControlInputs& controls)
+{
+    return trim_steady_flight(p, database, speed, altitude, 0.0f, state, controls);
+}
+
+bool trim_steady_flight(const AircraftParameters& p, const AeroDatabase* database,
+                        float speed, float altitude, float flight_path_angle,
+                        AircraftState& state, ControlInputs& controls)
+{
+    AerodynamicsModel aerodynamics(p);
+    aerodynamics.set_database(database);
+    AircraftDynamics dynamics(p);
+    const Atmosphere::Properties air = Atmosphere::standard().get(altitude);
+
+    // x = [alpha, elevator, throttle], r = [u_dot, w_dot, q_dot]
+    auto residual = [&](const double x[3], double r[3]) {
+        const AircraftState s = steady_state(speed, altitude, static_cast<float>(x[0]), flight_path_angle);
+        const ControlInputs c = {static_cast<float>(x[2]), static_cast<float>(x[1]), 0.0f, 0.0f};
+        const AerodynamicsModel::AeroDynamicForces fm = aerodynamics.calculate(s.boby_velocity, s.body_omega, c, air);
+        const AircraftDynamics::StateDerivatives d = dynamics.compute_derivatives(s, fm, c, air);
+        r[0] = d.body_velocity_dot.x;
+        r[1] = d.body_velocity_dot.z;
+        r[2] = d.body_omega_dot.y;
+    };
+
+    double x[3] = {0.0, 0.5 * (p.min_elevator + p.max_elevator), 0.5};
+    double r[3];
+
+    for (int iteration = 0; iteration < kMaxIterations; ++iteration) {
+        residual(x, r);
+        if (std::fabs(r[0]) + std::fabs(r[1]) + std::fabs(r[2]) < kTolerance) {
+            break;
+        }
+
+        double J[3][4];
+        for (int j = 0; j < 3; ++j) {
+            double xp[3] = {x[0], x[1], x[2]};
+            xp[j] += kStep;
+            double rp[3];
+            residual(xp, rp);
+            for (int i = 0; i < 3; ++i) {
+                J[i][j] = (rp[i] - r[i]) / kStep;
+            }
+        }
+        for (int i = 0; i < 3; ++i) {
+            J[i][3] = -r[i];
+        }
+
+        double dx[3];
+        if (!solve3(J, dx)) {
+            return false;
+        }
+        for (int k = 0; k < 3; ++k) {
+            x[k] += dx[k];
+        }
+    }
+
+    residual(x, r);
+    if (std::fabs(r[0]) + std::fabs(r[1]) + std::fabs(r[2]) > kAcceptance) {
+        return false;
+    }
+
+    // The iteration does not know the control limits: a solution beyond them
+    // cannot be flown (FDMSolver would clamp it)
+    if (x[2] < 0.0 || x[2] > 1.0 || x[1] < p.min_elevator || x[1] > p.max_elevator) {
+        return false;
+    }
+
+    state = steady_state(speed, altitude, static_cast<float>(x[0]), flight_path_angle);
+    controls = {static_cast<float>(x[2]), static_cast<float>(x[1]), 0.0f, 0.0f};
+    return true;
+}
+
+} // namespace dlfdm
@@ -0,0 +1,306 @@
+#include <dlfdm/windfield.h>
+
+#include <dlfdm/atmosphere.h>
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <utility>
+
+namespace dlfdm {
+
+namespace {
+
+constexpr float kInvAltitudeStep = 1.0f / Atmosphere::kTableStep;
+constexpr float kInvGustSpacing = 1.0f / WindField::kGustSpacing;
+constexpr std::size_t kGustMask = WindField::kGustSamples - 1;
+
+static_assert((WindField::kGustSamples & kGustMask) == 0, "kGustSamples must be a power of 2");
+
+// Horizontal axes of the three turbulence patterns (0, 60 and 120 deg from north)
+constexpr int kNumAxes = 3;
+constexpr float kAxisCos[kNumAxes] = {1.0f, 0.5f, -0.5f};
+constexpr float kAxisSin[kNumAxes] = {0.0f, 0.866025403784439f, 0.866025403784439f};
+constexpr float kInvSqrtAxes = 0.577350269189626f;
+
+///
+/// splitmix64 generator: fully specified (unlike std::*_distribution), so a
+/// seed gives the same turbulence with any compiler and standard library
+///
+class Random
+{
+public:
+    Random(std::uint64_t seed, std::uint64_t stream)
+        : state_(seed)
+    {
+        state_ = next() ^ stream;
+    }
+
+    std::uint64_t next(void)
+    {
+        std::uint64_t z = (state_ += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Standard normal (Box-Muller, one value per call)
+    double gaussian(void)
+    {
+        const double u1 = 1.0 - static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        const double u2 = static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0);
+        return std::sqrt(-2.0 * std::log(u1)) * std::cos(6.283185307179586 * u2);
+    }
+
+private:
+    std::uint64_t state_;
+};
+
+///
+/// Dryden gust series of kGustSamples points kGustSpacing apart, periodic and
+/// scaled to standard deviation sigma. Spatial filters, s in 1/m:
+///
+///     longitudinal        1 / (1 + L s)
+///     lateral, vertical   (1 + sqrt(3) L s) / (1 + L s)^2
+///                         = sqrt(3) / (1 + L s) + (1 - sqrt(3)) / (1 + L s)^2
+///
+std::vector<float> dryden_series(Random& random, bool longitudinal, float sigma)
+{
+    const double a = std::exp(-static_cast<double>(WindField::kGustSpacing / WindField::kScaleLength));
+    const double sqrt3 = 1.7320508075688772;
+
+    // Start-up transient of the filters, and overlap to close the period
+    const std::size_t warmup = static_cast<std::size_t>(5.0f * WindField::kScaleLength * kInvGustSpacing);
+    const std::size_t blend = static_cast<std::size_t>(2.0f * WindField::kScaleLength * kInvGustSpacing);
+    const std::size_t count = WindField::kGustSamples;
+
+    std::vector<double> raw(count + blend);
+    double lag1 = 0.0;
+    double lag2 = 0.0;
+
+    for (std::size_t i = 0; i < warmup + count + blend; ++i) {
+        lag1 = a * lag1 + (1.0 - a) * random.gaussian();
+        lag2 = a * lag2 + (1.0 - a) * lag1;
+
+        if (i >= warmup) {
+            raw[i - warmup] = longitudinal ? lag1 : sqrt3 * lag1 + (1.0 - sqrt3) * lag2;
+        }
+    }
+
+    // Equal power crossfade of the start with the samples past the end: the
+    // last point runs into the first one without a step
+    for (std::size_t i = 0; i < blend; ++i) {
+        const double w = (static_cast<double>(i) + 0.5) / static_cast<double>(blend);
+        raw[i] = std::sqrt(w) * raw[i] + std::sqrt(1.0 - w) * raw[count + i];
+    }
+    raw.resize(count);
+
+    // Exact intensity over the period
+    double mean = 0.0;
+    for (double x : raw) {
+        mean += x;
+    }
+    mean /= static_cast<double>(count);
+
+    double variance = 0.0;
+    for (double x : raw) {
+        variance += (x - mean) * (x - mean);
+    }
+    variance /= static_cast<double>(count);
+
+    const double scale = (variance > 0.0) ? sigma / std::sqrt(variance) : 0.0;
+
+    std::vector<float> series(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        series[i] = static_cast<float>((raw[i] - mean) * scale);
+    }
+    return series;
+}
+
+} // namespace
+
+///
+/// Pre-filtered gusts of one seed and intensity: for each axis the gust along
+/// the axis, across it (to the right) and vertical, as a function of the
+/// distance along the axis
+///
+class WindField::GustTable
+{
+public:
+    struct Sample {
+        float along;
+        float across;
+        float vertical;
+    };
+
+    GustTable(std::uint64_t seed, float intensity)
+    {
+        for (int k = 0; k < kNumAxes; ++k) {
+            Random random_along(seed, 3 * k + 0);
+            Random random_across(seed, 3 * k + 1);
+            Random random_vertical(seed, 3 * k + 2);
+
+            const std::vector<float> along = dryden_series(random_along, true, intensity);
+            const std::vector<float> across = dryden_series(random_across, false, intensity);
+            const std::vector<float> vertical = dryden_series(random_vertical, false, intensity);
+
+            samples_[k].resize(kGustSamples);
+            for (std::size_t i = 0; i < kGustSamples; ++i) {
+                samples_[k][i] = {along[i], across[i], vertical[i]};
+            }
+        }
+    }
+
+    ///
+    /// \brief get Shared table of a seed and intensity, built on first use
+    ///
+    static std::shared_ptr<const GustTable> get(std::uint64_t seed, float intensity)
+    {
+        static std::mutex mutex;
+        static std::map<std::pair<std::uint64_t, float>, std::weak_ptr<const GustTable>> tables;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        std::weak_ptr<const GustTable>& entry = tables[std::make_pair(seed, intensity)];
+        std::shared_ptr<const GustTable> table = entry.lock();
+        if (!table) {
+            table = std::make_shared<const GustTable>(seed, intensity);
+            entry = table;
+        }
+        return table;
+    }
+
+    Sample sample(int axis, float distance) const
+    {
+        const float x = distance * kInvGustSpacing;
+        const float cell = std::floor(x);
+        const float t = x - cell;
+        const std::size_t i = static_cast<std::size_t>(static_cast<std::int64_t>(cell)) & kGustMask;
+
+        const Sample& a = samples_[axis][i];
+        const Sample& b = samples_[axis][(i + 1) & kGustMask];
+        return {a.along + t * (b.along - a.along),
+                a.across + t * (b.across - a.across),
+                a.vertical + t * (b.vertical - a.vertical)};
+    }
+
+private:
+    std::vector<Sample> samples_[kNumAxes];
+};
+
+WindField::WindField()
+    : WindField(std::vector<Layer>(), Turbulence())
+{
+}
+
+WindField::WindField(const std::vector<Layer>& profile, const Turbulence& turbulence)
+    : drift_wind_(0.0f), turbulence_(turbulence)
+{
+    std::vector<Layer> layers = profile;
+    std::sort(layers.begin(), layers.end(),
+              [](const Layer& a, const Layer& b) { return a.altitude < b.altitude; });
+
+    // Wind vector of a layer: blowing from direction, NED
+    auto wind = [](const Layer& layer) {
+        return glm::vec3(-layer.speed * std::cos(layer.direction), -layer.speed * std::sin(layer.direction), 0.0f);
+    };
+
+    const int num_points = static_cast<int>(std::lround((Atmosphere::kMaxAltitude - Atmosphere::kMinAltitude) /
+                                                        Atmosphere::kTableStep)) + 1;
+    mean_table_.resize(num_points, glm::vec3(0.0f));
+    last_ = num_points - 2;
+
+    if (!layers.empty()) {
+        std::size_t upper = 0;
+        for (int i = 0; i < num_points; ++i) {
+            const float h = Atmosphere::kMinAltitude + Atmosphere::kTableStep * static_cast<float>(i);
+
+            while (upper < layers.size() && layers[upper].altitude < h) {
+                ++upper;
+            }
+
+            if (upper == 0) {
+                mean_table_[i] = wind(layers.front());
+            }
+            else if (upper == layers.size()) {
+                mean_table_[i] = wind(layers.back());
+            }
+            else {
+                const Layer& a = layers[upper - 1];
+                const Layer& b = layers[upper];
+                const float t = (h - a.altitude) / (b.altitude - a.altitude);
+                mean_table_[i] = wind(a) + t * (wind(b) - wind(a));
+            }
+        }
+
+        // Drift of the gusts: mean wind over the altitudes of the profile
+        const float bottom = layers.front().altitude;
+        const float top = layers.back().altitude;
+        if (top > bottom) {
+            const int samples = std::max(static_cast<int>(std::ceil((top - bottom) / Atmosphere::kTableStep)), 1);
+            for (int i = 0; i < samples; ++i) {
+                const float t = (static_cast<float>(i) + 0.5f) / static_cast<float>(samples);
+                drift_wind_ += mean(bottom + t * (top - bottom));
+            }
+            drift_wind_ = drift_wind_ * (1.0f / static_cast<float>(samples));
+        }
+        else {
+            drift_wind_ = wind(layers.front());
+        }
+    }
+
+    if (turbulence_.intensity > 0.0f) {
+        gusts_ = GustTable::get(turbulence_.seed, turbulence_.intensity);
+    }
+}
+
+glm::vec3 WindField::mean(float altitude) const
+{
+    const float x = (altitude - Atmosphere::kMinAltitude) * kInvAltitudeStep;
+    const int i = std::min(std::max(static_cast<int>(x), 0), last_);
+    const float t = std::min(std::max(x - static_cast<float>(i), 0.0f), 1.0f);
+
+    return mean_table_[i] + t * (mean_table_[i + 1] - mean_table_[i]);
+}
+
+glm::vec3 WindField::gust(const glm::vec3& ned_position, float time) const
+{
+    if (!gusts_) {
+        return glm::vec3(0.0f);
+    }
+    return frozen_gust(ned_position, time);
+}
+
+glm::vec3 WindField::get(const glm::vec3& ned_position, float time) const
+{
+    const glm::vec3 wind = mean(-ned_position.z);
+    if (!gusts_) {
+        return wind;
+    }
+    return wind + frozen_gust(ned_position, time);
+}
+
+glm::vec3 WindField::frozen_gust(const glm::vec3& ned_position, float time) const
+{
+    // Frozen turbulence: the pattern moves with the reference wind, the same
+    // drift at every altitude
+    const float north = ned_position.x - drift_wind_.x * time;
+    const float east = ned_position.y - drift_wind_.y * time;
+
+    glm::vec3 g(0.0f);
+    for (int k = 0; k < kNumAxes; ++k) {
+        const float c = kAxisCos[k];
+        const float s = kAxisSin[k];
+        const GustTable::Sample sample = gusts_->sample(k, north * c + east * s);
+
+        g.x += sample.along * c - sample.across * s;
+        g.y += sample.along * s + sample.across * c;
+        g.z += sample.vertical;
+    }
+
+    // Independent patterns: the sum keeps the intensity of one
+    return g * kInvSqrtAxes;
+}
+
+} // namespace dlfdm
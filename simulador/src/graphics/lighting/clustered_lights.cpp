@@ -0,0 +1,320 @@
+#include "clustered_lights.h"
+#include "../rendering/gl_state.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Graphics {
+namespace Lighting {
+
+    ClusteredLights::ClusteredLights(int num_threads)
+        : grid_buffer_(Rendering::BufferType::TEXTURE_BUFFER, Rendering::BufferUsage::STREAM_DRAW),
+          index_buffer_(Rendering::BufferType::TEXTURE_BUFFER, Rendering::BufferUsage::STREAM_DRAW),
+          light_buffer_(Rendering::BufferType::TEXTURE_BUFFER, Rendering::BufferUsage::STREAM_DRAW),
+          grid_texture_(0), index_texture_(0), light_texture_(0),
+          cluster_counts_(NUM_CLUSTERS, 0),
+          cluster_lights_(static_cast<size_t>(NUM_CLUSTERS) * MAX_LIGHTS_PER_CLUSTER, 0),
+          grid_(2 * NUM_CLUSTERS, 0),
+          num_visible_(0),
+          scale_x_(1.0f), scale_y_(1.0f), near_(0.1f), far_(1.0f), depth_scale_(1.0f), depth_bias_(0.0f),
+          generation_(0), active_workers_(0), stop_(false), next_slice_(0), dropped_(0) {
+
+        visible_.reserve(MAX_LIGHTS);
+        light_data_.reserve(4 * MAX_LIGHTS);
+        indices_.reserve(NUM_CLUSTERS);
+
+        // Buffers vacíos y sus vistas como textura
+        upload();
+
+        const std::pair<GLuint*, std::pair<GLenum, GLuint>> views[] = {
+            {&grid_texture_, {GL_RG32UI, grid_buffer_.getId()}},
+            {&index_texture_, {GL_R16UI, index_buffer_.getId()}},
+            {&light_texture_, {GL_RGBA32F, light_buffer_.getId()}}};
+
+        Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+        for (const auto& view : views) {
+            glGenTextures(1, view.first);
+            gl_state.bindTexture(GL_TEXTURE_BUFFER, *view.first);
+            glTexBuffer(GL_TEXTURE_BUFFER, view.second.first, view.second.second);
+        }
+        gl_state.bindTexture(GL_TEXTURE_BUFFER, 0);
+
+        // El hilo de render también trabaja: hasta 3 más según los núcleos
+        if (num_threads < 0) {
+            num_threads = std::min(3, std::max(0, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+        }
+        for (int i = 0; i < num_threads; ++i) {
+            workers_.emplace_back(&ClusteredLights::workerLoop, this);
+        }
+    }
+
+    ClusteredLights::~ClusteredLights() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_cv_.notify_all();
+        for (auto& worker : workers_) {
+            worker.join();
+        }
+
+        Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+        gl_state.deleteTexture(grid_texture_);
+        gl_state.deleteTexture(index_texture_);
+        gl_state.deleteTexture(light_texture_);
+    }
+
+    float ClusteredLights::lightRange(const PointLight& light, float max_range) {
+        const glm::vec3 color = glm::max(light.getAmbient(), light.getDiffuse());
+        const float intensity = std::max(color.x, std::max(color.y, color.z));
+
+        // constant + linear d + quadratic d^2 = 256 intensity
+        const float c = light.getConstant() - 256.0f * intensity;
+        const float l = light.getLinear();
+        const float q = light.getQuadratic();
+
+        if (c >= 0.0f) {
+            return 0.0f;
+        }
+        if (q > 0.0f) {
+            return std::min(max_range, (-l + std::sqrt(l * l - 4.0f * q * c)) / (2.0f * q));
+        }
+        if (l > 0.0f) {
+            return std::min(max_range, -c / l);
+        }
+        return max_range;
+    }
+
+    float ClusteredLights::sliceDepth(int slice) const {
+        return std::exp((static_cast<float>(slice) - depth_bias_) / depth_scale_);
+    }
+
+    int ClusteredLights::depthSlice(float depth) const {
+        const float slice = std::floor(std::log(depth) * depth_scale_ + depth_bias_);
+        return std::min(std::max(static_cast<int>(slice), 0), CLUSTERS_Z - 1);
+    }
+
+    void ClusteredLights::update(const std::vector<std::unique_ptr<PointLight>>& lights,
+                                 const glm::mat4& view, const glm::mat4& projection,
+                                 float near_plane, float far_plane,
+                                 Rendering::FrameData& frame) {
+        scale_x_ = projection[0][0];
+        scale_y_ = projection[1][1];
+        near_ = near_plane;
+        far_ = far_plane;
+
+        // slice = log(d / near) / log(far / near) * CLUSTERS_Z
+        const float log_ratio = std::log(far_ / near_);
+        depth_scale_ = static_cast<float>(CLUSTERS_Z) / log_ratio;
+        depth_bias_ = -static_cast<float>(CLUSTERS_Z) * std::log(near_) / log_ratio;
+
+        // Luces delante de la cámara, de la más cercana a la más lejana: si
+        // un cluster se llena se quedan las cercanas
+        struct Candidate {
+            const PointLight* light;
+            glm::vec3 center;
+            float range;
+        };
+        std::vector<Candidate> candidates;
+        candidates.reserve(lights.size());
+
+        for (const auto& light : lights) {
+            if (!light->isEnabled()) continue;
+
+            const float range = lightRange(*light, far_);
+            const glm::vec3 center = glm::vec3(view * glm::vec4(light->getPosition(), 1.0f));
+            const float depth = -center.z;
+            if (range <= 0.0f || depth + range < near_ || depth - range > far_) continue;
+
+            candidates.push_back({light.get(), center, range});
+        }
+
+        std::sort(candidates.begin(), candidates.end(),
+                  [](const Candidate& a, const Candidate& b) { return a.center.z > b.center.z; });
+        if (candidates.size() > static_cast<size_t>(MAX_LIGHTS)) {
+            candidates.resize(MAX_LIGHTS);
+        }
+
+        visible_.clear();
+        light_data_.clear();
+        for (const Candidate& candidate : candidates) {
+            const PointLight& light = *candidate.light;
+            const float depth = -candidate.center.z;
+
+            VisibleLight visible;
+            visible.center = candidate.center;
+            visible.radius = candidate.range;
+            visible.depth_min = std::max(depth - candidate.range, near_);
+            visible.depth_max = std::min(depth + candidate.range, far_);
+            visible.slice_min = depthSlice(visible.depth_min);
+            visible.slice_max = depthSlice(visible.depth_max);
+            visible_.push_back(visible);
+
+            light_data_.push_back(glm::vec4(light.getPosition(), candidate.range));
+            light_data_.push_back(glm::vec4(light.getAmbient(), light.getConstant()));
+            light_data_.push_back(glm::vec4(light.getDiffuse(), light.getLinear()));
+            light_data_.push_back(glm::vec4(light.getSpecular(), light.getQuadratic()));
+        }
+        num_visible_ = static_cast<int>(visible_.size());
+
+        // Reparto por cortes de profundidad
+        std::fill(cluster_counts_.begin(), cluster_counts_.end(), 0);
+        dropped_.store(0);
+        next_slice_.store(0);
+
+        if (workers_.empty() || num_visible_ < PARALLEL_MIN_LIGHTS) {
+            processSlices();
+        } else {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                active_workers_ = static_cast<int>(workers_.size());
+                ++generation_;
+            }
+            start_cv_.notify_all();
+
+            processSlices();
+
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_cv_.wait(lock, [this]() { return active_workers_ == 0; });
+        }
+
+        // Listas de todos los clusters seguidas
+        indices_.clear();
+        for (int c = 0; c < NUM_CLUSTERS; ++c) {
+            const std::uint16_t count = cluster_counts_[c];
+            const std::uint16_t* list = &cluster_lights_[static_cast<size_t>(c) * MAX_LIGHTS_PER_CLUSTER];
+
+            grid_[2 * c] = static_cast<GLuint>(indices_.size());
+            grid_[2 * c + 1] = count;
+            indices_.insert(indices_.end(), list, list + count);
+        }
+
+        upload();
+
+        frame.cluster_count[0] = CLUSTERS_X;
+        frame.cluster_count[1] = CLUSTERS_Y;
+        frame.cluster_count[2] = CLUSTERS_Z;
+        frame.num_point_lights = num_visible_;
+        frame.cluster_depth_scale = depth_scale_;
+        frame.cluster_depth_bias = depth_bias_;
+    }
+
+    void ClusteredLights::workerLoop() {
+        std::uint64_t seen = 0;
+
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_cv_.wait(lock, [this, seen]() { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+
+            processSlices();
+
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                if (--active_workers_ == 0) {
+                    done_cv_.notify_one();
+                }
+            }
+        }
+    }
+
+    void ClusteredLights::processSlices() {
+        // Cada hilo toma el siguiente corte libre
+        for (int slice = next_slice_.fetch_add(1); slice < CLUSTERS_Z; slice = next_slice_.fetch_add(1)) {
+            assignSlice(slice);
+        }
+    }
+
+    void ClusteredLights::assignSlice(int slice) {
+        const float slice_near = sliceDepth(slice);
+        const float slice_far = sliceDepth(slice + 1);
+
+        // Celda de pantalla de una coordenada normalizada, limitada a la rejilla
+        auto cell = [](float ndc, int count) {
+            const float x = std::floor((std::min(std::max(ndc, -2.0f), 2.0f) * 0.5f + 0.5f) * static_cast<float>(count));
+            return static_cast<int>(x);
+        };
+
+        for (int i = 0; i < num_visible_; ++i) {
+            const VisibleLight& light = visible_[i];
+            if (slice < light.slice_min || slice > light.slice_max) continue;
+
+            // Parte de la esfera dentro del corte
+            const float d0 = std::max(slice_near, light.depth_min);
+            const float d1 = std::min(slice_far, light.depth_max);
+
+            // Caja de la esfera proyectada en [d0, d1]: cada borde se proyecta
+            // con la profundidad que más lo aleja del centro de la pantalla
+            const float left = light.center.x - light.radius;
+            const float right = light.center.x + light.radius;
+            const float bottom = light.center.y - light.radius;
+            const float top = light.center.y + light.radius;
+
+            int x0 = cell(scale_x_ * left / (left < 0.0f ? d0 : d1), CLUSTERS_X);
+            int x1 = cell(scale_x_ * right / (right > 0.0f ? d0 : d1), CLUSTERS_X);
+            int y0 = cell(scale_y_ * bottom / (bottom < 0.0f ? d0 : d1), CLUSTERS_Y);
+            int y1 = cell(scale_y_ * top / (top > 0.0f ? d0 : d1), CLUSTERS_Y);
+
+            if (x0 >= CLUSTERS_X || x1 < 0 || y0 >= CLUSTERS_Y || y1 < 0) continue;
+            x0 = std::max(x0, 0);
+            y0 = std::max(y0, 0);
+            x1 = std::min(x1, CLUSTERS_X - 1);
+            y1 = std::min(y1, CLUSTERS_Y - 1);
+
+            for (int y = y0; y <= y1; ++y) {
+                for (int x = x0; x <= x1; ++x) {
+                    const int c = (slice * CLUSTERS_Y + y) * CLUSTERS_X + x;
+                    std::uint16_t& count = cluster_counts_[c];
+
+                    if (count < MAX_LIGHTS_PER_CLUSTER) {
+                        cluster_lights_[static_cast<size_t>(c) * MAX_LIGHTS_PER_CLUSTER + count] = static_cast<std::uint16_t>(i);
+                        ++count;
+                    } else {
+                        dropped_.fetch_add(1, std::memory_order_relaxed);
+                    }
+                }
+            }
+        }
+    }
+
+    void ClusteredLights::upload() {
+        // Un buffer texture no puede estar vacío
+        static const std::uint16_t empty_index = 0;
+        static const glm::vec4 empty_light(0.0f);
+
+        grid_buffer_.setData(grid_.data(), grid_.size());
+        if (indices_.empty()) {
+            index_buffer_.setData(&empty_index, 1);
+        } else {
+            index_buffer_.setData(indices_.data(), indices_.size());
+        }
+        if (light_data_.empty()) {
+            light_buffer_.setData(&empty_light, 1);
+        } else {
+            light_buffer_.setData(light_data_.data(), light_data_.size());
+        }
+        light_buffer_.unbind();
+    }
+
+    void ClusteredLights::bind() const {
+        Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+        gl_state.bindTexture(GRID_TEXTURE_UNIT, GL_TEXTURE_BUFFER, grid_texture_);
+        gl_state.bindTexture(INDEX_TEXTURE_UNIT, GL_TEXTURE_BUFFER, index_texture_);
+        gl_state.bindTexture(LIGHT_TEXTURE_UNIT, GL_TEXTURE_BUFFER, light_texture_);
+    }
+
+    void ClusteredLights::setSamplers(Shaders::Shader* shader) {
+        shader->use();
+        shader->setInt("clusterGrid", GRID_TEXTURE_UNIT);
+        shader->setInt("clusterLightIndices", INDEX_TEXTURE_UNIT);
+        shader->setInt("pointLightData", LIGHT_TEXTURE_UNIT);
+        shader->unuse();
+    }
+
+} // namespace Lighting
+} // namespace Graphics
@@ -0,0 +1,159 @@
+#pragma once
+
+#include "light.h"
+#include "../rendering/buffer_objects.h"
+#include "../rendering/frame_uniforms.h"
+#include "../shaders/shader_manager.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Graphics {
+namespace Lighting {
+
+    /**
+     * @brief Reparto de las luces puntuales en clusters del frustum
+     *        (clustered forward shading)
+     *
+     * El frustum de la cámara se divide en CLUSTERS_X x CLUSTERS_Y celdas de
+     * pantalla y CLUSTERS_Z cortes de profundidad en escala logarítmica. Cada
+     * frame se calcula en la CPU qué luces (esfera de alcance) tocan cada
+     * cluster y se suben tres buffer textures: la rejilla (primer índice y
+     * número de luces por cluster), la lista de índices y los datos de las
+     * luces. El fragment shader (shaders/clustered_lights.glsl) sólo recorre
+     * las luces de su cluster, así el coste por fragmento no depende del
+     * número total de luces sino de las que se solapan en ese punto.
+     *
+     * Los cortes de profundidad se reparten entre hilos de trabajo que
+     * esperan entre frames; cada corte tiene sus propios clusters, así que no
+     * hay escrituras compartidas. Se usan buffer textures (GL 3.1) y no SSBO
+     * porque el contexto es OpenGL 3.3.
+     */
+    class ClusteredLights {
+    public:
+        static constexpr int CLUSTERS_X = 16;
+        static constexpr int CLUSTERS_Y = 9;
+        static constexpr int CLUSTERS_Z = 24;
+        static constexpr int NUM_CLUSTERS = CLUSTERS_X * CLUSTERS_Y * CLUSTERS_Z;
+
+        static constexpr int MAX_LIGHTS = 1024;
+        static constexpr int MAX_LIGHTS_PER_CLUSTER = 64;
+
+        // Unidades de textura de los buffer textures (la 0 es la del material)
+        static constexpr GLint GRID_TEXTURE_UNIT = 1;
+        static constexpr GLint INDEX_TEXTURE_UNIT = 2;
+        static constexpr GLint LIGHT_TEXTURE_UNIT = 3;
+
+        /**
+         * @param num_threads Hilos de trabajo además del de render
+         *        (-1 = según los núcleos disponibles, 0 = sólo el de render)
+         */
+        explicit ClusteredLights(int num_threads = -1);
+        ~ClusteredLights();
+
+        // No permitir copia
+        ClusteredLights(const ClusteredLights&) = delete;
+        ClusteredLights& operator=(const ClusteredLights&) = delete;
+
+        /**
+         * @brief Reparte las luces en los clusters del frustum del frame y
+         *        sube los buffers
+         *
+         * Escribe en frame el número de clusters, el corte de profundidad y
+         * el número de luces visibles (el bloque se sube después).
+         */
+        void update(const std::vector<std::unique_ptr<PointLight>>& lights,
+                    const glm::mat4& view, const glm::mat4& projection,
+                    float near_plane, float far_plane,
+                    Rendering::FrameData& frame);
+
+        /**
+         * @brief Enlaza los buffer textures en sus unidades de textura
+         */
+        void bind() const;
+
+        /**
+         * @brief Asigna las unidades de textura a los samplers de un shader
+         *        (una vez, después de cargarlo)
+         */
+        static void setSamplers(Shaders::Shader* shader);
+
+        /**
+         * @brief Alcance de una luz [m]: distancia a la que su aportación
+         *        baja de 1/256 (invisible en 8 bits)
+         */
+        static float lightRange(const PointLight& light, float max_range);
+
+        // Estadísticas del último frame
+        int getVisibleLightCount() const { return num_visible_; }
+        size_t getIndexCount() const { return indices_.size(); }
+        int getDroppedCount() const { return dropped_.load(); }
+        int getWorkerCount() const { return static_cast<int>(workers_.size()); }
+
+    private:
+        /**
+         * @brief Luz visible en espacio de vista
+         */
+        struct VisibleLight {
+            glm::vec3 center;   // Espacio de vista (la cámara mira hacia -z)
+            float radius;
+            float depth_min;    // Profundidad (-z) de la esfera
+            float depth_max;
+            int slice_min;
+            int slice_max;
+        };
+
+        // Por debajo de este número de luces el reparto se hace en el hilo de render
+        static constexpr int PARALLEL_MIN_LIGHTS = 32;
+
+        // Buffers y texturas de la GPU
+        Rendering::Buffer grid_buffer_;
+        Rendering::Buffer index_buffer_;
+        Rendering::Buffer light_buffer_;
+        GLuint grid_texture_;
+        GLuint index_texture_;
+        GLuint light_texture_;
+
+        // Datos del frame
+        std::vector<VisibleLight> visible_;
+        std::vector<glm::vec4> light_data_;         // 4 texels por luz visible
+        std::vector<std::uint16_t> cluster_counts_;
+        std::vector<std::uint16_t> cluster_lights_; // MAX_LIGHTS_PER_CLUSTER por cluster
+        std::vector<GLuint> grid_;                  // (primer índice, número) por cluster
+        std::vector<std::uint16_t> indices_;
+        int num_visible_;
+
+        // Proyección del frame
+        float scale_x_;
+        float scale_y_;
+        float near_;
+        float far_;
+        float depth_scale_;
+        float depth_bias_;
+
+        // Hilos de trabajo
+        std::vector<std::thread> workers_;
+        std::mutex mutex_;
+        std::condition_variable start_cv_;
+        std::condition_variable done_cv_;
+        std::uint64_t generation_;
+        int active_workers_;
+        bool stop_;
+        std::atomic<int> next_slice_;
+        std::atomic<int> dropped_;
+
+        void workerLoop();
+        void processSlices();
+        void assignSlice(int slice);
+        float sliceDepth(int slice) const;
+        int depthSlice(float depth) const;
+        void upload();
+    };
+
+} // namespace Lighting
+} // namespace Graphics
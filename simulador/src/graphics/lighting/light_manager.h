@@ -1,7 +1,7 @@
 #pragma once
 
 #include "light.h"
-#include "../shaders/shader_manager.h"
+#include "../rendering/frame_uniforms.h"
 #include <vector>
 #include <memory>
 
@@ -63,46 +63,27 @@ namespace Lighting {
         }
 
         /**
-         * @brief Aplica las luces a un shader
+         * @brief Escribe la luz direccional en el bloque de uniformes del frame
          */
-        void applyToShader(Shaders::Shader* shader) const {
-            if (!shader) return;
-
-            shader->use();
-
-            // Aplicar luz direccional principal
+        void writeFrameData(Rendering::FrameData& frame) const {
+            // Luz direccional principal
+            Rendering::FrameDirLight& sun = frame.dir_light;
             if (main_light_ && main_light_->isEnabled()) {
-                shader->setVec3("dirLight.direction", main_light_->getDirection());
-                shader->setVec3("dirLight.ambient", main_light_->getAmbient());
-                shader->setVec3("dirLight.diffuse", main_light_->getDiffuse());
-                shader->setVec3("dirLight.specular", main_light_->getSpecular());
-                shader->setBool("dirLight.enabled", true);
+                sun.direction = main_light_->getDirection();
+                sun.ambient = main_light_->getAmbient();
+                sun.diffuse = main_light_->getDiffuse();
+                sun.specular = main_light_->getSpecular();
+                sun.enabled = GL_TRUE;
             } else {
-                shader->setBool("dirLight.enabled", false);
-            }
-
-            // Aplicar luces puntuales (hasta un máximo)
-            const int MAX_POINT_LIGHTS = 4;
-            int num_active_point_lights = 0;
-            
-            for (size_t i = 0; i < point_lights_.size() && i < MAX_POINT_LIGHTS; ++i) {
-                const auto& light = point_lights_[i];
-                if (!light->isEnabled()) continue;
-
-                std::string base = "pointLights[" + std::to_string(num_active_point_lights) + "]";
-                shader->setVec3(base + ".position", light->getPosition());
-                shader->setVec3(base + ".ambient", light->getAmbient());
-                shader->setVec3(base + ".diffuse", light->getDiffuse());
-                shader->setVec3(base + ".specular", light->getSpecular());
-                shader->setFloat(base + ".constant", light->getConstant());
-                shader->setFloat(base + ".linear", light->getLinear());
-                shader->setFloat(base + ".quadratic", light->getQuadratic());
-                shader->setBool(base + ".enabled", true);
-                
-                num_active_point_lights++;
+                sun.enabled = GL_FALSE;
             }
+        }
 
-            shader->setInt("numPointLights", num_active_point_lights);
+        /**
+         * @brief Luces puntuales (se reparten por clusters en ClusteredLights)
+         */
+        const std::vector<std::unique_ptr<PointLight>>& getPointLights() const {
+            return point_lights_;
         }
 
         /**
@@ -1,4 +1,5 @@
 #include "buffer_objects.h"
+#include "gl_state.h"
 #include <iostream>
 
 namespace Graphics {
@@ -13,7 +14,7 @@ namespace Graphics {
 
         Buffer::~Buffer() {
             if (buffer_id_ != 0) {
-                glDeleteBuffers(1, &buffer_id_);
+                GLState::getInstance().deleteBuffer(buffer_id_);
             }
         }
 
@@ -28,7 +29,7 @@ namespace Graphics {
         Buffer& Buffer::operator=(Buffer&& other) noexcept {
             if (this != &other) {
                 if (buffer_id_ != 0) {
-                    glDeleteBuffers(1, &buffer_id_);
+                    GLState::getInstance().deleteBuffer(buffer_id_);
                 }
                 
                 buffer_id_ = other.buffer_id_;
@@ -45,15 +46,20 @@ namespace Graphics {
         }
 
         void Buffer::bind() {
-            glBindBuffer(static_cast<GLenum>(type_), buffer_id_);
+            GLState::getInstance().bindBuffer(static_cast<GLenum>(type_), buffer_id_);
             bound_ = true;
         }
 
         void Buffer::unbind() {
-            glBindBuffer(static_cast<GLenum>(type_), 0);
+            GLState::getInstance().bindBuffer(static_cast<GLenum>(type_), 0);
             bound_ = false;
         }
 
+        void Buffer::bindBase(GLuint index) {
+            GLState::getInstance().bindBufferBase(static_cast<GLenum>(type_), index, buffer_id_);
+            bound_ = true;
+        }
+
         // === Implementación de VertexBuffer ===
 
         VertexBuffer::VertexBuffer(BufferUsage usage)
@@ -74,7 +80,7 @@ namespace Graphics {
 
         VertexArray::~VertexArray() {
             if (vao_id_ != 0) {
-                glDeleteVertexArrays(1, &vao_id_);
+                GLState::getInstance().deleteVertexArray(vao_id_);
             }
         }
 
@@ -91,7 +97,7 @@ namespace Graphics {
         VertexArray& VertexArray::operator=(VertexArray&& other) noexcept {
             if (this != &other) {
                 if (vao_id_ != 0) {
-                    glDeleteVertexArrays(1, &vao_id_);
+                    GLState::getInstance().deleteVertexArray(vao_id_);
                 }
                 
                 vao_id_ = other.vao_id_;
@@ -107,12 +113,12 @@ namespace Graphics {
         }
 
         void VertexArray::bind() {
-            glBindVertexArray(vao_id_);
+            GLState::getInstance().bindVertexArray(vao_id_);
             bound_ = true;
         }
 
         void VertexArray::unbind() {
-            glBindVertexArray(0);
+            GLState::getInstance().bindVertexArray(0);
             bound_ = false;
         }
 
@@ -146,5 +152,9 @@ namespace Graphics {
             addAttribute(index, size, GL_INT, GL_FALSE, stride, pointer);
         }
 
+        void VertexArray::addNormalizedAttribute(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {
+            addAttribute(index, size, type, GL_TRUE, stride, pointer);
+        }
+
     } // namespace Rendering
 } // namespace Graphics
\ No newline at end of file
@@ -15,7 +15,8 @@ namespace Graphics {
         enum class BufferType {
             VERTEX_BUFFER = GL_ARRAY_BUFFER,
             INDEX_BUFFER = GL_ELEMENT_ARRAY_BUFFER,
-            UNIFORM_BUFFER = GL_UNIFORM_BUFFER
+            UNIFORM_BUFFER = GL_UNIFORM_BUFFER,
+            TEXTURE_BUFFER = GL_TEXTURE_BUFFER
         };
 
         // Enum para uso de buffer
@@ -49,6 +50,9 @@ namespace Graphics {
 
             void bind();
             void unbind();
+
+            // Enlaza el buffer a un punto de binding indexado (uniform buffers)
+            void bindBase(GLuint index);
             
             template<typename T>
             void setData(const std::vector<T>& data);
@@ -136,6 +140,8 @@ namespace Graphics {
             // Métodos de conveniencia para tipos comunes
             void addFloatAttribute(GLuint index, GLint size, GLsizei stride = 0, const void* pointer = nullptr);
             void addIntAttribute(GLuint index, GLint size, GLsizei stride = 0, const void* pointer = nullptr);
+            // Enteros que el shader lee como float en [0, 1] / [-1, 1]
+            void addNormalizedAttribute(GLuint index, GLint size, GLenum type, GLsizei stride = 0, const void* pointer = nullptr);
 
             GLuint getId() const { return vao_id_; }
             size_t getVertexBufferCount() const { return vertex_buffers_.size(); }
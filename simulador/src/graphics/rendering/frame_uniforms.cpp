@@ -0,0 +1,23 @@
+#include "frame_uniforms.h"
+
+namespace Graphics {
+    namespace Rendering {
+
+        FrameUniforms::FrameUniforms()
+            : buffer_(BufferType::UNIFORM_BUFFER, BufferUsage::DYNAMIC_DRAW), data_() {
+            data_.view = glm::mat4(1.0f);
+            data_.projection = glm::mat4(1.0f);
+
+            buffer_.setData(&data_, 1);
+            buffer_.bindBase(BINDING);
+        }
+
+        void FrameUniforms::upload() {
+            // glBufferData con el tamaño completo: el driver puede dar memoria
+            // nueva en lugar de esperar a que la GPU termine el frame anterior
+            buffer_.setData(&data_, 1);
+            buffer_.bindBase(BINDING);
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
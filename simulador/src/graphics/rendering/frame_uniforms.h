@@ -0,0 +1,91 @@
+#ifndef FRAME_UNIFORMS_H
+#define FRAME_UNIFORMS_H
+
+#include "buffer_objects.h"
+
+#include <cstddef>
+#include <glm/glm.hpp>
+
+namespace Graphics {
+    namespace Rendering {
+
+        // === Bloque FrameData (std140) ===
+        // Espejo en C++ de shaders/frame_data.glsl: vec3 se alinea a 16 bytes,
+        // los escalares que siguen a un vec3 ocupan su hueco y bool son 4 bytes.
+
+        struct FrameDirLight {
+            glm::vec3 direction;
+            GLint enabled;
+            glm::vec3 ambient;
+            float pad0;
+            glm::vec3 diffuse;
+            float pad1;
+            glm::vec3 specular;
+            float pad2;
+        };
+
+        /**
+         * @brief Datos por frame de cámara, niebla y luces compartidos por
+         *        todos los shaders de escena
+         */
+        struct FrameData {
+            glm::mat4 view;
+            glm::mat4 projection;
+            glm::vec3 view_pos;
+            GLint fog_enabled;
+            glm::vec3 fog_color;
+            float fog_density;
+            FrameDirLight dir_light;
+
+            // Luces puntuales por cluster (Lighting::ClusteredLights)
+            GLint cluster_count[3];     // Clusters en x, y y profundidad
+            GLint num_point_lights;     // Luces visibles, 0 = ninguna
+            float cluster_depth_scale;  // Corte de profundidad: log(d) * scale + bias
+            float cluster_depth_bias;
+            float pad[2];               // El bloque se redondea a 16 bytes
+        };
+
+        static_assert(sizeof(FrameDirLight) == 64, "FrameDirLight debe seguir el layout std140");
+        static_assert(offsetof(FrameData, view_pos) == 128 && offsetof(FrameData, fog_color) == 144 &&
+                      offsetof(FrameData, dir_light) == 160 && offsetof(FrameData, cluster_count) == 224 &&
+                      offsetof(FrameData, num_point_lights) == 236 && offsetof(FrameData, cluster_depth_scale) == 240 &&
+                      sizeof(FrameData) == 256,
+                      "FrameData debe seguir el layout std140 de shaders/frame_data.glsl");
+
+        /**
+         * @brief Uniform buffer del bloque FrameData
+         *
+         * Se rellena data() durante el frame y upload() lo sube con una sola
+         * llamada y lo deja enlazado en BINDING. Los shaders que declaran el
+         * bloque lo leen de ahí (ShaderManager::registerUniformBlock), en
+         * lugar de recibir cada uniforme por separado.
+         */
+        class FrameUniforms {
+        private:
+            Buffer buffer_;
+            FrameData data_;
+
+        public:
+            static constexpr GLuint BINDING = 0;
+            static constexpr const char* BLOCK_NAME = "FrameData";
+
+            FrameUniforms();
+            ~FrameUniforms() = default;
+
+            // No permitir copia
+            FrameUniforms(const FrameUniforms&) = delete;
+            FrameUniforms& operator=(const FrameUniforms&) = delete;
+
+            FrameData& data() { return data_; }
+            const FrameData& data() const { return data_; }
+
+            /**
+             * @brief Sube el bloque completo y lo enlaza en BINDING
+             */
+            void upload();
+        };
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // FRAME_UNIFORMS_H
@@ -0,0 +1,259 @@
+#include "gl_state.h"
+
+namespace Graphics {
+    namespace Rendering {
+
+        GLState& GLState::getInstance() {
+            // Destructor trivial: sigue siendo válido para los objetos que
+            // se destruyen al salir del programa
+            static GLState instance;
+            return instance;
+        }
+
+        GLState::GLState() {
+            resetToDefaults();
+        }
+
+        void GLState::resetToDefaults() {
+            program_ = 0;
+            vertex_array_ = 0;
+            for (GLuint& buffer : buffers_) buffer = 0;
+            active_unit_ = 0;
+            for (auto& unit : textures_) {
+                for (GLuint& texture : unit) texture = 0;
+            }
+            for (std::int8_t& capability : capabilities_) capability = 0;
+            blend_src_ = GL_ONE;
+            blend_dst_ = GL_ZERO;
+            depth_func_ = GL_LESS;
+            depth_mask_ = 1;
+            cull_face_ = GL_BACK;
+            polygon_mode_ = GL_FILL;
+        }
+
+        void GLState::invalidate() {
+            program_ = UNKNOWN;
+            vertex_array_ = UNKNOWN;
+            for (GLuint& buffer : buffers_) buffer = UNKNOWN;
+            active_unit_ = UNKNOWN;
+            for (auto& unit : textures_) {
+                for (GLuint& texture : unit) texture = UNKNOWN;
+            }
+            for (std::int8_t& capability : capabilities_) capability = -1;
+            blend_src_ = UNKNOWN;
+            blend_dst_ = UNKNOWN;
+            depth_func_ = UNKNOWN;
+            depth_mask_ = -1;
+            cull_face_ = UNKNOWN;
+            polygon_mode_ = UNKNOWN;
+        }
+
+        bool GLState::change(GLuint& cached, GLuint value) {
+            if (cached == value) {
+                ++stats_.filtered;
+                return false;
+            }
+            cached = value;
+            ++stats_.issued;
+            return true;
+        }
+
+        bool GLState::change(std::int8_t& cached, bool value) {
+            const std::int8_t flag = value ? 1 : 0;
+            if (cached == flag) {
+                ++stats_.filtered;
+                return false;
+            }
+            cached = flag;
+            ++stats_.issued;
+            return true;
+        }
+
+        int GLState::bufferSlot(GLenum target) {
+            switch (target) {
+                case GL_ARRAY_BUFFER: return ARRAY_BUFFER_SLOT;
+                case GL_UNIFORM_BUFFER: return UNIFORM_BUFFER_SLOT;
+                case GL_TEXTURE_BUFFER: return TEXTURE_BUFFER_SLOT;
+                default: return -1;
+            }
+        }
+
+        int GLState::textureSlot(GLenum target) {
+            switch (target) {
+                case GL_TEXTURE_2D: return TEXTURE_2D_SLOT;
+                case GL_TEXTURE_CUBE_MAP: return TEXTURE_CUBE_MAP_SLOT;
+                case GL_TEXTURE_BUFFER: return TEXTURE_BUFFER_TEXTURE_SLOT;
+                default: return -1;
+            }
+        }
+
+        int GLState::capabilitySlot(GLenum capability) {
+            switch (capability) {
+                case GL_DEPTH_TEST: return DEPTH_TEST_SLOT;
+                case GL_BLEND: return BLEND_SLOT;
+                case GL_CULL_FACE: return CULL_FACE_SLOT;
+                default: return -1;
+            }
+        }
+
+        // === Objetos enlazados ===
+
+        void GLState::useProgram(GLuint program) {
+            if (change(program_, program)) {
+                glUseProgram(program);
+            }
+        }
+
+        void GLState::bindVertexArray(GLuint vao) {
+            if (change(vertex_array_, vao)) {
+                glBindVertexArray(vao);
+            }
+        }
+
+        void GLState::bindBuffer(GLenum target, GLuint buffer) {
+            const int slot = bufferSlot(target);
+            if (slot < 0) {
+                ++stats_.issued;
+                glBindBuffer(target, buffer);
+            } else if (change(buffers_[slot], buffer)) {
+                glBindBuffer(target, buffer);
+            }
+        }
+
+        void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+            // También cambia el enlace genérico del destino
+            ++stats_.issued;
+            glBindBufferBase(target, index, buffer);
+
+            const int slot = bufferSlot(target);
+            if (slot >= 0) {
+                buffers_[slot] = buffer;
+            }
+        }
+
+        void GLState::activeTexture(GLuint unit) {
+            if (change(active_unit_, unit)) {
+                glActiveTexture(GL_TEXTURE0 + unit);
+            }
+        }
+
+        void GLState::bindTexture(GLenum target, GLuint texture) {
+            const int slot = textureSlot(target);
+            if (slot < 0 || active_unit_ >= MAX_TEXTURE_UNITS) {
+                ++stats_.issued;
+                glBindTexture(target, texture);
+            } else if (change(textures_[active_unit_][slot], texture)) {
+                glBindTexture(target, texture);
+            }
+        }
+
+        void GLState::bindTexture(GLuint unit, GLenum target, GLuint texture) {
+            const int slot = textureSlot(target);
+            if (slot >= 0 && unit < MAX_TEXTURE_UNITS && textures_[unit][slot] == texture) {
+                ++stats_.filtered;
+                return;
+            }
+            activeTexture(unit);
+            bindTexture(target, texture);
+        }
+
+        // === Estado fijo ===
+
+        void GLState::setEnabled(GLenum capability, bool enabled) {
+            const int slot = capabilitySlot(capability);
+            if (slot >= 0 && !change(capabilities_[slot], enabled)) {
+                return;
+            }
+            if (slot < 0) {
+                ++stats_.issued;
+            }
+
+            if (enabled) {
+                glEnable(capability);
+            } else {
+                glDisable(capability);
+            }
+        }
+
+        bool GLState::isEnabled(GLenum capability) {
+            const int slot = capabilitySlot(capability);
+            if (slot < 0) {
+                return glIsEnabled(capability) == GL_TRUE;
+            }
+            if (capabilities_[slot] < 0) {
+                capabilities_[slot] = glIsEnabled(capability) == GL_TRUE ? 1 : 0;
+            }
+            return capabilities_[slot] == 1;
+        }
+
+        void GLState::blendFunc(GLenum src, GLenum dst) {
+            if (blend_src_ == src && blend_dst_ == dst) {
+                ++stats_.filtered;
+                return;
+            }
+            blend_src_ = src;
+            blend_dst_ = dst;
+            ++stats_.issued;
+            glBlendFunc(src, dst);
+        }
+
+        void GLState::depthFunc(GLenum func) {
+            if (change(depth_func_, func)) {
+                glDepthFunc(func);
+            }
+        }
+
+        void GLState::depthMask(bool write) {
+            if (change(depth_mask_, write)) {
+                glDepthMask(write ? GL_TRUE : GL_FALSE);
+            }
+        }
+
+        void GLState::cullFace(GLenum face) {
+            if (change(cull_face_, face)) {
+                glCullFace(face);
+            }
+        }
+
+        void GLState::polygonMode(GLenum mode) {
+            if (change(polygon_mode_, mode)) {
+                glPolygonMode(GL_FRONT_AND_BACK, mode);
+            }
+        }
+
+        // === Borrado ===
+
+        void GLState::deleteProgram(GLuint program) {
+            if (program == 0) return;
+            glDeleteProgram(program);
+            // Un programa en uso sigue enlazado hasta cambiar de programa,
+            // pero su nombre puede reutilizarse: se vuelve a emitir
+            if (program_ == program) program_ = UNKNOWN;
+        }
+
+        void GLState::deleteVertexArray(GLuint vao) {
+            if (vao == 0) return;
+            glDeleteVertexArrays(1, &vao);
+            if (vertex_array_ == vao) vertex_array_ = 0;
+        }
+
+        void GLState::deleteBuffer(GLuint buffer) {
+            if (buffer == 0) return;
+            glDeleteBuffers(1, &buffer);
+            for (GLuint& bound : buffers_) {
+                if (bound == buffer) bound = 0;
+            }
+        }
+
+        void GLState::deleteTexture(GLuint texture) {
+            if (texture == 0) return;
+            glDeleteTextures(1, &texture);
+            for (auto& unit : textures_) {
+                for (GLuint& bound : unit) {
+                    if (bound == texture) bound = 0;
+                }
+            }
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
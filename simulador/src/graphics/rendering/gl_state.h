@@ -0,0 +1,127 @@
+#ifndef GL_STATE_H
+#define GL_STATE_H
+
+extern "C" {
+    #include <glad/glad.h>
+}
+
+#include <cstddef>
+#include <cstdint>
+
+namespace Graphics {
+    namespace Rendering {
+
+        /**
+         * @brief Caché del estado de OpenGL del contexto
+         *
+         * Todos los módulos enlazan programas, VAOs, buffers y texturas y
+         * cambian el estado fijo (depth, blend, cull) a través de esta clase,
+         * que sólo llama a GL cuando el valor cambia. Para que la caché sea
+         * válida nadie debe cambiar ese estado directamente; el código
+         * externo que lo haga debe llamar a invalidate() después.
+         *
+         * Los objetos se borran con los delete* de aquí: GL desenlaza un
+         * objeto borrado y la caché tiene que olvidarlo.
+         *
+         * El estado inicial es el de un contexto nuevo. Sólo se usa desde el
+         * hilo que tiene el contexto actual.
+         */
+        class GLState {
+        public:
+            /**
+             * @brief Cambios de estado pedidos: emitidos a GL o descartados
+             *        por repetir el valor actual
+             */
+            struct Stats {
+                size_t issued = 0;
+                size_t filtered = 0;
+            };
+
+            static constexpr GLuint MAX_TEXTURE_UNITS = 16;
+
+            static GLState& getInstance();
+
+            // No permitir copia
+            GLState(const GLState&) = delete;
+            GLState& operator=(const GLState&) = delete;
+
+            // === Objetos enlazados ===
+            void useProgram(GLuint program);
+            void bindVertexArray(GLuint vao);
+            // GL_ELEMENT_ARRAY_BUFFER es estado del VAO y siempre se emite
+            void bindBuffer(GLenum target, GLuint buffer);
+            void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+            void activeTexture(GLuint unit);
+            // En la unidad activa
+            void bindTexture(GLenum target, GLuint texture);
+            void bindTexture(GLuint unit, GLenum target, GLuint texture);
+
+            GLuint getProgram() const { return program_; }
+            GLuint getVertexArray() const { return vertex_array_; }
+
+            // === Estado fijo ===
+            // GL_DEPTH_TEST, GL_BLEND y GL_CULL_FACE (el resto siempre se emite)
+            void setEnabled(GLenum capability, bool enabled);
+            bool isEnabled(GLenum capability);
+            void blendFunc(GLenum src, GLenum dst);
+            void depthFunc(GLenum func);
+            void depthMask(bool write);
+            void cullFace(GLenum face);
+            void polygonMode(GLenum mode);
+
+            // === Borrado ===
+            void deleteProgram(GLuint program);
+            void deleteVertexArray(GLuint vao);
+            void deleteBuffer(GLuint buffer);
+            void deleteTexture(GLuint texture);
+
+            /**
+             * @brief Olvida todo el estado: la siguiente llamada de cada tipo
+             *        se emite
+             */
+            void invalidate();
+
+            const Stats& getStats() const { return stats_; }
+            void resetStats() { stats_ = Stats(); }
+
+        private:
+            // Valor desconocido (tras invalidate)
+            static constexpr GLuint UNKNOWN = 0xFFFFFFFFu;
+
+            // Destinos de buffer y de textura con caché
+            enum { ARRAY_BUFFER_SLOT, UNIFORM_BUFFER_SLOT, TEXTURE_BUFFER_SLOT, BUFFER_SLOTS };
+            enum { TEXTURE_2D_SLOT, TEXTURE_CUBE_MAP_SLOT, TEXTURE_BUFFER_TEXTURE_SLOT, TEXTURE_SLOTS };
+            enum { DEPTH_TEST_SLOT, BLEND_SLOT, CULL_FACE_SLOT, CAPABILITY_SLOTS };
+
+            GLuint program_;
+            GLuint vertex_array_;
+            GLuint buffers_[BUFFER_SLOTS];
+            GLuint active_unit_;
+            GLuint textures_[MAX_TEXTURE_UNITS][TEXTURE_SLOTS];
+            std::int8_t capabilities_[CAPABILITY_SLOTS];   // 0, 1 o -1 (desconocido)
+            GLenum blend_src_;
+            GLenum blend_dst_;
+            GLenum depth_func_;
+            std::int8_t depth_mask_;
+            GLenum cull_face_;
+            GLenum polygon_mode_;
+            Stats stats_;
+
+            GLState();
+            ~GLState() = default;
+
+            void resetToDefaults();
+
+            // Cuenta el cambio y devuelve si hay que emitirlo
+            bool change(GLuint& cached, GLuint value);
+            bool change(std::int8_t& cached, bool value);
+
+            static int bufferSlot(GLenum target);
+            static int textureSlot(GLenum target);
+            static int capabilitySlot(GLenum capability);
+        };
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // GL_STATE_H
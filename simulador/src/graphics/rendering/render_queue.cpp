@@ -0,0 +1,92 @@
+#include "render_queue.h"
+#include "gl_state.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace Graphics {
+    namespace Rendering {
+
+        void RenderQueue::addSource(Source source) {
+            sources_.push_back(std::move(source));
+        }
+
+        void RenderQueue::submit(RenderPass pass, Shaders::Shader* shader, GLuint texture, float depth,
+                                 std::function<void()> draw) {
+            const GLuint program = shader ? shader->getProgramId() : 0;
+            items_.push_back({makeKey(pass, program, texture, depth), shader, texture, std::move(draw)});
+        }
+
+        std::uint64_t RenderQueue::makeKey(RenderPass pass, GLuint program, GLuint texture, float depth) {
+            // Un float positivo ordena igual que sus bits como entero
+            depth = std::max(depth, 0.0f);
+            std::uint32_t depth_bits;
+            std::memcpy(&depth_bits, &depth, sizeof(depth_bits));
+
+            const std::uint64_t pass_bits = static_cast<std::uint64_t>(pass) << 60;
+            const std::uint64_t program_bits = program & 0xFFFu;
+            const std::uint64_t texture_bits = texture & 0xFFFFu;
+
+            if (pass == RenderPass::BLENDED) {
+                return pass_bits | (static_cast<std::uint64_t>(~depth_bits) << 28) |
+                       (program_bits << 16) | texture_bits;
+            }
+            return pass_bits | (program_bits << 48) | (texture_bits << 32) | depth_bits;
+        }
+
+        float RenderQueue::viewDepth(const FrameData& frame, const glm::vec3& position) {
+            return -(frame.view * glm::vec4(position, 1.0f)).z;
+        }
+
+        void RenderQueue::render(const FrameData& frame) {
+            items_.clear();
+            for (const Source& source : sources_) {
+                source(*this, frame);
+            }
+
+            order_.clear();
+            order_.reserve(items_.size());
+            for (size_t i = 0; i < items_.size(); ++i) {
+                order_.emplace_back(items_[i].key, static_cast<std::uint32_t>(i));
+            }
+            std::sort(order_.begin(), order_.end());
+
+            stats_ = Stats();
+            stats_.items = items_.size();
+            execute();
+        }
+
+        void RenderQueue::countChanges(const DrawItem& item, const DrawItem*& previous,
+                                       size_t& shader_changes, size_t& texture_changes) {
+            // Los elementos sin shader no declaran estado
+            if (!item.shader) return;
+
+            if (!previous || item.shader != previous->shader) ++shader_changes;
+            if (!previous || item.texture != previous->texture) ++texture_changes;
+            previous = &item;
+        }
+
+        void RenderQueue::execute() {
+            GLState& gl_state = GLState::getInstance();
+
+            const DrawItem* unsorted = nullptr;
+            for (const DrawItem& item : items_) {
+                countChanges(item, unsorted, stats_.unsorted_shader_changes, stats_.unsorted_texture_changes);
+            }
+
+            const DrawItem* previous = nullptr;
+            for (const auto& entry : order_) {
+                const DrawItem& item = items_[entry.second];
+                countChanges(item, previous, stats_.shader_changes, stats_.texture_changes);
+
+                // GLState descarta los enlaces que no cambian nada
+                if (item.shader) {
+                    item.shader->use();
+                    gl_state.bindTexture(0, GL_TEXTURE_2D, item.texture);
+                }
+                item.draw();
+            }
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
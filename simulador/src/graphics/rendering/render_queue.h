@@ -0,0 +1,125 @@
+#ifndef RENDER_QUEUE_H
+#define RENDER_QUEUE_H
+
+extern "C" {
+    #include <glad/glad.h>
+}
+
+#include "frame_uniforms.h"
+#include "../shaders/shader_manager.h"
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Graphics {
+    namespace Rendering {
+
+        /**
+         * @brief Pasadas del frame, en orden de ejecución
+         */
+        enum class RenderPass : std::uint8_t {
+            GEOMETRY = 0,       // Geometría opaca, de delante hacia atrás
+            SKY = 1,            // Fondo: sólo donde no se ha dibujado nada
+            BLENDED = 2,        // Transparente, de atrás hacia delante
+            OVERLAY = 3         // HUD en pantalla
+        };
+
+        /**
+         * @brief Elemento de dibujo con su clave de orden de 64 bits
+         */
+        struct DrawItem {
+            std::uint64_t key;
+            Shaders::Shader* shader;    // nullptr: draw gestiona su propio estado
+            GLuint texture;             // Textura 2D en la unidad 0 (0 = ninguna)
+            std::function<void()> draw; // Uniformes por objeto y llamadas de dibujo
+        };
+
+        /**
+         * @brief Cola de dibujo ordenada por clave
+         *
+         * Cada objeto de la escena envía sus elementos desde una fuente
+         * registrada con addSource(); render() los recoge, los ordena por la
+         * clave (pasada, programa, textura, profundidad) y los ejecuta, así
+         * los elementos que comparten programa y textura quedan seguidos.
+         * Añadir un objeto es registrar una fuente, sin tocar el bucle de
+         * render.
+         *
+         * Con shader no nulo, el programa y la textura del elemento ya están
+         * enlazados (a través de GLState) cuando se llama a draw, que fija
+         * los uniformes por objeto y dibuja. Con shader nulo draw prepara
+         * todo su estado.
+         */
+        class RenderQueue {
+        public:
+            using Source = std::function<void(RenderQueue&, const FrameData&)>;
+
+            /**
+             * @brief Cambios de programa y de textura entre elementos
+             *        consecutivos del último frame
+             */
+            struct Stats {
+                size_t items = 0;
+                size_t shader_changes = 0;
+                size_t texture_changes = 0;
+                // Los mismos cambios si se ejecutara en orden de envío
+                size_t unsorted_shader_changes = 0;
+                size_t unsorted_texture_changes = 0;
+            };
+
+            RenderQueue() = default;
+            ~RenderQueue() = default;
+
+            // No permitir copia
+            RenderQueue(const RenderQueue&) = delete;
+            RenderQueue& operator=(const RenderQueue&) = delete;
+
+            /**
+             * @brief Registra una fuente de elementos, llamada en cada render()
+             *        en orden de registro
+             */
+            void addSource(Source source);
+
+            /**
+             * @brief Añade un elemento al frame en curso
+             * @param depth Distancia a la cámara en el eje de vista
+             */
+            void submit(RenderPass pass, Shaders::Shader* shader, GLuint texture, float depth,
+                        std::function<void()> draw);
+
+            /**
+             * @brief Recoge los elementos de las fuentes, los ordena y los dibuja
+             */
+            void render(const FrameData& frame);
+
+            const Stats& getStats() const { return stats_; }
+
+            /**
+             * @brief Clave de orden: pasada (4 bits) y después programa (12),
+             *        textura (16) y profundidad (32), de delante hacia atrás;
+             *        en BLENDED la profundidad va antes y de atrás hacia
+             *        delante
+             */
+            static std::uint64_t makeKey(RenderPass pass, GLuint program, GLuint texture, float depth);
+
+            /**
+             * @brief Profundidad de un punto del mundo en la vista del frame
+             */
+            static float viewDepth(const FrameData& frame, const glm::vec3& position);
+
+        private:
+            std::vector<Source> sources_;
+            std::vector<DrawItem> items_;
+            // (clave, posición de envío): los empates conservan el orden de envío
+            std::vector<std::pair<std::uint64_t, std::uint32_t>> order_;
+            Stats stats_;
+
+            static void countChanges(const DrawItem& item, const DrawItem*& previous,
+                                     size_t& shader_changes, size_t& texture_changes);
+            void execute();
+        };
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // RENDER_QUEUE_H
@@ -0,0 +1,233 @@
+#include "program_cache.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace Graphics {
+    namespace Shaders {
+
+        namespace {
+            constexpr char BINARY_MAGIC[4] = {'S', 'P', 'B', 'C'};
+            constexpr std::uint32_t BINARY_VERSION = 1;
+
+            // Cabecera de cada fichero, seguida de length bytes del binario
+            struct BinaryHeader {
+                char magic[4];
+                std::uint32_t version;
+                std::uint64_t key;
+                std::uint32_t format;
+                std::uint32_t length;
+            };
+
+            std::uint64_t fnv1a(const std::string& data, std::uint64_t hash = 14695981039346656037ull) {
+                for (unsigned char c : data) {
+                    hash ^= c;
+                    hash *= 1099511628211ull;
+                }
+                // Separador: "ab" + "c" no debe dar lo mismo que "a" + "bc"
+                hash ^= 0xff;
+                hash *= 1099511628211ull;
+                return hash;
+            }
+
+            std::string glString(GLenum name) {
+                const GLubyte* value = glGetString(name);
+                return value ? reinterpret_cast<const char*>(value) : "";
+            }
+
+            std::string toHex(std::uint64_t value) {
+                static const char digits[] = "0123456789abcdef";
+                std::string hex(16, '0');
+                for (int i = 15; i >= 0; --i) {
+                    hex[i] = digits[value & 0xf];
+                    value >>= 4;
+                }
+                return hex;
+            }
+
+            // El nombre del programa se usa como nombre de fichero
+            std::string fileName(const std::string& name) {
+                std::string result = name;
+                for (char& c : result) {
+                    const bool valid = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                                       (c >= '0' && c <= '9') || c == '_';
+                    if (!valid) {
+                        c = '_';
+                    }
+                }
+                return result;
+            }
+        }
+
+        ProgramCache& ProgramCache::getInstance() {
+            static ProgramCache instance;
+            return instance;
+        }
+
+        ProgramCache::ProgramCache()
+            : directory_("shader_cache"), enabled_(true), checked_(false), available_(false), driver_hash_(0) {
+        }
+
+        bool ProgramCache::isAvailable() {
+            if (!enabled_) {
+                return false;
+            }
+
+            if (!checked_) {
+                checked_ = true;
+
+                GLint formats = 0;
+                if (glGetProgramBinary && glProgramBinary) {
+                    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+                }
+                available_ = formats > 0;
+
+                const std::string driver = glString(GL_VENDOR) + "\n" + glString(GL_RENDERER) + "\n" + glString(GL_VERSION);
+                driver_hash_ = fnv1a(driver);
+
+                if (!available_) {
+                    std::cout << "Shader program cache disabled: driver has no program binary formats" << std::endl;
+                }
+            }
+            return available_;
+        }
+
+        std::uint64_t ProgramCache::computeKey(const std::string& vertex_source,
+                                               const std::string& fragment_source,
+                                               const std::string& geometry_source) {
+            if (!isAvailable()) {
+                return 0;
+            }
+
+            std::uint64_t hash = driver_hash_;
+            hash = fnv1a(vertex_source, hash);
+            hash = fnv1a(fragment_source, hash);
+            hash = fnv1a(geometry_source, hash);
+            return hash;
+        }
+
+        std::string ProgramCache::getPath(const std::string& name, std::uint64_t key) const {
+            return directory_ + "/" + fileName(name) + "-" + toHex(key) + ".bin";
+        }
+
+        GLuint ProgramCache::load(const std::string& name, std::uint64_t key) {
+            if (name.empty() || !isAvailable()) {
+                return 0;
+            }
+
+            const std::string path = getPath(name, key);
+            std::ifstream file(path, std::ios::binary);
+            if (!file) {
+                return 0; // Primera ejecución, fuentes editados o driver nuevo
+            }
+
+            BinaryHeader header;
+            std::vector<char> binary;
+            bool valid = static_cast<bool>(file.read(reinterpret_cast<char*>(&header), sizeof(header))) &&
+                         std::equal(header.magic, header.magic + 4, BINARY_MAGIC) &&
+                         header.version == BINARY_VERSION && header.key == key && header.length > 0;
+            if (valid) {
+                binary.resize(header.length);
+                valid = static_cast<bool>(file.read(binary.data(), header.length));
+            }
+            file.close();
+
+            GLuint program = 0;
+            if (valid) {
+                program = glCreateProgram();
+                glProgramBinary(program, header.format, binary.data(), static_cast<GLsizei>(header.length));
+
+                GLint linked = GL_FALSE;
+                glGetProgramiv(program, GL_LINK_STATUS, &linked);
+                if (!linked) {
+                    glDeleteProgram(program);
+                    program = 0;
+                    // Formato desconocido para el driver: GL_INVALID_ENUM
+                    while (glGetError() != GL_NO_ERROR) {
+                    }
+                }
+            }
+
+            if (program == 0) {
+                std::cerr << "WARNING: Discarding cached binary for shader '" << name << "', recompiling" << std::endl;
+                std::error_code error;
+                std::filesystem::remove(path, error);
+            }
+            return program;
+        }
+
+        void ProgramCache::store(const std::string& name, std::uint64_t key, GLuint program) {
+            if (name.empty() || !isAvailable()) {
+                return;
+            }
+
+            GLint length = 0;
+            glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+            if (length <= 0) {
+                return;
+            }
+
+            BinaryHeader header;
+            std::copy(BINARY_MAGIC, BINARY_MAGIC + 4, header.magic);
+            header.version = BINARY_VERSION;
+            header.key = key;
+
+            std::vector<char> binary(length);
+            GLsizei written = 0;
+            GLenum format = 0;
+            glGetProgramBinary(program, length, &written, &format, binary.data());
+            if (written <= 0) {
+                return;
+            }
+            header.format = format;
+            header.length = static_cast<std::uint32_t>(written);
+
+            std::error_code error;
+            std::filesystem::create_directories(directory_, error);
+
+            // Se escribe aparte y se renombra: nunca queda un fichero a medias
+            const std::string path = getPath(name, key);
+            const std::string temp_path = path + ".tmp";
+            {
+                std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+                file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+                file.write(binary.data(), written);
+                if (!file) {
+                    std::cerr << "WARNING: Could not write shader cache file: " << temp_path << std::endl;
+                    file.close();
+                    std::filesystem::remove(temp_path, error);
+                    return;
+                }
+            }
+            std::filesystem::rename(temp_path, path, error);
+            if (error) {
+                std::filesystem::remove(temp_path, error);
+                return;
+            }
+
+            removeOtherVersions(name, key);
+        }
+
+        void ProgramCache::removeOtherVersions(const std::string& name, std::uint64_t key) const {
+            const std::string prefix = fileName(name) + "-";
+            const std::string current = fileName(name) + "-" + toHex(key) + ".bin";
+
+            std::error_code error;
+            std::vector<std::filesystem::path> stale;
+            for (std::filesystem::directory_iterator it(directory_, error), end; !error && it != end; it.increment(error)) {
+                const std::string file = it->path().filename().string();
+                // <nombre>-<16 dígitos>.bin (los nombres no llevan '-'; se ignoran los .tmp)
+                if (file.size() == current.size() && file.compare(0, prefix.size(), prefix) == 0 && file != current) {
+                    stale.push_back(it->path());
+                }
+            }
+
+            for (const auto& path : stale) {
+                std::filesystem::remove(path, error);
+            }
+        }
+
+    } // namespace Shaders
+} // namespace Graphics
@@ -0,0 +1,80 @@
+#ifndef PROGRAM_CACHE_H
+#define PROGRAM_CACHE_H
+
+extern "C" {
+    #include <glad/glad.h>
+}
+
+#include <cstdint>
+#include <string>
+
+namespace Graphics {
+    namespace Shaders {
+
+        /**
+         * @brief Caché en disco de programas enlazados (glGetProgramBinary)
+         *
+         * Cada programa se guarda como <directorio>/<nombre>-<clave>.bin. La
+         * clave es un hash FNV-1a de los fuentes ya expandidos (con sus
+         * #include) y de GL_VENDOR, GL_RENDERER y GL_VERSION: al editar un
+         * shader o actualizar el driver cambia la clave, el binario anterior no
+         * se encuentra y se compila desde el fuente. Si el driver rechaza un
+         * binario (glProgramBinary deja el programa sin enlazar) el fichero se
+         * borra y también se recompila.
+         *
+         * Sólo se activa si el driver ofrece al menos un formato de binario.
+         * Necesita el contexto de OpenGL actual.
+         */
+        class ProgramCache {
+        private:
+            std::string directory_;
+            bool enabled_;
+            bool checked_;   // ya se ha consultado el driver
+            bool available_; // el driver ofrece formatos de binario
+            std::uint64_t driver_hash_;
+
+            ProgramCache();
+
+            std::string getPath(const std::string& name, std::uint64_t key) const;
+            void removeOtherVersions(const std::string& name, std::uint64_t key) const;
+
+        public:
+            static ProgramCache& getInstance();
+
+            // No permitir copia
+            ProgramCache(const ProgramCache&) = delete;
+            ProgramCache& operator=(const ProgramCache&) = delete;
+
+            void setDirectory(const std::string& directory) { directory_ = directory; }
+            const std::string& getDirectory() const { return directory_; }
+            void setEnabled(bool enabled) { enabled_ = enabled; }
+
+            /**
+             * @brief Habilitada y soportada por el driver
+             */
+            bool isAvailable();
+
+            /**
+             * @brief Clave de un programa: fuentes + driver
+             */
+            std::uint64_t computeKey(const std::string& vertex_source,
+                                     const std::string& fragment_source,
+                                     const std::string& geometry_source);
+
+            /**
+             * @brief Crea un programa a partir del binario guardado
+             * @return El programa enlazado, o 0 si no hay binario válido
+             */
+            GLuint load(const std::string& name, std::uint64_t key);
+
+            /**
+             * @brief Guarda el binario de un programa recién enlazado y borra
+             *        los de versiones anteriores del mismo programa
+             */
+            void store(const std::string& name, std::uint64_t key, GLuint program);
+        };
+
+    } // namespace Shaders
+} // namespace Graphics
+
+#endif // PROGRAM_CACHE_H
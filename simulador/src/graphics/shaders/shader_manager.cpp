@@ -1,4 +1,8 @@
 #include "shader_manager.h"
+#include "program_cache.h"
+#include "../rendering/gl_state.h"
+#include <algorithm>
+#include <chrono>
 #include <fstream>
 #include <sstream>
 #include <iostream>
@@ -11,21 +15,22 @@ namespace Graphics {
 
         // === Implementación de Shader ===
 
-        Shader::Shader() : program_id_(0), name_(""), compiled_(false) {
+        Shader::Shader() : program_id_(0), name_(""), compiled_(false), from_cache_(false) {
         }
 
         Shader::Shader(const std::string& name) 
-            : program_id_(0), name_(name), compiled_(false) {
+            : program_id_(0), name_(name), compiled_(false), from_cache_(false) {
         }
 
         Shader::~Shader() {
             if (program_id_ != 0) {
-                glDeleteProgram(program_id_);
+                Rendering::GLState::getInstance().deleteProgram(program_id_);
             }
         }
 
         Shader::Shader(Shader&& other) noexcept 
-            : program_id_(other.program_id_), name_(std::move(other.name_)), compiled_(other.compiled_) {
+            : program_id_(other.program_id_), name_(std::move(other.name_)), compiled_(other.compiled_),
+              from_cache_(other.from_cache_), uniforms_(std::move(other.uniforms_)), missing_uniforms_(std::move(other.missing_uniforms_)) {
             other.program_id_ = 0;
             other.compiled_ = false;
         }
@@ -33,12 +38,15 @@ namespace Graphics {
         Shader& Shader::operator=(Shader&& other) noexcept {
             if (this != &other) {
                 if (program_id_ != 0) {
-                    glDeleteProgram(program_id_);
+                    Rendering::GLState::getInstance().deleteProgram(program_id_);
                 }
                 
                 program_id_ = other.program_id_;
                 name_ = std::move(other.name_);
                 compiled_ = other.compiled_;
+                from_cache_ = other.from_cache_;
+                uniforms_ = std::move(other.uniforms_);
+                missing_uniforms_ = std::move(other.missing_uniforms_);
                 
                 other.program_id_ = 0;
                 other.compiled_ = false;
@@ -46,7 +54,7 @@ namespace Graphics {
             return *this;
         }
 
-        std::string Shader::loadShaderSource(const std::string& filepath) {
+        std::string Shader::loadShaderSource(const std::string& filepath, int depth) {
             std::ifstream file;
             std::stringstream stream;
             
@@ -56,12 +64,45 @@ namespace Graphics {
                 file.open(filepath);
                 stream << file.rdbuf();
                 file.close();
-                return stream.str();
             } catch (std::ifstream::failure& e) {
                 std::cerr << "ERROR: Failed to read shader file: " << filepath << std::endl;
                 std::cerr << "Error: " << e.what() << std::endl;
                 return "";
             }
+
+            // Expandir #include "fichero" (relativo al directorio del shader)
+            const std::string directory = filepath.substr(0, filepath.find_last_of("/\\") + 1);
+            std::string source;
+            std::string line;
+            int line_number = 0;
+
+            while (std::getline(stream, line)) {
+                ++line_number;
+
+                const size_t directive = line.find_first_not_of(" \t");
+                if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0) {
+                    source += line + "\n";
+                    continue;
+                }
+
+                const size_t open = line.find('"', directive);
+                const size_t close = (open == std::string::npos) ? open : line.find('"', open + 1);
+                if (close == std::string::npos || depth >= 4) {
+                    std::cerr << "ERROR: Invalid #include in " << filepath << ":" << line_number << std::endl;
+                    return "";
+                }
+
+                std::string included = loadShaderSource(directory + line.substr(open + 1, close - open - 1), depth + 1);
+                if (included.empty()) {
+                    return "";
+                }
+
+                // #line mantiene los números de línea del fichero en los errores
+                source += included;
+                source += "#line " + std::to_string(line_number + 1) + "\n";
+            }
+
+            return source;
         }
 
         GLuint Shader::compileShader(const std::string& source, GLenum type) {
@@ -85,7 +126,16 @@ namespace Graphics {
         }
 
         bool Shader::linkProgram(GLuint vertex_shader, GLuint fragment_shader, GLuint geometry_shader) {
+            // Al recargar se sustituye el programa anterior
+            if (program_id_ != 0) {
+                Rendering::GLState::getInstance().deleteProgram(program_id_);
+            }
             program_id_ = glCreateProgram();
+
+            // Sin la pista algunos drivers no guardan el binario
+            if (ProgramCache::getInstance().isAvailable()) {
+                glProgramParameteri(program_id_, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+            }
             
             glAttachShader(program_id_, vertex_shader);
             glAttachShader(program_id_, fragment_shader);
@@ -105,10 +155,62 @@ namespace Graphics {
             if (geometry_shader != 0) {
                 glDeleteShader(geometry_shader);
             }
+
+            if (compiled_) {
+                introspectUniforms();
+            }
             
             return compiled_;
         }
 
+        void Shader::introspectUniforms() {
+            uniforms_.clear();
+            missing_uniforms_.clear();
+
+            GLint count = 0;
+            GLint max_length = 0;
+            glGetProgramiv(program_id_, GL_ACTIVE_UNIFORMS, &count);
+            glGetProgramiv(program_id_, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_length);
+
+            std::vector<GLchar> buffer(std::max(max_length, 1));
+
+            for (GLint i = 0; i < count; ++i) {
+                GLsizei length = 0;
+                GLint size = 0;
+                GLenum type = 0;
+                glGetActiveUniform(program_id_, static_cast<GLuint>(i), static_cast<GLsizei>(buffer.size()),
+                                   &length, &size, &type, buffer.data());
+
+                std::string name(buffer.data(), length);
+                GLint location = glGetUniformLocation(program_id_, name.c_str());
+                if (location == -1) {
+                    continue; // Miembro de un bloque de uniformes (no tiene ubicación)
+                }
+
+                // Los arrays de tipos básicos aparecen una vez como "nombre[0]":
+                // se añaden el nombre sin índice y cada elemento
+                const std::string suffix = "[0]";
+                if (name.size() > suffix.size() &&
+                    name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+                    std::string base = name.substr(0, name.size() - suffix.size());
+                    uniforms_.push_back({base, location, type});
+
+                    for (GLint element = 0; element < size; ++element) {
+                        std::string element_name = base + "[" + std::to_string(element) + "]";
+                        GLint element_location = glGetUniformLocation(program_id_, element_name.c_str());
+                        if (element_location != -1) {
+                            uniforms_.push_back({element_name, element_location, type});
+                        }
+                    }
+                } else {
+                    uniforms_.push_back({name, location, type});
+                }
+            }
+
+            std::sort(uniforms_.begin(), uniforms_.end(),
+                      [](const UniformEntry& a, const UniformEntry& b) { return a.name < b.name; });
+        }
+
         void Shader::checkCompileErrors(GLuint shader, const std::string& type) {
             GLint success;
             GLchar info_log[1024];
@@ -162,6 +264,22 @@ namespace Graphics {
                                   const std::string& geometry_source) {
             
             compiled_ = false;
+            from_cache_ = false;
+
+            // Binario ya enlazado de una ejecución anterior con los mismos fuentes y driver
+            auto& cache = ProgramCache::getInstance();
+            const std::uint64_t cache_key = cache.computeKey(vertex_source, fragment_source, geometry_source);
+            GLuint cached_program = cache.load(name_, cache_key);
+            if (cached_program != 0) {
+                if (program_id_ != 0) {
+                    Rendering::GLState::getInstance().deleteProgram(program_id_);
+                }
+                program_id_ = cached_program;
+                compiled_ = true;
+                from_cache_ = true;
+                introspectUniforms();
+                return true;
+            }
             
             // Compilar shaders
             GLuint vertex_shader = compileShader(vertex_source, GL_VERTEX_SHADER);
@@ -184,24 +302,82 @@ namespace Graphics {
             }
             
             // Enlazar programa
-            return linkProgram(vertex_shader, fragment_shader, geometry_shader);
+            if (!linkProgram(vertex_shader, fragment_shader, geometry_shader)) {
+                return false;
+            }
+
+            cache.store(name_, cache_key, program_id_);
+            return true;
         }
 
         void Shader::use() const {
             if (compiled_ && program_id_ != 0) {
-                glUseProgram(program_id_);
+                Rendering::GLState::getInstance().useProgram(program_id_);
             }
         }
 
         void Shader::unuse() const {
-            glUseProgram(0);
+            Rendering::GLState::getInstance().useProgram(0);
+        }
+
+        const Shader::UniformEntry* Shader::findUniform(const std::string& name) const {
+            auto it = std::lower_bound(uniforms_.begin(), uniforms_.end(), name,
+                                       [](const UniformEntry& entry, const std::string& key) { return entry.name < key; });
+            if (it != uniforms_.end() && it->name == name) {
+                return &(*it);
+            }
+            return nullptr;
         }
 
         GLint Shader::getUniformLocation(const std::string& name) const {
-            GLint location = glGetUniformLocation(program_id_, name.c_str());
-            if (location == -1) {
+            const UniformEntry* entry = findUniform(name);
+            if (entry) {
+                return entry->location;
+            }
+
+            if (missing_uniforms_.insert(name).second) {
                 std::cerr << "WARNING: Uniform '" << name << "' not found in shader '" << name_ << "'" << std::endl;
             }
+            return -1;
+        }
+
+        bool Shader::bindUniformBlock(const std::string& block_name, GLuint binding) const {
+            GLuint index = glGetUniformBlockIndex(program_id_, block_name.c_str());
+            if (index == GL_INVALID_INDEX) {
+                return false;
+            }
+
+            glUniformBlockBinding(program_id_, index, binding);
+            return true;
+        }
+
+        GLint Shader::resolveUniform(const std::string& name, GLenum type) const {
+            GLint location = getUniformLocation(name);
+            if (location == -1) {
+                return -1;
+            }
+
+            // bool, int y samplers se asignan todos con glUniform1i
+            auto is_integer = [](GLenum t) {
+                switch (t) {
+                    case GL_BOOL: case GL_INT:
+                    case GL_SAMPLER_1D: case GL_SAMPLER_2D: case GL_SAMPLER_3D: case GL_SAMPLER_CUBE:
+                    case GL_SAMPLER_2D_SHADOW: case GL_SAMPLER_2D_ARRAY: case GL_SAMPLER_BUFFER:
+                    case GL_INT_SAMPLER_BUFFER: case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+                        return true;
+                    default:
+                        return false;
+                }
+            };
+
+            GLenum actual = findUniform(name)->type;
+            if (actual != type && !(is_integer(actual) && is_integer(type))) {
+                if (missing_uniforms_.insert(name).second) {
+                    std::cerr << "WARNING: Uniform '" << name << "' in shader '" << name_
+                              << "' has a different type (0x" << std::hex << actual << std::dec << ")" << std::endl;
+                }
+                return -1;
+            }
             return location;
         }
 
@@ -264,15 +440,26 @@ namespace Graphics {
                                      const std::string& fragment_path,
                                      const std::string& geometry_path) {
             
+            auto start = std::chrono::steady_clock::now();
             auto shader = std::make_unique<Shader>(name);
             
             if (!shader->loadFromFiles(vertex_path, fragment_path, geometry_path)) {
                 std::cerr << "Failed to load shader: " << name << std::endl;
                 return false;
             }
+
+            const double milliseconds =
+                std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            load_timings_.push_back({name, milliseconds, shader->isFromCache()});
             
+            for (const auto& block : uniform_blocks_) {
+                shader->bindUniformBlock(block.first, block.second);
+            }
+
+            const bool from_cache = shader->isFromCache();
             shaders_[name] = std::move(shader);
-            std::cout << "Shader loaded successfully: " << name << std::endl;
+            std::cout << "Shader loaded successfully: " << name << " (" << (from_cache ? "cached binary" : "compiled")
+                      << ", " << milliseconds << " ms)" << std::endl;
             return true;
         }
 
@@ -286,6 +473,14 @@ namespace Graphics {
             return nullptr;
         }
 
+        void ShaderManager::registerUniformBlock(const std::string& block_name, GLuint binding) {
+            uniform_blocks_[block_name] = binding;
+
+            for (const auto& entry : shaders_) {
+                entry.second->bindUniformBlock(block_name, binding);
+            }
+        }
+
         void ShaderManager::removeShader(const std::string& name) {
             shaders_.erase(name);
         }
@@ -302,5 +497,20 @@ namespace Graphics {
             return shaders_.size();
         }
 
+        void ShaderManager::printLoadTimings() const {
+            double total = 0.0;
+            size_t cached = 0;
+
+            std::cout << "Shader load times:" << std::endl;
+            for (const auto& timing : load_timings_) {
+                std::cout << "  " << timing.name << ": " << timing.milliseconds << " ms"
+                          << (timing.from_cache ? " (cached binary)" : " (compiled)") << std::endl;
+                total += timing.milliseconds;
+                cached += timing.from_cache ? 1 : 0;
+            }
+            std::cout << "  total: " << total << " ms, " << cached << "/" << load_timings_.size()
+                      << " from cache" << std::endl;
+        }
+
     } // namespace Shaders
 } // namespace Graphics
\ No newline at end of file
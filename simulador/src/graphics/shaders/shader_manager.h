@@ -7,6 +7,8 @@ extern "C" {
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include <memory>
 #include <glm/glm.hpp>
 #include <glm/gtc/type_ptr.hpp>
@@ -14,17 +16,87 @@ extern "C" {
 namespace Graphics {
     namespace Shaders {
 
+        // === Uniformes con tipo ===
+
+        namespace detail {
+            // Tipo GLSL esperado para cada tipo de C++
+            template <typename T> struct UniformType;
+            template <> struct UniformType<bool>      { static constexpr GLenum value = GL_BOOL; };
+            template <> struct UniformType<int>       { static constexpr GLenum value = GL_INT; };
+            template <> struct UniformType<float>     { static constexpr GLenum value = GL_FLOAT; };
+            template <> struct UniformType<glm::vec2> { static constexpr GLenum value = GL_FLOAT_VEC2; };
+            template <> struct UniformType<glm::vec3> { static constexpr GLenum value = GL_FLOAT_VEC3; };
+            template <> struct UniformType<glm::vec4> { static constexpr GLenum value = GL_FLOAT_VEC4; };
+            template <> struct UniformType<glm::mat2> { static constexpr GLenum value = GL_FLOAT_MAT2; };
+            template <> struct UniformType<glm::mat3> { static constexpr GLenum value = GL_FLOAT_MAT3; };
+            template <> struct UniformType<glm::mat4> { static constexpr GLenum value = GL_FLOAT_MAT4; };
+
+            inline void uniform(GLint location, bool value)             { glUniform1i(location, static_cast<int>(value)); }
+            inline void uniform(GLint location, int value)              { glUniform1i(location, value); }
+            inline void uniform(GLint location, float value)            { glUniform1f(location, value); }
+            inline void uniform(GLint location, const glm::vec2& value) { glUniform2fv(location, 1, &value[0]); }
+            inline void uniform(GLint location, const glm::vec3& value) { glUniform3fv(location, 1, &value[0]); }
+            inline void uniform(GLint location, const glm::vec4& value) { glUniform4fv(location, 1, &value[0]); }
+            inline void uniform(GLint location, const glm::mat2& value) { glUniformMatrix2fv(location, 1, GL_FALSE, &value[0][0]); }
+            inline void uniform(GLint location, const glm::mat3& value) { glUniformMatrix3fv(location, 1, GL_FALSE, &value[0][0]); }
+            inline void uniform(GLint location, const glm::mat4& value) { glUniformMatrix4fv(location, 1, GL_FALSE, &value[0][0]); }
+        }
+
+        /**
+         * @brief Uniforme ya resuelto de un programa (handle con tipo)
+         *
+         * Se obtiene una vez con Shader::getUniform<T>() después de cargar el
+         * shader; set() llama directamente a glUniform* sin buscar el nombre ni
+         * crear strings. Como los set* de Shader, actúa sobre el programa en uso.
+         * Un uniforme que no existe (o que el compilador de GLSL ha eliminado)
+         * da un handle inválido y set() no tiene efecto, igual que glUniform*
+         * con ubicación -1. Al recargar el shader hay que volver a obtenerlo.
+         */
+        template <typename T>
+        class Uniform {
+        private:
+            GLint location_;
+
+        public:
+            Uniform() : location_(-1) {}
+            explicit Uniform(GLint location) : location_(location) {}
+
+            void set(const T& value) const { detail::uniform(location_, value); }
+
+            GLint getLocation() const { return location_; }
+            bool isValid() const { return location_ != -1; }
+        };
+
         class Shader {
         private:
+            /**
+             * @brief Entrada de la tabla de uniformes del programa enlazado
+             */
+            struct UniformEntry {
+                std::string name;
+                GLint location;
+                GLenum type;
+            };
+
             GLuint program_id_;
             std::string name_;
             bool compiled_;
+            // El último programa cargado salió de ProgramCache
+            bool from_cache_;
+
+            // Uniformes activos ordenados por nombre (se rellena al enlazar)
+            std::vector<UniformEntry> uniforms_;
+            // Nombres ya avisados como inexistentes (un aviso por nombre)
+            mutable std::unordered_set<std::string> missing_uniforms_;
             
             // Métodos auxiliares privados
-            std::string loadShaderSource(const std::string& filepath);
+            std::string loadShaderSource(const std::string& filepath, int depth = 0);
             GLuint compileShader(const std::string& source, GLenum type);
             bool linkProgram(GLuint vertex_shader, GLuint fragment_shader, GLuint geometry_shader = 0);
             void checkCompileErrors(GLuint shader, const std::string& type);
+            void introspectUniforms();
+            const UniformEntry* findUniform(const std::string& name) const;
+            GLint resolveUniform(const std::string& name, GLenum type) const;
 
         public:
             Shader();
@@ -53,6 +125,7 @@ namespace Graphics {
             GLuint getProgramId() const { return program_id_; }
             const std::string& getName() const { return name_; }
             bool isCompiled() const { return compiled_; }
+            bool isFromCache() const { return from_cache_; }
 
             // Métodos para establecer uniformes
             void setBool(const std::string& name, bool value) const;
@@ -69,13 +142,49 @@ namespace Graphics {
             void setMat4(const std::string& name, const float* value) const;
             void setVec3(const std::string& name, float x, float y, float z) const;
 
+            /**
+             * @brief Handle con tipo de un uniforme, para el código que se
+             *        ejecuta cada frame
+             *
+             * Avisa (una vez) si el uniforme no existe o si su tipo GLSL no
+             * corresponde a T.
+             */
+            template <typename T>
+            Uniform<T> getUniform(const std::string& name) const {
+                return Uniform<T>(resolveUniform(name, detail::UniformType<T>::value));
+            }
+
+            /**
+             * @brief Enlaza un bloque de uniformes del programa a un punto de binding
+             * @return false si el programa no declara el bloque
+             */
+            bool bindUniformBlock(const std::string& block_name, GLuint binding) const;
+
+            /**
+             * @brief Número de ubicaciones en la tabla de uniformes
+             */
+            size_t getUniformCount() const { return uniforms_.size(); }
+
         private:
             GLint getUniformLocation(const std::string& name) const;
         };
 
+        /**
+         * @brief Tiempo de carga de un shader (lectura, compilación o caché)
+         */
+        struct ShaderLoadTiming {
+            std::string name;
+            double milliseconds;
+            bool from_cache;
+        };
+
         class ShaderManager {
         private:
             std::unordered_map<std::string, std::unique_ptr<Shader>> shaders_;
+            // Tiempos de carga en el orden en que se cargaron
+            std::vector<ShaderLoadTiming> load_timings_;
+            // Bloques de uniformes compartidos y su punto de binding
+            std::unordered_map<std::string, GLuint> uniform_blocks_;
             static std::unique_ptr<ShaderManager> instance_;
 
         public:
@@ -95,12 +204,26 @@ namespace Graphics {
                           const std::string& geometry_path = "");
 
             Shader* getShader(const std::string& name);
+
+            /**
+             * @brief Registra un bloque de uniformes compartido: se enlaza a
+             *        binding en todos los shaders que lo declaren, los ya
+             *        cargados y los que se carguen después
+             */
+            void registerUniformBlock(const std::string& block_name, GLuint binding);
             void removeShader(const std::string& name);
             void clear();
             
             // Utilidades
             bool hasShader(const std::string& name) const;
             size_t getShaderCount() const;
+
+            const std::vector<ShaderLoadTiming>& getLoadTimings() const { return load_timings_; }
+
+            /**
+             * @brief Imprime el tiempo de carga de cada shader y el total
+             */
+            void printLoadTimings() const;
         };
 
     } // namespace Shaders
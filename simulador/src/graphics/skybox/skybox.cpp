@@ -1,5 +1,6 @@
 #include "skybox.h"
 #include "../shaders/shader_manager.h"
+#include "../rendering/gl_state.h"
 #include <stb_image.h>
 #include <iostream>
 #include <filesystem>
@@ -119,6 +120,15 @@ namespace Graphics {
                 return false;
             }
 
+            // Uniformes constantes del skybox: se fijan una vez en el programa
+            Shaders::Shader* shader = shader_manager.getShader(shader_name_);
+            shader->use();
+            shader->setFloat("skyFogScale", 13333.0f);   // menor impacto global (densidad de la escena 6e-5)
+            shader->setFloat("skyFogMax", 0.8f);         // tope más bajo
+            shader->setFloat("skyFogExponent", 2.5f);    // banda más fina en el horizonte
+            shader->setInt("skybox", 0);
+            shader->unuse();
+
             initialized_ = true;
             std::cout << "Skybox initialized successfully" << std::endl;
             return true;
@@ -126,7 +136,7 @@ namespace Graphics {
 
         bool Skybox::loadCubemap(const std::vector<std::string>& faces_paths, bool flip_y) {
             glGenTextures(1, &texture_id_);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
 
             stbi_set_flip_vertically_on_load(flip_y);
 
@@ -160,18 +170,19 @@ namespace Graphics {
             glGenVertexArrays(1, &VAO_);
             glGenBuffers(1, &VBO_);
 
-            glBindVertexArray(VAO_);
-            glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+            Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+            gl_state.bindVertexArray(VAO_);
+            gl_state.bindBuffer(GL_ARRAY_BUFFER, VBO_);
             glBufferData(GL_ARRAY_BUFFER, sizeof(skybox_vertices_), &skybox_vertices_, GL_STATIC_DRAW);
 
             // Posiciones (location = 0)
             glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
             glEnableVertexAttribArray(0);
 
-            glBindVertexArray(0);
+            gl_state.bindVertexArray(0);
         }
 
-        void Skybox::render(const glm::mat4& view, const glm::mat4& projection, bool fog_enabled) {
+        void Skybox::render() {
             if (!initialized_) return;
 
             // Obtener shader del ShaderManager
@@ -182,51 +193,36 @@ namespace Graphics {
                 return;
             }
 
+            Rendering::GLState& gl_state = Rendering::GLState::getInstance();
+
             // Cambiar depth function para que el skybox se dibuje en el fondo
-            glDepthFunc(GL_LEQUAL);
+            gl_state.depthFunc(GL_LEQUAL);
             
+            // La vista sin traslación se calcula en el vertex shader
             shader->use();
             
-            // Remover translación de la matriz view para el skybox
-            glm::mat4 skybox_view = glm::mat4(glm::mat3(view));
-            
-            // Set uniforms
-            shader->setMat4("view", skybox_view);
-            shader->setMat4("projection", projection);
-            
-            // Configurar niebla para el skybox (alineada con el terreno)
-            shader->setBool("fogEnabled", fog_enabled);
-            shader->setFloat("fogDensity", 0.0001f);
-            shader->setVec3("fogColor", glm::vec3(0.85f, 0.90f, 0.95f));
-            shader->setFloat("skyFogScale", 8000.0f);    // menor impacto global
-            shader->setFloat("skyFogMax", 0.8f);         // tope más bajo
-            shader->setFloat("skyFogExponent", 2.5f);    // banda más fina en el horizonte
-            
             // Bind skybox texture
-            glActiveTexture(GL_TEXTURE0);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
-            shader->setInt("skybox", 0);
+            gl_state.bindTexture(0, GL_TEXTURE_CUBE_MAP, texture_id_);
             
             // Render skybox cube
-            glBindVertexArray(VAO_);
+            gl_state.bindVertexArray(VAO_);
             glDrawArrays(GL_TRIANGLES, 0, 36);
-            glBindVertexArray(0);
             
             // Restaurar depth function
-            glDepthFunc(GL_LESS);
+            gl_state.depthFunc(GL_LESS);
         }
 
         void Skybox::cleanup() {
             if (VAO_) {
-                glDeleteVertexArrays(1, &VAO_);
+                Rendering::GLState::getInstance().deleteVertexArray(VAO_);
                 VAO_ = 0;
             }
             if (VBO_) {
-                glDeleteBuffers(1, &VBO_);
+                Rendering::GLState::getInstance().deleteBuffer(VBO_);
                 VBO_ = 0;
             }
             if (texture_id_) {
-                glDeleteTextures(1, &texture_id_);
+                Rendering::GLState::getInstance().deleteTexture(texture_id_);
                 texture_id_ = 0;
             }
             initialized_ = false;
@@ -53,7 +53,8 @@ namespace Graphics {
             Skybox& operator=(Skybox&& other) noexcept;
 
             bool initialize(const SkyboxConfig& config = SkyboxConfig::createDefault());
-            void render(const glm::mat4& view, const glm::mat4& projection, bool fog_enabled = true);
+            // Cámara y niebla del bloque FrameData del frame
+            void render();
             void cleanup();
 
             bool isInitialized() const { return initialized_; }
@@ -1,4 +1,5 @@
 #include "texture_manager.h"
+#include "../rendering/gl_state.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../../include/stb_image.h"
@@ -31,7 +32,7 @@ namespace Graphics {
 
         Texture::~Texture() {
             if (texture_id_ != 0) {
-                glDeleteTextures(1, &texture_id_);
+                Rendering::GLState::getInstance().deleteTexture(texture_id_);
             }
         }
 
@@ -49,7 +50,7 @@ namespace Graphics {
         Texture& Texture::operator=(Texture&& other) noexcept {
             if (this != &other) {
                 if (texture_id_ != 0) {
-                    glDeleteTextures(1, &texture_id_);
+                    Rendering::GLState::getInstance().deleteTexture(texture_id_);
                 }
                 
                 texture_id_ = other.texture_id_;
@@ -75,7 +76,7 @@ namespace Graphics {
         void Texture::applyParameters() {
             GLenum target = (type_ == TextureType::TEXTURE_2D) ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
             
-            glBindTexture(target, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(target, texture_id_);
             
             glTexParameteri(target, GL_TEXTURE_MIN_FILTER, static_cast<GLint>(min_filter_));
             glTexParameteri(target, GL_TEXTURE_MAG_FILTER, static_cast<GLint>(mag_filter_));
@@ -86,7 +87,7 @@ namespace Graphics {
                 glTexParameteri(target, GL_TEXTURE_WRAP_R, static_cast<GLint>(wrap_r_));
             }
             
-            glBindTexture(target, 0);
+            Rendering::GLState::getInstance().bindTexture(target, 0);
         }
 
         bool Texture::loadImageData(const std::string& filepath, unsigned char*& data,
@@ -117,7 +118,7 @@ namespace Graphics {
 
             // Generar textura
             glGenTextures(1, &texture_id_);
-            glBindTexture(GL_TEXTURE_2D, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id_);
 
             // Determinar formato
             GLenum format, internal_format;
@@ -145,7 +146,7 @@ namespace Graphics {
             applyParameters();
             
             stbi_image_free(data);
-            glBindTexture(GL_TEXTURE_2D, 0);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, 0);
             
             loaded_ = true;
             std::cout << "Texture loaded: " << filepath << " (" << width_ << "x" << height_ 
@@ -177,14 +178,14 @@ namespace Graphics {
 
             // Generar textura
             glGenTextures(1, &texture_id_);
-            glBindTexture(GL_TEXTURE_2D, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id_);
             
             glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width_, height_, 0, GL_RGBA, GL_UNSIGNED_BYTE, data.data());
             
             generateMipmaps();
             applyParameters();
             
-            glBindTexture(GL_TEXTURE_2D, 0);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, 0);
             
             loaded_ = true;
             std::cout << "Procedural texture created: " << width_ << "x" << height_ << std::endl;
@@ -203,13 +204,13 @@ namespace Graphics {
             format_ = format;
 
             glGenTextures(1, &texture_id_);
-            glBindTexture(GL_TEXTURE_2D, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id_);
             
             glTexImage2D(GL_TEXTURE_2D, 0, static_cast<GLenum>(format), width, height, 0, 
                         static_cast<GLenum>(format), GL_UNSIGNED_BYTE, nullptr);
             
             applyParameters();
-            glBindTexture(GL_TEXTURE_2D, 0);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, 0);
             
             loaded_ = true;
             return true;
@@ -227,7 +228,7 @@ namespace Graphics {
             }
 
             glGenTextures(1, &texture_id_);
-            glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
 
             bool success = true;
             for (const auto& face_texture : face_textures) {
@@ -284,12 +285,12 @@ namespace Graphics {
                 std::cout << "Cubemap loaded successfully (" << width_ << "x" << height_ << ")" << std::endl;
             } else {
                 if (texture_id_ != 0) {
-                    glDeleteTextures(1, &texture_id_);
+                    Rendering::GLState::getInstance().deleteTexture(texture_id_);
                     texture_id_ = 0;
                 }
             }
 
-            glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+            Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
             return success;
         }
 
@@ -319,20 +320,20 @@ namespace Graphics {
         void Texture::bind(unsigned int unit) const {
             if (!loaded_) return;
             
-            glActiveTexture(GL_TEXTURE0 + unit);
+            Rendering::GLState::getInstance().activeTexture(unit);
             
             if (type_ == TextureType::TEXTURE_2D) {
-                glBindTexture(GL_TEXTURE_2D, texture_id_);
+                Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id_);
             } else if (type_ == TextureType::TEXTURE_CUBE_MAP) {
-                glBindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
+                Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_CUBE_MAP, texture_id_);
             }
         }
 
         void Texture::unbind() const {
             if (type_ == TextureType::TEXTURE_2D) {
-                glBindTexture(GL_TEXTURE_2D, 0);
+                Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, 0);
             } else if (type_ == TextureType::TEXTURE_CUBE_MAP) {
-                glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
+                Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_CUBE_MAP, 0);
             }
         }
 
@@ -367,9 +368,9 @@ namespace Graphics {
             float color[] = {r, g, b, a};
             GLenum target = (type_ == TextureType::TEXTURE_2D) ? GL_TEXTURE_2D : GL_TEXTURE_CUBE_MAP;
             
-            glBindTexture(target, texture_id_);
+            Rendering::GLState::getInstance().bindTexture(target, texture_id_);
             glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, color);
-            glBindTexture(target, 0);
+            Rendering::GLState::getInstance().bindTexture(target, 0);
         }
 
         void Texture::generateMipmaps() {
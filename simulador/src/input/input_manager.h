@@ -208,6 +208,8 @@ namespace Input
         static constexpr int KEY_C = GLFW_KEY_C;
         static constexpr int KEY_X = GLFW_KEY_X;
         static constexpr int KEY_J = GLFW_KEY_J; // Toggle joystick controls
+        static constexpr int KEY_L = GLFW_KEY_L; // Luces de pista
+        static constexpr int KEY_V = GLFW_KEY_V; // Vegetación y edificios
     };
 
     // Clase auxiliar para manejar acciones específicas
@@ -26,14 +26,19 @@
 #include "graphics/shaders/shader_manager.h"
 #include "graphics/textures/texture_manager.h"
 #include "graphics/rendering/buffer_objects.h"
+#include "graphics/rendering/frame_uniforms.h"
+#include "graphics/rendering/render_queue.h"
+#include "graphics/rendering/gl_state.h"
 #include "graphics/skybox/skybox.h"
 #include "graphics/lighting/light_manager.h"
+#include "graphics/lighting/clustered_lights.h"
 
 // Scene System
 #include "scene/mesh.h"
 #include "scene/camera.h"
 #include "scene/terrain.h"
 #include "scene/chunked_terrain.h"
+#include "scene/scenery.h"
 #include "scene/model.h"
 #include "utils/assimp_loader.h"
 
@@ -80,10 +85,12 @@ private:
     std::unique_ptr<Model> plane_model_;
     std::unique_ptr<CameraController> camera_controller_;
     std::unique_ptr<Skybox> skybox_;
+    std::unique_ptr<Scenery> scenery_; // antes del terreno: sus hilos lo usan
     std::unique_ptr<ChunkedTerrain> chunked_terrain_;
 
     // Lighting System
     std::unique_ptr<LightManager> light_manager_;
+    std::unique_ptr<ClusteredLights> clustered_lights_;
 
     // UI Systems
     std::unique_ptr<BankAngleIndicator> bank_angle_indicator_;
@@ -92,6 +99,34 @@ private:
     // Physics System
     std::unique_ptr<Physics::FlightDynamicsManager> flight_dynamics_;
 
+    // Uniform buffer por frame (cámara, niebla y luces)
+    std::unique_ptr<FrameUniforms> frame_uniforms_;
+
+    // Cola de dibujo ordenada por clave, con una fuente por objeto de escena
+    std::unique_ptr<RenderQueue> render_queue_;
+
+    /**
+     * @brief Uniformes por objeto de los shaders de escena, resueltos una vez
+     *        al cargarlos (sin búsqueda por nombre al dibujar)
+     */
+    struct SceneUniforms
+    {
+        Uniform<glm::mat4> model;
+        Uniform<bool> use_texture;
+        Uniform<bool> use_uniform_color;
+
+        void resolve(const Shader *shader)
+        {
+            model = shader->getUniform<glm::mat4>("model");
+            use_texture = shader->getUniform<bool>("useTexture");
+            use_uniform_color = shader->getUniform<bool>("useUniformColor");
+        }
+    };
+
+    SceneUniforms basic_uniforms_;
+    SceneUniforms terrain_uniforms_;
+    Uniform<glm::vec3> scenery_color_;
+
     // Application State
     struct AppState
     {
@@ -103,6 +138,9 @@ private:
         float last_frame = 0.0f;
         int terrain_size = 3;
         bool use_textured_terrain = true;
+        int turbulence_level = 0; // 0 calma, 1 ligera, 2 moderada, 3 severa
+        bool runway_lights = false;
+        bool show_scenery = true;
     } app_state_;
 
     // Third-person camera state
@@ -128,8 +166,12 @@ private:
         bool num2_pressed = false;
         bool c_pressed = false;
         bool x_pressed = false; // (sin uso)
-        bool y_pressed = false; // (sin uso)
+        bool y_pressed = false; // ciclo de turbulencia
         bool j_pressed = false; // toggle joystick
+        bool p_pressed = false; // toggle replay
+        bool enter_pressed = false; // recuperar tras contacto con el terreno
+        bool l_pressed = false;     // luces de pista
+        bool v_pressed = false;     // vegetación y edificios
     } input_state_;
 
 public:
@@ -198,6 +240,12 @@ public:
             return false;
         }
 
+        // 7. Fuentes de la cola de dibujo
+        registerRenderSources();
+
+        // Compilados en el primer arranque, binarios de shader_cache/ en los siguientes
+        ShaderManager::getInstance().printLoadTimings();
+
         std::cout << "=== Engine initialized successfully! ===" << std::endl;
         return true;
     }
@@ -264,6 +312,10 @@ private:
         auto &shader_manager = ShaderManager::getInstance();
         auto &texture_manager = TextureManager::getInstance();
 
+        // Bloque de datos por frame compartido por los shaders de escena
+        frame_uniforms_ = std::make_unique<FrameUniforms>();
+        shader_manager.registerUniformBlock(FrameUniforms::BLOCK_NAME, FrameUniforms::BINDING);
+
         // Cargar shaders
         if (!shader_manager.loadShader("basic_3d", "shaders/vertex_3d.glsl", "shaders/fragment_3d.glsl"))
         {
@@ -285,6 +337,23 @@ private:
             return false;
         }
 
+        basic_uniforms_.resolve(shader_manager.getShader("basic_3d"));
+        terrain_uniforms_.resolve(shader_manager.getShader("terrain_faceted_green"));
+        scenery_color_ = shader_manager.getShader("instanced_3d")->getUniform<glm::vec3>("objectColor");
+
+        // Luces puntuales por clusters (basic_3d las lee de buffer textures)
+        clustered_lights_ = std::make_unique<ClusteredLights>();
+        ClusteredLights::setSamplers(shader_manager.getShader("basic_3d"));
+
+        // Las texturas de los shaders de escena van siempre en la unidad 0
+        for (const char *name : {"basic_3d", "instanced_3d"})
+        {
+            Shader *scene_shader = shader_manager.getShader(name);
+            scene_shader->use();
+            scene_shader->setInt("ourTexture", 0);
+            scene_shader->unuse();
+        }
+
         // Cargar texturas
         if (!texture_manager.loadTexture2D("container", "textures/container.jpg", true))
         {
@@ -388,6 +457,20 @@ private:
                 std::cerr << "Failed to create chunked terrain" << std::endl;
                 return false;
             }
+
+            // Árboles y edificios: se reparten al construir cada chunk
+            scenery_ = std::make_unique<Scenery>(ctc.noise_seed);
+            if (scenery_->initialize(ctc))
+            {
+                // Pista de 2400 m en el eje Z y la aproximación (createRunwayLights)
+                scenery_->addClearArea(glm::vec2(-300.0f, -1600.0f), glm::vec2(300.0f, 2000.0f));
+                chunked_terrain_->setScenery(scenery_.get());
+            }
+            else
+            {
+                std::cerr << "Warning: Could not create scenery" << std::endl;
+                scenery_.reset();
+            }
         }
 
         // Obtener altura del terreno en el origen (donde queremos el cubo)
@@ -439,6 +522,9 @@ private:
             }
         }
 
+        // Luces de pista sobre el terreno (apagadas hasta pulsar L)
+        createRunwayLights();
+
         // Inicializar skybox
         skybox_ = std::make_unique<Skybox>();
         if (!skybox_->initialize())
@@ -455,6 +541,189 @@ private:
         return true;
     }
 
+    /**
+     * @brief Crea las luces de una pista de 2400 m en el eje Z centrada en el
+     *        origen: borde, cabeceras y aproximación (~170 luces puntuales)
+     */
+    void createRunwayLights()
+    {
+        if (!light_manager_ || !chunked_terrain_)
+            return;
+
+        const float half_length = 1200.0f;
+        const float half_width = 22.5f;
+        const float light_height = 1.0f; // sobre el terreno
+
+        auto add_light = [this, light_height](float x, float z, const glm::vec3 &color)
+        {
+            // Sobre la malla dibujada, no sobre el ruido (difieren entre vértices)
+            PointLight light(glm::vec3(x, chunked_terrain_->getSurfaceHeightAt(x, z) + light_height, z), "runway_light");
+            light.setAmbient(color * 0.05f);
+            light.setDiffuse(color);
+            light.setSpecular(color);
+            light.setAttenuation(1.0f, 0.14f, 0.07f);
+            light.setEnabled(false);
+            light_manager_->addPointLight(std::move(light));
+        };
+
+        const glm::vec3 white(1.0f, 0.95f, 0.8f);
+        const glm::vec3 green(0.2f, 1.0f, 0.3f);
+        const glm::vec3 red(1.0f, 0.15f, 0.1f);
+
+        // Borde: cada 60 m a ambos lados
+        for (float z = -half_length; z <= half_length; z += 60.0f)
+        {
+            add_light(-half_width, z, white);
+            add_light(half_width, z, white);
+        }
+
+        // Cabeceras: verde en la de entrada (+Z), rojo en la de salida
+        for (float x = -half_width; x <= half_width; x += 6.0f)
+        {
+            add_light(x, half_length + 3.0f, green);
+            add_light(x, -half_length - 3.0f, red);
+        }
+
+        // Aproximación: barras de 5 luces cada 30 m durante 450 m
+        for (float d = 30.0f; d <= 450.0f; d += 30.0f)
+        {
+            for (float x = -6.0f; x <= 6.0f; x += 3.0f)
+            {
+                add_light(x, half_length + d, white);
+            }
+        }
+
+        std::cout << "  - Runway lights created: " << light_manager_->getPointLightCount() << std::endl;
+    }
+
+    /**
+     * @brief Registra en la cola de dibujo una fuente por objeto de escena
+     *
+     * Cada fuente envía sus elementos con la pasada, el shader, la textura y
+     * la profundidad; la cola decide el orden. Un objeto nuevo sólo necesita
+     * su fuente aquí.
+     */
+    void registerRenderSources()
+    {
+        render_queue_ = std::make_unique<RenderQueue>();
+
+        auto &shader_manager = ShaderManager::getInstance();
+        Shader *basic_shader = shader_manager.getShader("basic_3d");
+        Shader *faceted_shader = shader_manager.getShader("terrain_faceted_green");
+
+        // Textura 2D de la unidad 0 (fallback si no se cargó), 0 sin texturas
+        auto texture_id = [this](const char *name) -> GLuint
+        {
+            if (!app_state_.use_texture)
+                return 0;
+            auto &texture_manager = TextureManager::getInstance();
+            Texture *texture = texture_manager.getTexture(name);
+            if (!texture)
+                texture = texture_manager.getTexture("fallback");
+            return texture ? texture->getId() : 0;
+        };
+
+        // Terreno por chunks
+        render_queue_->addSource([this, basic_shader, faceted_shader, texture_id](RenderQueue &queue, const FrameData &frame)
+                                 {
+            if (!chunked_terrain_)
+                return;
+
+            // Actualizar grid de chunks alrededor de la cámara
+            chunked_terrain_->update(frame.view_pos);
+
+            // Shader facetado verde o texturizado (basic_3d)
+            Shader *shader = basic_shader;
+            const SceneUniforms *uniforms = &basic_uniforms_;
+            GLuint texture = 0;
+            if (!app_state_.use_textured_terrain && faceted_shader)
+            {
+                shader = faceted_shader;
+                uniforms = &terrain_uniforms_;
+            }
+            else if (app_state_.use_textured_terrain)
+            {
+                texture = texture_id("terrain");
+            }
+
+            const bool use_texture = app_state_.use_texture;
+            queue.submit(RenderPass::GEOMETRY, shader, texture, 0.0f, [this, uniforms, use_texture]()
+                         {
+                uniforms->use_texture.set(use_texture);
+                uniforms->use_uniform_color.set(false);
+                uniforms->model.set(glm::mat4(1.0f));
+                chunked_terrain_->draw(); }); });
+
+        // Vegetación y edificios: un draw instanciado por tipo con las
+        // teselas visibles (después del terreno, que añade los chunks nuevos)
+        Shader *instanced_shader = shader_manager.getShader("instanced_3d");
+        render_queue_->addSource([this, instanced_shader](RenderQueue &queue, const FrameData &frame)
+                                 {
+            if (!scenery_ || !instanced_shader || !app_state_.show_scenery)
+                return;
+
+            scenery_->update(frame.projection * frame.view, frame.view_pos);
+            for (size_t type = 0; type < scenery_->getTypeCount(); ++type)
+            {
+                if (scenery_->getVisibleInstanceCount(type) == 0)
+                    continue;
+                queue.submit(RenderPass::GEOMETRY, instanced_shader, 0, 0.0f, [this, type]()
+                             {
+                    scenery_color_.set(scenery_->getType(type).color);
+                    scenery_->draw(type); });
+            } });
+
+        // Cubo sobre el terreno en el origen
+        render_queue_->addSource([this, basic_shader, texture_id](RenderQueue &queue, const FrameData &frame)
+                                 {
+            if (!cube_mesh_ || !chunked_terrain_)
+                return;
+
+            // Posicionar el cubo SOBRE el terreno
+            float cube_size = 4.0f; // Tamaño del cubo escalado
+            glm::vec3 cube_pos(0.0f, chunked_terrain_->getHeightAt(0.0f, 0.0f) + cube_size, 0.0f);
+
+            glm::mat4 cube_model = glm::translate(glm::mat4(1.0f), cube_pos);
+            cube_model = glm::scale(cube_model, glm::vec3(cube_size));
+
+            const bool use_texture = app_state_.use_texture;
+            queue.submit(RenderPass::GEOMETRY, basic_shader, texture_id("container"),
+                         RenderQueue::viewDepth(frame, cube_pos), [this, cube_model, use_texture]()
+                         {
+                basic_uniforms_.use_texture.set(use_texture);
+                basic_uniforms_.use_uniform_color.set(false);
+                basic_uniforms_.model.set(cube_model);
+                cube_mesh_->draw(); }); });
+
+        // Avión (solo en tercera persona); cada malla enlaza su textura
+        render_queue_->addSource([this, basic_shader](RenderQueue &queue, const FrameData &frame)
+                                 {
+            if (!plane_model_ || !plane_model_->isVisible())
+                return;
+
+            queue.submit(RenderPass::GEOMETRY, basic_shader, 0,
+                         RenderQueue::viewDepth(frame, plane_model_->getTransform().position),
+                         [this, basic_shader]()
+                         { plane_model_->render(basic_shader); }); });
+
+        // Skybox después de lo opaco: sólo se dibuja donde queda fondo
+        render_queue_->addSource([this](RenderQueue &queue, const FrameData &)
+                                 {
+            if (skybox_)
+                queue.submit(RenderPass::SKY, nullptr, 0, 0.0f, [this]()
+                             { skybox_->render(); }); });
+
+        // HUD (siempre en primera persona)
+        render_queue_->addSource([this](RenderQueue &queue, const FrameData &)
+                                 {
+            if (bank_angle_indicator_)
+                queue.submit(RenderPass::OVERLAY, nullptr, 0, 0.0f, [this]()
+                             { bank_angle_indicator_->render(); });
+            if (pitch_ladder_)
+                queue.submit(RenderPass::OVERLAY, nullptr, 0, 0.0f, [this]()
+                             { pitch_ladder_->render(); }); });
+    }
+
     /**
      * @brief Inicializar sistema de física de vuelo
      */
@@ -463,6 +732,15 @@ private:
         flight_dynamics_ = std::make_unique<Physics::FlightDynamicsManager>();
         flight_dynamics_->initialize();
 
+        // AGL y contacto con la misma superficie que se dibuja
+        if (chunked_terrain_)
+        {
+            const ChunkedTerrain *terrain = chunked_terrain_.get();
+            flight_dynamics_->setTerrain([terrain](float x, float z)
+                                         { return terrain->getHeightAt(x, z); },
+                                         terrain->getGridSpacing());
+        }
+
         std::cout << "Flight dynamics initialized successfully" << std::endl;
         return true;
     }
@@ -571,6 +849,23 @@ private:
 
         auto &input_manager = InputManager::getInstance();
 
+        // En modo repetición las flechas controlan la velocidad de reproducción
+        if (flight_dynamics_->isReplaying())
+        {
+            const float scrub_rate = input_manager.isKeyPressed(InputManager::KEY_LEFT_SHIFT) ? 32.0f : 8.0f;
+            float replay_rate = 1.0f;
+            if (input_manager.isKeyPressed(InputManager::KEY_LEFT))
+            {
+                replay_rate = -scrub_rate;
+            }
+            else if (input_manager.isKeyPressed(InputManager::KEY_RIGHT))
+            {
+                replay_rate = scrub_rate;
+            }
+            flight_dynamics_->setReplayRate(replay_rate);
+            return;
+        }
+
         // Sensibilidades de control (ajustables)
         const float throttle_rate = 0.3f * app_state_.delta_time;                // 30% por segundo
         const float elevator_rate = glm::radians(30.0f) * app_state_.delta_time; // 30 grados/seg
@@ -769,12 +1064,82 @@ private:
             input_state_.j_pressed = false;
         }
 
+        // P - Toggle replay del vuelo grabado
+        if (input_manager.isKeyPressed(InputManager::KEY_P))
+        {
+            if (!input_state_.p_pressed && flight_dynamics_)
+            {
+                if (flight_dynamics_->isReplaying())
+                {
+                    flight_dynamics_->exitReplay();
+                    std::cout << "Replay: OFF (live flight resumed)" << std::endl;
+                }
+                else if (flight_dynamics_->enterReplay())
+                {
+                    std::cout << "Replay: ON (" << flight_dynamics_->getReplay().get_end_time() -
+                                                       flight_dynamics_->getReplay().get_start_time()
+                              << " s recorded)" << std::endl;
+                }
+                input_state_.p_pressed = true;
+            }
+        }
+        else
+        {
+            input_state_.p_pressed = false;
+        }
+
+        // ENTER - Recuperar el vuelo tras un contacto con el terreno
+        if (input_manager.isKeyPressed(InputManager::KEY_ENTER))
+        {
+            if (!input_state_.enter_pressed && flight_dynamics_ && flight_dynamics_->hasGroundContact())
+            {
+                flight_dynamics_->recoverFromGroundContact();
+                input_state_.enter_pressed = true;
+            }
+        }
+        else
+        {
+            input_state_.enter_pressed = false;
+        }
+
+        // Y - Ciclo de turbulencia (calma, ligera, moderada, severa)
+        if (input_manager.isKeyPressed(InputManager::KEY_Y))
+        {
+            if (!input_state_.y_pressed && flight_dynamics_ && !flight_dynamics_->isReplaying())
+            {
+                static const char *names[] = {"OFF", "LIGHT", "MODERATE", "SEVERE"};
+                static const float intensities[] = {0.0f,
+                                                    dlfdm::WindField::kLightTurbulence,
+                                                    dlfdm::WindField::kModerateTurbulence,
+                                                    dlfdm::WindField::kSevereTurbulence};
+
+                app_state_.turbulence_level = (app_state_.turbulence_level + 1) % 4;
+                if (app_state_.turbulence_level == 0)
+                {
+                    flight_dynamics_->clearWind();
+                }
+                else
+                {
+                    dlfdm::WindField::Turbulence turbulence;
+                    turbulence.intensity = intensities[app_state_.turbulence_level];
+                    flight_dynamics_->setWind({}, turbulence);
+                }
+                std::cout << "Turbulence: " << names[app_state_.turbulence_level] << std::endl;
+                input_state_.y_pressed = true;
+            }
+        }
+        else
+        {
+            input_state_.y_pressed = false;
+        }
+
         // F1 - Show/Hide Controls
         if (input_manager.isKeyPressed(InputManager::KEY_1))
         {
             if (!input_state_.f1_pressed)
             {
                 printControls();
+                printRenderStats();
                 input_state_.f1_pressed = true;
             }
         }
@@ -798,6 +1163,40 @@ private:
             input_state_.num2_pressed = false;
         }
 
+        // L - Luces de pista
+        if (input_manager.isKeyPressed(InputManager::KEY_L))
+        {
+            if (!input_state_.l_pressed && light_manager_)
+            {
+                app_state_.runway_lights = !app_state_.runway_lights;
+                for (const auto &light : light_manager_->getPointLights())
+                {
+                    light->setEnabled(app_state_.runway_lights);
+                }
+                std::cout << "Runway lights: " << (app_state_.runway_lights ? "ON" : "OFF") << std::endl;
+                input_state_.l_pressed = true;
+            }
+        }
+        else
+        {
+            input_state_.l_pressed = false;
+        }
+
+        // V - Vegetación y edificios
+        if (input_manager.isKeyPressed(InputManager::KEY_V))
+        {
+            if (!input_state_.v_pressed)
+            {
+                app_state_.show_scenery = !app_state_.show_scenery;
+                std::cout << "Scenery: " << (app_state_.show_scenery ? "ON" : "OFF") << std::endl;
+                input_state_.v_pressed = true;
+            }
+        }
+        else
+        {
+            input_state_.v_pressed = false;
+        }
+
         // C - Toggle tercera persona
         if (input_manager.isKeyPressed(InputManager::KEY_C))
         {
@@ -913,6 +1312,8 @@ private:
      */
     void render()
     {
+        // Estadísticas de la caché de estado por frame
+        GLState::getInstance().resetStats();
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
         Camera *camera = camera_controller_->getActiveCamera();
@@ -922,175 +1323,25 @@ private:
             return;
         }
 
-        glm::mat4 view_matrix = camera->getViewMatrix();
-        glm::mat4 projection_matrix = camera->getProjectionMatrix();
-        glm::vec3 camera_pos = camera->getPosition();
-
-        // Renderizar skybox primero (debe estar en el fondo)
-        if (skybox_)
-        {
-            glm::mat4 skybox_view = glm::mat4(glm::mat3(view_matrix));
-            skybox_->render(skybox_view, projection_matrix, app_state_.fog_enabled);
-        }
-
-        // Obtener shader y texture manager para objetos normales
-        auto &shader_manager = ShaderManager::getInstance();
-        auto &texture_manager = TextureManager::getInstance();
-
-        Shader *shader = shader_manager.getShader("basic_3d");
-
-        if (!shader || !camera)
-        {
-            std::cerr << "Missing shader or camera!" << std::endl;
-            return;
-        }
-
-        shader->use();
-
-        shader->setMat4("view", view_matrix);
-        shader->setMat4("projection", projection_matrix);
-        shader->setBool("useTexture", app_state_.use_texture);
-        shader->setVec3("viewPos", camera_pos);
-
-        // Configurar niebla
-        shader->setBool("fogEnabled", app_state_.fog_enabled);
-        shader->setFloat("fogDensity", 0.0001f); // niebla más blanda en objetos/terreno
-        // shader->setVec3("fogColor", glm::vec3(0.7f, 0.8f, 0.9f));
-        shader->setVec3("fogColor", glm::vec3(0.85f, 0.90f, 0.95f));
-
-        // Aplicar sistema de iluminación
+        // Datos por frame (cámara, niebla y luces): un solo uniform buffer
+        // para todos los shaders de escena
+        FrameData &frame = frame_uniforms_->data();
+        frame.view = camera->getViewMatrix();
+        frame.projection = camera->getProjectionMatrix();
+        frame.view_pos = camera->getPosition();
+        frame.fog_enabled = app_state_.fog_enabled;
+        frame.fog_density = 0.00006f; // niebla blanda en objetos y terreno
+        frame.fog_color = glm::vec3(0.85f, 0.90f, 0.95f);
         if (light_manager_)
         {
-            light_manager_->applyToShader(shader);
-        }
-
-        // Renderizar terreno por chunks
-        if (chunked_terrain_)
-        {
-            // Seleccionar shader según modo de terreno
-            Shader *terrain_shader = shader;
-            if (!app_state_.use_textured_terrain)
-            {
-                // Usar shader facetado verde
-                terrain_shader = shader_manager.getShader("terrain_faceted_green");
-                if (!terrain_shader)
-                {
-                    terrain_shader = shader; // Fallback a basic_3d
-                }
-            }
-
-            terrain_shader->use();
-            terrain_shader->setMat4("view", view_matrix);
-            terrain_shader->setMat4("projection", projection_matrix);
-            terrain_shader->setVec3("viewPos", camera_pos);
-            terrain_shader->setBool("fogEnabled", app_state_.fog_enabled);
-            terrain_shader->setFloat("fogDensity", 0.00006f); // niebla más blanda en terreno
-            terrain_shader->setVec3("fogColor", glm::vec3(0.85f, 0.90f, 0.95f));
-
-            // Configurar iluminación (solo para shader textured)
-            if (app_state_.use_textured_terrain)
-            {
-                light_manager_->applyToShader(terrain_shader);
-            }
-            else
-            {
-                // Para terreno facetado, solo configurar luz direccional manualmente
-                if (light_manager_->getMainLight())
-                {
-                    auto main_light = light_manager_->getMainLight();
-                    terrain_shader->setVec3("dirLight.direction", main_light->getDirection());
-                    terrain_shader->setVec3("dirLight.ambient", main_light->getAmbient());
-                    terrain_shader->setVec3("dirLight.diffuse", main_light->getDiffuse());
-                    terrain_shader->setVec3("dirLight.specular", main_light->getSpecular());
-                    terrain_shader->setBool("dirLight.enabled", true);
-                }
-            }
-
-            // Configurar textura del terrain (solo si es texturado)
-            if (app_state_.use_texture && app_state_.use_textured_terrain)
-            {
-                Texture *terrain_texture = texture_manager.getTexture("terrain");
-                if (!terrain_texture)
-                {
-                    terrain_texture = texture_manager.getTexture("fallback");
-                }
-
-                if (terrain_texture)
-                {
-                    terrain_texture->bind(0);
-                    terrain_shader->setInt("ourTexture", 0);
-                }
-            }
-
-            // Desactivar color uniforme para el terreno
-            terrain_shader->setBool("useUniformColor", false);
-
-            // Actualizar y dibujar chunks (modelo identidad)
-            glm::mat4 terrain_model = glm::mat4(1.0f);
-            terrain_shader->setMat4("model", terrain_model);
-
-            // Actualizar grid de chunks alrededor de la cámara
-            chunked_terrain_->update(camera_pos);
-            chunked_terrain_->draw();
-        }
-
-        // Renderizar cubo
-        if (cube_mesh_ && chunked_terrain_)
-        {
-            shader->use();
-
-            // Desactivar color uniforme para el cubo
-            shader->setBool("useUniformColor", false);
-
-            // Configurar textura del cubo
-            if (app_state_.use_texture)
-            {
-                Texture *cube_texture = texture_manager.getTexture("container");
-                if (!cube_texture)
-                {
-                    cube_texture = texture_manager.getTexture("fallback");
-                }
-
-                if (cube_texture)
-                {
-                    cube_texture->bind(0);
-                    shader->setInt("ourTexture", 0);
-                }
-            }
-
-            // Posicionar el cubo SOBRE el terreno
-            float cube_x = 0.0f;
-            float cube_z = 0.0f;
-            float terrain_height = chunked_terrain_->getHeightAt(cube_x, cube_z);
-            float cube_size = 4.0f;                    // Tamaño del cubo escalado
-            float cube_y = terrain_height + cube_size; // Cubo sentado sobre el terreno
-
-            // Configurar matriz modelo para el cubo
-            glm::mat4 cube_model = glm::mat4(1.0f);
-            cube_model = glm::translate(cube_model, glm::vec3(cube_x, cube_y, cube_z));
-            cube_model = glm::scale(cube_model, glm::vec3(cube_size));
-            shader->setMat4("model", cube_model);
-
-            cube_mesh_->draw();
-            shader->unuse();
-        }
-
-        // Renderizar avión (solo en tercera persona)
-        if (plane_model_ && plane_model_->isVisible())
-        {
-            // Reutilizamos el shader básico ya configurado (view/projection/fog/lights)
-            plane_model_->render(shader);
+            light_manager_->writeFrameData(frame);
+            clustered_lights_->update(light_manager_->getPointLights(), frame.view, frame.projection,
+                                      camera->getNearPlane(), camera->getFarPlane(), frame);
+            clustered_lights_->bind();
         }
+        frame_uniforms_->upload();
 
-        // Renderizar HUD (siempre en primera persona)
-        if (bank_angle_indicator_)
-        {
-            bank_angle_indicator_->render();
-        }
-        if (pitch_ladder_)
-        {
-            pitch_ladder_->render();
-        }
+        render_queue_->render(frame);
     }
 
     /**
@@ -1116,6 +1367,10 @@ private:
         camera_controller_.reset();
         skybox_.reset();
         chunked_terrain_.reset();
+        scenery_.reset();
+        render_queue_.reset();
+        clustered_lights_.reset();
+        frame_uniforms_.reset();
 
         // Limpiar contexto
         context_.reset();
@@ -1123,6 +1378,32 @@ private:
         std::cout << "Engine shutdown complete" << std::endl;
     }
 
+    /**
+     * @brief Imprime los cambios de estado del último frame de la cola de dibujo
+     */
+    void printRenderStats() const
+    {
+        if (!render_queue_)
+            return;
+
+        const RenderQueue::Stats &stats = render_queue_->getStats();
+        std::cout << "Render queue: " << stats.items << " items, "
+                  << stats.shader_changes << " shader / " << stats.texture_changes << " texture changes ("
+                  << stats.unsorted_shader_changes << " / " << stats.unsorted_texture_changes << " unsorted)" << std::endl;
+
+        if (scenery_ && chunked_terrain_)
+        {
+            std::cout << "Scenery: " << scenery_->getVisibleInstanceCount() << " / " << scenery_->getInstanceCount()
+                      << " instances visible (" << scenery_->getVisibleTileCount() << " tiles, "
+                      << scenery_->getChunkCount() << " chunks, "
+                      << chunked_terrain_->getPendingChunkCount() << " chunks building)" << std::endl;
+        }
+
+        const GLState::Stats &gl_stats = GLState::getInstance().getStats();
+        std::cout << "GL state: " << gl_stats.issued << " calls issued, "
+                  << gl_stats.filtered << " redundant filtered" << std::endl;
+    }
+
     /**
      * @brief Imprime los controles disponibles
      */
@@ -1146,9 +1427,21 @@ private:
         std::cout << "T             : Toggle texture" << std::endl;
         std::cout << "F             : Toggle fog" << std::endl;
         std::cout << "2             : Toggle terrain mode (textured vs faceted)" << std::endl;
+        std::cout << "L             : Toggle runway lights" << std::endl;
+        std::cout << "V             : Toggle trees and buildings" << std::endl;
+        std::cout << "" << std::endl;
+        std::cout << "REPLAY:" << std::endl;
+        std::cout << "P             : Toggle flight replay" << std::endl;
+        std::cout << "LEFT / RIGHT  : Rewind / Fast forward (x8, SHIFT x32)" << std::endl;
+        std::cout << "" << std::endl;
+        std::cout << "TERRAIN:" << std::endl;
+        std::cout << "ENTER         : Recover after terrain contact" << std::endl;
+        std::cout << "" << std::endl;
+        std::cout << "WEATHER:" << std::endl;
+        std::cout << "Y             : Cycle turbulence (off, light, moderate, severe)" << std::endl;
         std::cout << "" << std::endl;
         std::cout << "INFO:" << std::endl;
-        std::cout << "1             : Show controls" << std::endl;
+        std::cout << "1             : Show controls and render statistics" << std::endl;
         std::cout << "ESC           : Exit" << std::endl;
         std::cout << "J             : Toggle joystick controls (Logitech Extreme 3D Pro)" << std::endl;
         std::cout << "======================================" << std::endl;
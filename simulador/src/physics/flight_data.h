@@ -0,0 +1,27 @@
+#ifndef FLIGHT_DATA_H
+#define FLIGHT_DATA_H
+
+namespace Physics {
+
+// Estructura para datos de puntos de navegación
+typedef struct Waypoint {
+    float latitude;     // [deg]
+    float longitude;    // [deg]
+    float altitude;     // [ft]
+} Waypoint;
+
+// Estructura para datos de vuelo
+typedef struct FlightData {
+    float pitch;           // [deg]
+    float roll;            // [deg]
+    float heading;         // [deg]
+    float altitude;        // [ft]
+    float altitude_agl;    // [ft] sobre el terreno
+    float speed;           // [kt]
+    float vertical_speed;  // [ft/min]
+    Waypoint waypoint;
+} FlightData;
+
+} // namespace Physics
+
+#endif // FLIGHT_DATA_H
@@ -2,70 +2,351 @@
 #include <dlfdm/fdmsolver.h>
 #include <dlfdm/defines.h>
 #include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/trim.h>
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 
 namespace Physics {
 
-FlightDynamicsManager::FlightDynamicsManager() {
-    // Inicializar controles en posición neutra/trim
-    current_controls_.throttle = 0.3202f;   // 32% throttle para vuelo nivelado
-    current_controls_.elevator = -0.09024f;  // Elevador trimado
+FlightDynamicsManager::FlightDynamicsManager()
+    : scheduler_(DYNAMICS_RATE), flight_data_() {
+    // Controles en posición neutra hasta que initialize() calcula el trim
+    current_controls_.throttle = 0.0f;
+    current_controls_.elevator = 0.0f;
     current_controls_.aileron = 0.0f;
     current_controls_.rudder = 0.0f;
 }
 
+FlightDynamicsManager::~FlightDynamicsManager() {
+    stopRecording();
+
+    if (fdm_solver_) {
+        scheduler_.printStats(std::cout);
+    }
+
+    if (terrain_.hasTerrain()) {
+        std::cout << "Terrain cache: " << terrain_.getNodeLookups() << " node lookups, "
+                  << terrain_.getNodeMisses() << " height evaluations" << std::endl;
+    }
+}
+
 void FlightDynamicsManager::initialize() {
     // Cargar parámetros del avión
     aircraft_params_ = loadJetTrainerModel();
     
     // Crear el solver FDM con un timestep de 120 Hz
-    fdm_solver_ = std::make_unique<dlfdm::FDMSolver>(aircraft_params_, 1.0f / 120.0f);
-    
-    // Configurar condiciones iniciales de trim (vuelo nivelado)
-    dlfdm::AircraftState init_state;
-    
-    // Posición inicial: sistema NED (North, East, Down)
-    // Iniciamos a 5000m de altitud
-    init_state.intertial_position = glm::vec3(0.0f, 0.0f, -1000.0f);  // [m]
-    
-    // Velocidad inicial: vuelo nivelado a ~150 m/s
-    init_state.boby_velocity = glm::vec3(149.998f, 0.0f, -0.36675f);  // [m/s]
-    
-    // Sin rotación inicial
-    init_state.body_omega = glm::vec3(0.0f, 0.0f, 0.0f);
-    
-    // Actitud inicial: nivelado
-    init_state.theta = 0.0f;  // pitch
-    init_state.phi = 0.0f;    // roll
-    init_state.psi = 0.0f;    // yaw
+    fdm_solver_ = std::make_unique<dlfdm::FDMSolver>(aircraft_params_, 1.0f / DYNAMICS_RATE);
+
+    // Coeficientes aerodinámicos tabulados (alpha x beta x Mach x deflexión)
+    if (aero_database_.load(AERO_DATABASE_PATH)) {
+        active_aero_database_ = &aero_database_;
+        fdm_solver_->set_aero_database(active_aero_database_);
+        std::cout << "  Aerodynamic database: " << AERO_DATABASE_PATH << std::endl;
+    }
+    else {
+        std::cout << "  Aerodynamic database not available, using linear model" << std::endl;
+    }
     
-    fdm_solver_->setState(init_state);
+    // Condiciones iniciales: vuelo nivelado equilibrado, sistema NED (North, East, Down)
+    setTrimmedState(glm::vec3(0.0f, 0.0f, -INITIAL_ALTITUDE), 0.0f);
+
+    // Actitud por cuaternión: sin singularidad en theta = ±90° (acrobacias completas),
+    // los ángulos de Euler sólo se calculan cuando se consultan
+    fdm_solver_->set_attitude_mode(dlfdm::AttitudeMode::QUATERNION);
+
+    // Registrador de datos de vuelo siempre activo
+    startRecording(DEFAULT_RECORDING_PATH);
+
+    // Telemetría para herramientas externas (opcional, sin ella la simulación sigue)
+    if (telemetry_.open()) {
+        std::cout << "  Telemetry exported to shared memory " << TelemetryPublisher::DEFAULT_NAME << std::endl;
+    }
+    else {
+        std::cerr << "WARNING: telemetry export not available" << std::endl;
+    }
+
+    setupScheduler();
+    flight_data_ = computeFlightData();
     
     std::cout << "Flight Dynamics Manager initialized successfully" << std::endl;
     std::cout << "  Initial altitude: " << getAltitude() << " ft" << std::endl;
     std::cout << "  Initial speed: " << getSpeed() << " kts" << std::endl;
 }
 
+void FlightDynamicsManager::setupScheduler() {
+    // Orden dentro de un tick: grabación de repetición, atmósfera, aerodinámica,
+    // dinámica, terreno, datos de vuelo y telemetría. Frecuencia 0 = todos los ticks (frecuencia base).
+    scheduler_.addTask("replay", 0.0f, [this](float) {
+        if (!replay_mode_) {
+            replay_.capture(*fdm_solver_, current_controls_);
+        }
+    });
+
+    scheduler_.addTask("atmosphere", ATMOSPHERE_RATE, [this](float) {
+        fdm_solver_->update_atmosphere();
+    });
+
+    scheduler_.addTask("aerodynamics", AERODYNAMICS_RATE, [this](float) {
+        fdm_solver_->update_aerodynamics(current_controls_);
+    });
+
+    scheduler_.addTask("dynamics", 0.0f, [this](float) {
+        step_start_position_ = fdm_solver_->get_position();
+        fdm_solver_->integrate();
+    });
+
+    scheduler_.addTask("terrain", 0.0f, [this](float dt) {
+        updateTerrain(dt);
+    });
+
+    scheduler_.addTask("flight_data", FLIGHT_DATA_RATE, [this](float) {
+        flight_data_ = computeFlightData();
+    });
+
+    scheduler_.addTask("telemetry", 0.0f, [this](float) {
+        if (!replay_mode_) {
+            publishTelemetry(scheduler_.getTick());
+        }
+    });
+}
+
 void FlightDynamicsManager::update(float delta_time) {
     if (!fdm_solver_) {
         std::cerr << "ERROR: FDM Solver not initialized!" << std::endl;
         return;
     }
-    
-    // El FDM usa su propio timestep interno (120 Hz)
-    // Podemos llamar a update múltiples veces si delta_time es grande
-    const float fdm_timestep = 1.0f / 120.0f;  // 120 Hz
-    float remaining_time = delta_time;
-    
-    while (remaining_time > 0.0f) {
-        float dt = std::min(remaining_time, fdm_timestep);
-        fdm_solver_->update(current_controls_);
-        remaining_time -= dt;
+
+    if (replay_mode_) {
+        // Avanzar (o retroceder) el cursor y reconstruir el estado desde el keyframe más cercano
+        const double last_step = static_cast<double>(replay_.get_num_steps());
+        replay_cursor_ += static_cast<double>(delta_time * replay_rate_) / replay_.get_time_step();
+        replay_cursor_ = std::max(0.0, std::min(last_step, replay_cursor_));
+        seekReplayStep(static_cast<std::uint64_t>(replay_cursor_));
+        return;
+    }
+
+    // Sin tren de aterrizaje: tras el contacto el avión queda detenido hasta recoverFromGroundContact()
+    if (ground_contact_) {
+        return;
+    }
+
+    // Cada subsistema corre a su frecuencia, el planificador ejecuta los ticks completos
+    scheduler_.advance(delta_time);
+}
+
+void FlightDynamicsManager::seekReplayStep(std::uint64_t step) {
+    // Cada paso grabado es un tick del planificador: se re-simula la misma secuencia
+    replay_.seek(*fdm_solver_, step,
+                 [this](dlfdm::FDMSolver&, const dlfdm::ControlInputs& controls, std::uint64_t tick) {
+                     current_controls_ = controls;
+                     scheduler_.runTick(tick);
+                 });
+
+    flight_data_ = computeFlightData();
+    publishTelemetry(step);
+}
+
+void FlightDynamicsManager::setDynamicsRate(float rate) {
+    if (!fdm_solver_ || replay_mode_) {
+        return;
+    }
+
+    rate = std::max(DYNAMICS_RATE_MIN, std::min(DYNAMICS_RATE_MAX, rate));
+
+    fdm_solver_->setTimeStep(1.0f / rate);
+    scheduler_.setBaseRate(rate);
+
+    // Los pasos de la repetición son ticks del planificador, se empieza de nuevo
+    scheduler_.reset();
+    replay_.clear();
+
+    std::cout << "Dynamics rate: " << rate << " Hz" << std::endl;
+}
+
+void FlightDynamicsManager::setTerrain(TerrainContact::HeightFunction height, float grid_spacing) {
+    terrain_.setTerrain(std::move(height), grid_spacing);
+
+    if (!fdm_solver_) {
+        return;
+    }
+
+    const glm::vec3 position = nedToWorldCoordinates(fdm_solver_->get_position());
+    altitude_agl_ = position.y - terrain_.getHeight(position.x, position.z);
+
+    // El estado inicial no sabe del terreno: no empezar dentro de una montaña
+    if (altitude_agl_ < RECOVERY_CLEARANCE) {
+        placeAboveTerrain(RECOVERY_CLEARANCE);
+        std::cout << "  Initial position raised to " << RECOVERY_CLEARANCE << " m above the terrain" << std::endl;
+    }
+
+    clearance_ahead_ = altitude_agl_;
+    flight_data_ = computeFlightData();
+}
+
+void FlightDynamicsManager::updateTerrain(float dt) {
+    if (!terrain_.hasTerrain()) {
+        return;
+    }
+
+    // Barrido del segmento recorrido en el paso: a alta velocidad el avión puede
+    // cruzar una cresta entera entre el inicio y el final
+    const glm::vec3 from = nedToWorldCoordinates(step_start_position_);
+    const glm::vec3 to = nedToWorldCoordinates(fdm_solver_->get_position());
+    const glm::vec3 velocity = (dt > 0.0f) ? (to - from) / dt : glm::vec3(0.0f);
+
+    float fraction;
+    if (terrain_.sweep(from, to, fraction)) {
+        const GroundContact contact = holdAtContact(from, to, fraction, dt);
+
+        // La repetición re-simula el mismo contacto, sólo se notifica en vivo
+        if (!replay_mode_) {
+            ground_contact_ = true;
+            last_contact_ = contact;
+
+            std::cout << "Terrain contact: " << (contact.crash ? "CRASH" : "touchdown")
+                      << " at t = " << contact.time << " s, sink rate " << contact.sink_rate
+                      << " m/s, ground speed " << contact.ground_speed << " m/s, pitch "
+                      << contact.pitch << " deg, bank " << contact.bank << " deg" << std::endl;
+        }
     }
+
+    const glm::vec3 position = nedToWorldCoordinates(fdm_solver_->get_position());
+    altitude_agl_ = position.y - terrain_.getHeight(position.x, position.z);
+    clearance_ahead_ = ground_contact_ ? altitude_agl_
+                                       : terrain_.clearanceAhead(position, velocity, TERRAIN_LOOKAHEAD);
 }
 
-FlightData FlightDynamicsManager::getFlightData() const {
+GroundContact FlightDynamicsManager::holdAtContact(const glm::vec3& from, const glm::vec3& to,
+                                                   float fraction, float dt) {
+    const glm::vec3 point = from + (to - from) * fraction;
+    const glm::vec3 velocity = (dt > 0.0f) ? (to - from) / dt : glm::vec3(0.0f);
+    dlfdm::AircraftState state = fdm_solver_->getState();
+
+    GroundContact contact;
+    contact.time = fdm_solver_->get_sim_time() - (1.0f - fraction) * dt;
+    contact.position = point;
+    contact.terrain_height = terrain_.getHeight(point.x, point.z);
+    contact.sink_rate = -velocity.y;
+    contact.ground_speed = std::sqrt(velocity.x * velocity.x + velocity.z * velocity.z);
+    contact.pitch = state.theta * RAD_TO_DEG;
+    contact.bank = state.phi * RAD_TO_DEG;
+    contact.crash = contact.sink_rate > MAX_TOUCHDOWN_SINK_RATE ||
+                    contact.ground_speed > MAX_TOUCHDOWN_SPEED ||
+                    std::fabs(contact.bank) > MAX_TOUCHDOWN_BANK ||
+                    contact.pitch < MIN_TOUCHDOWN_PITCH ||
+                    contact.pitch > MAX_TOUCHDOWN_PITCH;
+
+    // Detenido en el punto de contacto (mundo -> NED)
+    state.intertial_position = glm::vec3(-point.z, point.x, -point.y);
+    state.boby_velocity = glm::vec3(0.0f);
+    state.body_omega = glm::vec3(0.0f);
+    fdm_solver_->setState(state);
+
+    return contact;
+}
+
+void FlightDynamicsManager::setTrimmedState(const glm::vec3& ned_position, float psi) {
+    const float altitude = -ned_position.z;
+
+    dlfdm::AircraftState state;
+    dlfdm::ControlInputs trim;
+    if (!dlfdm::trim_level_flight(aircraft_params_, active_aero_database_, TRIM_SPEED, altitude, state, trim)) {
+        // Sin equilibrio: nivelado sin incidencia con los controles actuales
+        std::cerr << "WARNING: cannot trim level flight at " << altitude << " m, " << TRIM_SPEED << " m/s" << std::endl;
+        state.boby_velocity = glm::vec3(TRIM_SPEED, 0.0f, 0.0f);
+        state.body_omega = glm::vec3(0.0f);
+        state.phi = 0.0f;
+        state.theta = 0.0f;
+        trim = current_controls_;
+    }
+
+    // trim_level_flight devuelve el avión en (0, 0) con rumbo norte
+    state.intertial_position = ned_position;
+    state.psi = psi;
+    fdm_solver_->setState(state);
+
+    current_controls_.throttle = trim.throttle;
+    current_controls_.elevator = trim.elevator;
+    current_controls_.aileron = 0.0f;
+    current_controls_.rudder = 0.0f;
+}
+
+void FlightDynamicsManager::placeAboveTerrain(float clearance) {
+    const float psi = fdm_solver_->getState().psi;
+    const glm::vec3 ned_position = fdm_solver_->get_position();
+    const glm::vec3 position = nedToWorldCoordinates(ned_position);
+    const float ground = terrain_.getHeight(position.x, position.z);
+
+    // Equilibrado a la nueva altitud (otra densidad), conservando el rumbo
+    setTrimmedState(glm::vec3(ned_position.x, ned_position.y, -(ground + clearance)), psi);
+
+    altitude_agl_ = clearance;
+
+    // Los pasos de la repetición no pueden saltar de estado, se empieza de nuevo
+    scheduler_.reset();
+    replay_.clear();
+}
+
+bool FlightDynamicsManager::recoverFromGroundContact() {
+    if (!fdm_solver_ || !ground_contact_ || replay_mode_) {
+        return false;
+    }
+
+    placeAboveTerrain(RECOVERY_CLEARANCE);
+    ground_contact_ = false;
+    clearance_ahead_ = altitude_agl_;
+    flight_data_ = computeFlightData();
+
+    std::cout << "Recovered " << RECOVERY_CLEARANCE << " m above the terrain" << std::endl;
+    return true;
+}
+
+void FlightDynamicsManager::setWind(const std::vector<dlfdm::WindField::Layer>& profile,
+                                    const dlfdm::WindField::Turbulence& turbulence) {
+    if (!fdm_solver_ || replay_mode_) {
+        return;
+    }
+
+    wind_field_ = std::make_unique<dlfdm::WindField>(profile, turbulence);
+    fdm_solver_->set_wind_field(wind_field_.get());
+
+    // La repetición re-simula con el viento actual, se empieza de nuevo
+    scheduler_.reset();
+    replay_.clear();
+}
+
+void FlightDynamicsManager::clearWind() {
+    if (!fdm_solver_ || replay_mode_) {
+        return;
+    }
+
+    fdm_solver_->set_wind_field(nullptr);
+    wind_field_.reset();
+
+    scheduler_.reset();
+    replay_.clear();
+}
+
+void FlightDynamicsManager::publishTelemetry(std::uint64_t step) {
+    if (!telemetry_.isOpen()) {
+        return;
+    }
+
+    // Se publica cada paso de la física: el estado sin derivar los ángulos de
+    // Euler y los datos de vuelo de la última tarea "flight_data"
+    TelemetryRecord record;
+    record.step = step;
+    record.time = fdm_solver_->get_sim_time();
+    record.state = fdm_solver_->get_integrated_state();
+    record.attitude_mode = fdm_solver_->get_attitude_mode();
+    record.controls = current_controls_;
+    record.flight_data = flight_data_;
+
+    telemetry_.publish(record);
+}
+
+FlightData FlightDynamicsManager::computeFlightData() const {
     FlightData data;
     
     if (!fdm_solver_) {
@@ -83,8 +364,9 @@ FlightData FlightDynamicsManager::getFlightData() const {
     while (data.heading < 0.0f) data.heading += 360.0f;
     while (data.heading >= 360.0f) data.heading -= 360.0f;
     
-    // Calcular altitud en pies (z negativo en NED = altura sobre el suelo)
+    // Calcular altitud en pies (z negativo en NED = altura sobre el nivel del mar)
     data.altitude = -state.intertial_position.z * METERS_TO_FEET;
+    data.altitude_agl = terrain_.hasTerrain() ? altitude_agl_ * METERS_TO_FEET : data.altitude;
     
     // Calcular velocidad total en nudos
     glm::vec3 vel = state.boby_velocity;
@@ -161,6 +443,22 @@ float FlightDynamicsManager::getAltitude() const {
     return -state.intertial_position.z * METERS_TO_FEET;
 }
 
+float FlightDynamicsManager::getAltitudeAGL() const {
+    if (!terrain_.hasTerrain()) {
+        return getAltitude();
+    }
+
+    return altitude_agl_ * METERS_TO_FEET;
+}
+
+float FlightDynamicsManager::getTerrainClearanceAhead() const {
+    if (!terrain_.hasTerrain()) {
+        return getAltitude();
+    }
+
+    return clearance_ahead_ * METERS_TO_FEET;
+}
+
 glm::mat4 FlightDynamicsManager::getModelMatrix() const {
     if (!fdm_solver_) {
         return glm::mat4(1.0f);
@@ -200,6 +498,77 @@ void FlightDynamicsManager::setInitialState(const glm::vec3& position,
     fdm_solver_->setState(state);
 }
 
+bool FlightDynamicsManager::startRecording(const std::string& path) {
+    if (!fdm_solver_) {
+        std::cerr << "ERROR: Cannot start recording - FDM not initialized" << std::endl;
+        return false;
+    }
+
+    if (!recorder_.open(path)) {
+        fdm_solver_->set_recorder(nullptr);
+        return false;
+    }
+
+    fdm_solver_->set_recorder(&recorder_);
+    std::cout << "  Flight data recording: " << path << std::endl;
+    return true;
+}
+
+void FlightDynamicsManager::stopRecording() {
+    if (fdm_solver_) {
+        fdm_solver_->set_recorder(nullptr);
+    }
+
+    if (recorder_.is_open()) {
+        recorder_.close();
+        std::cout << "Flight data recorder closed (" << recorder_.get_recorded() << " samples, "
+                  << recorder_.get_dropped() << " dropped)" << std::endl;
+    }
+}
+
+bool FlightDynamicsManager::enterReplay() {
+    if (!fdm_solver_ || replay_mode_ || replay_.get_num_steps() == 0) {
+        return false;
+    }
+
+    // Los pasos re-simulados no deben llegar al registrador de datos
+    fdm_solver_->set_recorder(nullptr);
+
+    replay_mode_ = true;
+    replay_rate_ = 1.0f;
+    replay_cursor_ = 0.0;
+    seekReplayStep(0);
+    return true;
+}
+
+void FlightDynamicsManager::exitReplay() {
+    if (!replay_mode_) {
+        return;
+    }
+
+    // El último paso grabado reproduce exactamente el estado en vivo
+    seekReplayStep(replay_.get_num_steps());
+    replay_mode_ = false;
+
+    if (recorder_.is_open()) {
+        fdm_solver_->set_recorder(&recorder_);
+    }
+}
+
+void FlightDynamicsManager::seekReplay(float time) {
+    if (!replay_mode_ || replay_.get_time_step() <= 0.0f) {
+        return;
+    }
+
+    const double step = (time - replay_.get_start_time()) / replay_.get_time_step();
+    replay_cursor_ = std::max(0.0, std::min(static_cast<double>(replay_.get_num_steps()), step));
+    seekReplayStep(static_cast<std::uint64_t>(replay_cursor_));
+}
+
+float FlightDynamicsManager::getSimTime() const {
+    return fdm_solver_ ? fdm_solver_->get_sim_time() : 0.0f;
+}
+
 void FlightDynamicsManager::setControls(const dlfdm::ControlInputs& controls) {
     current_controls_ = controls;
 }
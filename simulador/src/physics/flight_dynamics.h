@@ -5,26 +5,35 @@
 #include <glm/glm.hpp>
 #include <dlfdm/fdmsolver.h>
 #include <dlfdm/defines.h>
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/flightrecorder.h>
+#include <dlfdm/flightreplay.h>
+#include <dlfdm/windfield.h>
+#include "flight_data.h"
+#include "multirate_scheduler.h"
+#include "telemetry.h"
+#include "terrain_contact.h"
 
 namespace Physics {
 
-// Estructura para datos de puntos de navegación
-typedef struct Waypoint {
-    float latitude;     // [deg]
-    float longitude;    // [deg]
-    float altitude;     // [ft]
-} Waypoint;
-
-// Estructura para datos de vuelo
-typedef struct FlightData {
-    float pitch;           // [deg]
-    float roll;            // [deg]
-    float heading;         // [deg]
-    float altitude;        // [ft]
-    float speed;           // [kt]
-    float vertical_speed;  // [ft/min]
-    Waypoint waypoint;
-} FlightData;
+/**
+ * @brief Contacto del avión con el terreno
+ *
+ * No hay tren de aterrizaje modelado: tras cualquier contacto el avión queda
+ * detenido en el punto de contacto. Se clasifica como toma si la actitud, la
+ * velocidad de descenso y la velocidad respecto a tierra son las de un
+ * aterrizaje, como choque en otro caso.
+ */
+struct GroundContact {
+    float time;             // [s] tiempo de simulación
+    glm::vec3 position;     // [m] punto de contacto (coordenadas del mundo)
+    float terrain_height;   // [m]
+    float sink_rate;        // [m/s] positiva hacia abajo
+    float ground_speed;     // [m/s] velocidad horizontal
+    float pitch;            // [deg]
+    float bank;             // [deg]
+    bool crash;
+};
 
 /**
  * @brief Clase que integra el modelo físico FDM con el simulador gráfico
@@ -36,7 +45,7 @@ typedef struct FlightData {
 class FlightDynamicsManager {
 public:
     FlightDynamicsManager();
-    ~FlightDynamicsManager() = default;
+    ~FlightDynamicsManager();
 
     /**
      * @brief Inicializa el modelo físico con parámetros de un avión jet trainer
@@ -50,10 +59,22 @@ public:
     void update(float delta_time);
 
     /**
-     * @brief Obtiene los datos de vuelo actuales
+     * @brief Carga los parámetros de un avión jet trainer (AERMACCHI S-211)
+     *
+     * Estático para que las herramientas sin gráficos (benchmark, dispersión)
+     * usen el mismo avión que el simulador.
+     */
+    static dlfdm::AircraftParameters loadJetTrainerModel();
+
+    // Base de datos aerodinámica del S-211 (si falta se usa el modelo lineal),
+    // también la que cargan por defecto las herramientas
+    static constexpr const char* AERO_DATABASE_PATH = "data/aero/s211.aero";
+
+    /**
+     * @brief Obtiene los datos de vuelo actuales (refrescados a FLIGHT_DATA_RATE)
      * @return Estructura FlightData con todos los parámetros de vuelo
      */
-    FlightData getFlightData() const;
+    FlightData getFlightData() const { return flight_data_; }
 
     /**
      * @brief Obtiene la posición del avión en coordenadas del mundo
@@ -79,6 +100,47 @@ public:
      */
     float getAltitude() const;
 
+    /**
+     * @brief Asigna el terreno para la altitud AGL y la detección de contacto
+     * @param height Altura del terreno en (x, z) del mundo [m], la misma función que genera la malla
+     * @param grid_spacing Paso de la rejilla de la malla del terreno [m]
+     * @note Si el avión queda por debajo de RECOVERY_CLEARANCE se sube sobre el terreno
+     */
+    void setTerrain(TerrainContact::HeightFunction height, float grid_spacing);
+
+    /**
+     * @brief Obtiene la altitud sobre el terreno (AGL)
+     * @return Altitud AGL en pies (feet), igual a getAltitude() sin terreno
+     */
+    float getAltitudeAGL() const;
+
+    /**
+     * @brief Holgura mínima sobre el terreno en la trayectoria prevista
+     *        (TERRAIN_LOOKAHEAD segundos en línea recta)
+     * @return Holgura en pies (feet), negativa si la trayectoria entra en el terreno
+     */
+    float getTerrainClearanceAhead() const;
+
+    /**
+     * @brief Indica si el avión ha tocado el terreno (la simulación en vivo se detiene)
+     */
+    bool hasGroundContact() const { return ground_contact_; }
+
+    /**
+     * @brief Obtiene el último contacto con el terreno
+     */
+    const GroundContact& getLastContact() const { return last_contact_; }
+
+    /**
+     * @brief Recoloca el avión en vuelo nivelado RECOVERY_CLEARANCE metros sobre
+     *        el terreno, con el rumbo actual, y retoma la simulación
+     * @note Descarta la grabación de repetición (el estado salta)
+     * @return false si no había contacto
+     */
+    bool recoverFromGroundContact();
+
+    const TerrainContact& getTerrain() const { return terrain_; }
+
     /**
      * @brief Obtiene la matriz de modelo para renderizado
      * @return Matriz 4x4 de transformación
@@ -134,9 +196,120 @@ public:
      */
     dlfdm::FDMSolver& getFDMSolver() { return *fdm_solver_; }
 
+    /**
+     * @brief Inicia la grabación binaria de datos de vuelo (registrador siempre activo)
+     * @param path Archivo de salida (.fdr), convertible a CSV con la herramienta fdr2csv
+     * @return true si el archivo pudo abrirse
+     */
+    bool startRecording(const std::string& path);
+
+    /**
+     * @brief Detiene la grabación y vuelca los datos pendientes a disco
+     */
+    void stopRecording();
+
+    /**
+     * @brief Obtiene el registrador de datos de vuelo
+     */
+    const dlfdm::FlightRecorder& getRecorder() const { return recorder_; }
+
+    /**
+     * @brief Entra en modo repetición: la simulación en vivo se congela y update()
+     *        reproduce los controles grabados desde el inicio del vuelo
+     * @return false si todavía no hay nada grabado
+     */
+    bool enterReplay();
+
+    /**
+     * @brief Sale del modo repetición y retoma el vuelo en vivo donde se había dejado
+     */
+    void exitReplay();
+
+    bool isReplaying() const { return replay_mode_; }
+
+    /**
+     * @brief Velocidad de reproducción (1 = tiempo real, negativo = hacia atrás)
+     */
+    void setReplayRate(float rate) { replay_rate_ = rate; }
+    float getReplayRate() const { return replay_rate_; }
+
+    /**
+     * @brief Salta a un instante de la grabación
+     * @param time Tiempo de simulación [s]
+     */
+    void seekReplay(float time);
+
+    /**
+     * @brief Obtiene el tiempo de simulación actual [s]
+     */
+    float getSimTime() const;
+
+    const dlfdm::FlightReplay& getReplay() const { return replay_; }
+
+    /**
+     * @brief Cambia la frecuencia de la dinámica de cuerpo rígido (configuraciones
+     *        rígidas), el resto de subsistemas mantiene su frecuencia
+     * @param rate Frecuencia [Hz], se limita a [DYNAMICS_RATE_MIN, DYNAMICS_RATE_MAX]
+     * @note Descarta la grabación de repetición (los pasos cambian de duración)
+     */
+    void setDynamicsRate(float rate);
+    float getDynamicsRate() const { return scheduler_.getBaseRate(); }
+
+    /**
+     * @brief Vuela en un campo de viento: viento medio por altitud y turbulencia de Dryden
+     * @param profile Capas de viento medio (vacío = sin viento medio)
+     * @param turbulence Intensidad (0 = sin turbulencia) y semilla de las ráfagas
+     * @note Descarta la grabación de repetición (la re-simulación usaría otro viento)
+     */
+    void setWind(const std::vector<dlfdm::WindField::Layer>& profile,
+                 const dlfdm::WindField::Turbulence& turbulence);
+
+    /**
+     * @brief Vuelve al aire en calma
+     */
+    void clearWind();
+
+    /**
+     * @brief Campo de viento actual, nullptr en aire en calma
+     */
+    const dlfdm::WindField* getWindField() const { return wind_field_.get(); }
+
+    /**
+     * @brief Obtiene el planificador multi-frecuencia (estadísticas por tarea)
+     */
+    const MultiRateScheduler& getScheduler() const { return scheduler_; }
+
+    /**
+     * @brief Exportación de telemetría por memoria compartida (un registro por paso)
+     */
+    const TelemetryPublisher& getTelemetry() const { return telemetry_; }
+
 private:
     std::unique_ptr<dlfdm::FDMSolver> fdm_solver_;
+
+    // Subsistemas: dinámica a la frecuencia base, el resto a la suya
+    MultiRateScheduler scheduler_;
+    FlightData flight_data_;
+    dlfdm::FlightRecorder recorder_;
+    TelemetryPublisher telemetry_;
+
+    // Terreno: AGL, barrido del paso y holgura por delante
+    TerrainContact terrain_;
+    glm::vec3 step_start_position_;         // [m] NED antes de integrar el paso
+    float altitude_agl_ = 0.0f;             // [m]
+    float clearance_ahead_ = 0.0f;          // [m]
+    bool ground_contact_ = false;
+    GroundContact last_contact_{};
+
+    // Repetición determinística (controles + keyframes de estado)
+    dlfdm::FlightReplay replay_;
+    bool replay_mode_ = false;
+    float replay_rate_ = 1.0f;
+    double replay_cursor_ = 0.0;    // [pasos desde el inicio de la grabación]
     dlfdm::AircraftParameters aircraft_params_;
+    dlfdm::AeroDatabase aero_database_;     // Tablas de coeficientes (pérdida, Mach)
+    const dlfdm::AeroDatabase* active_aero_database_ = nullptr;  // nullptr = modelo lineal
+    std::unique_ptr<dlfdm::WindField> wind_field_;  // nullptr = aire en calma
     dlfdm::ControlInputs current_controls_;
 
     // Constantes de conversión
@@ -144,10 +317,75 @@ private:
     static constexpr float MPS_TO_KNOTS = 1.94384f;
     static constexpr float RAD_TO_DEG = 57.2957795f;
 
+    // Frecuencias de los subsistemas [Hz]
+    static constexpr float DYNAMICS_RATE = 120.0f;
+    static constexpr float DYNAMICS_RATE_MIN = 120.0f;
+    static constexpr float DYNAMICS_RATE_MAX = 1000.0f;
+    static constexpr float AERODYNAMICS_RATE = 120.0f;
+    static constexpr float ATMOSPHERE_RATE = 30.0f;
+    static constexpr float FLIGHT_DATA_RATE = 20.0f;
+
+    // Vuelo nivelado inicial y tras recuperar un contacto con el terreno
+    static constexpr float INITIAL_ALTITUDE = 1000.0f;          // [m]
+    static constexpr float TRIM_SPEED = 150.0f;                 // [m/s]
+
+    // Terreno
+    static constexpr float TERRAIN_LOOKAHEAD = 10.0f;           // [s]
+    static constexpr float RECOVERY_CLEARANCE = 300.0f;         // [m]
+
+    // Límites de una toma (fuera de ellos el contacto es un choque)
+    static constexpr float MAX_TOUCHDOWN_SINK_RATE = 3.0f;      // [m/s]
+    static constexpr float MAX_TOUCHDOWN_SPEED = 80.0f;         // [m/s]
+    static constexpr float MAX_TOUCHDOWN_BANK = 10.0f;          // [deg]
+    static constexpr float MIN_TOUCHDOWN_PITCH = -5.0f;         // [deg]
+    static constexpr float MAX_TOUCHDOWN_PITCH = 15.0f;         // [deg]
+
+    // Grabación por defecto del registrador de datos de vuelo
+    static constexpr const char* DEFAULT_RECORDING_PATH = "flight_record.fdr";
+
     /**
-     * @brief Carga los parámetros de un avión jet trainer (AERMACCHI S-211)
+     * @brief Registra las tareas del planificador (el orden define la secuencia de un tick)
+     */
+    void setupScheduler();
+
+    /**
+     * @brief Reconstruye el estado de la repetición en un paso (tick) grabado
+     */
+    void seekReplayStep(std::uint64_t step);
+
+    /**
+     * @brief Paso del terreno: AGL, barrido entre el inicio y el final del paso
+     *        y holgura por delante
+     * @param dt Duración del paso [s]
+     */
+    void updateTerrain(float dt);
+
+    /**
+     * @brief Detiene el avión en el punto de contacto y clasifica el contacto
+     */
+    GroundContact holdAtContact(const glm::vec3& from, const glm::vec3& to, float fraction, float dt);
+
+    /**
+     * @brief Vuelo nivelado a TRIM_SPEED equilibrado (trim_level_flight) a la
+     *        altitud de ned_position con el modelo aerodinámico activo
+     * @param psi Rumbo [rad]
+     */
+    void setTrimmedState(const glm::vec3& ned_position, float psi);
+
+    /**
+     * @brief Coloca el avión en vuelo nivelado de trim a clearance metros sobre el terreno
+     */
+    void placeAboveTerrain(float clearance);
+
+    /**
+     * @brief Calcula los datos de vuelo a partir del estado del solver
+     */
+    FlightData computeFlightData() const;
+
+    /**
+     * @brief Publica el estado, los controles y los datos de vuelo del paso
      */
-    dlfdm::AircraftParameters loadJetTrainerModel();
+    void publishTelemetry(std::uint64_t step);
 
     /**
      * @brief Convierte coordenadas NED (North-East-Down) a coordenadas del mundo OpenGL
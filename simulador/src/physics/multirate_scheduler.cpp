@@ -0,0 +1,122 @@
+#include "multirate_scheduler.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+
+namespace Physics {
+
+MultiRateScheduler::MultiRateScheduler(float base_rate, unsigned int max_ticks_per_advance)
+    : base_rate_(std::max(base_rate, 1.0f)),
+      max_ticks_per_advance_(std::max(max_ticks_per_advance, 1u)),
+      tick_(0),
+      accumulator_(0.0) {
+}
+
+std::size_t MultiRateScheduler::addTask(const std::string& name, float rate, TaskFunction function) {
+    tasks_.push_back({std::max(rate, 0.0f), 1u, std::move(function)});
+    stats_.push_back({name, 0.0f, 0u, 0.0, 0.0});
+
+    const std::size_t index = tasks_.size() - 1;
+    updateDivider(index);
+    return index;
+}
+
+void MultiRateScheduler::setBaseRate(float base_rate) {
+    base_rate_ = std::max(base_rate, 1.0f);
+
+    for (std::size_t i = 0; i < tasks_.size(); ++i) {
+        updateDivider(i);
+    }
+}
+
+void MultiRateScheduler::updateDivider(std::size_t index) {
+    Task& task = tasks_[index];
+
+    // Una tarea nunca corre más rápido que la frecuencia base
+    if (task.requested_rate <= 0.0f || task.requested_rate >= base_rate_) {
+        task.divider = 1u;
+    }
+    else {
+        task.divider = static_cast<std::uint32_t>(std::lround(base_rate_ / task.requested_rate));
+    }
+
+    stats_[index].rate = base_rate_ / static_cast<float>(task.divider);
+}
+
+unsigned int MultiRateScheduler::advance(float delta_time) {
+    const double tick_time = 1.0 / static_cast<double>(base_rate_);
+
+    accumulator_ += std::max(delta_time, 0.0f);
+
+    unsigned int ticks = 0;
+    while (accumulator_ >= tick_time && ticks < max_ticks_per_advance_) {
+        runTick(tick_);
+        ++tick_;
+        ++ticks;
+        accumulator_ -= tick_time;
+    }
+
+    // Si se alcanzó el límite se descarta el atraso en lugar de acumularlo
+    if (ticks == max_ticks_per_advance_) {
+        accumulator_ = std::min(accumulator_, tick_time);
+    }
+
+    return ticks;
+}
+
+void MultiRateScheduler::runTick(std::uint64_t tick) {
+    using Clock = std::chrono::steady_clock;
+
+    for (std::size_t i = 0; i < tasks_.size(); ++i) {
+        Task& task = tasks_[i];
+        if (tick % task.divider != 0) {
+            continue;
+        }
+
+        const Clock::time_point start = Clock::now();
+        task.function(static_cast<float>(task.divider) / base_rate_);
+        const double ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        TaskStats& stats = stats_[i];
+        ++stats.calls;
+        stats.total_ms += ms;
+        stats.max_ms = std::max(stats.max_ms, ms);
+    }
+}
+
+void MultiRateScheduler::reset() {
+    tick_ = 0;
+    accumulator_ = 0.0;
+}
+
+void MultiRateScheduler::resetStats() {
+    for (TaskStats& stats : stats_) {
+        stats.calls = 0;
+        stats.total_ms = 0.0;
+        stats.max_ms = 0.0;
+    }
+}
+
+void MultiRateScheduler::printStats(std::ostream& os) const {
+    const std::ios::fmtflags flags = os.flags();
+    const std::streamsize precision = os.precision();
+
+    os << "Scheduler (" << base_rate_ << " Hz base, " << tick_ << " ticks)" << std::endl;
+
+    for (const TaskStats& stats : stats_) {
+        const double mean_us = stats.calls ? 1000.0 * stats.total_ms / static_cast<double>(stats.calls) : 0.0;
+
+        os << "  " << std::left << std::setw(16) << stats.name << std::right
+           << std::setw(8) << std::fixed << std::setprecision(1) << stats.rate << " Hz"
+           << std::setw(10) << stats.calls << " calls"
+           << std::setw(10) << std::setprecision(2) << mean_us << " us avg"
+           << std::setw(10) << std::setprecision(2) << 1000.0 * stats.max_ms << " us max"
+           << std::endl;
+    }
+
+    os.flags(flags);
+    os.precision(precision);
+}
+
+} // namespace Physics
@@ -0,0 +1,106 @@
+#ifndef MULTIRATE_SCHEDULER_H
+#define MULTIRATE_SCHEDULER_H
+
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace Physics {
+
+/**
+ * @brief Planificador multi-frecuencia de los subsistemas de la simulación
+ *
+ * El tiempo avanza en ticks de la frecuencia base (la más rápida, normalmente
+ * la dinámica de cuerpo rígido). Cada tarea declara su frecuencia y se ejecuta
+ * cada N ticks, con N = round(frecuencia_base / frecuencia). Dentro de un tick
+ * las tareas se ejecutan en el orden en que se registraron, así la secuencia
+ * es determinística y se puede reproducir tick a tick (runTick).
+ *
+ * Cada tarea lleva contadores de llamadas y tiempo de CPU.
+ */
+class MultiRateScheduler {
+public:
+    /**
+     * @brief Función de una tarea
+     * @param dt Periodo de la tarea [s]
+     */
+    using TaskFunction = std::function<void(float dt)>;
+
+    struct TaskStats {
+        std::string name;
+        float rate;             // [Hz] frecuencia efectiva
+        std::uint64_t calls;
+        double total_ms;        // Tiempo de CPU acumulado [ms]
+        double max_ms;          // Peor llamada [ms]
+    };
+
+    /**
+     * @param base_rate Frecuencia base [Hz]
+     * @param max_ticks_per_advance Límite de ticks por llamada a advance()
+     *        (evita la espiral de la muerte tras una pausa larga)
+     */
+    explicit MultiRateScheduler(float base_rate = 120.0f, unsigned int max_ticks_per_advance = 32);
+
+    /**
+     * @brief Registra una tarea
+     * @param name Nombre para las estadísticas
+     * @param rate Frecuencia pedida [Hz], 0 = todos los ticks (sigue a la frecuencia base)
+     * @param function Trabajo de la tarea
+     * @return Índice de la tarea
+     */
+    std::size_t addTask(const std::string& name, float rate, TaskFunction function);
+
+    /**
+     * @brief Cambia la frecuencia base y recalcula los divisores de las tareas
+     */
+    void setBaseRate(float base_rate);
+    float getBaseRate() const { return base_rate_; }
+    float getBaseTimeStep() const { return 1.0f / base_rate_; }
+
+    /**
+     * @brief Avanza el tiempo real transcurrido ejecutando los ticks completos
+     * @param delta_time Tiempo desde la última llamada [s]
+     * @return Número de ticks ejecutados
+     */
+    unsigned int advance(float delta_time);
+
+    /**
+     * @brief Ejecuta las tareas que tocan en un tick concreto (sin mover el
+     *        contador de ticks), por ejemplo para re-simular una repetición
+     */
+    void runTick(std::uint64_t tick);
+
+    /**
+     * @brief Vuelve al tick 0 y descarta el tiempo acumulado
+     */
+    void reset();
+
+    std::uint64_t getTick() const { return tick_; }
+
+    const std::vector<TaskStats>& getStats() const { return stats_; }
+    void resetStats();
+    void printStats(std::ostream& os) const;
+
+private:
+    struct Task {
+        float requested_rate;       // [Hz], 0 = todos los ticks
+        std::uint32_t divider;      // Se ejecuta cuando tick % divider == 0
+        TaskFunction function;
+    };
+
+    float base_rate_;
+    unsigned int max_ticks_per_advance_;
+    std::uint64_t tick_;
+    double accumulator_;            // Tiempo real pendiente [s]
+
+    std::vector<Task> tasks_;
+    std::vector<TaskStats> stats_;
+
+    void updateDivider(std::size_t index);
+};
+
+} // namespace Physics
+
+#endif // MULTIRATE_SCHEDULER_H
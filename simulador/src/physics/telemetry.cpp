@@ -0,0 +1,264 @@
+#include "telemetry.h"
+#include <cstring>
+#include <iostream>
+#include <type_traits>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Physics {
+
+namespace {
+
+constexpr char kMagic[4] = {'D', 'L', 'T', 'M'};
+constexpr std::uint64_t kMask = TelemetryBlock::kCapacity - 1;
+
+static_assert((TelemetryBlock::kCapacity & kMask) == 0, "Capacity must be a power of two");
+static_assert(std::is_trivially_copyable<TelemetryRecord>::value, "TelemetryRecord is copied raw");
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free &&
+              std::atomic<std::uint64_t>::is_always_lock_free,
+              "Shared memory atomics must be lock free");
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// TelemetryPublisher
+// -----------------------------------------------------------------------------
+
+TelemetryPublisher::TelemetryPublisher() : block_(nullptr) {
+}
+
+TelemetryPublisher::~TelemetryPublisher() {
+    close();
+}
+
+bool TelemetryPublisher::open(const std::string& name) {
+    close();
+
+#ifdef _WIN32
+    std::cerr << "Telemetry: shared memory export is only available on POSIX systems" << std::endl;
+    (void)name;
+    return false;
+#else
+    const int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+    if (fd < 0) {
+        std::cerr << "Telemetry: cannot create shared memory " << name << std::endl;
+        return false;
+    }
+
+    if (ftruncate(fd, sizeof(TelemetryBlock)) != 0) {
+        std::cerr << "Telemetry: cannot size shared memory " << name << std::endl;
+        ::close(fd);
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    void* memory = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        std::cerr << "Telemetry: cannot map shared memory " << name << std::endl;
+        shm_unlink(name.c_str());
+        return false;
+    }
+
+    // Los lectores ignoran el segmento hasta que aparece el magic
+    block_ = static_cast<TelemetryBlock*>(memory);
+    std::memset(block_->magic, 0, sizeof(block_->magic));
+    std::atomic_thread_fence(std::memory_order_release);
+
+    block_->version = TelemetryBlock::kVersion;
+    block_->record_size = sizeof(TelemetryRecord);
+    block_->capacity = TelemetryBlock::kCapacity;
+    block_->published.store(0, std::memory_order_relaxed);
+    for (TelemetryBlock::Slot& slot : block_->slots) {
+        slot.sequence.store(0, std::memory_order_relaxed);
+    }
+
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(block_->magic, kMagic, sizeof(kMagic));
+
+    name_ = name;
+    return true;
+#endif
+}
+
+void TelemetryPublisher::close() {
+    if (!block_) {
+        return;
+    }
+
+#ifndef _WIN32
+    munmap(block_, sizeof(TelemetryBlock));
+    shm_unlink(name_.c_str());
+#endif
+
+    block_ = nullptr;
+    name_.clear();
+}
+
+void TelemetryPublisher::publish(const TelemetryRecord& record) {
+    if (!block_) {
+        return;
+    }
+
+    const std::uint64_t index = block_->published.load(std::memory_order_relaxed);
+    TelemetryBlock::Slot& slot = block_->slots[index & kMask];
+
+    // Secuencia impar: registro en escritura
+    const std::uint32_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.index = index;
+    std::memcpy(&slot.record, &record, sizeof(TelemetryRecord));
+
+    // Secuencia par: registro consistente
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    block_->published.store(index + 1, std::memory_order_release);
+}
+
+// -----------------------------------------------------------------------------
+// TelemetryReader
+// -----------------------------------------------------------------------------
+
+TelemetryReader::TelemetryReader() : block_(nullptr), device_(0), inode_(0) {
+}
+
+TelemetryReader::~TelemetryReader() {
+    close();
+}
+
+bool TelemetryReader::open(const std::string& name) {
+    close();
+
+#ifdef _WIN32
+    std::cerr << "Telemetry: shared memory export is only available on POSIX systems" << std::endl;
+    (void)name;
+    return false;
+#else
+    const int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<std::size_t>(info.st_size) < sizeof(TelemetryBlock)) {
+        ::close(fd);
+        return false;
+    }
+
+    void* memory = mmap(nullptr, sizeof(TelemetryBlock), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);
+
+    if (memory == MAP_FAILED) {
+        return false;
+    }
+
+    const TelemetryBlock* block = static_cast<const TelemetryBlock*>(memory);
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (std::memcmp(block->magic, kMagic, sizeof(kMagic)) != 0 ||
+        block->version != TelemetryBlock::kVersion ||
+        block->record_size != sizeof(TelemetryRecord) ||
+        block->capacity != TelemetryBlock::kCapacity) {
+        munmap(memory, sizeof(TelemetryBlock));
+        return false;
+    }
+
+    block_ = block;
+    name_ = name;
+    device_ = static_cast<std::uint64_t>(info.st_dev);
+    inode_ = static_cast<std::uint64_t>(info.st_ino);
+    return true;
+#endif
+}
+
+void TelemetryReader::close() {
+    if (!block_) {
+        return;
+    }
+
+#ifndef _WIN32
+    munmap(const_cast<TelemetryBlock*>(block_), sizeof(TelemetryBlock));
+#endif
+
+    block_ = nullptr;
+    name_.clear();
+}
+
+bool TelemetryReader::isCurrent() const {
+    if (!block_) {
+        return false;
+    }
+
+#ifdef _WIN32
+    return true;
+#else
+    // El publicador pone el magic a cero mientras reinicializa el segmento
+    if (std::memcmp(block_->magic, kMagic, sizeof(kMagic)) != 0) {
+        return false;
+    }
+
+    // Un simulador nuevo elimina el segmento y crea otro con el mismo nombre:
+    // el mapeado sigue siendo válido pero ya nadie escribe en él
+    const int fd = shm_open(name_.c_str(), O_RDONLY, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat info;
+    const bool same = fstat(fd, &info) == 0 &&
+                      static_cast<std::uint64_t>(info.st_dev) == device_ &&
+                      static_cast<std::uint64_t>(info.st_ino) == inode_;
+    ::close(fd);
+    return same;
+#endif
+}
+
+std::uint64_t TelemetryReader::getPublished() const {
+    return block_ ? block_->published.load(std::memory_order_acquire) : 0;
+}
+
+bool TelemetryReader::read(std::uint64_t index, TelemetryRecord& record) const {
+    if (!block_) {
+        return false;
+    }
+
+    const TelemetryBlock::Slot& slot = block_->slots[index & kMask];
+
+    for (;;) {
+        const std::uint64_t published = block_->published.load(std::memory_order_acquire);
+        if (index >= published || published - index > TelemetryBlock::kCapacity) {
+            return false;
+        }
+
+        const std::uint32_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before & 1u) {
+            continue;   // Escritura en curso
+        }
+
+        const std::uint64_t stored = slot.index;
+        std::memcpy(&record, &slot.record, sizeof(TelemetryRecord));
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            // El escritor pudo dar la vuelta al anillo antes de la copia
+            return stored == index;
+        }
+    }
+}
+
+bool TelemetryReader::readLatest(TelemetryRecord& record) const {
+    const std::uint64_t published = getPublished();
+    if (published == 0) {
+        return false;
+    }
+    return read(published - 1, record);
+}
+
+} // namespace Physics
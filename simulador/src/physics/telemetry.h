@@ -0,0 +1,137 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <dlfdm/defines.h>
+#include "flight_data.h"
+
+namespace Physics {
+
+/**
+ * @brief Muestra de telemetría publicada en cada paso de la física
+ */
+struct TelemetryRecord {
+    std::uint64_t step;                 // Paso de la física (tick del planificador)
+    float time;                         // [s] tiempo de simulación
+    dlfdm::AircraftState state;         // Estado tal como se integra (ver attitude_mode)
+    dlfdm::AttitudeMode attitude_mode;  // QUATERNION: phi, theta, psi sin actualizar, vale state.attitude
+                                        // EULER: state.attitude sin actualizar
+    dlfdm::ControlInputs controls;
+    FlightData flight_data;             // Datos del HUD, refrescados a FLIGHT_DATA_RATE
+};
+
+/**
+ * @brief Memoria compartida POSIX con un anillo de registros protegidos por seqlock
+ *
+ * Un único escritor (el simulador) y cualquier número de lectores locales que
+ * mapean el segmento en sólo lectura: sin sockets, sin bloqueos y sin que los
+ * lectores puedan frenar la simulación. Cada ranura tiene su secuencia: impar
+ * mientras se escribe, par cuando el registro es consistente. El lector copia
+ * el registro y lo descarta si la secuencia cambió entretanto.
+ */
+struct TelemetryBlock {
+    static constexpr std::uint32_t kVersion = 3;
+    static constexpr std::uint32_t kCapacity = 1024;    // Potencia de 2 (> 1 s a 1000 Hz)
+
+    struct Slot {
+        std::atomic<std::uint32_t> sequence;
+        std::uint64_t index;                // Número de registro guardado en la ranura
+        TelemetryRecord record;
+    };
+
+    char magic[4];                          // "DLTM", se escribe el último al crear
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint32_t capacity;
+    std::atomic<std::uint64_t> published;   // Registros publicados desde el inicio
+    Slot slots[kCapacity];
+};
+
+/**
+ * @brief Lado del simulador: crea el segmento y publica los registros
+ */
+class TelemetryPublisher {
+public:
+    static constexpr const char* DEFAULT_NAME = "/dlfdm_telemetry";
+
+    TelemetryPublisher();
+    ~TelemetryPublisher();
+
+    TelemetryPublisher(const TelemetryPublisher&) = delete;
+    TelemetryPublisher& operator=(const TelemetryPublisher&) = delete;
+
+    /**
+     * @brief Crea (o reutiliza) el segmento de memoria compartida
+     * @param name Nombre POSIX del segmento ("/nombre")
+     */
+    bool open(const std::string& name = DEFAULT_NAME);
+
+    /**
+     * @brief Desmapea y elimina el segmento
+     */
+    void close();
+
+    bool isOpen() const { return block_ != nullptr; }
+
+    /**
+     * @brief Publica un registro (sin bloqueos, apto para el bucle de la física)
+     */
+    void publish(const TelemetryRecord& record);
+
+private:
+    TelemetryBlock* block_;
+    std::string name_;
+};
+
+/**
+ * @brief Lado de las herramientas externas: mapea el segmento en sólo lectura
+ */
+class TelemetryReader {
+public:
+    TelemetryReader();
+    ~TelemetryReader();
+
+    TelemetryReader(const TelemetryReader&) = delete;
+    TelemetryReader& operator=(const TelemetryReader&) = delete;
+
+    bool open(const std::string& name = TelemetryPublisher::DEFAULT_NAME);
+    void close();
+
+    bool isOpen() const { return block_ != nullptr; }
+
+    /**
+     * @brief Comprueba que el segmento mapeado sigue siendo el publicado con ese nombre
+     * @return false si el simulador lo eliminó, lo creó de nuevo o lo está
+     * reinicializando: hay que cerrar y volver a abrir
+     */
+    bool isCurrent() const;
+
+    /**
+     * @brief Número de registros publicados hasta ahora
+     */
+    std::uint64_t getPublished() const;
+
+    /**
+     * @brief Lee el registro número index (0 = el primero publicado)
+     * @return false si todavía no se publicó o ya fue sobrescrito en el anillo
+     */
+    bool read(std::uint64_t index, TelemetryRecord& record) const;
+
+    /**
+     * @brief Lee el último registro publicado
+     */
+    bool readLatest(TelemetryRecord& record) const;
+
+private:
+    const TelemetryBlock* block_;
+    std::string name_;
+    std::uint64_t device_;                  // Identidad del segmento mapeado (st_dev, st_ino)
+    std::uint64_t inode_;
+};
+
+} // namespace Physics
+
+#endif // TELEMETRY_H
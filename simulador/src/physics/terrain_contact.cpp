@@ -0,0 +1,134 @@
+#include "terrain_contact.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Physics {
+
+TerrainContact::TerrainContact()
+    : spacing_(1.0f),
+      inv_spacing_(1.0f),
+      cache_(CACHE_SIZE * CACHE_SIZE),
+      node_lookups_(0),
+      node_misses_(0) {
+    clearCache();
+}
+
+void TerrainContact::setTerrain(HeightFunction height, float grid_spacing) {
+    height_ = std::move(height);
+    spacing_ = std::max(grid_spacing, 1e-3f);
+    inv_spacing_ = 1.0f / spacing_;
+    clearCache();
+}
+
+void TerrainContact::clearCache() {
+    for (Node& node : cache_) {
+        node.valid = false;
+    }
+}
+
+float TerrainContact::nodeHeight(int ix, int iz) {
+    ++node_lookups_;
+
+    Node& node = cache_[(ix & (CACHE_SIZE - 1)) + ((iz & (CACHE_SIZE - 1)) << CACHE_BITS)];
+    if (!node.valid || node.ix != ix || node.iz != iz) {
+        ++node_misses_;
+        node.ix = ix;
+        node.iz = iz;
+        node.height = height_(static_cast<float>(ix) * spacing_, static_cast<float>(iz) * spacing_);
+        node.valid = true;
+    }
+    return node.height;
+}
+
+float TerrainContact::getHeight(float x, float z) {
+    if (!height_) {
+        return 0.0f;
+    }
+
+    const float gx = x * inv_spacing_;
+    const float gz = z * inv_spacing_;
+    const float cell_x = std::floor(gx);
+    const float cell_z = std::floor(gz);
+    const int ix = static_cast<int>(cell_x);
+    const int iz = static_cast<int>(cell_z);
+    const float fx = gx - cell_x;
+    const float fz = gz - cell_z;
+
+    // Mismos triángulos que la malla: (TL, BL, TR) y (TR, BL, BR)
+    const float top_right = nodeHeight(ix + 1, iz);
+    const float bottom_left = nodeHeight(ix, iz + 1);
+
+    if (fx + fz <= 1.0f) {
+        const float top_left = nodeHeight(ix, iz);
+        return top_left + fx * (top_right - top_left) + fz * (bottom_left - top_left);
+    }
+
+    const float bottom_right = nodeHeight(ix + 1, iz + 1);
+    return bottom_right + (1.0f - fx) * (bottom_left - bottom_right) + (1.0f - fz) * (top_right - bottom_right);
+}
+
+void TerrainContact::getHeights(const float* x, const float* z, float* out, std::size_t count) {
+    for (std::size_t i = 0; i < count; ++i) {
+        out[i] = getHeight(x[i], z[i]);
+    }
+}
+
+bool TerrainContact::sweep(const glm::vec3& from, const glm::vec3& to, float& fraction) {
+    fraction = 1.0f;
+    if (!height_) {
+        return false;
+    }
+
+    // Dentro de un triángulo la holgura es lineal: basta con no saltarse triángulos
+    const glm::vec3 delta = to - from;
+    const float horizontal = std::sqrt(delta.x * delta.x + delta.z * delta.z);
+    const int samples = std::max(1, std::min(MAX_SWEEP_SAMPLES,
+                                             static_cast<int>(std::ceil(2.0f * horizontal * inv_spacing_))));
+
+    float previous_t = 0.0f;
+    float previous_clearance = from.y - getHeight(from.x, from.z);
+    if (previous_clearance <= 0.0f) {
+        fraction = 0.0f;
+        return true;
+    }
+
+    for (int i = 1; i <= samples; ++i) {
+        const float t = static_cast<float>(i) / static_cast<float>(samples);
+        const glm::vec3 p = from + delta * t;
+        const float clearance = p.y - getHeight(p.x, p.z);
+
+        if (clearance <= 0.0f) {
+            fraction = previous_t + (t - previous_t) * previous_clearance / (previous_clearance - clearance);
+            return true;
+        }
+
+        previous_t = t;
+        previous_clearance = clearance;
+    }
+
+    return false;
+}
+
+float TerrainContact::clearanceAhead(const glm::vec3& position, const glm::vec3& velocity, float horizon) {
+    float x[LOOKAHEAD_SAMPLES];
+    float z[LOOKAHEAD_SAMPLES];
+    float ground[LOOKAHEAD_SAMPLES];
+
+    for (int i = 0; i < LOOKAHEAD_SAMPLES; ++i) {
+        const float t = horizon * static_cast<float>(i + 1) / static_cast<float>(LOOKAHEAD_SAMPLES);
+        x[i] = position.x + velocity.x * t;
+        z[i] = position.z + velocity.z * t;
+    }
+
+    getHeights(x, z, ground, LOOKAHEAD_SAMPLES);
+
+    float min_clearance = position.y - getHeight(position.x, position.z);
+    for (int i = 0; i < LOOKAHEAD_SAMPLES; ++i) {
+        const float t = horizon * static_cast<float>(i + 1) / static_cast<float>(LOOKAHEAD_SAMPLES);
+        min_clearance = std::min(min_clearance, position.y + velocity.y * t - ground[i]);
+    }
+
+    return min_clearance;
+}
+
+} // namespace Physics
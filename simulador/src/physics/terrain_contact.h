@@ -0,0 +1,124 @@
+#ifndef TERRAIN_CONTACT_H
+#define TERRAIN_CONTACT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Physics {
+
+/**
+ * @brief Consulta de la altura del terreno para la física (AGL, contacto y
+ *        terreno por delante)
+ *
+ * El terreno se ve como la malla que se dibuja: una rejilla regular de paso
+ * grid_spacing alineada con el origen, cada celda partida en dos triángulos
+ * por la diagonal (x+1, z)-(x, z+1). Sólo se evalúa la función de altura en
+ * los nodos de la rejilla y se interpola en el triángulo, así el contacto
+ * coincide con la superficie dibujada y no con el ruido continuo.
+ *
+ * Los nodos se guardan en una caché de correspondencia directa (toroidal)
+ * indexada por las coordenadas enteras del nodo: al volar se reutilizan los
+ * mismos pocos nodos durante cientos de pasos y la función de altura (ruido
+ * de Perlin) sólo se evalúa al entrar en celdas nuevas.
+ *
+ * Coordenadas del mundo de la escena: x = Este, y = arriba, z = -Norte [m].
+ */
+class TerrainContact {
+public:
+    /**
+     * @brief Altura del terreno [m] en un punto (x, z) del mundo
+     */
+    using HeightFunction = std::function<float(float x, float z)>;
+
+    TerrainContact();
+
+    /**
+     * @brief Asigna el terreno y vacía la caché
+     * @param height Función de altura (la misma que genera la malla)
+     * @param grid_spacing Paso de la rejilla de la malla [m]
+     */
+    void setTerrain(HeightFunction height, float grid_spacing);
+
+    bool hasTerrain() const { return static_cast<bool>(height_); }
+    float getGridSpacing() const { return spacing_; }
+
+    /**
+     * @brief Altura del terreno interpolada en la malla [m]
+     */
+    float getHeight(float x, float z);
+
+    /**
+     * @brief Alturas de varios puntos (x[i], z[i]) en una llamada
+     */
+    void getHeights(const float* x, const float* z, float* out, std::size_t count);
+
+    /**
+     * @brief Barrido de un segmento contra el terreno
+     *
+     * Submuestrea el segmento a menos de media celda (la holgura es lineal
+     * dentro de un triángulo) y refina el primer cruce interpolando la holgura.
+     *
+     * @param from Posición al inicio del paso [m]
+     * @param to Posición al final del paso [m]
+     * @param fraction Fracción del segmento en el primer contacto, [0, 1]
+     * @return true si el segmento toca o atraviesa el terreno
+     */
+    bool sweep(const glm::vec3& from, const glm::vec3& to, float& fraction);
+
+    /**
+     * @brief Holgura mínima sobre el terreno a lo largo de la trayectoria
+     *        rectilínea prevista
+     * @param position Posición actual [m]
+     * @param velocity Velocidad respecto a tierra [m/s]
+     * @param horizon Tiempo de previsión [s]
+     * @return Holgura mínima [m] (negativa si la trayectoria entra en el terreno)
+     */
+    float clearanceAhead(const glm::vec3& position, const glm::vec3& velocity, float horizon);
+
+    /**
+     * @brief Vacía la caché de nodos (la función de altura no cambia)
+     */
+    void clearCache();
+
+    /**
+     * @brief Estadísticas de la caché: consultas de nodo y evaluaciones de la función
+     */
+    std::uint64_t getNodeLookups() const { return node_lookups_; }
+    std::uint64_t getNodeMisses() const { return node_misses_; }
+
+private:
+    struct Node {
+        int ix;
+        int iz;
+        float height;
+        bool valid;
+    };
+
+    // Caché de CACHE_SIZE x CACHE_SIZE nodos (potencia de 2, 64 km con celdas de 1 km)
+    static constexpr int CACHE_BITS = 6;
+    static constexpr int CACHE_SIZE = 1 << CACHE_BITS;
+
+    // Submuestras del barrido y de la previsión
+    static constexpr int MAX_SWEEP_SAMPLES = 16;
+    static constexpr int LOOKAHEAD_SAMPLES = 8;
+
+    HeightFunction height_;
+    float spacing_;
+    float inv_spacing_;
+    std::vector<Node> cache_;
+
+    std::uint64_t node_lookups_;
+    std::uint64_t node_misses_;
+
+    /**
+     * @brief Altura en un nodo de la rejilla (de la caché o evaluando la función)
+     */
+    float nodeHeight(int ix, int iz);
+};
+
+} // namespace Physics
+
+#endif // TERRAIN_CONTACT_H
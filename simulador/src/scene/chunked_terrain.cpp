@@ -1,15 +1,83 @@
 #include "chunked_terrain.h"
 #include "terrain.h" // Para reutilizar tipos y coherencia
-#include "../utils/perlin_noise.h"
+#include "scenery.h"
+#include "../graphics/rendering/gl_state.h"
 #include <glad/glad.h>
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 
 namespace Scene {
 
-ChunkedTerrain::ChunkedTerrain(const std::string &name) : name_(name) {}
+struct ChunkedTerrain::ChunkBuild {
+    ChunkKey key;
+    glm::vec2 origin;
+    std::vector<float> vertices;
+    std::vector<unsigned int> indices;
+    ChunkScatter scatter;
+};
+
+// === ChunkHeightGrid ===
+
+float ChunkHeightGrid::getHeight(float x, float z) const {
+    const float fx = std::min(std::max((x - start_x) / x_step, 0.0f), static_cast<float>(width_segments));
+    const float fz = std::min(std::max((z - start_z) / z_step, 0.0f), static_cast<float>(depth_segments));
+    const int cx = std::min(static_cast<int>(fx), width_segments - 1);
+    const int cz = std::min(static_cast<int>(fz), depth_segments - 1);
+    const float u = fx - cx;
+    const float v = fz - cz;
+
+    // Cada celda son dos triángulos separados por la diagonal (x, z + 1) - (x + 1, z)
+    if (u + v <= 1.0f) {
+        const float h00 = at(cx, cz);
+        return h00 + u * (at(cx + 1, cz) - h00) + v * (at(cx, cz + 1) - h00);
+    }
+    const float h11 = at(cx + 1, cz + 1);
+    return h11 + (1.0f - u) * (at(cx, cz + 1) - h11) + (1.0f - v) * (at(cx + 1, cz) - h11);
+}
+
+glm::vec3 ChunkHeightGrid::getNormal(float x, float z) const {
+    const float fx = std::min(std::max((x - start_x) / x_step, 0.0f), static_cast<float>(width_segments));
+    const float fz = std::min(std::max((z - start_z) / z_step, 0.0f), static_cast<float>(depth_segments));
+    const int cx = std::min(static_cast<int>(fx), width_segments - 1);
+    const int cz = std::min(static_cast<int>(fz), depth_segments - 1);
+
+    float dx, dz;
+    if ((fx - cx) + (fz - cz) <= 1.0f) {
+        dx = at(cx + 1, cz) - at(cx, cz);
+        dz = at(cx, cz + 1) - at(cx, cz);
+    } else {
+        dx = at(cx + 1, cz + 1) - at(cx, cz + 1);
+        dz = at(cx + 1, cz + 1) - at(cx + 1, cz);
+    }
+
+    const glm::vec3 tangent_x(x_step, dx, 0.0f);
+    const glm::vec3 tangent_z(0.0f, dz, z_step);
+    return glm::normalize(glm::cross(tangent_z, tangent_x));
+}
+
+// === ChunkedTerrain ===
+
+ChunkedTerrain::ChunkedTerrain(const std::string &name, int num_threads) : name_(name) {
+    // Al menos un hilo: construir un chunk en el de render congela el frame
+    if (num_threads < 0) {
+        num_threads = std::min(2, std::max(1, static_cast<int>(std::thread::hardware_concurrency()) - 1));
+    }
+    for (int i = 0; i < num_threads; ++i) {
+        workers_.emplace_back(&ChunkedTerrain::workerLoop, this);
+    }
+}
 
 ChunkedTerrain::~ChunkedTerrain() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+
     for (auto &kv : chunks_) {
         destroyChunk(kv.second);
     }
@@ -18,11 +86,13 @@ ChunkedTerrain::~ChunkedTerrain() {
 
 bool ChunkedTerrain::initialize(const ChunkedTerrainConfig &cfg) {
     config_ = cfg;
+    perlin_ = Utils::PerlinNoise(config_.noise_seed);
     // No generamos nada aún, se hará en update() según la cámara
     std::cout << "ChunkedTerrain '" << name_ << "' initialized (chunk "
               << config_.chunk_width << "x" << config_.chunk_depth
               << ", segments " << config_.width_segments << "x" << config_.depth_segments
-              << ", radius " << config_.view_radius_chunks << ")" << std::endl;
+              << ", radius " << config_.view_radius_chunks
+              << ", " << workers_.size() << " build threads)" << std::endl;
     return true;
 }
 
@@ -31,11 +101,15 @@ void ChunkedTerrain::update(const glm::vec3 &camera_pos) {
     int gx = static_cast<int>(std::floor(camera_pos.x / config_.chunk_width));
     int gz = static_cast<int>(std::floor(camera_pos.z / config_.chunk_depth));
 
-    // Asegurar todos los chunks dentro del radio
-    for (int dz = -config_.view_radius_chunks; dz <= config_.view_radius_chunks; ++dz) {
-        for (int dx = -config_.view_radius_chunks; dx <= config_.view_radius_chunks; ++dx) {
-            ensureChunk(gx + dx, gz + dz);
-        }
+    // Subir los chunks terminados y pedir los que falten dentro del radio
+    collectReady(gx, gz);
+    requestChunks(gx, gz);
+
+    // El chunk bajo la cámara no puede faltar: se espera a que termine
+    ChunkKey center{gx, gz};
+    if (chunks_.find(center) == chunks_.end()) {
+        waitForChunk(center);
+        collectReady(gx, gz);
     }
 
     // Eliminar los que queden muy lejos
@@ -43,49 +117,181 @@ void ChunkedTerrain::update(const glm::vec3 &camera_pos) {
 }
 
 void ChunkedTerrain::draw() const {
+    Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
     for (const auto &kv : chunks_) {
         const Chunk &c = kv.second;
         if (c.VAO == 0 || c.index_count == 0) continue;
-        glBindVertexArray(c.VAO);
+        gl_state.bindVertexArray(c.VAO);
         glDrawElements(GL_TRIANGLES, c.index_count, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
     }
 }
 
 float ChunkedTerrain::getHeightAt(float x, float z) const {
     if (!config_.use_perlin_noise) return config_.y_position;
-    Utils::PerlinNoise perlin(config_.noise_seed);
-    float h = config_.y_position + perlin.getTerrainHeight(
+    float h = config_.y_position + perlin_.getTerrainHeight(
         x, z, config_.noise_scale, config_.height_multiplier, config_.noise_octaves);
     return h;
 }
 
-void ChunkedTerrain::ensureChunk(int gx, int gz) {
-    ChunkKey key{gx, gz};
-    if (chunks_.find(key) != chunks_.end()) return;
-    createChunk(gx, gz);
+float ChunkedTerrain::getSurfaceHeightAt(float x, float z) const {
+    // Celda de la rejilla que contiene el punto (los chunks empiezan en múltiplos del paso)
+    ChunkHeightGrid cell;
+    cell.width_segments = 1;
+    cell.depth_segments = 1;
+    cell.x_step = config_.chunk_width / static_cast<float>(config_.width_segments);
+    cell.z_step = config_.chunk_depth / static_cast<float>(config_.depth_segments);
+    cell.start_x = std::floor(x / cell.x_step) * cell.x_step;
+    cell.start_z = std::floor(z / cell.z_step) * cell.z_step;
+    cell.heights = {getHeightAt(cell.start_x, cell.start_z),
+                    getHeightAt(cell.start_x + cell.x_step, cell.start_z),
+                    getHeightAt(cell.start_x, cell.start_z + cell.z_step),
+                    getHeightAt(cell.start_x + cell.x_step, cell.start_z + cell.z_step)};
+    return cell.getHeight(x, z);
 }
 
-void ChunkedTerrain::createChunk(int gx, int gz) {
-    ChunkKey key{gx, gz};
-    Chunk chunk;
-    chunk.origin = glm::vec2((gx + 0.5f) * config_.chunk_width, (gz + 0.5f) * config_.chunk_depth);
+size_t ChunkedTerrain::getPendingChunkCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pending_.size();
+}
 
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    buildChunkMesh(chunk.origin.x, chunk.origin.y, vertices, indices);
+bool ChunkedTerrain::isInRange(const ChunkKey &key, int center_gx, int center_gz) const {
+    return std::abs(key.gx - center_gx) <= config_.view_radius_chunks &&
+           std::abs(key.gz - center_gz) <= config_.view_radius_chunks;
+}
+
+void ChunkedTerrain::requestChunks(int center_gx, int center_gz) {
+    std::vector<ChunkKey> missing;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // Los que siguen en cola y ya no hacen falta no se construyen
+        for (auto it = queue_.begin(); it != queue_.end();) {
+            if (!isInRange(*it, center_gx, center_gz)) {
+                pending_.erase(*it);
+                it = queue_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+
+        for (int dz = -config_.view_radius_chunks; dz <= config_.view_radius_chunks; ++dz) {
+            for (int dx = -config_.view_radius_chunks; dx <= config_.view_radius_chunks; ++dx) {
+                ChunkKey key{center_gx + dx, center_gz + dz};
+                if (chunks_.find(key) == chunks_.end() && pending_.find(key) == pending_.end()) {
+                    missing.push_back(key);
+                }
+            }
+        }
+    }
+    if (missing.empty()) return;
+
+    // Del más cercano a la cámara al más lejano
+    std::sort(missing.begin(), missing.end(), [center_gx, center_gz](const ChunkKey &a, const ChunkKey &b) {
+        const int da = (a.gx - center_gx) * (a.gx - center_gx) + (a.gz - center_gz) * (a.gz - center_gz);
+        const int db = (b.gx - center_gx) * (b.gx - center_gx) + (b.gz - center_gz) * (b.gz - center_gz);
+        return da < db;
+    });
+
+    // Sin hilos de trabajo se construyen aquí mismo
+    if (workers_.empty()) {
+        for (const ChunkKey &key : missing) {
+            std::unique_ptr<ChunkBuild> build = buildChunk(key);
+            uploadChunk(*build);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const ChunkKey &key : missing) {
+            pending_.insert(key);
+        }
+        // Los nuevos van delante: están más cerca de la cámara actual
+        queue_.insert(queue_.begin(), missing.begin(), missing.end());
+    }
+    work_cv_.notify_all();
+}
+
+void ChunkedTerrain::collectReady(int center_gx, int center_gz) {
+    std::vector<std::unique_ptr<ChunkBuild>> ready;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ready.swap(ready_);
+        // Hasta aquí siguen pendientes: requestChunks no los vuelve a encolar
+        for (const auto &build : ready) {
+            pending_.erase(build->key);
+        }
+    }
+
+    for (auto &build : ready) {
+        // La cámara puede haberse alejado mientras se construía
+        if (!isInRange(build->key, center_gx, center_gz) || chunks_.find(build->key) != chunks_.end()) continue;
+        uploadChunk(*build);
+    }
+}
+
+void ChunkedTerrain::waitForChunk(const ChunkKey &key) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this, &key]() {
+        return pending_.find(key) == pending_.end() ||
+               std::any_of(ready_.begin(), ready_.end(),
+                           [&key](const std::unique_ptr<ChunkBuild> &build) { return build->key == key; });
+    });
+}
+
+void ChunkedTerrain::workerLoop() {
+    for (;;) {
+        ChunkKey key;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            work_cv_.wait(lock, [this]() { return stop_ || !queue_.empty(); });
+            if (stop_) return;
+            key = queue_.front();
+            queue_.pop_front();
+        }
+
+        std::unique_ptr<ChunkBuild> build = buildChunk(key);
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            ready_.push_back(std::move(build)); // sigue en pending_ hasta collectReady
+        }
+        done_cv_.notify_all();
+    }
+}
+
+std::unique_ptr<ChunkedTerrain::ChunkBuild> ChunkedTerrain::buildChunk(const ChunkKey &key) const {
+    auto build = std::make_unique<ChunkBuild>();
+    build->key = key;
+    build->origin = glm::vec2((key.gx + 0.5f) * config_.chunk_width, (key.gz + 0.5f) * config_.chunk_depth);
+
+    ChunkHeightGrid grid;
+    buildHeightGrid(build->origin.x, build->origin.y, grid);
+    buildChunkMesh(grid, build->vertices, build->indices);
+
+    // Los objetos se apoyan en la misma rejilla de alturas
+    if (scenery_) {
+        build->scatter = scenery_->scatter(key, grid);
+    }
+    return build;
+}
+
+void ChunkedTerrain::uploadChunk(ChunkBuild &build) {
+    Chunk chunk;
+    chunk.origin = build.origin;
 
     // Crear buffers
+    Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
     glGenVertexArrays(1, &chunk.VAO);
-    glBindVertexArray(chunk.VAO);
+    gl_state.bindVertexArray(chunk.VAO);
 
     glGenBuffers(1, &chunk.VBO);
-    glBindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    gl_state.bindBuffer(GL_ARRAY_BUFFER, chunk.VBO);
+    glBufferData(GL_ARRAY_BUFFER, build.vertices.size() * sizeof(float), build.vertices.data(), GL_STATIC_DRAW);
 
     glGenBuffers(1, &chunk.EBO);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
+    gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, chunk.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, build.indices.size() * sizeof(unsigned int), build.indices.data(), GL_STATIC_DRAW);
 
     // Atributos (pos 0..2, normal 3..5, uv 6..7)
     glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)0);
@@ -95,25 +301,28 @@ void ChunkedTerrain::createChunk(int gx, int gz) {
     glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
     glEnableVertexAttribArray(2);
 
-    glBindVertexArray(0);
+    gl_state.bindVertexArray(0);
 
-    chunk.index_count = static_cast<unsigned int>(indices.size());
-    chunks_.emplace(key, std::move(chunk));
+    chunk.index_count = static_cast<unsigned int>(build.indices.size());
+    chunks_.emplace(build.key, std::move(chunk));
+
+    if (scenery_) {
+        scenery_->addChunk(build.key, std::move(build.scatter));
+    }
 }
 
 void ChunkedTerrain::destroyChunk(Chunk &c) {
-    if (c.VAO) glDeleteVertexArrays(1, &c.VAO);
-    if (c.VBO) glDeleteBuffers(1, &c.VBO);
-    if (c.EBO) glDeleteBuffers(1, &c.EBO);
+    Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
+    gl_state.deleteVertexArray(c.VAO);
+    gl_state.deleteBuffer(c.VBO);
+    gl_state.deleteBuffer(c.EBO);
     c = Chunk{};
 }
 
 void ChunkedTerrain::evictFarChunks(int center_gx, int center_gz) {
     std::vector<ChunkKey> to_remove;
     for (const auto &kv : chunks_) {
-        int dx = std::abs(kv.first.gx - center_gx);
-        int dz = std::abs(kv.first.gz - center_gz);
-        if (dx > config_.view_radius_chunks || dz > config_.view_radius_chunks) {
+        if (!isInRange(kv.first, center_gx, center_gz)) {
             to_remove.push_back(kv.first);
         }
     }
@@ -122,54 +331,59 @@ void ChunkedTerrain::evictFarChunks(int center_gx, int center_gz) {
         if (it != chunks_.end()) {
             destroyChunk(it->second);
             chunks_.erase(it);
+            if (scenery_) {
+                scenery_->removeChunk(k);
+            }
         }
     }
 }
 
-void ChunkedTerrain::buildChunkMesh(float origin_x, float origin_z,
-                                    std::vector<float> &out_vertices,
-                                    std::vector<unsigned int> &out_indices) {
-    out_vertices.clear();
-    out_indices.clear();
-
-    Utils::PerlinNoise perlin(config_.noise_seed);
-
-    // Pasos
-    float x_step = config_.chunk_width / static_cast<float>(config_.width_segments);
-    float z_step = config_.chunk_depth / static_cast<float>(config_.depth_segments);
-    float u_step = config_.texture_repeat / static_cast<float>(config_.width_segments);
-    float v_step = config_.texture_repeat / static_cast<float>(config_.depth_segments);
+void ChunkedTerrain::buildHeightGrid(float origin_x, float origin_z, ChunkHeightGrid &grid) const {
+    grid.width_segments = config_.width_segments;
+    grid.depth_segments = config_.depth_segments;
+    grid.x_step = config_.chunk_width / static_cast<float>(config_.width_segments);
+    grid.z_step = config_.chunk_depth / static_cast<float>(config_.depth_segments);
 
     // Inicio (centrado en el origin)
-    float start_x = origin_x - config_.chunk_width * 0.5f;
-    float start_z = origin_z - config_.chunk_depth * 0.5f;
-
-    // Almacenar alturas para normales
-    std::vector<std::vector<float>> heights(config_.depth_segments + 1,
-                                            std::vector<float>(config_.width_segments + 1));
+    grid.start_x = origin_x - config_.chunk_width * 0.5f;
+    grid.start_z = origin_z - config_.chunk_depth * 0.5f;
 
+    grid.heights.resize(static_cast<size_t>(config_.depth_segments + 1) * (config_.width_segments + 1));
     for (int z = 0; z <= config_.depth_segments; ++z) {
         for (int x = 0; x <= config_.width_segments; ++x) {
-            float pos_x = start_x + x * x_step;
-            float pos_z = start_z + z * z_step;
+            float pos_x = grid.start_x + x * grid.x_step;
+            float pos_z = grid.start_z + z * grid.z_step;
             float height = config_.y_position;
             if (config_.use_perlin_noise) {
-                height = config_.y_position + perlin.getTerrainHeight(
+                height = config_.y_position + perlin_.getTerrainHeight(
                     pos_x, pos_z,
                     config_.noise_scale,
                     config_.height_multiplier,
                     config_.noise_octaves);
             }
-            heights[z][x] = height;
+            grid.heights[z * (config_.width_segments + 1) + x] = height;
         }
     }
+}
+
+void ChunkedTerrain::buildChunkMesh(const ChunkHeightGrid &grid,
+                                    std::vector<float> &out_vertices,
+                                    std::vector<unsigned int> &out_indices) const {
+    out_vertices.clear();
+    out_indices.clear();
+
+    // Pasos
+    float x_step = grid.x_step;
+    float z_step = grid.z_step;
+    float u_step = config_.texture_repeat / static_cast<float>(config_.width_segments);
+    float v_step = config_.texture_repeat / static_cast<float>(config_.depth_segments);
 
     // Vértices
     for (int z = 0; z <= config_.depth_segments; ++z) {
         for (int x = 0; x <= config_.width_segments; ++x) {
-            float pos_x = start_x + x * x_step;
-            float pos_y = heights[z][x];
-            float pos_z = start_z + z * z_step;
+            float pos_x = grid.start_x + x * x_step;
+            float pos_y = grid.at(x, z);
+            float pos_z = grid.start_z + z * z_step;
 
             float u = x * u_step;
             float v = z * v_step;
@@ -177,10 +391,10 @@ void ChunkedTerrain::buildChunkMesh(float origin_x, float origin_z,
             // Normal
             glm::vec3 normal(0.0f, 1.0f, 0.0f);
             if (config_.use_perlin_noise) {
-                float hL = (x > 0) ? heights[z][x - 1] : pos_y;
-                float hR = (x < config_.width_segments) ? heights[z][x + 1] : pos_y;
-                float hD = (z > 0) ? heights[z - 1][x] : pos_y;
-                float hU = (z < config_.depth_segments) ? heights[z + 1][x] : pos_y;
+                float hL = (x > 0) ? grid.at(x - 1, z) : pos_y;
+                float hR = (x < config_.width_segments) ? grid.at(x + 1, z) : pos_y;
+                float hD = (z > 0) ? grid.at(x, z - 1) : pos_y;
+                float hU = (z < config_.depth_segments) ? grid.at(x, z + 1) : pos_y;
                 glm::vec3 tangent_x(2.0f * x_step, hR - hL, 0.0f);
                 glm::vec3 tangent_z(0.0f, hU - hD, 2.0f * z_step);
                 normal = glm::normalize(glm::cross(tangent_z, tangent_x));
@@ -1,12 +1,21 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 #include <string>
+#include "../utils/perlin_noise.h"
 
 namespace Scene {
 
+class Scenery;
+
 // Parámetros base tomados de TerrainConfig (cada chunk tendrá este tamaño)
 struct ChunkedTerrainConfig {
     float chunk_width;      // tamaño del chunk en X (mismo que TerrainConfig::width)
@@ -26,13 +35,54 @@ struct ChunkedTerrainConfig {
     int view_radius_chunks = 2; // radio de chunks alrededor de la cámara (2 -> 5x5)
 };
 
+/**
+ * @brief Alturas de los vértices de un chunk
+ *
+ * getHeight() y getNormal() interpolan sobre los mismos triángulos que se
+ * dibujan, así lo que se coloca encima queda apoyado en la malla y no en el
+ * ruido (que tiene más detalle que la rejilla).
+ */
+struct ChunkHeightGrid {
+    float start_x = 0.0f;   // esquina de menor x, z
+    float start_z = 0.0f;
+    float x_step = 1.0f;
+    float z_step = 1.0f;
+    int width_segments = 0;
+    int depth_segments = 0;
+    std::vector<float> heights; // (depth_segments + 1) filas de (width_segments + 1)
+
+    float at(int x, int z) const { return heights[z * (width_segments + 1) + x]; }
+
+    float getHeight(float x, float z) const;
+    glm::vec3 getNormal(float x, float z) const;
+};
+
 class ChunkedTerrain {
 public:
-    explicit ChunkedTerrain(const std::string &name = "chunked_terrain");
+    struct ChunkKey {
+        int gx;
+        int gz;
+        bool operator==(const ChunkKey &o) const { return gx == o.gx && gz == o.gz; }
+    };
+
+    struct ChunkKeyHasher {
+        std::size_t operator()(const ChunkKey &k) const {
+            return (std::hash<int>()(k.gx) * 73856093) ^ (std::hash<int>()(k.gz) * 19349663);
+        }
+    };
+
+    /**
+     * @param num_threads Hilos que construyen los chunks en segundo plano
+     *        (-1 = según los núcleos disponibles, 0 = en el hilo de render)
+     */
+    explicit ChunkedTerrain(const std::string &name = "chunked_terrain", int num_threads = -1);
     ~ChunkedTerrain();
 
     bool initialize(const ChunkedTerrainConfig &cfg);
 
+    // Objetos que se reparten sobre cada chunk al construirlo (antes del primer update)
+    void setScenery(Scenery *scenery) { scenery_ = scenery; }
+
     // Actualiza la malla de chunks alrededor de la cámara
     void update(const glm::vec3 &camera_pos);
 
@@ -42,21 +92,19 @@ public:
     // Altura en un punto del mundo (coincide con la función usada para generar)
     float getHeightAt(float x, float z) const;
 
-    const ChunkedTerrainConfig &getConfig() const { return config_; }
+    // Altura de la malla dibujada (interpolada en el triángulo de la rejilla)
+    float getSurfaceHeightAt(float x, float z) const;
 
-private:
-    struct ChunkKey {
-        int gx;
-        int gz;
-        bool operator==(const ChunkKey &o) const { return gx == o.gx && gz == o.gz; }
-    };
+    // Paso de la rejilla de la malla (los vértices están en múltiplos de este paso)
+    float getGridSpacing() const { return config_.chunk_width / static_cast<float>(config_.width_segments); }
 
-    struct ChunkKeyHasher {
-        std::size_t operator()(const ChunkKey &k) const {
-            return (std::hash<int>()(k.gx) * 73856093) ^ (std::hash<int>()(k.gz) * 19349663);
-        }
-    };
+    const ChunkedTerrainConfig &getConfig() const { return config_; }
+
+    size_t getChunkCount() const { return chunks_.size(); }
+    size_t getPendingChunkCount() const;
+    int getWorkerCount() const { return static_cast<int>(workers_.size()); }
 
+private:
     struct Chunk {
         unsigned int VAO = 0;
         unsigned int VBO = 0;
@@ -65,20 +113,42 @@ private:
         glm::vec2 origin; // centro del chunk en XZ (mundo)
     };
 
-    void ensureChunk(int gx, int gz);
-    void createChunk(int gx, int gz);
+    // Geometría de un chunk construida fuera del hilo de render
+    struct ChunkBuild;
+
+    std::unique_ptr<ChunkBuild> buildChunk(const ChunkKey &key) const;
+    void uploadChunk(ChunkBuild &build);
     void destroyChunk(Chunk &c);
     void evictFarChunks(int center_gx, int center_gz);
+    bool isInRange(const ChunkKey &key, int center_gx, int center_gz) const;
+
+    // Hilos de trabajo
+    void workerLoop();
+    void requestChunks(int center_gx, int center_gz);
+    void collectReady(int center_gx, int center_gz);
+    void waitForChunk(const ChunkKey &key);
 
     // Generación de geometría (similar a Terrain::generateVertices/Indices pero con offset)
-    void buildChunkMesh(float origin_x, float origin_z,
+    void buildHeightGrid(float origin_x, float origin_z, ChunkHeightGrid &grid) const;
+    void buildChunkMesh(const ChunkHeightGrid &grid,
                         std::vector<float> &out_vertices,
-                        std::vector<unsigned int> &out_indices);
+                        std::vector<unsigned int> &out_indices) const;
 
 private:
     std::string name_;
     ChunkedTerrainConfig config_{};
+    Utils::PerlinNoise perlin_;     // Tabla de permutación de noise_seed, se crea una vez
+    Scenery *scenery_ = nullptr;
     std::unordered_map<ChunkKey, Chunk, ChunkKeyHasher> chunks_;
+
+    std::vector<std::thread> workers_;
+    mutable std::mutex mutex_;
+    std::condition_variable work_cv_;
+    std::condition_variable done_cv_;
+    std::deque<ChunkKey> queue_;                                // del más cercano al más lejano
+    std::unordered_set<ChunkKey, ChunkKeyHasher> pending_;      // en cola, construyéndose o en ready_ sin subir
+    std::vector<std::unique_ptr<ChunkBuild>> ready_;
+    bool stop_ = false;
 };
 
 } // namespace Scene
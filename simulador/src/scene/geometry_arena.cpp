@@ -0,0 +1,187 @@
+#include "geometry_arena.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        GeometryArena &GeometryArena::getInstance()
+        {
+            static GeometryArena instance;
+            return instance;
+        }
+
+        GeometryArena::GeometryArena() : free_bytes_(0), entry_count_(0)
+        {
+        }
+
+        GeometryArena::Handle GeometryArena::store(const std::vector<glm::vec3> &positions,
+                                                   const std::vector<unsigned int> &indices)
+        {
+            if (positions.empty())
+                return INVALID_HANDLE;
+
+            Entry entry;
+            entry.vertex_count = positions.size();
+            entry.index_count = indices.size();
+            entry.wide_indices = positions.size() > 65536;
+
+            glm::vec3 min = positions[0];
+            glm::vec3 max = positions[0];
+            for (const glm::vec3 &p : positions)
+            {
+                min = glm::min(min, p);
+                max = glm::max(max, p);
+            }
+            entry.origin = min;
+            entry.step = (max - min) / 65535.0f;
+
+            const size_t index_size = entry.wide_indices ? sizeof(std::uint32_t) : sizeof(std::uint16_t);
+            entry.size = positions.size() * 3 * sizeof(std::uint16_t) + indices.size() * index_size;
+            entry.offset = data_.size();
+            entry.live = true;
+            data_.resize(data_.size() + entry.size);
+
+            // Posiciones cuantizadas dentro de la caja
+            std::uint8_t *out = data_.data() + entry.offset;
+            for (const glm::vec3 &p : positions)
+            {
+                const float v[3] = {p.x, p.y, p.z};
+                const float o[3] = {entry.origin.x, entry.origin.y, entry.origin.z};
+                const float s[3] = {entry.step.x, entry.step.y, entry.step.z};
+                for (int axis = 0; axis < 3; ++axis)
+                {
+                    const float q = s[axis] > 0.0f ? std::round((v[axis] - o[axis]) / s[axis]) : 0.0f;
+                    const std::uint16_t packed = static_cast<std::uint16_t>(std::min(std::max(q, 0.0f), 65535.0f));
+                    std::memcpy(out, &packed, sizeof(packed));
+                    out += sizeof(packed);
+                }
+            }
+
+            for (unsigned int index : indices)
+            {
+                if (entry.wide_indices)
+                {
+                    const std::uint32_t packed = index;
+                    std::memcpy(out, &packed, sizeof(packed));
+                    out += sizeof(packed);
+                }
+                else
+                {
+                    const std::uint16_t packed = static_cast<std::uint16_t>(index);
+                    std::memcpy(out, &packed, sizeof(packed));
+                    out += sizeof(packed);
+                }
+            }
+
+            Handle handle;
+            if (!free_handles_.empty())
+            {
+                handle = free_handles_.back();
+                free_handles_.pop_back();
+                entries_[handle - 1] = entry;
+            }
+            else
+            {
+                entries_.push_back(entry);
+                handle = static_cast<Handle>(entries_.size());
+            }
+            ++entry_count_;
+            return handle;
+        }
+
+        bool GeometryArena::load(Handle handle, std::vector<glm::vec3> &positions,
+                                 std::vector<unsigned int> &indices) const
+        {
+            if (handle == INVALID_HANDLE || handle > entries_.size() || !entries_[handle - 1].live)
+                return false;
+
+            const Entry &entry = entries_[handle - 1];
+            const std::uint8_t *in = data_.data() + entry.offset;
+
+            positions.resize(entry.vertex_count);
+            for (glm::vec3 &p : positions)
+            {
+                std::uint16_t q[3];
+                std::memcpy(q, in, sizeof(q));
+                in += sizeof(q);
+                p = entry.origin + glm::vec3(q[0], q[1], q[2]) * entry.step;
+            }
+
+            indices.resize(entry.index_count);
+            for (unsigned int &index : indices)
+            {
+                if (entry.wide_indices)
+                {
+                    std::uint32_t packed;
+                    std::memcpy(&packed, in, sizeof(packed));
+                    in += sizeof(packed);
+                    index = packed;
+                }
+                else
+                {
+                    std::uint16_t packed;
+                    std::memcpy(&packed, in, sizeof(packed));
+                    in += sizeof(packed);
+                    index = packed;
+                }
+            }
+            return true;
+        }
+
+        void GeometryArena::release(Handle handle)
+        {
+            if (handle == INVALID_HANDLE || handle > entries_.size() || !entries_[handle - 1].live)
+                return;
+
+            Entry &entry = entries_[handle - 1];
+            entry.live = false;
+            free_bytes_ += entry.size;
+            free_handles_.push_back(handle);
+            --entry_count_;
+
+            if (entry_count_ == 0)
+            {
+                std::vector<std::uint8_t>().swap(data_);
+                free_bytes_ = 0;
+            }
+            else if (free_bytes_ * 2 > data_.size())
+            {
+                compact();
+            }
+        }
+
+        void GeometryArena::compact()
+        {
+            // Mover las entradas vivas al principio en el orden en que están en memoria
+            std::vector<Entry *> live;
+            for (Entry &entry : entries_)
+            {
+                if (entry.live)
+                    live.push_back(&entry);
+            }
+            std::sort(live.begin(), live.end(), [](const Entry *a, const Entry *b)
+                      { return a->offset < b->offset; });
+
+            size_t offset = 0;
+            for (Entry *entry : live)
+            {
+                if (entry->offset != offset)
+                {
+                    std::memmove(data_.data() + offset, data_.data() + entry->offset, entry->size);
+                    entry->offset = offset;
+                }
+                offset += entry->size;
+            }
+
+            data_.resize(offset);
+            data_.shrink_to_fit();
+            free_bytes_ = 0;
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
@@ -0,0 +1,93 @@
+#ifndef GEOMETRY_ARENA_H
+#define GEOMETRY_ARENA_H
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        /**
+         * @brief Qué copia de la geometría se conserva en CPU tras subirla a la GPU
+         */
+        enum class MeshResidency
+        {
+            CPU_AND_GPU, // Vértices completos en CPU (se pueden editar y volver a subir)
+            GPU_ONLY,    // Sólo los buffers de la GPU; las cajas quedan cacheadas
+            COMPRESSED   // Posiciones e índices comprimidos en GeometryArena (colisión)
+        };
+
+        /**
+         * @brief Almacén compartido de geometría comprimida para consultas en CPU
+         *
+         * Guarda sólo posiciones e índices: las posiciones se cuantizan a 16 bits
+         * por eje dentro de la caja de la malla (error máximo de extensión / 131070,
+         * unos 0.4 m en un terreno de 50 km y décimas de milímetro en un avión) y
+         * los índices ocupan 16 bits cuando la malla tiene menos de 65536 vértices.
+         * Un vértice pasa de 68 bytes (Vertex) a 6.
+         *
+         * Todas las mallas comparten un único bloque de memoria; los huecos de las
+         * que se liberan se recuperan compactando cuando superan la mitad del bloque.
+         * Se usa desde el hilo de render.
+         */
+        class GeometryArena
+        {
+        public:
+            using Handle = std::uint32_t;
+            static constexpr Handle INVALID_HANDLE = 0;
+
+            static GeometryArena &getInstance();
+
+            // No permitir copia
+            GeometryArena(const GeometryArena &) = delete;
+            GeometryArena &operator=(const GeometryArena &) = delete;
+
+            /**
+             * @brief Comprime y guarda una malla
+             * @return Identificador para load/release, o INVALID_HANDLE si está vacía
+             */
+            Handle store(const std::vector<glm::vec3> &positions, const std::vector<unsigned int> &indices);
+
+            /**
+             * @brief Descomprime una malla guardada
+             */
+            bool load(Handle handle, std::vector<glm::vec3> &positions, std::vector<unsigned int> &indices) const;
+
+            void release(Handle handle);
+
+            // Estadísticas
+            size_t getEntryCount() const { return entry_count_; }
+            size_t getUsedBytes() const { return data_.size() - free_bytes_; }
+            size_t getReservedBytes() const { return data_.capacity(); }
+
+        private:
+            struct Entry
+            {
+                size_t offset = 0;
+                size_t size = 0;
+                size_t vertex_count = 0;
+                size_t index_count = 0;
+                glm::vec3 origin = glm::vec3(0.0f);
+                glm::vec3 step = glm::vec3(0.0f); // metros por unidad cuantizada
+                bool wide_indices = false;
+                bool live = false;
+            };
+
+            std::vector<std::uint8_t> data_;
+            std::vector<Entry> entries_; // handle = posición + 1
+            std::vector<Handle> free_handles_;
+            size_t free_bytes_;
+            size_t entry_count_;
+
+            GeometryArena();
+            void compact();
+        };
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // GEOMETRY_ARENA_H
@@ -1,4 +1,5 @@
 #include "mesh.h"
+#include "../graphics/rendering/gl_state.h"
 #include <iostream>
 #include <cmath>
 #include <glm/gtc/matrix_transform.hpp>
@@ -11,27 +12,42 @@ namespace Graphics
 
         // === Implementación de Mesh ===
 
-        Mesh::Mesh() : name_("unnamed_mesh"), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false)
+        Mesh::Mesh() : name_("unnamed_mesh"), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false),
+                       vertex_format_(VertexFormat::FULL), material_color_(1.0f)
         {
         }
 
-        Mesh::Mesh(const std::string &name) : name_(name), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false)
+        Mesh::Mesh(const std::string &name) : name_(name), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false),
+                                              vertex_format_(VertexFormat::FULL), material_color_(1.0f)
         {
         }
 
-        Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, const std::string &name)
-            : vertices_(vertices), indices_(indices), name_(name.empty() ? "unnamed_mesh" : name), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false)
+        Mesh::Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, const std::string &name,
+                   VertexFormat format)
+            : vertices_(vertices), indices_(indices), name_(name.empty() ? "unnamed_mesh" : name), initialized_(false), instance_count_(0), texture_id_(0), has_texture_(false),
+              vertex_format_(format), material_color_(1.0f)
         {
             setupMesh();
         }
 
+        Mesh::~Mesh()
+        {
+            GeometryArena::getInstance().release(arena_handle_);
+        }
+
         Mesh::Mesh(Mesh &&other) noexcept
             : vertices_(std::move(other.vertices_)), indices_(std::move(other.indices_)),
               vao_(std::move(other.vao_)), vbo_(std::move(other.vbo_)), ebo_(std::move(other.ebo_)),
               instance_vbo_(std::move(other.instance_vbo_)), instance_count_(other.instance_count_),
               name_(std::move(other.name_)), initialized_(other.initialized_),
-              texture_id_(other.texture_id_), has_texture_(other.has_texture_)
+              texture_id_(other.texture_id_), has_texture_(other.has_texture_),
+              vertex_format_(other.vertex_format_), material_color_(other.material_color_),
+              residency_(other.residency_), arena_handle_(other.arena_handle_),
+              vertex_count_(other.vertex_count_), index_count_(other.index_count_),
+              min_bounds_(other.min_bounds_), max_bounds_(other.max_bounds_),
+              bounding_radius_(other.bounding_radius_)
         {
+            other.arena_handle_ = GeometryArena::INVALID_HANDLE;
             other.initialized_ = false;
             other.instance_count_ = 0;
             other.texture_id_ = 0;
@@ -42,6 +58,7 @@ namespace Graphics
         {
             if (this != &other)
             {
+                GeometryArena::getInstance().release(arena_handle_);
                 vertices_ = std::move(other.vertices_);
                 indices_ = std::move(other.indices_);
                 vao_ = std::move(other.vao_);
@@ -53,6 +70,16 @@ namespace Graphics
                 initialized_ = other.initialized_;
                 texture_id_ = other.texture_id_;
                 has_texture_ = other.has_texture_;
+                vertex_format_ = other.vertex_format_;
+                material_color_ = other.material_color_;
+                residency_ = other.residency_;
+                arena_handle_ = other.arena_handle_;
+                vertex_count_ = other.vertex_count_;
+                index_count_ = other.index_count_;
+                min_bounds_ = other.min_bounds_;
+                max_bounds_ = other.max_bounds_;
+                bounding_radius_ = other.bounding_radius_;
+                other.arena_handle_ = GeometryArena::INVALID_HANDLE;
                 other.initialized_ = false;
                 other.instance_count_ = 0;
                 other.texture_id_ = 0;
@@ -69,33 +96,15 @@ namespace Graphics
                 return;
             }
 
-            // Crear VAO
+            // Crear VAO (uno nuevo no tiene los atributos de instancia:
+            // setInstanceData los vuelve a crear)
             vao_ = std::make_unique<VertexArray>();
             vao_->bind();
+            instance_vbo_.reset();
+            instance_count_ = 0;
 
-            // Crear y configurar VBO
-            vbo_ = std::make_unique<VertexBuffer>();
-            vbo_->setData(vertices_);
-            vao_->addVertexBuffer(std::move(vbo_));
-
-            // Configurar atributos de vértice
-            // Posición (location = 0)
-            vao_->addFloatAttribute(0, 3, sizeof(Vertex), (void *)offsetof(Vertex, position));
-
-            // Normal (location = 1)
-            vao_->addFloatAttribute(1, 3, sizeof(Vertex), (void *)offsetof(Vertex, normal));
-
-            // Coordenadas de textura (location = 2)
-            vao_->addFloatAttribute(2, 2, sizeof(Vertex), (void *)offsetof(Vertex, texture_coords));
-
-            // Tangente (location = 3)
-            vao_->addFloatAttribute(3, 3, sizeof(Vertex), (void *)offsetof(Vertex, tangent));
-
-            // Bitangente (location = 4)
-            vao_->addFloatAttribute(4, 3, sizeof(Vertex), (void *)offsetof(Vertex, bitangent));
-
-            // Color del vértice (location = 5)
-            vao_->addFloatAttribute(5, 3, sizeof(Vertex), (void *)offsetof(Vertex, color));
+            // Crear VBO en el formato de la malla y configurar atributos
+            uploadVertices(*vao_, vertices_, vertex_format_);
 
             // Configurar EBO si hay índices
             if (!indices_.empty())
@@ -109,9 +118,19 @@ namespace Graphics
 
             initialized_ = true;
 
+            // Datos que siguen disponibles aunque se libere la copia en CPU
+            vertex_count_ = vertices_.size();
+            index_count_ = indices_.size();
+            min_bounds_ = getMinBounds();
+            max_bounds_ = getMaxBounds();
+            bounding_radius_ = getBoundingRadius();
+
             std::cout << "Mesh '" << name_ << "' initialized successfully ("
                       << vertices_.size() << " vertices, "
-                      << indices_.size() << " indices)" << std::endl;
+                      << indices_.size() << " indices, "
+                      << getVertexBufferSize() << " vertex bytes)" << std::endl;
+
+            applyResidency();
         }
 
         void Mesh::calculateTangents()
@@ -197,6 +216,99 @@ namespace Graphics
             setupMesh();
         }
 
+        void Mesh::setVertexFormat(VertexFormat format)
+        {
+            if (format == vertex_format_)
+                return;
+
+            if (initialized_ && vertices_.empty())
+            {
+                std::cerr << "ERROR: Cannot change vertex format of mesh '" << name_
+                          << "': CPU copy was released" << std::endl;
+                return;
+            }
+
+            vertex_format_ = format;
+            if (initialized_)
+            {
+                setupMesh();
+            }
+        }
+
+        void Mesh::setResidency(MeshResidency residency)
+        {
+            if (residency == residency_)
+                return;
+
+            if (residency == MeshResidency::CPU_AND_GPU && initialized_ && vertices_.empty())
+            {
+                std::cerr << "ERROR: Cannot restore CPU copy of mesh '" << name_ << "'" << std::endl;
+                return;
+            }
+
+            // Sin la copia en CPU no hay nada que comprimir en GeometryArena
+            if (residency == MeshResidency::COMPRESSED && initialized_ && vertices_.empty())
+            {
+                std::cerr << "ERROR: Cannot compress mesh '" << name_ << "': CPU copy was released" << std::endl;
+                return;
+            }
+
+            residency_ = residency;
+            if (initialized_)
+            {
+                applyResidency();
+            }
+        }
+
+        void Mesh::applyResidency()
+        {
+            GeometryArena &arena = GeometryArena::getInstance();
+            if (residency_ != MeshResidency::COMPRESSED)
+            {
+                arena.release(arena_handle_);
+                arena_handle_ = GeometryArena::INVALID_HANDLE;
+            }
+            if (residency_ == MeshResidency::CPU_AND_GPU || vertices_.empty())
+                return;
+
+            if (residency_ == MeshResidency::COMPRESSED)
+            {
+                std::vector<glm::vec3> positions;
+                positions.reserve(vertices_.size());
+                for (const Vertex &vertex : vertices_)
+                {
+                    positions.push_back(vertex.position);
+                }
+                arena.release(arena_handle_);
+                arena_handle_ = arena.store(positions, indices_);
+            }
+
+            // swap en lugar de clear: clear no devuelve la memoria
+            std::vector<Vertex>().swap(vertices_);
+            std::vector<unsigned int>().swap(indices_);
+        }
+
+        size_t Mesh::getCpuMemoryUsage() const
+        {
+            return vertices_.capacity() * sizeof(Vertex) + indices_.capacity() * sizeof(unsigned int);
+        }
+
+        bool Mesh::getCollisionGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned int> &indices) const
+        {
+            if (!vertices_.empty())
+            {
+                positions.clear();
+                positions.reserve(vertices_.size());
+                for (const Vertex &vertex : vertices_)
+                {
+                    positions.push_back(vertex.position);
+                }
+                indices = indices_;
+                return true;
+            }
+            return GeometryArena::getInstance().load(arena_handle_, positions, indices);
+        }
+
         void Mesh::updateVertices(const std::vector<Vertex> &vertices)
         {
             if (!initialized_)
@@ -230,30 +342,23 @@ namespace Graphics
             if (!initialized_)
                 return;
 
-            // Activar textura si está disponible
+            // Activar textura si está disponible (se queda enlazada: la
+            // siguiente malla con la misma textura no la vuelve a enlazar)
             if (has_texture_)
             {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, texture_id_);
+                GLState::getInstance().bindTexture(0, GL_TEXTURE_2D, texture_id_);
             }
 
+            setConstantAttributes(vertex_format_, material_color_);
             vao_->bind();
 
             if (vao_->hasIndexBuffer())
             {
-                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(indices_.size()), GL_UNSIGNED_INT, 0);
+                glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(index_count_), GL_UNSIGNED_INT, 0);
             }
             else
             {
-                glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices_.size()));
-            }
-
-            vao_->unbind();
-            
-            // Desactivar textura
-            if (has_texture_)
-            {
-                glBindTexture(GL_TEXTURE_2D, 0);
+                glDrawArrays(GL_TRIANGLES, 0, static_cast<GLsizei>(vertex_count_));
             }
         }
 
@@ -262,18 +367,17 @@ namespace Graphics
             if (!initialized_)
                 return;
 
+            setConstantAttributes(vertex_format_, material_color_);
             vao_->bind();
 
             if (vao_->hasIndexBuffer())
             {
-                glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(indices_.size()), GL_UNSIGNED_INT, 0, count);
+                glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(index_count_), GL_UNSIGNED_INT, 0, count);
             }
             else
             {
-                glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(vertices_.size()), count);
+                glDrawArraysInstanced(GL_TRIANGLES, 0, static_cast<GLsizei>(vertex_count_), count);
             }
-
-            vao_->unbind();
         }
 
         void Mesh::calculateNormals()
@@ -320,6 +424,12 @@ namespace Graphics
 
         void Mesh::transform(const glm::mat4 &matrix)
         {
+            if (initialized_ && vertices_.empty())
+            {
+                std::cerr << "ERROR: Cannot transform mesh '" << name_ << "': CPU copy was released" << std::endl;
+                return;
+            }
+
             glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(matrix)));
 
             for (auto &vertex : vertices_)
@@ -354,7 +464,7 @@ namespace Graphics
         glm::vec3 Mesh::getMinBounds() const
         {
             if (vertices_.empty())
-                return glm::vec3(0.0f);
+                return min_bounds_;
 
             glm::vec3 min = vertices_[0].position;
             for (const auto &vertex : vertices_)
@@ -367,7 +477,7 @@ namespace Graphics
         glm::vec3 Mesh::getMaxBounds() const
         {
             if (vertices_.empty())
-                return glm::vec3(0.0f);
+                return max_bounds_;
 
             glm::vec3 max = vertices_[0].position;
             for (const auto &vertex : vertices_)
@@ -384,6 +494,9 @@ namespace Graphics
 
         float Mesh::getBoundingRadius() const
         {
+            if (vertices_.empty())
+                return bounding_radius_;
+
             glm::vec3 center = getCenter();
             float maxDistance = 0.0f;
 
@@ -519,6 +632,109 @@ namespace Graphics
             return mesh;
         }
 
+        std::unique_ptr<Mesh> MeshFactory::createCylinder(float radius, float height, unsigned int segments, const std::string &name)
+        {
+            std::vector<Vertex> vertices;
+            std::vector<unsigned int> indices;
+
+            float halfHeight = height * 0.5f;
+
+            // Lateral: anillo inferior y superior con normales radiales
+            for (unsigned int s = 0; s <= segments; ++s)
+            {
+                float angle = 2.0f * static_cast<float>(M_PI) * s / segments;
+                glm::vec3 normal(cos(angle), 0.0f, sin(angle));
+                float u = static_cast<float>(s) / segments;
+
+                vertices.push_back(Vertex(glm::vec3(normal.x * radius, -halfHeight, normal.z * radius), normal, {u, 0.0f}));
+                vertices.push_back(Vertex(glm::vec3(normal.x * radius, halfHeight, normal.z * radius), normal, {u, 1.0f}));
+            }
+
+            for (unsigned int s = 0; s < segments; ++s)
+            {
+                unsigned int bottom = 2 * s;
+                indices.insert(indices.end(), {bottom, bottom + 1, bottom + 3, bottom, bottom + 3, bottom + 2});
+            }
+
+            // Tapas
+            for (int side = -1; side <= 1; side += 2)
+            {
+                glm::vec3 normal(0.0f, static_cast<float>(side), 0.0f);
+                unsigned int center = static_cast<unsigned int>(vertices.size());
+                vertices.push_back(Vertex(glm::vec3(0.0f, side * halfHeight, 0.0f), normal, {0.5f, 0.5f}));
+
+                for (unsigned int s = 0; s <= segments; ++s)
+                {
+                    float angle = 2.0f * static_cast<float>(M_PI) * s / segments;
+                    float x = cos(angle);
+                    float z = sin(angle);
+                    vertices.push_back(Vertex(glm::vec3(x * radius, side * halfHeight, z * radius), normal, {0.5f + 0.5f * x, 0.5f + 0.5f * z}));
+                }
+
+                for (unsigned int s = 0; s < segments; ++s)
+                {
+                    unsigned int first = center + 1 + s;
+                    if (side > 0)
+                        indices.insert(indices.end(), {center, first + 1, first});
+                    else
+                        indices.insert(indices.end(), {center, first, first + 1});
+                }
+            }
+
+            auto mesh = std::make_unique<Mesh>(name);
+            mesh->setData(vertices, indices);
+            return mesh;
+        }
+
+        std::unique_ptr<Mesh> MeshFactory::createCone(float radius, float height, unsigned int segments, const std::string &name)
+        {
+            std::vector<Vertex> vertices;
+            std::vector<unsigned int> indices;
+
+            float halfHeight = height * 0.5f;
+            float slope = radius / height;
+
+            // Lateral: un vértice de punta por segmento para que cada cara tenga su normal
+            for (unsigned int s = 0; s <= segments; ++s)
+            {
+                float angle = 2.0f * static_cast<float>(M_PI) * s / segments;
+                float x = cos(angle);
+                float z = sin(angle);
+                glm::vec3 normal = glm::normalize(glm::vec3(x, slope, z));
+                float u = static_cast<float>(s) / segments;
+
+                vertices.push_back(Vertex(glm::vec3(x * radius, -halfHeight, z * radius), normal, {u, 0.0f}));
+                vertices.push_back(Vertex(glm::vec3(0.0f, halfHeight, 0.0f), normal, {u, 1.0f}));
+            }
+
+            for (unsigned int s = 0; s < segments; ++s)
+            {
+                unsigned int base = 2 * s;
+                indices.insert(indices.end(), {base, base + 1, base + 2});
+            }
+
+            // Base
+            glm::vec3 down(0.0f, -1.0f, 0.0f);
+            unsigned int center = static_cast<unsigned int>(vertices.size());
+            vertices.push_back(Vertex(glm::vec3(0.0f, -halfHeight, 0.0f), down, {0.5f, 0.5f}));
+            for (unsigned int s = 0; s <= segments; ++s)
+            {
+                float angle = 2.0f * static_cast<float>(M_PI) * s / segments;
+                float x = cos(angle);
+                float z = sin(angle);
+                vertices.push_back(Vertex(glm::vec3(x * radius, -halfHeight, z * radius), down, {0.5f + 0.5f * x, 0.5f + 0.5f * z}));
+            }
+            for (unsigned int s = 0; s < segments; ++s)
+            {
+                unsigned int first = center + 1 + s;
+                indices.insert(indices.end(), {center, first, first + 1});
+            }
+
+            auto mesh = std::make_unique<Mesh>(name);
+            mesh->setData(vertices, indices);
+            return mesh;
+        }
+
         std::unique_ptr<Mesh> MeshFactory::createSkyboxCube(const std::string &name)
         {
             float size = 1.0f;
@@ -596,15 +812,16 @@ namespace Graphics
                 return;
             }
 
-            if (instance_data.empty())
+            instance_count_ = static_cast<unsigned int>(instance_data.size());
+
+            // El buffer de instancias y los atributos se crean una vez; después
+            // sólo se reemplazan los datos (glBufferData sobre el mismo buffer)
+            if (instance_vbo_)
             {
-                instance_count_ = 0;
-                instance_vbo_.reset();
+                instance_vbo_->setData(instance_data);
                 return;
             }
 
-            instance_count_ = static_cast<unsigned int>(instance_data.size());
-
             // Crear VBO para instancias
             instance_vbo_ = std::make_unique<VertexBuffer>(BufferUsage::DYNAMIC_DRAW);
             instance_vbo_->setData(instance_data);
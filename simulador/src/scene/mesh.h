@@ -2,6 +2,8 @@
 #define MESH_H
 
 #include "buffer_objects.h"
+#include "vertex_format.h"
+#include "geometry_arena.h"
 #include "../shaders/shader_manager.h"
 
 #include <glm/glm.hpp>
@@ -64,14 +66,30 @@ namespace Graphics
             std::string name_;
             bool initialized_;
 
+            // Formato del VBO y color para los formatos sin color por vértice
+            VertexFormat vertex_format_;
+            glm::vec3 material_color_;
+
+            // Copia en CPU tras la subida y datos cacheados en setupMesh para
+            // cuando vertices_/indices_ ya no están
+            MeshResidency residency_ = MeshResidency::CPU_AND_GPU;
+            GeometryArena::Handle arena_handle_ = GeometryArena::INVALID_HANDLE;
+            size_t vertex_count_ = 0;
+            size_t index_count_ = 0;
+            glm::vec3 min_bounds_ = glm::vec3(0.0f);
+            glm::vec3 max_bounds_ = glm::vec3(0.0f);
+            float bounding_radius_ = 0.0f;
+
             void setupMesh();
             void calculateTangents();
+            void applyResidency();
 
         public:
             Mesh();
             Mesh(const std::string &name);
-            Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, const std::string &name = "");
-            ~Mesh() = default;
+            Mesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices, const std::string &name = "",
+                 VertexFormat format = VertexFormat::FULL);
+            ~Mesh();
 
             // No permitir copia
             Mesh(const Mesh &) = delete;
@@ -99,13 +117,42 @@ namespace Graphics
             unsigned int getInstanceCount() const { return instance_count_; }
             bool hasInstanceData() const { return instance_count_ > 0; }
 
-            // Getters
+            // Getters (getVertices/getIndices quedan vacíos si la copia en CPU se liberó)
             const std::vector<Vertex> &getVertices() const { return vertices_; }
             const std::vector<unsigned int> &getIndices() const { return indices_; }
             const std::string &getName() const { return name_; }
             bool isInitialized() const { return initialized_; }
-            size_t getVertexCount() const { return vertices_.size(); }
-            size_t getTriangleCount() const { return indices_.size() / 3; }
+            size_t getVertexCount() const { return vertices_.empty() ? vertex_count_ : vertices_.size(); }
+            size_t getTriangleCount() const { return (indices_.empty() ? index_count_ : indices_.size()) / 3; }
+
+            /**
+             * @brief Qué se conserva en CPU tras subir la malla
+             *
+             * Con GPU_ONLY y COMPRESSED se liberan vertices_ e indices_ al subir (o
+             * en el momento, si ya está subida); lo que necesita los vértices
+             * (transformaciones, normales, cambio de formato) deja de funcionar.
+             * Una vez liberada la copia no se puede volver a CPU_AND_GPU ni pasar
+             * a COMPRESSED.
+             */
+            void setResidency(MeshResidency residency);
+            MeshResidency getResidency() const { return residency_; }
+            bool hasCpuData() const { return !vertices_.empty(); }
+            size_t getCpuMemoryUsage() const;
+
+            /**
+             * @brief Posiciones e índices para colisión (copia en CPU o GeometryArena)
+             * @return false con GPU_ONLY
+             */
+            bool getCollisionGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned int> &indices) const;
+
+            // Formato de los vértices en la GPU (vuelve a subir el VBO si cambia)
+            void setVertexFormat(VertexFormat format);
+            VertexFormat getVertexFormat() const { return vertex_format_; }
+            size_t getVertexBufferSize() const { return getVertexCount() * getVertexStride(vertex_format_); }
+
+            // Color del material (VertexFormat::PACKED_MATERIAL_COLOR)
+            void setMaterialColor(const glm::vec3 &color) { material_color_ = color; }
+            const glm::vec3 &getMaterialColor() const { return material_color_; }
 
             // Textura
             void setTexture(unsigned int texture_id) { texture_id_ = texture_id; has_texture_ = true; }
@@ -122,7 +169,7 @@ namespace Graphics
             void scale(const glm::vec3 &scale);
             void rotate(float angle, const glm::vec3 &axis);
 
-            // Información de bounding
+            // Información de bounding (cacheada al subir si ya no hay copia en CPU)
             glm::vec3 getMinBounds() const;
             glm::vec3 getMaxBounds() const;
             glm::vec3 getCenter() const;
@@ -0,0 +1,160 @@
+#include "mesh_batch.h"
+#include "../graphics/rendering/gl_state.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <iostream>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        MeshBatch::MeshBatch(const std::string &name, VertexFormat format)
+            : name_(name), format_(format), residency_(MeshResidency::GPU_ONLY),
+              arena_handle_(GeometryArena::INVALID_HANDLE), mesh_count_(0), vertex_count_(0), index_count_(0),
+              min_bounds_(FLT_MAX), max_bounds_(-FLT_MAX)
+        {
+        }
+
+        MeshBatch::~MeshBatch()
+        {
+            GeometryArena::getInstance().release(arena_handle_);
+        }
+
+        void MeshBatch::addMesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices,
+                                unsigned int material, unsigned int texture_id, const glm::vec3 &color)
+        {
+            if (vao_)
+            {
+                std::cerr << "ERROR: Cannot add meshes to batch '" << name_ << "' after upload" << std::endl;
+                return;
+            }
+            if (vertices.empty() || indices.empty())
+                return;
+
+            auto group = std::find_if(groups_.begin(), groups_.end(), [material](const Group &g)
+                                      { return g.material == material; });
+            if (group == groups_.end())
+            {
+                groups_.push_back(Group{material, texture_id, color, {}, {}, {}});
+                group = groups_.end() - 1;
+            }
+
+            // Sub-rango: los índices de la malla tal cual, desplazados por el vértice base
+            group->counts.push_back(static_cast<GLsizei>(indices.size()));
+            group->offsets.push_back(reinterpret_cast<const void *>(indices_.size() * sizeof(unsigned int)));
+            group->base_vertices.push_back(static_cast<GLint>(vertices_.size()));
+
+            vertices_.insert(vertices_.end(), vertices.begin(), vertices.end());
+            indices_.insert(indices_.end(), indices.begin(), indices.end());
+
+            for (const Vertex &vertex : vertices)
+            {
+                min_bounds_ = glm::min(min_bounds_, vertex.position);
+                max_bounds_ = glm::max(max_bounds_, vertex.position);
+            }
+            ++mesh_count_;
+        }
+
+        void MeshBatch::setResidency(MeshResidency residency)
+        {
+            if (vao_ && residency != residency_)
+            {
+                std::cerr << "ERROR: Cannot change residency of batch '" << name_ << "' after upload" << std::endl;
+                return;
+            }
+            residency_ = residency;
+        }
+
+        bool MeshBatch::upload()
+        {
+            if (vertices_.empty())
+            {
+                std::cerr << "ERROR: Cannot upload empty batch '" << name_ << "'" << std::endl;
+                return false;
+            }
+
+            vao_ = std::make_unique<VertexArray>();
+            vao_->bind();
+
+            uploadVertices(*vao_, vertices_, format_);
+
+            auto ebo = std::make_unique<IndexBuffer>();
+            ebo->setIndices(indices_);
+            vao_->setIndexBuffer(std::move(ebo));
+
+            vao_->unbind();
+
+            vertex_count_ = vertices_.size();
+            index_count_ = indices_.size();
+
+            if (residency_ == MeshResidency::COMPRESSED)
+            {
+                std::vector<glm::vec3> positions;
+                std::vector<unsigned int> indices;
+                getCollisionGeometry(positions, indices);
+                arena_handle_ = GeometryArena::getInstance().store(positions, indices);
+            }
+            if (residency_ != MeshResidency::CPU_AND_GPU)
+            {
+                std::vector<Vertex>().swap(vertices_);
+                std::vector<unsigned int>().swap(indices_);
+            }
+
+            std::cout << "Mesh batch '" << name_ << "' uploaded (" << mesh_count_ << " meshes in "
+                      << groups_.size() << " material groups, " << vertex_count_ << " vertices, "
+                      << index_count_ << " indices, " << getVertexBufferSize() << " vertex bytes)" << std::endl;
+            return true;
+        }
+
+        bool MeshBatch::getCollisionGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned int> &indices) const
+        {
+            if (vertices_.empty())
+                return GeometryArena::getInstance().load(arena_handle_, positions, indices);
+
+            positions.clear();
+            positions.reserve(vertices_.size());
+            for (const Vertex &vertex : vertices_)
+            {
+                positions.push_back(vertex.position);
+            }
+
+            // Los índices de cada malla son locales: se suma su vértice base
+            indices.clear();
+            indices.reserve(indices_.size());
+            for (const Group &group : groups_)
+            {
+                for (size_t mesh = 0; mesh < group.counts.size(); ++mesh)
+                {
+                    const size_t first = reinterpret_cast<size_t>(group.offsets[mesh]) / sizeof(unsigned int);
+                    for (GLsizei i = 0; i < group.counts[mesh]; ++i)
+                    {
+                        indices.push_back(indices_[first + i] + static_cast<unsigned int>(group.base_vertices[mesh]));
+                    }
+                }
+            }
+            return true;
+        }
+
+        void MeshBatch::drawGroup(size_t group) const
+        {
+            if (!vao_ || group >= groups_.size())
+                return;
+
+            const Group &g = groups_[group];
+            if (g.texture_id != 0)
+            {
+                GLState::getInstance().bindTexture(0, GL_TEXTURE_2D, g.texture_id);
+            }
+
+            setConstantAttributes(format_, g.color);
+            vao_->bind();
+            glMultiDrawElementsBaseVertex(GL_TRIANGLES, g.counts.data(), GL_UNSIGNED_INT,
+                                          const_cast<const void *const *>(g.offsets.data()),
+                                          static_cast<GLsizei>(g.counts.size()),
+                                          const_cast<GLint *>(g.base_vertices.data()));
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
@@ -0,0 +1,113 @@
+#ifndef MESH_BATCH_H
+#define MESH_BATCH_H
+
+#include "mesh.h"
+
+#include <glm/glm.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        /**
+         * @brief Mallas estáticas de un modelo en un único VAO/VBO/EBO
+         *
+         * Cada malla añadida conserva sus índices (empiezan en 0) y se dibuja
+         * como un sub-rango con su vértice base. Las mallas del mismo
+         * material forman un grupo que se dibuja con una sola llamada a
+         * glMultiDrawElementsBaseVertex, así un modelo cuesta un draw y un
+         * cambio de textura por material en lugar de uno por malla.
+         */
+        class MeshBatch
+        {
+        public:
+            /**
+             * @brief Mallas de un material: un draw
+             */
+            struct Group
+            {
+                unsigned int material;
+                unsigned int texture_id; // 0 = sin textura
+                glm::vec3 color;         // VertexFormat::PACKED_MATERIAL_COLOR
+                std::vector<GLsizei> counts;
+                std::vector<const void *> offsets; // Bytes desde el inicio del EBO
+                std::vector<GLint> base_vertices;
+            };
+
+            explicit MeshBatch(const std::string &name = "mesh_batch", VertexFormat format = VertexFormat::FULL);
+            ~MeshBatch();
+
+            // No permitir copia
+            MeshBatch(const MeshBatch &) = delete;
+            MeshBatch &operator=(const MeshBatch &) = delete;
+
+            /**
+             * @brief Añade una malla al grupo de su material (antes de upload)
+             */
+            void addMesh(const std::vector<Vertex> &vertices, const std::vector<unsigned int> &indices,
+                         unsigned int material, unsigned int texture_id, const glm::vec3 &color = glm::vec3(1.0f));
+
+            /**
+             * @brief Qué se conserva en CPU tras upload() (por defecto GPU_ONLY);
+             *        se fija antes de upload()
+             */
+            void setResidency(MeshResidency residency);
+            MeshResidency getResidency() const { return residency_; }
+
+            /**
+             * @brief Sube los buffers y aplica la residencia a la copia en CPU
+             */
+            bool upload();
+
+            /**
+             * @brief Posiciones e índices (ya con el vértice base) para colisión
+             * @return false con GPU_ONLY
+             */
+            bool getCollisionGeometry(std::vector<glm::vec3> &positions, std::vector<unsigned int> &indices) const;
+
+            /**
+             * @brief Dibuja las mallas de un grupo (enlaza su textura en la unidad 0)
+             */
+            void drawGroup(size_t group) const;
+
+            size_t getGroupCount() const { return groups_.size(); }
+            const Group &getGroup(size_t group) const { return groups_[group]; }
+            size_t getMeshCount() const { return mesh_count_; }
+            size_t getVertexCount() const { return vertex_count_; }
+            size_t getIndexCount() const { return index_count_; }
+            size_t getVertexBufferSize() const { return vertex_count_ * getVertexStride(format_); }
+            VertexFormat getVertexFormat() const { return format_; }
+            const std::string &getName() const { return name_; }
+            bool isUploaded() const { return vao_ != nullptr; }
+
+            // Caja de todas las mallas (se calcula al añadirlas)
+            glm::vec3 getMinBounds() const { return min_bounds_; }
+            glm::vec3 getMaxBounds() const { return max_bounds_; }
+
+        private:
+            std::string name_;
+            VertexFormat format_;
+            std::vector<Group> groups_;
+
+            // Datos hasta upload() (o siempre con CPU_AND_GPU)
+            std::vector<Vertex> vertices_;
+            std::vector<unsigned int> indices_;
+            MeshResidency residency_;
+            GeometryArena::Handle arena_handle_;
+
+            std::unique_ptr<VertexArray> vao_;
+            size_t mesh_count_;
+            size_t vertex_count_;
+            size_t index_count_;
+            glm::vec3 min_bounds_;
+            glm::vec3 max_bounds_;
+        };
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // MESH_BATCH_H
@@ -20,6 +20,34 @@ namespace Scene
     }
   }
 
+  void Model::addBatch(std::unique_ptr<Graphics::Rendering::MeshBatch> batch)
+  {
+    if (batch)
+    {
+      batches_.push_back(std::move(batch));
+    }
+  }
+
+  size_t Model::getMeshCount() const
+  {
+    size_t count = meshes_.size();
+    for (const auto &batch : batches_)
+    {
+      count += batch->getMeshCount();
+    }
+    return count;
+  }
+
+  size_t Model::getDrawCallCount() const
+  {
+    size_t count = meshes_.size();
+    for (const auto &batch : batches_)
+    {
+      count += batch->getGroupCount();
+    }
+    return count;
+  }
+
   void Model::render(Graphics::Shaders::Shader *shader) const
   {
     if (!visible_ || !shader)
@@ -39,6 +67,16 @@ namespace Scene
       shader->setBool("useUniformColor", false);
     }
 
+    // Mallas agrupadas: un draw por material
+    for (const auto &batch : batches_)
+    {
+      for (size_t group = 0; group < batch->getGroupCount(); ++group)
+      {
+        shader->setBool("useTexture", batch->getGroup(group).texture_id != 0);
+        batch->drawGroup(group);
+      }
+    }
+
     for (const auto &mesh : meshes_)
     {
       // Configurar si usar textura o no basado en cada mesh
@@ -54,7 +92,7 @@ namespace Scene
       }
     }
 
-    shader->unuse();
+    // El programa queda en uso: la cola de dibujo sigue con él
   }
 
 }
@@ -4,6 +4,7 @@
 
 #include "../graphics/rendering/buffer_objects.h"
 #include "mesh.h"
+#include "mesh_batch.h"
 #include <glm/glm.hpp>
 #include <memory>
 #include <vector>
@@ -34,6 +35,7 @@ namespace Scene
   {
   private:
     std::vector<std::unique_ptr<Graphics::Rendering::Mesh>> meshes_;
+    std::vector<std::unique_ptr<Graphics::Rendering::MeshBatch>> batches_;
     Transform transform_;
     std::string name_;
     bool visible_;
@@ -53,13 +55,16 @@ namespace Scene
     Model &operator=(Model &&) = default;
 
     void addMesh(std::unique_ptr<Graphics::Rendering::Mesh> mesh);
+    void addBatch(std::unique_ptr<Graphics::Rendering::MeshBatch> batch);
     void render(Graphics::Shaders::Shader *shader) const;
 
     // Getters
     const std::string &getName() const { return name_; }
     const Transform &getTransform() const { return transform_; }
     bool isVisible() const { return visible_; }
-    size_t getMeshCount() const { return meshes_.size(); }
+    size_t getMeshCount() const;
+    size_t getBatchCount() const { return batches_.size(); }
+    size_t getDrawCallCount() const;
     bool usesUniformColor() const { return use_uniform_color_; }
     const glm::vec3 &getUniformColor() const { return uniform_color_; }
 
@@ -0,0 +1,288 @@
+#include "scenery.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <iostream>
+
+namespace Scene {
+
+using Graphics::Rendering::InstanceAttributes;
+using Graphics::Rendering::Mesh;
+using Graphics::Rendering::MeshFactory;
+using Graphics::Rendering::Vertex;
+using Graphics::Rendering::VertexFormat;
+
+namespace {
+
+    // Finalizador de splitmix64: hash de 64 bits bien repartido
+    std::uint64_t mixBits(std::uint64_t x) {
+        x += 0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        return x ^ (x >> 31);
+    }
+
+    // Generador de una tesela: el mismo en cualquier plataforma
+    struct TileRandom {
+        std::uint64_t state;
+
+        float next() {
+            return static_cast<float>(mixBits(++state) >> 40) * (1.0f / 16777216.0f);
+        }
+    };
+
+    // Copia de la malla con la base en y = 0 (las fábricas la centran)
+    std::unique_ptr<Mesh> groundedMesh(const Mesh &source, const std::string &name) {
+        std::vector<Vertex> vertices = source.getVertices();
+        const float base = source.getMinBounds().y;
+        for (Vertex &vertex : vertices) {
+            vertex.position.y -= base;
+        }
+
+        // El shader instanciado toma el color del tipo: no hace falta por vértice
+        return std::make_unique<Mesh>(vertices, source.getIndices(), name, VertexFormat::PACKED_MATERIAL_COLOR);
+    }
+
+} // namespace
+
+size_t ChunkScatter::getInstanceCount() const {
+    size_t count = 0;
+    for (const auto &type_instances : instances) {
+        count += type_instances.size();
+    }
+    return count;
+}
+
+Scenery::Scenery(unsigned int seed)
+    : seed_(mixBits(seed)), mask_noise_(seed + 1), base_height_(0.0f), height_range_(1.0f),
+      draw_distance_(15000.0f), dirty_(false) {}
+
+Scenery::~Scenery() = default;
+
+bool Scenery::initialize(const ChunkedTerrainConfig &terrain) {
+    base_height_ = terrain.y_position;
+    height_range_ = terrain.use_perlin_noise ? std::max(terrain.height_multiplier, 1.0f) : 1.0f;
+
+    // Mallas de pocos triángulos: se dibujan cientos de miles de veces
+    auto cone = MeshFactory::createCone(1.0f, 1.0f, 8, "scenery_cone_source");
+    auto canopy = MeshFactory::createSphere(0.5f, 6, 9, "scenery_canopy_source");
+    auto block = MeshFactory::createCube(1.0f, "scenery_block_source");
+    if (!cone || !canopy || !block) {
+        std::cerr << "ERROR: Could not create scenery meshes" << std::endl;
+        return false;
+    }
+
+    // Coníferas en las laderas altas, frondosos abajo y pueblos en lo llano
+    addKind({"conifer",   glm::vec3(0.13f, 0.27f, 0.12f), 25.0f, 0.42f, 0.85f, 35.0f, 1.0f / 3500.0f, -0.05f, glm::vec3(2.5f, 8.0f, 2.5f), glm::vec3(4.0f, 16.0f, 4.0f)},
+            groundedMesh(*cone, "scenery_conifer"));
+    addKind({"broadleaf", glm::vec3(0.24f, 0.40f, 0.15f), 25.0f, 0.0f, 0.55f, 25.0f, 1.0f / 3000.0f, 0.0f, glm::vec3(3.0f, 5.0f, 3.0f), glm::vec3(6.0f, 9.0f, 6.0f)},
+            groundedMesh(*canopy, "scenery_broadleaf"));
+    addKind({"building",  glm::vec3(0.62f, 0.58f, 0.52f), 40.0f, 0.0f, 0.5f, 6.0f, 1.0f / 6000.0f, 0.2f, glm::vec3(8.0f, 5.0f, 8.0f), glm::vec3(25.0f, 18.0f, 25.0f)},
+            groundedMesh(*block, "scenery_building"));
+
+    std::cout << "Scenery initialized (" << kinds_.size() << " types, draw distance "
+              << draw_distance_ << " m)" << std::endl;
+    return true;
+}
+
+void Scenery::addKind(const SceneryType &type, std::unique_ptr<Mesh> mesh) {
+    Kind kind;
+    kind.type = type;
+    kind.footprint = 0.0f;
+    for (const Vertex &vertex : mesh->getVertices()) {
+        kind.footprint = std::max(kind.footprint, std::max(std::abs(vertex.position.x), std::abs(vertex.position.z)));
+    }
+    kind.min_normal_y = std::cos(glm::radians(type.max_slope));
+    kind.mask_seed = 37.1f * static_cast<float>(kinds_.size());
+    kind.visible = 0;
+    kind.mesh = std::move(mesh);
+    kind.mesh->setResidency(Graphics::Rendering::MeshResidency::GPU_ONLY);
+    kinds_.push_back(std::move(kind));
+}
+
+void Scenery::addClearArea(const glm::vec2 &min, const glm::vec2 &max) {
+    clear_areas_.emplace_back(min.x, min.y, max.x, max.y);
+}
+
+bool Scenery::isClear(float x, float z) const {
+    for (const glm::vec4 &area : clear_areas_) {
+        if (x >= area.x && z >= area.y && x <= area.z && z <= area.w) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ChunkScatter Scenery::scatter(const ChunkedTerrain::ChunkKey &key, const ChunkHeightGrid &grid) const {
+    constexpr int NUM_TILES = TILES * TILES;
+
+    ChunkScatter result;
+    result.instances.resize(kinds_.size());
+    result.tile_offsets.resize(kinds_.size());
+    result.tile_bounds.assign(NUM_TILES, {glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)});
+
+    const float tile_width = grid.x_step * static_cast<float>(grid.width_segments) / TILES;
+    const float tile_depth = grid.z_step * static_cast<float>(grid.depth_segments) / TILES;
+    const float tile_area = tile_width * tile_depth * 1.0e-6f; // [km²]
+
+    // Semilla del chunk: hash de su clave
+    const std::uint64_t packed_key = (static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.gx)) << 32) |
+                                     static_cast<std::uint32_t>(key.gz);
+    const std::uint64_t chunk_seed = mixBits(seed_ ^ mixBits(packed_key));
+
+    for (size_t k = 0; k < kinds_.size(); ++k) {
+        const Kind &kind = kinds_[k];
+        const SceneryType &type = kind.type;
+        std::vector<InstanceAttributes> &instances = result.instances[k];
+        std::vector<std::uint32_t> &offsets = result.tile_offsets[k];
+        offsets.reserve(NUM_TILES + 1);
+
+        const float expected = type.density * tile_area;
+        for (int tile = 0; tile < NUM_TILES; ++tile) {
+            offsets.push_back(static_cast<std::uint32_t>(instances.size()));
+
+            TileRandom random{mixBits(chunk_seed + k * NUM_TILES + tile)};
+            const int count = static_cast<int>(expected) + (random.next() < expected - std::floor(expected) ? 1 : 0);
+            const float x0 = grid.start_x + static_cast<float>(tile % TILES) * tile_width;
+            const float z0 = grid.start_z + static_cast<float>(tile / TILES) * tile_depth;
+            ChunkScatter::Bounds &bounds = result.tile_bounds[tile];
+
+            for (int i = 0; i < count; ++i) {
+                // Cada candidato consume siempre los mismos números, así
+                // rechazar uno no cambia los siguientes
+                const float x = x0 + random.next() * tile_width;
+                const float z = z0 + random.next() * tile_depth;
+                const glm::vec3 r(random.next(), random.next(), random.next());
+                const float rotation = random.next() * 6.2831853f;
+
+                if (isClear(x, z)) continue;
+
+                const float height = grid.getHeight(x, z);
+                const float relative = (height - base_height_) / height_range_;
+                if (relative < type.min_height || relative > type.max_height) continue;
+
+                if (type.mask_threshold > -1.0f &&
+                    mask_noise_.fractalNoise2D(x * type.mask_scale + kind.mask_seed, z * type.mask_scale, 3) < type.mask_threshold) {
+                    continue;
+                }
+
+                const glm::vec3 normal = grid.getNormal(x, z);
+                if (normal.y < kind.min_normal_y) continue;
+
+                const glm::vec3 scale = type.min_scale + r * (type.max_scale - type.min_scale);
+
+                // La base se hunde lo que sube la pendiente bajo la huella
+                const float radius = kind.footprint * std::max(scale.x, scale.z);
+                const float sink = radius * std::sqrt(std::max(0.0f, 1.0f - normal.y * normal.y)) / normal.y;
+
+                InstanceAttributes instance;
+                instance.instance_position = glm::vec3(x, height - sink, z);
+                instance.instance_scale = scale;
+                instance.instance_rotation_y = rotation;
+                instance.instance_billboard = type.billboard ? 1.0f : 0.0f;
+                instances.push_back(instance);
+
+                bounds.min = glm::min(bounds.min, instance.instance_position - glm::vec3(radius, 0.0f, radius));
+                bounds.max = glm::max(bounds.max, instance.instance_position + glm::vec3(radius, scale.y, radius));
+            }
+        }
+        offsets.push_back(static_cast<std::uint32_t>(instances.size()));
+    }
+
+    return result;
+}
+
+void Scenery::addChunk(const ChunkedTerrain::ChunkKey &key, ChunkScatter scatter) {
+    chunks_[key] = std::move(scatter);
+    dirty_ = true;
+}
+
+void Scenery::removeChunk(const ChunkedTerrain::ChunkKey &key) {
+    if (chunks_.erase(key) > 0) {
+        dirty_ = true;
+    }
+}
+
+void Scenery::update(const glm::mat4 &view_projection, const glm::vec3 &view_pos) {
+    // Planos del frustum con la normal hacia dentro (Gribb-Hartmann)
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; ++i) {
+        rows[i] = glm::vec4(view_projection[0][i], view_projection[1][i], view_projection[2][i], view_projection[3][i]);
+    }
+    const glm::vec4 planes[6] = {
+        rows[3] + rows[0], rows[3] - rows[0],
+        rows[3] + rows[1], rows[3] - rows[1],
+        rows[3] + rows[2], rows[3] - rows[2]};
+
+    previous_visible_.swap(visible_);
+    visible_.clear();
+
+    const float max_distance2 = draw_distance_ * draw_distance_;
+    for (const auto &kv : chunks_) {
+        const ChunkScatter &chunk = kv.second;
+        for (int tile = 0; tile < static_cast<int>(chunk.tile_bounds.size()); ++tile) {
+            const ChunkScatter::Bounds &bounds = chunk.tile_bounds[tile];
+            if (bounds.min.x > bounds.max.x) continue; // tesela vacía
+
+            // Distancia de la cámara a la caja
+            const glm::vec3 closest = glm::clamp(view_pos, bounds.min, bounds.max);
+            const glm::vec3 offset = closest - view_pos;
+            if (glm::dot(offset, offset) > max_distance2) continue;
+
+            // Fuera si el vértice más adentro de la caja queda detrás de algún plano
+            bool inside = true;
+            for (const glm::vec4 &plane : planes) {
+                const glm::vec3 corner(plane.x > 0.0f ? bounds.max.x : bounds.min.x,
+                                       plane.y > 0.0f ? bounds.max.y : bounds.min.y,
+                                       plane.z > 0.0f ? bounds.max.z : bounds.min.z);
+                if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f) {
+                    inside = false;
+                    break;
+                }
+            }
+            if (inside) {
+                visible_.push_back({&chunk, tile});
+            }
+        }
+    }
+
+    // Las instancias sólo se vuelven a subir si cambian las teselas visibles
+    if (!dirty_ && visible_ == previous_visible_) return;
+    dirty_ = false;
+
+    for (size_t k = 0; k < kinds_.size(); ++k) {
+        staging_.clear();
+        for (const TileRef &ref : visible_) {
+            const std::vector<std::uint32_t> &offsets = ref.chunk->tile_offsets[k];
+            const std::vector<InstanceAttributes> &instances = ref.chunk->instances[k];
+            staging_.insert(staging_.end(), instances.begin() + offsets[ref.tile], instances.begin() + offsets[ref.tile + 1]);
+        }
+        kinds_[k].visible = staging_.size();
+        kinds_[k].mesh->setInstanceData(staging_);
+    }
+}
+
+void Scenery::draw(size_t type) const {
+    const Kind &kind = kinds_[type];
+    if (kind.visible == 0) return;
+    kind.mesh->drawInstanced(static_cast<unsigned int>(kind.visible));
+}
+
+size_t Scenery::getInstanceCount() const {
+    size_t count = 0;
+    for (const auto &kv : chunks_) {
+        count += kv.second.getInstanceCount();
+    }
+    return count;
+}
+
+size_t Scenery::getVisibleInstanceCount() const {
+    size_t count = 0;
+    for (const Kind &kind : kinds_) {
+        count += kind.visible;
+    }
+    return count;
+}
+
+} // namespace Scene
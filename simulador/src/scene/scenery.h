@@ -0,0 +1,155 @@
+#pragma once
+
+#include "chunked_terrain.h"
+#include "mesh.h"
+#include "../utils/perlin_noise.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Scene {
+
+/**
+ * @brief Tipo de objeto que se reparte sobre el terreno (árboles, edificios)
+ *
+ * Las alturas van relativas al relieve: 0 es el nivel base del terreno y 1
+ * la altura máxima del ruido. La máscara es ruido de baja frecuencia común a
+ * todos los chunks, así los bosques y los pueblos siguen al cruzar un borde.
+ */
+struct SceneryType {
+    std::string name;
+    glm::vec3 color;
+    float density;          // candidatos por km²
+    float min_height;       // altura relativa [0, 1]
+    float max_height;
+    float max_slope;        // [grados]
+    float mask_scale;       // frecuencia de la máscara [1/m]
+    float mask_threshold;   // [-1, 1], -1 = en todas partes
+    glm::vec3 min_scale;    // [m] (la malla mide 1 de alto con la base en y = 0)
+    glm::vec3 max_scale;
+    bool billboard = false;
+};
+
+/**
+ * @brief Instancias de un chunk por tipo, ordenadas por tesela
+ *
+ * Se construye en los hilos de ChunkedTerrain junto con la malla del chunk.
+ */
+struct ChunkScatter {
+    struct Bounds {
+        glm::vec3 min;
+        glm::vec3 max;
+    };
+
+    std::vector<std::vector<Graphics::Rendering::InstanceAttributes>> instances;   // [tipo]
+    std::vector<std::vector<std::uint32_t>> tile_offsets;   // [tipo][tesela], TILES² + 1
+    std::vector<Bounds> tile_bounds;                        // [tesela], todos los tipos
+
+    size_t getInstanceCount() const;
+};
+
+/**
+ * @brief Vegetación y edificios repartidos por chunk y dibujados con instancing
+ *
+ * El reparto es determinista: la semilla de cada tesela sale de un hash de
+ * la clave del chunk, así un chunk que se descarta y se vuelve a generar
+ * tiene los mismos objetos. Cada candidato se acepta o no según la altura,
+ * la pendiente de la malla y la máscara del tipo.
+ *
+ * Cada chunk se divide en TILES x TILES teselas con su caja. update() descarta
+ * las teselas fuera del frustum o más allá de la distancia de dibujo y copia
+ * las instancias de las visibles al buffer de instancias de cada malla (sólo
+ * cuando cambia el conjunto visible); draw() hace un draw instanciado por tipo.
+ */
+class Scenery {
+public:
+    static constexpr int TILES = 8;
+
+    explicit Scenery(unsigned int seed = 1);
+    ~Scenery();
+
+    // No permitir copia
+    Scenery(const Scenery &) = delete;
+    Scenery &operator=(const Scenery &) = delete;
+
+    /**
+     * @brief Crea los tipos y sus mallas (necesita el contexto GL)
+     */
+    bool initialize(const ChunkedTerrainConfig &terrain);
+
+    /**
+     * @brief Zona sin objetos (pista, plataforma) en XZ del mundo
+     */
+    void addClearArea(const glm::vec2 &min, const glm::vec2 &max);
+
+    void setDrawDistance(float distance) { draw_distance_ = distance; }
+    float getDrawDistance() const { return draw_distance_; }
+
+    /**
+     * @brief Reparte los objetos de un chunk (hilos de trabajo, sin GL)
+     */
+    ChunkScatter scatter(const ChunkedTerrain::ChunkKey &key, const ChunkHeightGrid &grid) const;
+
+    // Hilo de render
+    void addChunk(const ChunkedTerrain::ChunkKey &key, ChunkScatter scatter);
+    void removeChunk(const ChunkedTerrain::ChunkKey &key);
+
+    /**
+     * @brief Culling por tesela y subida de las instancias visibles
+     */
+    void update(const glm::mat4 &view_projection, const glm::vec3 &view_pos);
+
+    /**
+     * @brief Un draw instanciado con las instancias visibles de un tipo
+     */
+    void draw(size_t type) const;
+
+    size_t getTypeCount() const { return kinds_.size(); }
+    const SceneryType &getType(size_t type) const { return kinds_[type].type; }
+    size_t getVisibleInstanceCount(size_t type) const { return kinds_[type].visible; }
+
+    // Estadísticas
+    size_t getChunkCount() const { return chunks_.size(); }
+    size_t getInstanceCount() const;
+    size_t getVisibleInstanceCount() const;
+    size_t getVisibleTileCount() const { return visible_.size(); }
+
+private:
+    struct Kind {
+        SceneryType type;
+        std::unique_ptr<Graphics::Rendering::Mesh> mesh;
+        float footprint;    // radio en XZ de la malla con escala 1
+        float min_normal_y; // cos(max_slope)
+        float mask_seed;    // desplazamiento de la máscara en el ruido
+        size_t visible;
+    };
+
+    struct TileRef {
+        const ChunkScatter *chunk;
+        int tile;
+        bool operator==(const TileRef &o) const { return chunk == o.chunk && tile == o.tile; }
+    };
+
+    std::uint64_t seed_;
+    Utils::PerlinNoise mask_noise_;
+    float base_height_;
+    float height_range_;
+    float draw_distance_;
+    std::vector<Kind> kinds_;
+    std::vector<glm::vec4> clear_areas_;    // (min x, min z, max x, max z)
+
+    std::unordered_map<ChunkedTerrain::ChunkKey, ChunkScatter, ChunkedTerrain::ChunkKeyHasher> chunks_;
+    std::vector<TileRef> visible_;
+    std::vector<TileRef> previous_visible_;
+    std::vector<Graphics::Rendering::InstanceAttributes> staging_;
+    bool dirty_;
+
+    void addKind(const SceneryType &type, std::unique_ptr<Graphics::Rendering::Mesh> mesh);
+    bool isClear(float x, float z) const;
+};
+
+} // namespace Scene
@@ -1,5 +1,6 @@
 #include "terrain.h"
 #include "../utils/perlin_noise.h"
+#include "../graphics/rendering/gl_state.h"
 #include <iostream>
 #include <cmath>
 #include <glad/glad.h>
@@ -7,7 +8,8 @@
 namespace Scene {
 
     Terrain::Terrain(const std::string& name)
-        : VAO_(0), VBO_(0), EBO_(0), name_(name), vertex_count_(0), index_count_(0) {
+        : VAO_(0), VBO_(0), EBO_(0), name_(name), vertex_count_(0), index_count_(0),
+          min_bounds_(0.0f), max_bounds_(0.0f), arena_handle_(Graphics::Rendering::GeometryArena::INVALID_HANDLE) {
     }
 
     Terrain::~Terrain() {
@@ -18,8 +20,10 @@ namespace Scene {
         : VAO_(other.VAO_), VBO_(other.VBO_), EBO_(other.EBO_),
           config_(std::move(other.config_)), name_(std::move(other.name_)),
           vertices_(std::move(other.vertices_)), indices_(std::move(other.indices_)),
-          vertex_count_(other.vertex_count_), index_count_(other.index_count_) {
+          vertex_count_(other.vertex_count_), index_count_(other.index_count_),
+          min_bounds_(other.min_bounds_), max_bounds_(other.max_bounds_), arena_handle_(other.arena_handle_) {
         
+        other.arena_handle_ = Graphics::Rendering::GeometryArena::INVALID_HANDLE;
         other.VAO_ = 0;
         other.VBO_ = 0;
         other.EBO_ = 0;
@@ -40,7 +44,11 @@ namespace Scene {
             indices_ = std::move(other.indices_);
             vertex_count_ = other.vertex_count_;
             index_count_ = other.index_count_;
+            min_bounds_ = other.min_bounds_;
+            max_bounds_ = other.max_bounds_;
+            arena_handle_ = other.arena_handle_;
             
+            other.arena_handle_ = Graphics::Rendering::GeometryArena::INVALID_HANDLE;
             other.VAO_ = 0;
             other.VBO_ = 0;
             other.EBO_ = 0;
@@ -57,8 +65,9 @@ namespace Scene {
         generateVertices();
         generateIndices();
         
-        // Configurar buffers de OpenGL
+        // Configurar buffers de OpenGL y soltar lo que no haga falta en CPU
         setupBuffers();
+        applyResidency();
         
         std::cout << "Terrain '" << name_ << "' initialized successfully (" 
                   << vertex_count_ << " vertices, " << index_count_ << " indices)" << std::endl;
@@ -193,17 +202,18 @@ namespace Scene {
 
     void Terrain::setupBuffers() {
         // Generar y configurar VAO
+        Graphics::Rendering::GLState& gl_state = Graphics::Rendering::GLState::getInstance();
         glGenVertexArrays(1, &VAO_);
-        glBindVertexArray(VAO_);
+        gl_state.bindVertexArray(VAO_);
         
         // Generar y configurar VBO
         glGenBuffers(1, &VBO_);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO_);
+        gl_state.bindBuffer(GL_ARRAY_BUFFER, VBO_);
         glBufferData(GL_ARRAY_BUFFER, vertices_.size() * sizeof(float), vertices_.data(), GL_STATIC_DRAW);
         
         // Generar y configurar EBO
         glGenBuffers(1, &EBO_);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
+        gl_state.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO_);
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices_.size() * sizeof(unsigned int), indices_.data(), GL_STATIC_DRAW);
         
         // Configurar atributos de vértice
@@ -219,31 +229,77 @@ namespace Scene {
         glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void*)(6 * sizeof(float)));
         glEnableVertexAttribArray(2);
         
-        glBindVertexArray(0);
+        gl_state.bindVertexArray(0);
+
+        // Caja del terreno (pos 0..2 de cada vértice)
+        if (vertices_.size() >= 3) {
+            min_bounds_ = max_bounds_ = glm::vec3(vertices_[0], vertices_[1], vertices_[2]);
+            for (size_t i = 0; i + 2 < vertices_.size(); i += 8) {
+                glm::vec3 p(vertices_[i], vertices_[i + 1], vertices_[i + 2]);
+                min_bounds_ = glm::min(min_bounds_, p);
+                max_bounds_ = glm::max(max_bounds_, p);
+            }
+        }
+    }
+
+    void Terrain::applyResidency() {
+        using Graphics::Rendering::MeshResidency;
+        if (config_.residency == MeshResidency::CPU_AND_GPU) return;
+
+        if (config_.residency == MeshResidency::COMPRESSED) {
+            std::vector<glm::vec3> positions;
+            positions.reserve(vertex_count_);
+            for (size_t i = 0; i + 2 < vertices_.size(); i += 8) {
+                positions.emplace_back(vertices_[i], vertices_[i + 1], vertices_[i + 2]);
+            }
+            Graphics::Rendering::GeometryArena &arena = Graphics::Rendering::GeometryArena::getInstance();
+            arena.release(arena_handle_);
+            arena_handle_ = arena.store(positions, indices_);
+        }
+
+        // swap en lugar de clear: clear no devuelve la memoria
+        std::vector<float>().swap(vertices_);
+        std::vector<unsigned int>().swap(indices_);
+    }
+
+    bool Terrain::getCollisionGeometry(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) const {
+        if (vertices_.empty()) {
+            return Graphics::Rendering::GeometryArena::getInstance().load(arena_handle_, positions, indices);
+        }
+
+        positions.clear();
+        positions.reserve(vertex_count_);
+        for (size_t i = 0; i + 2 < vertices_.size(); i += 8) {
+            positions.emplace_back(vertices_[i], vertices_[i + 1], vertices_[i + 2]);
+        }
+        indices = indices_;
+        return true;
     }
 
     void Terrain::draw() const {
         if (VAO_ == 0) return;
         
-        glBindVertexArray(VAO_);
+        Graphics::Rendering::GLState::getInstance().bindVertexArray(VAO_);
         glDrawElements(GL_TRIANGLES, index_count_, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
     }
 
     void Terrain::cleanup() {
         if (VAO_) {
-            glDeleteVertexArrays(1, &VAO_);
+            Graphics::Rendering::GLState::getInstance().deleteVertexArray(VAO_);
             VAO_ = 0;
         }
         if (VBO_) {
-            glDeleteBuffers(1, &VBO_);
+            Graphics::Rendering::GLState::getInstance().deleteBuffer(VBO_);
             VBO_ = 0;
         }
         if (EBO_) {
-            glDeleteBuffers(1, &EBO_);
+            Graphics::Rendering::GLState::getInstance().deleteBuffer(EBO_);
             EBO_ = 0;
         }
         
+        Graphics::Rendering::GeometryArena::getInstance().release(arena_handle_);
+        arena_handle_ = Graphics::Rendering::GeometryArena::INVALID_HANDLE;
+
         vertices_.clear();
         indices_.clear();
         vertex_count_ = 0;
@@ -5,6 +5,8 @@
 #include <vector>
 #include <glm/glm.hpp>
 
+#include "geometry_arena.h"
+
 namespace Scene {
 
     struct TerrainConfig {
@@ -23,6 +25,10 @@ namespace Scene {
         float height_multiplier = 800.0f;    // Altura de las montañas
         int noise_octaves = 7;               // Niveles de detalle
         unsigned int noise_seed = 237;       // Semilla
+
+        // Copia en CPU tras subir la malla (las alturas salen del ruido,
+        // no de los vértices)
+        Graphics::Rendering::MeshResidency residency = Graphics::Rendering::MeshResidency::GPU_ONLY;
     };
 
     class Terrain {
@@ -39,11 +45,17 @@ namespace Scene {
         std::vector<unsigned int> indices_;
         unsigned int vertex_count_;
         unsigned int index_count_;
+
+        // Cacheados al subir (siguen disponibles sin la copia en CPU)
+        glm::vec3 min_bounds_;
+        glm::vec3 max_bounds_;
+        Graphics::Rendering::GeometryArena::Handle arena_handle_;
         
         // Generation methods
         void generateVertices();
         void generateIndices();
         void setupBuffers();
+        void applyResidency();
         void cleanup();
 
     public:
@@ -70,6 +82,12 @@ namespace Scene {
         unsigned int getVertexCount() const { return vertex_count_; }
         unsigned int getIndexCount() const { return index_count_; }
         glm::vec3 getPosition() const { return glm::vec3(0.0f, config_.y_position, 0.0f); }
+        glm::vec3 getMinBounds() const { return min_bounds_; }
+        glm::vec3 getMaxBounds() const { return max_bounds_; }
+        size_t getCpuMemoryUsage() const { return vertices_.capacity() * sizeof(float) + indices_.capacity() * sizeof(unsigned int); }
+
+        // Posiciones e índices para colisión (false con MeshResidency::GPU_ONLY)
+        bool getCollisionGeometry(std::vector<glm::vec3>& positions, std::vector<unsigned int>& indices) const;
         
         // Obtener altura del terreno en una posición (x, z)
         float getHeightAt(float x, float z) const;
@@ -0,0 +1,145 @@
+#include "vertex_format.h"
+#include "mesh.h"
+
+#include <glm/gtc/packing.hpp>
+#include <cstddef>
+#include <cstring>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        size_t getVertexStride(VertexFormat format)
+        {
+            switch (format)
+            {
+            case VertexFormat::PACKED:
+                return sizeof(PackedVertex) + sizeof(std::uint32_t);
+            case VertexFormat::PACKED_MATERIAL_COLOR:
+                return sizeof(PackedVertex);
+            case VertexFormat::FULL:
+            default:
+                return sizeof(Vertex);
+            }
+        }
+
+        glm::vec2 encodeOctahedral(const glm::vec3 &normal)
+        {
+            // Proyección sobre el octaedro |x| + |y| + |z| = 1
+            const float l1 = glm::abs(normal.x) + glm::abs(normal.y) + glm::abs(normal.z);
+            if (l1 <= 0.0f)
+                return glm::vec2(0.0f, 0.0f);
+
+            glm::vec2 p(normal.x / l1, normal.y / l1);
+            if (normal.z < 0.0f)
+            {
+                // Hemisferio inferior: se pliega sobre las esquinas del cuadrado
+                const float sx = p.x >= 0.0f ? 1.0f : -1.0f;
+                const float sy = p.y >= 0.0f ? 1.0f : -1.0f;
+                p = glm::vec2((1.0f - glm::abs(p.y)) * sx, (1.0f - glm::abs(p.x)) * sy);
+            }
+            return p;
+        }
+
+        std::vector<std::uint8_t> packVertices(const std::vector<Vertex> &vertices, VertexFormat format)
+        {
+            const size_t stride = getVertexStride(format);
+            std::vector<std::uint8_t> data(vertices.size() * stride);
+            if (format == VertexFormat::FULL)
+            {
+                if (!vertices.empty())
+                    std::memcpy(data.data(), vertices.data(), data.size());
+                return data;
+            }
+
+            std::uint8_t *out = data.data();
+            for (const Vertex &vertex : vertices)
+            {
+                // La bitangente sólo guarda su sentido respecto a cross(N, T)
+                const float handedness =
+                    glm::dot(glm::cross(vertex.normal, vertex.tangent), vertex.bitangent) < 0.0f ? -1.0f : 1.0f;
+
+                PackedVertex packed;
+                packed.position = vertex.position;
+                packed.normal = glm::packSnorm2x16(encodeOctahedral(vertex.normal));
+                packed.texture_coords = glm::packHalf2x16(vertex.texture_coords);
+                packed.tangent = glm::packSnorm3x10_1x2(
+                    glm::vec4(vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, handedness));
+                std::memcpy(out, &packed, sizeof(PackedVertex));
+
+                if (format == VertexFormat::PACKED)
+                {
+                    const std::uint32_t color = glm::packUnorm4x8(
+                        glm::vec4(vertex.color.x, vertex.color.y, vertex.color.z, 1.0f));
+                    std::memcpy(out + sizeof(PackedVertex), &color, sizeof(color));
+                }
+                out += stride;
+            }
+            return data;
+        }
+
+        void uploadVertices(VertexArray &vao, const std::vector<Vertex> &vertices, VertexFormat format)
+        {
+            auto vbo = std::make_unique<VertexBuffer>();
+            if (format == VertexFormat::FULL)
+            {
+                vbo->setData(vertices);
+            }
+            else
+            {
+                vbo->setData(packVertices(vertices, format));
+            }
+            vao.addVertexBuffer(std::move(vbo));
+
+            const GLsizei stride = static_cast<GLsizei>(getVertexStride(format));
+            if (format == VertexFormat::FULL)
+            {
+                // Posición (location = 0)
+                vao.addFloatAttribute(0, 3, stride, (void *)offsetof(Vertex, position));
+
+                // Normal (location = 1)
+                vao.addFloatAttribute(1, 3, stride, (void *)offsetof(Vertex, normal));
+
+                // Coordenadas de textura (location = 2)
+                vao.addFloatAttribute(2, 2, stride, (void *)offsetof(Vertex, texture_coords));
+
+                // Tangente (location = 3)
+                vao.addFloatAttribute(3, 3, stride, (void *)offsetof(Vertex, tangent));
+
+                // Bitangente (location = 4)
+                vao.addFloatAttribute(4, 3, stride, (void *)offsetof(Vertex, bitangent));
+
+                // Color del vértice (location = 5)
+                vao.addFloatAttribute(5, 3, stride, (void *)offsetof(Vertex, color));
+                return;
+            }
+
+            vao.addFloatAttribute(0, 3, stride, (void *)offsetof(PackedVertex, position));
+            vao.addNormalizedAttribute(PACKED_NORMAL_LOCATION, 2, GL_SHORT, stride,
+                                       (void *)offsetof(PackedVertex, normal));
+            vao.addAttribute(2, 2, GL_HALF_FLOAT, GL_FALSE, stride, (void *)offsetof(PackedVertex, texture_coords));
+            vao.addNormalizedAttribute(3, 4, GL_INT_2_10_10_10_REV, stride, (void *)offsetof(PackedVertex, tangent));
+
+            if (format == VertexFormat::PACKED)
+            {
+                vao.addNormalizedAttribute(5, 4, GL_UNSIGNED_BYTE, stride, (void *)sizeof(PackedVertex));
+            }
+        }
+
+        void setConstantAttributes(VertexFormat format, const glm::vec3 &material_color)
+        {
+            if (format == VertexFormat::FULL)
+                return;
+
+            // Normal a 0: el shader usa la octaédrica
+            glVertexAttrib3f(1, 0.0f, 0.0f, 0.0f);
+
+            if (format == VertexFormat::PACKED_MATERIAL_COLOR)
+            {
+                glVertexAttrib3f(5, material_color.x, material_color.y, material_color.z);
+            }
+        }
+
+    } // namespace Rendering
+} // namespace Graphics
@@ -0,0 +1,82 @@
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include "buffer_objects.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Graphics
+{
+    namespace Rendering
+    {
+
+        struct Vertex;
+
+        /**
+         * @brief Formato de los vértices en el VBO
+         *
+         * La copia en CPU es siempre Vertex; el formato sólo cambia lo que se
+         * sube a la GPU. Los formatos compactos usan las mismas locations que
+         * FULL, salvo la normal:
+         *  - posición: 3 floats (las coordenadas en metros no caben en half)
+         *  - normal: octaédrica en 2 x snorm16 en la location 10; la location 1
+         *    queda deshabilitada con valor 0 y el shader decodifica la
+         *    octaédrica (vertex_packing.glsl)
+         *  - UV: 2 x half float
+         *  - tangente: snorm 10_10_10_2 con el signo de la bitangente en w; la
+         *    bitangente (location 4) se reconstruye como cross(N, T) * w
+         *  - color: RGBA8, o un atributo constante por material
+         */
+        enum class VertexFormat
+        {
+            FULL,                 // Vertex tal cual, 68 bytes
+            PACKED,               // 28 bytes
+            PACKED_MATERIAL_COLOR // 24 bytes, color constante fijado en cada draw
+        };
+
+        // Vértice compacto (sin el color, que va detrás si el formato lo lleva)
+        struct PackedVertex
+        {
+            glm::vec3 position;
+            std::uint32_t normal;         // octaédrica, 2 x snorm16
+            std::uint32_t texture_coords; // 2 x half
+            std::uint32_t tangent;        // 3 x snorm10 + signo de la bitangente
+        };
+
+        // Location de la normal octaédrica
+        constexpr GLuint PACKED_NORMAL_LOCATION = 10;
+
+        /**
+         * @brief Bytes por vértice en el VBO
+         */
+        size_t getVertexStride(VertexFormat format);
+
+        /**
+         * @brief Normal unitaria a octaédrica en [-1, 1]²
+         */
+        glm::vec2 encodeOctahedral(const glm::vec3 &normal);
+
+        /**
+         * @brief Convierte los vértices al formato (FULL se sube sin copiar)
+         */
+        std::vector<std::uint8_t> packVertices(const std::vector<Vertex> &vertices, VertexFormat format);
+
+        /**
+         * @brief Crea el VBO en el formato dado y configura los atributos del VAO
+         */
+        void uploadVertices(VertexArray &vao, const std::vector<Vertex> &vertices, VertexFormat format);
+
+        /**
+         * @brief Valores constantes de los atributos que el formato no lleva
+         *
+         * Son estado del contexto, no del VAO: hay que fijarlos antes de cada
+         * draw de una malla compacta. No hace nada con FULL.
+         */
+        void setConstantAttributes(VertexFormat format, const glm::vec3 &material_color);
+
+    } // namespace Rendering
+} // namespace Graphics
+
+#endif // VERTEX_FORMAT_H
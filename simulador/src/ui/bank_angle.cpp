@@ -1,5 +1,6 @@
 #include "bank_angle.h"
 #include "text_renderer.h"
+#include "graphics/rendering/gl_state.h"
 #include <iostream>
 #include <cmath>
 #include <string>
@@ -29,8 +30,9 @@ namespace UI
         glGenVertexArrays(1, &vao_);
         glGenBuffers(1, &vbo_);
 
-        glBindVertexArray(vao_);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
+        gl_state.bindVertexArray(vao_);
+        gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
         // Reservar buffer vacío inicial
         glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
 
@@ -38,7 +40,7 @@ namespace UI
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
 
-        glBindVertexArray(0);
+        gl_state.bindVertexArray(0);
         return true;
     }
 
@@ -79,16 +81,17 @@ namespace UI
         // Usar el ángulo normalizado para todos los cálculos
         float display_angle = normalized_angle;
 
-        // Guardar estado GL
-        GLboolean depthWasEnabled = glIsEnabled(GL_DEPTH_TEST);
+        // Guardar estado GL (de la caché, sin consultar al driver)
+        Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
+        bool depthWasEnabled = gl_state.isEnabled(GL_DEPTH_TEST);
 
         // Configurar OpenGL para renderizado 2D
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl_state.setEnabled(GL_DEPTH_TEST, false);
+        gl_state.setEnabled(GL_BLEND, true);
+        gl_state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
         shader->use();
-        glBindVertexArray(vao_);
+        gl_state.bindVertexArray(vao_);
 
         // Color del indicador (verde para las marcas)
         shader->setVec3("color", 0.0f, 1.0f, 0.0f);
@@ -144,7 +147,7 @@ namespace UI
                     line_x, line_y - mark_height / 2,
                     line_x, line_y + mark_height / 2};
 
-                glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+                gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
                 glBufferData(GL_ARRAY_BUFFER, mark.size() * sizeof(float), mark.data(), GL_DYNAMIC_DRAW);
                 glDrawArrays(GL_LINES, 0, 2);
 
@@ -159,7 +162,7 @@ namespace UI
 
                     if (!text_vertices.empty())
                     {
-                        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+                        gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
                         glBufferData(GL_ARRAY_BUFFER, text_vertices.size() * sizeof(float),
                                      text_vertices.data(), GL_DYNAMIC_DRAW);
                         glDrawArrays(GL_LINES, 0, text_vertices.size() / 2);
@@ -196,16 +199,13 @@ namespace UI
             base_x2, base_y2  // Base derecha
         };
 
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
         glBufferData(GL_ARRAY_BUFFER, needle.size() * sizeof(float), needle.data(), GL_DYNAMIC_DRAW);
         glDrawArrays(GL_LINE_LOOP, 0, 3); // Triángulo hueco usando LINE_LOOP
 
         // Restaurar estado OpenGL
-        glBindVertexArray(0);
-        glUseProgram(0);
-        if (depthWasEnabled)
-            glEnable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
+        gl_state.setEnabled(GL_DEPTH_TEST, depthWasEnabled);
+        gl_state.setEnabled(GL_BLEND, false);
     }
 
     void BankAngleIndicator::updateModelMatrix()
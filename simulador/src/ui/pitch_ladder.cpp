@@ -1,4 +1,5 @@
 #include "pitch_ladder.h"
+#include "graphics/rendering/gl_state.h"
 #include <iostream>
 #include <cmath>
 #include <algorithm>
@@ -28,8 +29,9 @@ namespace UI
         glGenVertexArrays(1, &vao_);
         glGenBuffers(1, &vbo_);
 
-        glBindVertexArray(vao_);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
+        gl_state.bindVertexArray(vao_);
+        gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
 
         // Reservar buffer vacío inicial
         glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
@@ -38,7 +40,7 @@ namespace UI
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void *)0);
 
-        glBindVertexArray(0);
+        gl_state.bindVertexArray(0);
 
         return true;
     }
@@ -150,13 +152,14 @@ namespace UI
         if (!shader || !shader->isCompiled())
             return;
 
-        // Guardar estado GL
-        GLboolean depthWasEnabled = glIsEnabled(GL_DEPTH_TEST);
+        // Guardar estado GL (de la caché, sin consultar al driver)
+        Graphics::Rendering::GLState &gl_state = Graphics::Rendering::GLState::getInstance();
+        bool depthWasEnabled = gl_state.isEnabled(GL_DEPTH_TEST);
 
         // Preparar el renderizado
-        glDisable(GL_DEPTH_TEST);
-        glEnable(GL_BLEND);
-        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        gl_state.setEnabled(GL_DEPTH_TEST, false);
+        gl_state.setEnabled(GL_BLEND, true);
+        gl_state.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
         glLineWidth(2.0f);
 
         shader->use();
@@ -192,19 +195,16 @@ namespace UI
         }
 
         // Cargar vertices al buffer
-        glBindVertexArray(vao_);
-        glBindBuffer(GL_ARRAY_BUFFER, vbo_);
+        gl_state.bindVertexArray(vao_);
+        gl_state.bindBuffer(GL_ARRAY_BUFFER, vbo_);
         glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
 
         // Renderizar todas las líneas
         glDrawArrays(GL_LINES, 0, vertices.size() / 2);
 
-        glBindVertexArray(0);
-
         // Restaurar estado GL
-        if (depthWasEnabled)
-            glEnable(GL_DEPTH_TEST);
-        glDisable(GL_BLEND);
+        gl_state.setEnabled(GL_DEPTH_TEST, depthWasEnabled);
+        gl_state.setEnabled(GL_BLEND, false);
         glLineWidth(1.0f);
     }
 
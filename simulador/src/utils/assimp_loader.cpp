@@ -1,6 +1,7 @@
 // NEW FILE: src/utils/assimp_loader.cpp
 #include "assimp_loader.h"
 #include "../graphics/textures/texture_manager.h"
+#include "../graphics/rendering/gl_state.h"
 #include <assimp/Importer.hpp>
 #include <assimp/scene.h>
 #include <assimp/postprocess.h>
@@ -42,7 +43,8 @@ namespace Utils
 
   std::unique_ptr<Scene::Model> AssimpLoader::loadModel(
       const std::string &filepath,
-      const glm::vec3 &uniformColor)
+      const glm::vec3 &uniformColor,
+      const ModelLoadOptions &options)
   {
     // Crear importador de Assimp
     Assimp::Importer importer;
@@ -75,10 +77,25 @@ namespace Utils
   std::cout << "  dest.z = sign(" << MAP_SIGN[2] << ") * src[" << MAP_POS[2] << "]" << std::endl;
 
     // Procesar el nodo raíz recursivamente
-    processNode(scene->mRootNode, scene, model.get(), uniformColor, directory);
+    std::unique_ptr<Graphics::Rendering::MeshBatch> batch;
+    if (options.batch_by_material)
+    {
+      batch = std::make_unique<Graphics::Rendering::MeshBatch>(filepath, options.vertex_format);
+      batch->setResidency(options.residency);
+    }
+    std::map<unsigned int, unsigned int> textures;
+    processNode(scene->mRootNode, scene, model.get(), batch.get(), uniformColor, directory, options, textures);
+
+    if (batch && batch->getMeshCount() > 0 && batch->upload())
+    {
+      std::cout << "  Batched " << batch->getMeshCount() << " meshes into "
+                << batch->getGroupCount() << " material groups" << std::endl;
+      model->addBatch(std::move(batch));
+    }
 
     std::cout << "Model loaded with Assimp: " << filepath << std::endl;
     std::cout << "  Meshes: " << model->getMeshCount() << std::endl;
+    std::cout << "  Draw calls: " << model->getDrawCallCount() << std::endl;
     std::cout << "  Materials: " << scene->mNumMaterials << std::endl;
     std::cout << "  Embedded textures: " << scene->mNumTextures << std::endl;
 
@@ -89,14 +106,28 @@ namespace Utils
       aiNode *node,
       const aiScene *scene,
       Scene::Model *model,
+      Graphics::Rendering::MeshBatch *batch,
       const glm::vec3 &uniformColor,
-      const std::string &directory)
+      const std::string &directory,
+      const ModelLoadOptions &options,
+      std::map<unsigned int, unsigned int> &textures)
   {
     // Procesar todas las mallas del nodo
     for (unsigned int i = 0; i < node->mNumMeshes; i++)
     {
       aiMesh *mesh = scene->mMeshes[node->mMeshes[i]];
-      auto processed_mesh = processMesh(mesh, scene, uniformColor, directory);
+      unsigned int texture_id = getMeshTexture(mesh, scene, directory, textures);
+
+      if (batch)
+      {
+        std::vector<Graphics::Rendering::Vertex> vertices;
+        std::vector<unsigned int> indices;
+        glm::vec3 color = extractMeshData(mesh, scene, uniformColor, vertices, indices);
+        batch->addMesh(vertices, indices, mesh->mMaterialIndex, texture_id, color);
+        continue;
+      }
+
+      auto processed_mesh = processMesh(mesh, scene, uniformColor, options, texture_id);
       if (processed_mesh)
       {
         model->addMesh(std::move(processed_mesh));
@@ -106,7 +137,7 @@ namespace Utils
     // Procesar todos los nodos hijos recursivamente
     for (unsigned int i = 0; i < node->mNumChildren; i++)
     {
-      processNode(node->mChildren[i], scene, model, uniformColor, directory);
+      processNode(node->mChildren[i], scene, model, batch, uniformColor, directory, options, textures);
     }
   }
 
@@ -114,10 +145,68 @@ namespace Utils
       aiMesh *mesh,
       const aiScene *scene,
       const glm::vec3 &uniformColor,
-      const std::string &directory)
+      const ModelLoadOptions &options,
+      unsigned int texture_id)
   {
     std::vector<Graphics::Rendering::Vertex> vertices;
     std::vector<unsigned int> indices;
+    glm::vec3 color = extractMeshData(mesh, scene, uniformColor, vertices, indices);
+
+    // Crear la malla
+    auto processed_mesh = std::make_unique<Graphics::Rendering::Mesh>(
+        vertices, indices, mesh->mName.C_Str(), options.vertex_format);
+    processed_mesh->setMaterialColor(color);
+    processed_mesh->setResidency(options.residency);
+
+    if (texture_id > 0)
+    {
+      processed_mesh->setTexture(texture_id);
+    }
+
+    return processed_mesh;
+  }
+
+  unsigned int AssimpLoader::getMeshTexture(
+      aiMesh *mesh,
+      const aiScene *scene,
+      const std::string &directory,
+      std::map<unsigned int, unsigned int> &textures)
+  {
+    if (!scene->mMaterials || mesh->mMaterialIndex >= scene->mNumMaterials)
+    {
+      return 0;
+    }
+
+    // Las mallas de un mismo material comparten textura (las embebidas se
+    // crearían otra vez en cada llamada)
+    auto cached = textures.find(mesh->mMaterialIndex);
+    if (cached != textures.end())
+    {
+      return cached->second;
+    }
+
+    // Intentar cargar textura difusa (aiTextureType_DIFFUSE = 1)
+    aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
+    unsigned int texture_id = loadMaterialTexture(material, scene, directory, 1);
+    if (texture_id > 0)
+    {
+      std::cout << "  Texture loaded for material " << mesh->mMaterialIndex
+                << " (ID: " << texture_id << ")" << std::endl;
+    }
+
+    textures[mesh->mMaterialIndex] = texture_id;
+    return texture_id;
+  }
+
+  glm::vec3 AssimpLoader::extractMeshData(
+      aiMesh *mesh,
+      const aiScene *scene,
+      const glm::vec3 &uniformColor,
+      std::vector<Graphics::Rendering::Vertex> &vertices,
+      std::vector<unsigned int> &indices)
+  {
+    vertices.reserve(mesh->mNumVertices);
+    indices.reserve(mesh->mNumFaces * 3);
 
     // Extraer color del material si está disponible
     glm::vec3 material_color = uniformColor;
@@ -192,26 +281,7 @@ namespace Utils
       }
     }
 
-    // Crear la malla
-    auto processed_mesh = std::make_unique<Graphics::Rendering::Mesh>(
-        vertices, indices, mesh->mName.C_Str());
-
-    // Cargar textura del material si existe
-    if (scene->mMaterials && mesh->mMaterialIndex >= 0)
-    {
-      aiMaterial *material = scene->mMaterials[mesh->mMaterialIndex];
-      
-      // Intentar cargar textura difusa (aiTextureType_DIFFUSE = 1)
-      unsigned int texture_id = loadMaterialTexture(material, scene, directory, 1);
-      
-      if (texture_id > 0)
-      {
-        processed_mesh->setTexture(texture_id);
-        std::cout << "  Texture loaded for mesh (ID: " << texture_id << ")" << std::endl;
-      }
-    }
-
-    return processed_mesh;
+    return material_color;
   }
 
   unsigned int AssimpLoader::loadMaterialTexture(
@@ -292,7 +362,7 @@ namespace Utils
         else if (channels == 4)
           format = GL_RGBA;
 
-        glBindTexture(GL_TEXTURE_2D, texture_id);
+        Graphics::Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id);
         glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
         glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -307,14 +377,14 @@ namespace Utils
       else
       {
         std::cerr << "Failed to load embedded texture from memory" << std::endl;
-        glDeleteTextures(1, &texture_id);
+        Graphics::Rendering::GLState::getInstance().deleteTexture(texture_id);
         return 0;
       }
     }
     else
     {
       // Textura sin comprimir (datos ARGB8888 raw)
-      glBindTexture(GL_TEXTURE_2D, texture_id);
+      Graphics::Rendering::GLState::getInstance().bindTexture(GL_TEXTURE_2D, texture_id);
       glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, texture->mWidth, texture->mHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, texture->pcData);
       glGenerateMipmap(GL_TEXTURE_2D);
 
@@ -4,6 +4,7 @@
 
 #include "../scene/mesh.h"
 #include "../scene/model.h"
+#include "../scene/mesh_batch.h"
 #include "../graphics/textures/texture_manager.h"
 #include <glm/glm.hpp>
 #include <string>
@@ -20,6 +21,24 @@ struct aiTexture;
 namespace Utils
 {
 
+  /**
+   * @brief Opciones de importación de AssimpLoader
+   */
+  struct ModelLoadOptions
+  {
+    // Juntar las mallas que comparten material en un único VBO/EBO
+    // (un draw por material en lugar de uno por malla)
+    bool batch_by_material = true;
+
+    // Formato de los VBO; el color del material pasa a ser un atributo
+    // constante por malla/grupo en lugar de ir en cada vértice
+    Graphics::Rendering::VertexFormat vertex_format = Graphics::Rendering::VertexFormat::PACKED_MATERIAL_COLOR;
+
+    // Copia en CPU tras la subida: los modelos importados no se editan,
+    // así que por defecto sólo quedan en la GPU
+    Graphics::Rendering::MeshResidency residency = Graphics::Rendering::MeshResidency::GPU_ONLY;
+  };
+
   /**
    * @class AssimpLoader
    * @brief Carga modelos 3D usando la biblioteca Assimp
@@ -31,22 +50,29 @@ namespace Utils
      * @brief Carga un modelo 3D desde un archivo usando Assimp
      * @param filepath Ruta al archivo del modelo
      * @param uniformColor Color uniforme a aplicar (opcional, por defecto gris)
+     * @param options Opciones de importación
      * @return Puntero único al modelo cargado
      */
     static std::unique_ptr<Scene::Model> loadModel(
         const std::string &filepath,
-        const glm::vec3 &uniformColor = glm::vec3(0.5f, 0.5f, 0.5f));
+        const glm::vec3 &uniformColor = glm::vec3(0.5f, 0.5f, 0.5f),
+        const ModelLoadOptions &options = ModelLoadOptions());
 
   private:
     /**
      * @brief Procesa un nodo de Assimp y todos sus hijos
+     * @param batch Si no es nulo, las mallas se añaden al lote en lugar de al modelo
+     * @param textures Texturas ya cargadas por índice de material
      */
     static void processNode(
         aiNode *node,
         const aiScene *scene,
         Scene::Model *model,
+        Graphics::Rendering::MeshBatch *batch,
         const glm::vec3 &uniformColor,
-        const std::string &directory);
+        const std::string &directory,
+        const ModelLoadOptions &options,
+        std::map<unsigned int, unsigned int> &textures);
 
     /**
      * @brief Procesa una malla de Assimp
@@ -55,7 +81,28 @@ namespace Utils
         aiMesh *mesh,
         const aiScene *scene,
         const glm::vec3 &uniformColor,
-        const std::string &directory);
+        const ModelLoadOptions &options,
+        unsigned int texture_id);
+
+    /**
+     * @brief Extrae vértices e índices de una malla de Assimp
+     * @return Color del material (el de todos los vértices)
+     */
+    static glm::vec3 extractMeshData(
+        aiMesh *mesh,
+        const aiScene *scene,
+        const glm::vec3 &uniformColor,
+        std::vector<Graphics::Rendering::Vertex> &vertices,
+        std::vector<unsigned int> &indices);
+
+    /**
+     * @brief Textura difusa del material de una malla (cargada una vez por material)
+     */
+    static unsigned int getMeshTexture(
+        aiMesh *mesh,
+        const aiScene *scene,
+        const std::string &directory,
+        std::map<unsigned int, unsigned int> &textures);
 
     /**
      * @brief Carga una textura desde un material
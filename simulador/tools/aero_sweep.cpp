@@ -0,0 +1,190 @@
+/**
+ * @file aero_sweep.cpp
+ * @brief Barrido de fuerzas aerodinámicas (carpet plot alfa x elevador)
+ *
+ * Uso: aero_sweep [--aero tablas.aero] [--speed V] [--altitude H]
+ *                 [--alpha MIN MAX N] [--elevator MIN MAX N] [--repeat N] [-o salida.csv]
+ *
+ * Evalúa la rejilla completa con el calculate() en bloque (SoA) de
+ * AerodynamicsModel y escribe por punto CL, CD, Cm y las fuerzas y momentos
+ * en ejes cuerpo (stdout por defecto). Ángulos en grados. En stderr se
+ * reportan los puntos/s del bloque frente a llamar a calculate() por punto.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/aerodynamicsmodel.h>
+#include <dlfdm/atmosphere.h>
+
+#include "flight_dynamics.h"
+
+namespace
+{
+
+constexpr float DEG_TO_RAD = 0.0174532925f;
+
+struct Range
+{
+    float min, max;     // [deg]
+    int count;
+
+    float at(int i) const
+    {
+        return (count > 1) ? min + (max - min) * i / (count - 1) : min;
+    }
+};
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *aero_path = nullptr;
+    const char *output_path = nullptr;
+    float speed = 150.0f;       // [m/s]
+    float altitude = 1000.0f;   // [m]
+    Range alpha = {-10.0f, 20.0f, 301};
+    Range elevator = {-15.0f, 15.0f, 31};
+    int repeat = 20;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--aero") == 0 && i + 1 < argc) aero_path = argv[++i];
+        else if (std::strcmp(argv[i], "--speed") == 0 && i + 1 < argc) speed = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--altitude") == 0 && i + 1 < argc) altitude = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--alpha") == 0 && i + 3 < argc)
+        {
+            alpha = {float(std::atof(argv[i + 1])), float(std::atof(argv[i + 2])), std::atoi(argv[i + 3])};
+            i += 3;
+        }
+        else if (std::strcmp(argv[i], "--elevator") == 0 && i + 3 < argc)
+        {
+            elevator = {float(std::atof(argv[i + 1])), float(std::atof(argv[i + 2])), std::atoi(argv[i + 3])};
+            i += 3;
+        }
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc) repeat = std::max(1, std::atoi(argv[++i]));
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output_path = argv[++i];
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--aero tables.aero] [--speed V] [--altitude H]\n"
+                      << "       [--alpha MIN MAX N] [--elevator MIN MAX N] [--repeat N] [-o output.csv]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (alpha.count < 1 || elevator.count < 1)
+    {
+        std::cerr << "Empty sweep" << std::endl;
+        return 1;
+    }
+
+    const dlfdm::AircraftParameters params = Physics::FlightDynamicsManager::loadJetTrainerModel();
+    dlfdm::AerodynamicsModel model(params);
+
+    dlfdm::AeroDatabase database;
+    if (aero_path)
+    {
+        if (!database.load(aero_path))
+        {
+            std::cerr << "Cannot load aerodynamic database " << aero_path << std::endl;
+            return 1;
+        }
+        model.set_database(&database);
+    }
+
+    const dlfdm::Atmosphere::Properties air = dlfdm::Atmosphere::standard().get(altitude);
+
+    // Rejilla en SoA, alfa la más rápida
+    const std::size_t count = std::size_t(alpha.count) * elevator.count;
+
+    std::vector<float> u(count), v(count, 0.0f), w(count);
+    std::vector<float> p(count, 0.0f), q(count, 0.0f), r(count, 0.0f);
+    std::vector<float> de(count), da(count, 0.0f), dr(count, 0.0f);
+    std::vector<float> density(count, air.density), speed_of_sound(count, air.speed_of_sound);
+
+    for (int j = 0; j < elevator.count; ++j)
+    {
+        for (int i = 0; i < alpha.count; ++i)
+        {
+            const std::size_t k = std::size_t(j) * alpha.count + i;
+            const float a = alpha.at(i) * DEG_TO_RAD;
+            u[k] = speed * std::cos(a);
+            w[k] = speed * std::sin(a);
+            de[k] = elevator.at(j) * DEG_TO_RAD;
+        }
+    }
+
+    std::vector<float> fx(count), fy(count), fz(count), mx(count), my(count), mz(count);
+
+    const dlfdm::AerodynamicsModel::BatchInput in = {
+        u.data(), v.data(), w.data(), p.data(), q.data(), r.data(),
+        de.data(), da.data(), dr.data(), density.data(), speed_of_sound.data()};
+    const dlfdm::AerodynamicsModel::BatchOutput out = {
+        fx.data(), fy.data(), fz.data(), mx.data(), my.data(), mz.data()};
+
+    using Clock = std::chrono::steady_clock;
+
+    auto start = Clock::now();
+    for (int n = 0; n < repeat; ++n)
+    {
+        model.calculate(in, out, count);
+    }
+    const double batch_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Referencia: un calculate() por punto
+    float checksum = 0.0f;
+    start = Clock::now();
+    for (int n = 0; n < repeat; ++n)
+    {
+        for (std::size_t k = 0; k < count; ++k)
+        {
+            const dlfdm::ControlInputs controls = {0.0f, de[k], da[k], dr[k]};
+            checksum += model.calculate(glm::vec3(u[k], v[k], w[k]), glm::vec3(p[k], q[k], r[k]), controls, air).body_forces.z;
+        }
+    }
+    const double point_seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    const double points = double(count) * repeat;
+    std::cerr << count << " points, batch " << points / batch_seconds * 1e-6 << " Mpoints/s, "
+              << "calculate() " << points / point_seconds * 1e-6 << " Mpoints/s"
+              << (std::isfinite(checksum) ? "" : " (non finite)") << std::endl;
+
+    std::ofstream output_file;
+    if (output_path)
+    {
+        output_file.open(output_path);
+        if (!output_file)
+        {
+            std::cerr << "Cannot create " << output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = output_path ? output_file : std::cout;
+
+    const float qbar_S = 0.5f * air.density * speed * speed * params.wingArea;
+
+    output << "alpha [deg],elevator [deg],CL,CD,Cm,Xb [N],Yb [N],Zb [N],L [N·m],M [N·m],N [N·m]\n";
+    for (std::size_t k = 0; k < count; ++k)
+    {
+        // Sin resbalamiento: de ejes cuerpo a ejes viento girando alfa
+        const float a = alpha.at(int(k % alpha.count)) * DEG_TO_RAD;
+        const float ca = std::cos(a);
+        const float sa = std::sin(a);
+        const float lift = fx[k] * sa - fz[k] * ca;
+        const float drag = -(fx[k] * ca + fz[k] * sa);
+
+        output << alpha.at(int(k % alpha.count)) << ',' << elevator.at(int(k / alpha.count)) << ','
+               << lift / qbar_S << ',' << drag / qbar_S << ',' << my[k] / (qbar_S * params.wingChord) << ','
+               << fx[k] << ',' << fy[k] << ',' << fz[k] << ','
+               << mx[k] << ',' << my[k] << ',' << mz[k] << '\n';
+    }
+
+    return 0;
+}
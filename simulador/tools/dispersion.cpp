@@ -0,0 +1,224 @@
+/**
+ * @file dispersion.cpp
+ * @brief Dispersión Monte Carlo del S-211 en paralelo
+ *
+ * Uso: dispersion [opciones]
+ *   --scenario cruise|descent   Crucero a 1000 m durante 60 s (estado terminal)
+ *                               o aproximación equilibrada (3 grados, 80 m/s) desde
+ *                               300 m hasta la toma, sin recogida
+ *   --samples N                 Número de muestras (1000)
+ *   --seed S                    Semilla (1), misma semilla = mismos resultados
+ *   --threads T                 Hilos (0 = todos los núcleos)
+ *   --tables FICHERO            Base de datos aerodinámica (la del simulador,
+ *                               data/aero/s211.aero)
+ *   --linear                    Modelo aerodinámico lineal en lugar de las tablas
+ *   --aero PCT                  Dispersión de los coeficientes aerodinámicos [+-%] (2):
+ *                               los del modelo lineal o cada tabla entera (CL, CD,
+ *                               CY, Cl, Cm, Cn) y las derivadas de amortiguamiento
+ *   --mass PCT                  Dispersión de la masa [+-%] (5)
+ *   --inertia PCT               Dispersión de las inercias [+-%] (10)
+ *   --thrust PCT                Dispersión del empuje [+-%] (5)
+ *   --position M                Posición inicial, 1 sigma [m] (10)
+ *   --airspeed MPS              Velocidad inicial, 1 sigma [m/s] (2)
+ *   --attitude DEG              Actitud inicial, 1 sigma [deg] (1)
+ *   --noise DEG                 Ruido en las superficies por paso, 1 sigma [deg] (0.2)
+ *   --wind MPS DEG              Viento medio constante: velocidad y dirección de
+ *                               procedencia (sin viento)
+ *   --turbulence MPS            Turbulencia de Dryden, 1 sigma [m/s] (0), 1.5 ligera,
+ *                               3 moderada, 6 severa
+ *   --csv FICHERO               Resultado de cada muestra en CSV
+ *   -o FICHERO                  Resumen JSON (stdout por defecto)
+ *
+ * Sustituye a editar loadJetTrainerModel() a mano para cada caso. Todas las
+ * muestras vuelan en el mismo campo de viento (misma semilla que la dispersión).
+ */
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/dispersion.h>
+#include <dlfdm/trim.h>
+#include <dlfdm/windfield.h>
+
+#include "flight_dynamics.h"
+
+namespace
+{
+
+constexpr float DEG_TO_RAD = 0.0174532925f;
+
+constexpr float TRIM_SPEED = 150.0f;            // [m/s]
+constexpr float CRUISE_ALTITUDE = 1000.0f;      // [m]
+constexpr float APPROACH_SPEED = 80.0f;         // [m/s]
+constexpr float APPROACH_ANGLE = -3.0f;         // Trayectoria [deg]
+constexpr float DESCENT_ALTITUDE = 300.0f;      // [m]
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    std::string scenario_name = "cruise";
+    std::size_t num_samples = 1000;
+    std::uint64_t seed = 1;
+    unsigned int num_threads = 0;
+    const char *csv_path = nullptr;
+    const char *output_path = nullptr;
+    const char *tables_path = Physics::FlightDynamicsManager::AERO_DATABASE_PATH;
+    float wind_speed = 0.0f;        // [m/s]
+    float wind_direction = 0.0f;    // [rad]
+    float turbulence = 0.0f;        // [m/s]
+
+    dlfdm::Dispersion::Uncertainty uncertainty;
+    uncertainty.aero_coefficients = 0.02f;
+    uncertainty.mass = 0.05f;
+    uncertainty.inertia = 0.10f;
+    uncertainty.thrust = 0.05f;
+    uncertainty.position = 10.0f;
+    uncertainty.airspeed = 2.0f;
+    uncertainty.attitude = 1.0f * DEG_TO_RAD;
+    uncertainty.control_noise = 0.2f * DEG_TO_RAD;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool has_value = i + 1 < argc;
+        const char *value = has_value ? argv[i + 1] : nullptr;
+
+        if (std::strcmp(argv[i], "--scenario") == 0 && has_value) scenario_name = value;
+        else if (std::strcmp(argv[i], "--samples") == 0 && has_value) num_samples = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(argv[i], "--seed") == 0 && has_value) seed = std::strtoull(value, nullptr, 10);
+        else if (std::strcmp(argv[i], "--threads") == 0 && has_value) num_threads = std::atoi(value);
+        else if (std::strcmp(argv[i], "--tables") == 0 && has_value) tables_path = value;
+        else if (std::strcmp(argv[i], "--linear") == 0)
+        {
+            tables_path = nullptr;
+            continue;
+        }
+        else if (std::strcmp(argv[i], "--aero") == 0 && has_value) uncertainty.aero_coefficients = std::atof(value) / 100.0f;
+        else if (std::strcmp(argv[i], "--mass") == 0 && has_value) uncertainty.mass = std::atof(value) / 100.0f;
+        else if (std::strcmp(argv[i], "--inertia") == 0 && has_value) uncertainty.inertia = std::atof(value) / 100.0f;
+        else if (std::strcmp(argv[i], "--thrust") == 0 && has_value) uncertainty.thrust = std::atof(value) / 100.0f;
+        else if (std::strcmp(argv[i], "--position") == 0 && has_value) uncertainty.position = std::atof(value);
+        else if (std::strcmp(argv[i], "--airspeed") == 0 && has_value) uncertainty.airspeed = std::atof(value);
+        else if (std::strcmp(argv[i], "--attitude") == 0 && has_value) uncertainty.attitude = std::atof(value) * DEG_TO_RAD;
+        else if (std::strcmp(argv[i], "--noise") == 0 && has_value) uncertainty.control_noise = std::atof(value) * DEG_TO_RAD;
+        else if (std::strcmp(argv[i], "--wind") == 0 && i + 2 < argc)
+        {
+            wind_speed = std::atof(argv[i + 1]);
+            wind_direction = std::atof(argv[i + 2]) * DEG_TO_RAD;
+            ++i;
+        }
+        else if (std::strcmp(argv[i], "--turbulence") == 0 && has_value) turbulence = std::atof(value);
+        else if (std::strcmp(argv[i], "--csv") == 0 && has_value) csv_path = value;
+        else if (std::strcmp(argv[i], "-o") == 0 && has_value) output_path = value;
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--scenario cruise|descent] [--samples N] [--seed S] [--threads T]\n"
+                      << "       [--tables tables.aero | --linear] [--aero PCT] [--mass PCT] [--inertia PCT] [--thrust PCT]\n"
+                      << "       [--position M] [--airspeed MPS] [--attitude DEG] [--noise DEG]\n"
+                      << "       [--wind MPS DEG] [--turbulence MPS]\n"
+                      << "       [--csv samples.csv] [-o summary.json]" << std::endl;
+            return 1;
+        }
+        ++i;
+    }
+
+    dlfdm::Dispersion::Scenario scenario;
+    scenario.params = Physics::FlightDynamicsManager::loadJetTrainerModel();
+
+    // Las mismas tablas que el simulador: equilibrado y muestras
+    dlfdm::AeroDatabase database;
+    if (tables_path)
+    {
+        if (!database.load(tables_path))
+        {
+            std::cerr << "Cannot load aerodynamic database " << tables_path << std::endl;
+            return 1;
+        }
+        scenario.database = &database;
+    }
+    std::cerr << "Aerodynamics: " << (tables_path ? tables_path : "linear model") << std::endl;
+
+    dlfdm::ControlInputs trim;
+    if (scenario_name == "cruise")
+    {
+        if (!dlfdm::trim_level_flight(scenario.params, scenario.database, TRIM_SPEED, CRUISE_ALTITUDE, scenario.initial_state, trim))
+        {
+            std::cerr << "Cannot trim for level flight at " << TRIM_SPEED << " m/s" << std::endl;
+            return 1;
+        }
+        scenario.duration = 60.0f;
+    }
+    else if (scenario_name == "descent")
+    {
+        // Senda de 3 grados con motor parcial: unos 4.2 m/s de descenso, toma a los ~70 s
+        if (!dlfdm::trim_steady_flight(scenario.params, scenario.database, APPROACH_SPEED, DESCENT_ALTITUDE,
+                                       APPROACH_ANGLE * DEG_TO_RAD, scenario.initial_state, trim))
+        {
+            std::cerr << "Cannot trim a " << APPROACH_ANGLE << " deg approach at " << APPROACH_SPEED << " m/s" << std::endl;
+            return 1;
+        }
+        scenario.duration = 180.0f;
+    }
+    else
+    {
+        std::cerr << "Unknown scenario " << scenario_name << std::endl;
+        return 1;
+    }
+
+    scenario.stop_at_touchdown = true;
+    scenario.controls = [trim](float) { return trim; };
+
+    // Un único campo (tablas de ráfagas incluidas) para todos los hilos
+    dlfdm::WindField::Turbulence wind_turbulence;
+    wind_turbulence.intensity = turbulence;
+    wind_turbulence.seed = seed;
+    const dlfdm::WindField wind({{0.0f, wind_speed, wind_direction}}, wind_turbulence);
+    if (wind_speed > 0.0f || turbulence > 0.0f)
+    {
+        scenario.wind = &wind;
+    }
+
+    const dlfdm::Dispersion dispersion(num_threads);
+    const dlfdm::Dispersion::Envelope envelope;
+
+    const auto start = std::chrono::steady_clock::now();
+    const std::vector<dlfdm::Dispersion::Sample> samples = dispersion.run(scenario, uncertainty, envelope, num_samples, seed);
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cerr << num_samples << " samples in " << seconds << " s on " << dispersion.get_num_threads() << " threads" << std::endl;
+
+    if (csv_path)
+    {
+        std::ofstream csv(csv_path);
+        if (!csv)
+        {
+            std::cerr << "Cannot create " << csv_path << std::endl;
+            return 1;
+        }
+        dlfdm::Dispersion::write_csv(csv, samples);
+    }
+
+    const dlfdm::Dispersion::Summary summary = dlfdm::Dispersion::summarize(samples);
+
+    if (output_path)
+    {
+        std::ofstream output(output_path);
+        if (!output)
+        {
+            std::cerr << "Cannot create " << output_path << std::endl;
+            return 1;
+        }
+        dlfdm::Dispersion::write_json(output, summary);
+    }
+    else
+    {
+        dlfdm::Dispersion::write_json(std::cout, summary);
+    }
+
+    return 0;
+}
@@ -0,0 +1,392 @@
+/**
+ * @file fastmath_check.cpp
+ * @brief Precisión y coste de las aproximaciones de fastmath.h
+ *
+ * Uso: fastmath_check [--trajectory salida.csv | --compare referencia.csv]
+ *
+ * Sin opciones mide el error máximo de cada núcleo frente a libm en doble
+ * precisión y los ns por valor (libm, escalar y en bloque).
+ *
+ * Las trayectorias comparan el FDM compilado con y sin DLFDM_FAST_MATH:
+ * --trajectory escribe las maniobras de referencia con este binario y
+ * --compare las vuela y las compara con las de otro binario (make
+ * fastmath-check hace ambas cosas). Devuelve 1 si alguna se sale de la
+ * tolerancia.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dlfdm/attitude.h>
+#include <dlfdm/fastmath.h>
+#include <dlfdm/fdmsolver.h>
+#include <dlfdm/trim.h>
+
+#include "flight_dynamics.h"
+
+namespace
+{
+
+constexpr float TRIM_SPEED = 150.0f;        // [m/s]
+constexpr float TRIM_ALTITUDE = 1000.0f;    // [m]
+constexpr int RATE = 120;                   // [Hz]
+constexpr int SAMPLE_EVERY = 12;            // Pasos entre muestras (10 Hz)
+
+// Diferencia admitida entre el FDM con libm y con fastmath
+constexpr double POSITION_TOLERANCE = 1.0;  // [m]
+constexpr double ATTITUDE_TOLERANCE = 0.1;  // [deg]
+
+constexpr double RAD_TO_DEG = 57.29577951308232;
+
+// ---------------------------------------------------------------------------
+// Núcleos
+
+struct KernelError
+{
+    const char *name;
+    const char *domain;
+    double max_error;
+    bool relative;
+};
+
+template <typename Fast, typename Reference>
+double max_error(float min, float max, std::size_t count, Fast fast, Reference reference, bool relative)
+{
+    double worst = 0.0;
+    for (std::size_t i = 0; i <= count; ++i)
+    {
+        const float x = min + (max - min) * static_cast<float>(static_cast<double>(i) / count);
+        const double exact = reference(static_cast<double>(x));
+        double error = std::fabs(static_cast<double>(fast(x)) - exact);
+        if (relative)
+        {
+            error /= std::max(std::fabs(exact), 1e-30);
+        }
+        worst = std::max(worst, error);
+    }
+    return worst;
+}
+
+double atan2_error(std::size_t count)
+{
+    // Ángulos en toda la circunferencia y radios de 1e-3 a 1e3
+    double worst = 0.0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double angle = -M_PI + 2.0 * M_PI * static_cast<double>(i) / count;
+        const double radius = std::pow(10.0, -3.0 + 6.0 * static_cast<double>(i % 997) / 996.0);
+        const float y = static_cast<float>(radius * std::sin(angle));
+        const float x = static_cast<float>(radius * std::cos(angle));
+
+        double error = std::fabs(dlfdm::fastmath::atan2(y, x) - std::atan2(static_cast<double>(y), static_cast<double>(x)));
+        error = std::min(error, std::fabs(error - 2.0 * M_PI));     // -pi y pi son el mismo ángulo
+        worst = std::max(worst, error);
+    }
+
+    // Ejes y ceros con signo (atan2(+-0, -0) = +-pi)
+    const float axes[][2] = {{0.0f, 1.0f}, {1.0f, 0.0f}, {0.0f, -1.0f}, {-1.0f, 0.0f}, {0.0f, 0.0f},
+                             {0.0f, -0.0f}, {-0.0f, -0.0f}, {-0.0f, 0.0f}, {-0.0f, -1.0f}, {-0.0f, 1.0f},
+                             {1.0f, -0.0f}, {-1.0f, -0.0f}};
+    for (const auto &p : axes)
+    {
+        worst = std::max(worst, std::fabs(dlfdm::fastmath::atan2(p[0], p[1]) - std::atan2(double(p[0]), double(p[1]))));
+    }
+    return worst;
+}
+
+template <typename Function>
+double ns_per_value(const std::vector<float> &x, Function function)
+{
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<float> out(x.size());
+    const int repeat = 20;
+
+    const Clock::time_point start = Clock::now();
+    for (int n = 0; n < repeat; ++n)
+    {
+        function(x.data(), out.data(), x.size());
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    // Que el compilador no descarte el resultado
+    volatile float sink = out[x.size() / 2];
+    (void)sink;
+
+    return ns / (static_cast<double>(x.size()) * repeat);
+}
+
+void check_kernels()
+{
+    namespace fm = dlfdm::fastmath;
+
+    const std::size_t N = 2000000;
+
+    const KernelError errors[] = {
+        {"sin", "|x| <= 1e4", std::max(max_error(-4.0f, 4.0f, N, [](float x) { return fm::sin(x); }, [](double x) { return std::sin(x); }, false),
+                                       max_error(-1e4f, 1e4f, N, [](float x) { return fm::sin(x); }, [](double x) { return std::sin(x); }, false)), false},
+        {"cos", "|x| <= 1e4", std::max(max_error(-4.0f, 4.0f, N, [](float x) { return fm::cos(x); }, [](double x) { return std::cos(x); }, false),
+                                       max_error(-1e4f, 1e4f, N, [](float x) { return fm::cos(x); }, [](double x) { return std::cos(x); }, false)), false},
+        {"tan", "|x| <= 1.5", max_error(-1.5f, 1.5f, N, [](float x) { return fm::tan(x); }, [](double x) { return std::tan(x); }, true), true},
+        {"atan", "|x| <= 1e3", max_error(-1e3f, 1e3f, N, [](float x) { return fm::atan(x); }, [](double x) { return std::atan(x); }, false), false},
+        {"atan2", "all", atan2_error(N), false},
+        {"asin", "[-1, 1]", max_error(-1.0f, 1.0f, N, [](float x) { return fm::asin(x); }, [](double x) { return std::asin(x); }, false), false},
+    };
+
+    std::cout << "kernel  domain          max error\n";
+    for (const KernelError &e : errors)
+    {
+        std::cout << std::left << std::setw(8) << e.name << std::setw(16) << e.domain
+                  << std::scientific << std::setprecision(2) << e.max_error << (e.relative ? " relative" : "") << "\n";
+    }
+
+    // Coste por valor en el rango del FDM
+    std::vector<float> x(1 << 16);
+    for (std::size_t i = 0; i < x.size(); ++i)
+    {
+        x[i] = -1.0f + 2.0f * static_cast<float>(i) / static_cast<float>(x.size());
+    }
+    std::vector<float> one(x.size(), 1.0f);
+
+    const auto libm_sin = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::sin(in[i]); };
+    const auto fast_sin = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = fm::sin(in[i]); };
+    const auto block_sin = [](const float *in, float *out, std::size_t n) { fm::sin(in, out, n); };
+
+    // Una salida por valor: seno + coseno (el bloque escribe el coseno sobre el seno)
+    const auto libm_sincos = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::sin(in[i]) + std::cos(in[i]); };
+    const auto fast_sincos = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) { float s, c; fm::sincos(in[i], s, c); out[i] = s + c; } };
+    const auto block_sincos = [](const float *in, float *out, std::size_t n) { fm::sincos(in, out, out, n); };
+
+    const auto libm_asin = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::asin(in[i]); };
+    const auto fast_asin = [](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = fm::asin(in[i]); };
+    const auto block_asin = [](const float *in, float *out, std::size_t n) { fm::asin(in, out, n); };
+
+    const float *ones = one.data();
+    const auto libm_atan2 = [ones](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = std::atan2(in[i], ones[i]); };
+    const auto fast_atan2 = [ones](const float *in, float *out, std::size_t n) { for (std::size_t i = 0; i < n; ++i) out[i] = fm::atan2(in[i], ones[i]); };
+    const auto block_atan2 = [ones](const float *in, float *out, std::size_t n) { fm::atan2(in, ones, out, n); };
+
+    std::cout << "\nns/value  libm    fast    fast block\n" << std::fixed << std::setprecision(2);
+    std::cout << "sin       " << std::setw(8) << ns_per_value(x, libm_sin) << std::setw(8) << ns_per_value(x, fast_sin) << ns_per_value(x, block_sin) << "\n";
+    std::cout << "sincos    " << std::setw(8) << ns_per_value(x, libm_sincos) << std::setw(8) << ns_per_value(x, fast_sincos) << ns_per_value(x, block_sincos) << "\n";
+    std::cout << "asin      " << std::setw(8) << ns_per_value(x, libm_asin) << std::setw(8) << ns_per_value(x, fast_asin) << ns_per_value(x, block_asin) << "\n";
+    std::cout << "atan2     " << std::setw(8) << ns_per_value(x, libm_atan2) << std::setw(8) << ns_per_value(x, fast_atan2) << ns_per_value(x, block_atan2) << "\n";
+}
+
+// ---------------------------------------------------------------------------
+// Trayectorias
+
+struct Sample
+{
+    std::string maneuver;
+    glm::vec3 position;
+    float phi, theta, psi;
+};
+
+struct Maneuver
+{
+    const char *name;
+    float duration;     // [s]
+    dlfdm::ControlInputs (*controls)(float t, const dlfdm::ControlInputs &trim);
+};
+
+dlfdm::ControlInputs cruise(float, const dlfdm::ControlInputs &trim)
+{
+    return trim;
+}
+
+dlfdm::ControlInputs doublet(float t, const dlfdm::ControlInputs &trim)
+{
+    dlfdm::ControlInputs c = trim;
+    if (t >= 1.0f && t < 2.0f) c.elevator += 0.02f;
+    else if (t >= 2.0f && t < 3.0f) c.elevator -= 0.02f;
+    else if (t >= 8.0f && t < 9.0f) c.aileron += 0.02f;
+    else if (t >= 9.0f && t < 10.0f) c.aileron -= 0.02f;
+    return c;
+}
+
+dlfdm::ControlInputs full_roll(float t, const dlfdm::ControlInputs &trim)
+{
+    dlfdm::ControlInputs c = trim;
+    if (t >= 1.0f && t < 2.9f) c.aileron = 1.0f;
+    return c;
+}
+
+const Maneuver MANEUVERS[] = {
+    {"cruise", 60.0f, cruise},
+    {"doublet", 20.0f, doublet},
+    {"full_roll", 10.0f, full_roll},
+};
+
+std::vector<Sample> fly_all()
+{
+    const dlfdm::AircraftParameters params = Physics::FlightDynamicsManager::loadJetTrainerModel();
+
+    // El trimado también usa las funciones de math::, cada binario el suyo
+    dlfdm::AircraftState state;
+    dlfdm::ControlInputs trim;
+    if (!dlfdm::trim_level_flight(params, nullptr, TRIM_SPEED, TRIM_ALTITUDE, state, trim))
+    {
+        std::cerr << "Cannot trim for level flight" << std::endl;
+        return {};
+    }
+
+    std::vector<Sample> samples;
+
+    for (const dlfdm::AttitudeMode mode : {dlfdm::AttitudeMode::EULER, dlfdm::AttitudeMode::QUATERNION})
+    {
+        for (const Maneuver &maneuver : MANEUVERS)
+        {
+            const std::string name = std::string(maneuver.name) + (mode == dlfdm::AttitudeMode::EULER ? "/euler" : "/quaternion");
+
+            dlfdm::FDMSolver solver(params, 1.0f / RATE);
+            solver.set_attitude_mode(mode);
+            solver.setState(state);
+
+            const int steps = static_cast<int>(std::lround(maneuver.duration * RATE));
+            for (int step = 0; step <= steps; ++step)
+            {
+                if (step % SAMPLE_EVERY == 0)
+                {
+                    const dlfdm::AircraftState &s = solver.getState();
+                    samples.push_back({name, s.intertial_position, s.phi, s.theta, s.psi});
+                }
+                if (step < steps)
+                {
+                    solver.update(maneuver.controls(static_cast<float>(step) / RATE, trim));
+                }
+            }
+        }
+    }
+
+    return samples;
+}
+
+bool write_trajectory(const char *path)
+{
+    std::ofstream output(path);
+    if (!output)
+    {
+        std::cerr << "Cannot create " << path << std::endl;
+        return false;
+    }
+
+    output << std::setprecision(9);
+    for (const Sample &s : fly_all())
+    {
+        output << s.maneuver << ',' << s.position.x << ',' << s.position.y << ',' << s.position.z << ','
+               << s.phi << ',' << s.theta << ',' << s.psi << '\n';
+    }
+    return true;
+}
+
+bool compare_trajectory(const char *path, bool &within)
+{
+    std::ifstream input(path);
+    if (!input)
+    {
+        std::cerr << "Cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::vector<Sample> reference;
+    std::string line;
+    while (std::getline(input, line))
+    {
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream fields(line);
+        Sample s;
+        fields >> s.maneuver >> s.position.x >> s.position.y >> s.position.z >> s.phi >> s.theta >> s.psi;
+        if (fields)
+        {
+            reference.push_back(s);
+        }
+    }
+
+    const std::vector<Sample> samples = fly_all();
+    if (samples.size() != reference.size())
+    {
+        std::cerr << "Reference has " << reference.size() << " samples, expected " << samples.size() << std::endl;
+        return false;
+    }
+
+    std::cout << "maneuver              position [m]   attitude [deg]\n";
+
+    within = true;
+    std::size_t i = 0;
+    while (i < samples.size())
+    {
+        const std::string &name = samples[i].maneuver;
+        double position_max = 0.0, attitude_max = 0.0;
+
+        for (; i < samples.size() && samples[i].maneuver == name; ++i)
+        {
+            const Sample &s = samples[i];
+            const Sample &r = reference[i];
+
+            position_max = std::max(position_max, static_cast<double>(glm::length(s.position - r.position)));
+
+            // Ángulo de la rotación entre ambas actitudes
+            const glm::quat q = dlfdm::euler_to_quat(s.phi, s.theta, s.psi);
+            const glm::quat qr = dlfdm::euler_to_quat(r.phi, r.theta, r.psi);
+            const double d = std::sqrt(double(q.w - qr.w) * (q.w - qr.w) + double(q.x - qr.x) * (q.x - qr.x) +
+                                       double(q.y - qr.y) * (q.y - qr.y) + double(q.z - qr.z) * (q.z - qr.z));
+            const double s2 = std::sqrt(double(q.w + qr.w) * (q.w + qr.w) + double(q.x + qr.x) * (q.x + qr.x) +
+                                        double(q.y + qr.y) * (q.y + qr.y) + double(q.z + qr.z) * (q.z + qr.z));
+            attitude_max = std::max(attitude_max, 2.0 * std::atan2(std::min(d, s2), std::max(d, s2)) * RAD_TO_DEG);
+        }
+
+        const bool ok = position_max <= POSITION_TOLERANCE && attitude_max <= ATTITUDE_TOLERANCE;
+        within = within && ok;
+
+        std::cout << std::left << std::setw(22) << name << std::right << std::scientific << std::setprecision(2)
+                  << std::setw(12) << position_max << std::setw(15) << attitude_max << (ok ? "" : "  OUT OF TOLERANCE") << "\n";
+    }
+
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+#ifdef DLFDM_FAST_MATH
+    std::cout << "FDM math: fastmath\n";
+#else
+    std::cout << "FDM math: libm\n";
+#endif
+
+    if (argc == 1)
+    {
+        check_kernels();
+        return 0;
+    }
+
+    if (argc == 3 && std::strcmp(argv[1], "--trajectory") == 0)
+    {
+        return write_trajectory(argv[2]) ? 0 : 1;
+    }
+
+    if (argc == 3 && std::strcmp(argv[1], "--compare") == 0)
+    {
+        bool within = false;
+        if (!compare_trajectory(argv[2], within))
+        {
+            return 1;
+        }
+        std::cout << (within ? "Within tolerance" : "Out of tolerance") << " (" << POSITION_TOLERANCE << " m, "
+                  << ATTITUDE_TOLERANCE << " deg)" << std::endl;
+        return within ? 0 : 1;
+    }
+
+    std::cerr << "Usage: " << argv[0] << " [--trajectory output.csv | --compare reference.csv]" << std::endl;
+    return 1;
+}
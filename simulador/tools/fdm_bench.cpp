@@ -0,0 +1,358 @@
+/**
+ * @file fdm_bench.cpp
+ * @brief Benchmark de precisión contra coste del FDM
+ *
+ * Uso: fdm_bench [--aero tablas.aero] [--euler] [--repeat N] [-o salida.json]
+ *
+ * Cada maniobra (crucero trimado, doblete, viraje, tonel completo) se integra
+ * con cada integrador (Euler, RK2, RK4) y frecuencia, y se compara con una
+ * referencia RK4 a REFERENCE_RATE. Por cada combinación se reporta ns/paso,
+ * pasos/s, coste por segundo simulado y error máximo/RMS de posición y
+ * actitud. La tabla se escribe en JSON (stdout por defecto).
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/attitude.h>
+#include <dlfdm/fdmsolver.h>
+#include <dlfdm/trim.h>
+
+#include "flight_dynamics.h"
+
+namespace
+{
+
+// Condición de vuelo inicial (la misma que FlightDynamicsManager)
+constexpr float TRIM_SPEED = 150.0f;        // [m/s]
+constexpr float TRIM_ALTITUDE = 1000.0f;    // [m]
+
+// Frecuencias probadas [Hz], todas dividen a la de referencia y muestreo
+constexpr int RATES[] = {30, 60, 120, 240, 480};
+// El estado es float: el redondeo de cada paso se acumula y por encima de
+// ~1 kHz domina sobre el error de truncamiento, una referencia más fina empeora
+constexpr int REFERENCE_RATE = 960;         // [Hz] RK4
+constexpr int SAMPLE_RATE = 10;             // [Hz] comparación de trayectorias
+
+constexpr float RAD_TO_DEG = 57.2957795f;
+
+struct Trim
+{
+    dlfdm::AircraftState state;
+    dlfdm::ControlInputs controls;
+};
+
+struct Maneuver
+{
+    const char *name;
+    float duration;     // [s]
+    dlfdm::ControlInputs (*controls)(float t, const dlfdm::ControlInputs &trim);
+};
+
+struct Trajectory
+{
+    std::vector<glm::vec3> position;
+    std::vector<glm::quat> attitude;
+    std::uint64_t steps;
+    double ns_per_step;
+};
+
+struct Result
+{
+    const char *maneuver;
+    const char *integrator;
+    int rate;
+    std::uint64_t steps;
+    double ns_per_step;
+    double position_error_max, position_error_rms;  // [m]
+    double attitude_error_max, attitude_error_rms;  // [deg]
+};
+
+dlfdm::ControlInputs cruise(float, const dlfdm::ControlInputs &trim)
+{
+    return trim;
+}
+
+dlfdm::ControlInputs doublet(float t, const dlfdm::ControlInputs &trim)
+{
+    // Doblete de elevador y luego de alerones
+    dlfdm::ControlInputs c = trim;
+    if (t >= 1.0f && t < 2.0f) c.elevator += 0.02f;
+    else if (t >= 2.0f && t < 3.0f) c.elevator -= 0.02f;
+    else if (t >= 8.0f && t < 9.0f) c.aileron += 0.02f;
+    else if (t >= 9.0f && t < 10.0f) c.aileron -= 0.02f;
+    return c;
+}
+
+dlfdm::ControlInputs steady_turn(float t, const dlfdm::ControlInputs &trim)
+{
+    // Alabeo hasta ~45 deg, luego tirón y potencia para sostener el viraje
+    dlfdm::ControlInputs c = trim;
+    if (t >= 1.0f && t < 1.5f) c.aileron += 0.03f;
+    else if (t >= 1.5f && t < 2.0f) c.aileron -= 0.03f;
+    if (t >= 2.0f)
+    {
+        c.elevator -= 0.02f;
+        c.throttle += 0.15f;
+    }
+    return c;
+}
+
+dlfdm::ControlInputs full_roll(float t, const dlfdm::ControlInputs &trim)
+{
+    // Alerones a fondo durante ~360 deg de alabeo
+    dlfdm::ControlInputs c = trim;
+    if (t >= 1.0f && t < 2.9f) c.aileron = 1.0f;   // Limitado por el solver
+    return c;
+}
+
+const Maneuver MANEUVERS[] = {
+    {"cruise", 60.0f, cruise},
+    {"doublet", 20.0f, doublet},
+    {"steady_turn", 40.0f, steady_turn},
+    {"full_roll", 10.0f, full_roll},
+};
+
+const char *integrator_name(dlfdm::IntegrationMethod method)
+{
+    switch (method)
+    {
+    case dlfdm::IntegrationMethod::EULER: return "euler";
+    case dlfdm::IntegrationMethod::RK2: return "rk2";
+    case dlfdm::IntegrationMethod::RK4: return "rk4";
+    }
+    return "unknown";
+}
+
+Trajectory fly(const dlfdm::AircraftParameters &p, const dlfdm::AeroDatabase *database, const Trim &trim,
+               const Maneuver &maneuver, dlfdm::IntegrationMethod method, int rate, dlfdm::AttitudeMode mode)
+{
+    using Clock = std::chrono::steady_clock;
+
+    dlfdm::FDMSolver solver(p, 1.0f / static_cast<float>(rate));
+    solver.set_aero_database(database);
+    solver.set_attitude_mode(mode);
+    solver.set_integration_method(method);
+    solver.setState(trim.state);
+
+    const std::uint64_t steps = static_cast<std::uint64_t>(std::lround(maneuver.duration * rate));
+    const std::uint64_t sample_every = static_cast<std::uint64_t>(rate / SAMPLE_RATE);
+    const float dt = 1.0f / static_cast<float>(rate);
+
+    Trajectory trajectory;
+    trajectory.steps = steps;
+    trajectory.position.reserve(steps / sample_every + 1);
+    trajectory.attitude.reserve(steps / sample_every + 1);
+
+    auto sample = [&]()
+    {
+        const dlfdm::AircraftState &s = solver.getState();
+        trajectory.position.push_back(s.intertial_position);
+        trajectory.attitude.push_back(dlfdm::euler_to_quat(s.phi, s.theta, s.psi));
+    };
+
+    sample();
+
+    const Clock::time_point start = Clock::now();
+    for (std::uint64_t step = 0; step < steps; ++step)
+    {
+        // Tiempo a partir del índice (sin deriva de la suma en float)
+        solver.update(maneuver.controls(static_cast<float>(step) * dt, trim.controls));
+
+        if ((step + 1) % sample_every == 0)
+        {
+            sample();
+        }
+    }
+    const double ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+    trajectory.ns_per_step = ns / static_cast<double>(steps);
+    return trajectory;
+}
+
+void compare(const Trajectory &trajectory, const Trajectory &reference, Result &result)
+{
+    const std::size_t n = std::min(trajectory.position.size(), reference.position.size());
+
+    double position_max = 0.0, position_sum2 = 0.0;
+    double attitude_max = 0.0, attitude_sum2 = 0.0;
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        const double position_error = glm::length(trajectory.position[i] - reference.position[i]);
+
+        // Ángulo de la rotación entre ambas actitudes, 2 atan2(|q - qr|, |q + qr|)
+        // (acos del producto escalar pierde resolución cerca de 1 en float)
+        const glm::quat &q = trajectory.attitude[i];
+        const glm::quat &qr = reference.attitude[i];
+        const double sign = glm::dot(q, qr) < 0.0f ? -1.0 : 1.0;
+        double diff2 = 0.0, sum2 = 0.0;
+        const double a[4] = {q.w, q.x, q.y, q.z};
+        const double b[4] = {sign * qr.w, sign * qr.x, sign * qr.y, sign * qr.z};
+        for (int k = 0; k < 4; ++k)
+        {
+            diff2 += (a[k] - b[k]) * (a[k] - b[k]);
+            sum2 += (a[k] + b[k]) * (a[k] + b[k]);
+        }
+        const double attitude_error = 2.0 * std::atan2(std::sqrt(diff2), std::sqrt(sum2)) * RAD_TO_DEG;
+
+        position_max = std::max(position_max, position_error);
+        attitude_max = std::max(attitude_max, attitude_error);
+        position_sum2 += position_error * position_error;
+        attitude_sum2 += attitude_error * attitude_error;
+    }
+
+    result.position_error_max = position_max;
+    result.position_error_rms = n ? std::sqrt(position_sum2 / static_cast<double>(n)) : 0.0;
+    result.attitude_error_max = attitude_max;
+    result.attitude_error_rms = n ? std::sqrt(attitude_sum2 / static_cast<double>(n)) : 0.0;
+}
+
+void write_json(std::ostream &os, const std::vector<Result> &results, const char *aero, const char *attitude)
+{
+    os << std::setprecision(6);
+    os << "{\n";
+    os << "  \"benchmark\": \"dlfdm\",\n";
+    os << "  \"aero\": \"" << aero << "\",\n";
+    os << "  \"attitude\": \"" << attitude << "\",\n";
+    os << "  \"reference\": {\"integrator\": \"rk4\", \"rate_hz\": " << REFERENCE_RATE << "},\n";
+    os << "  \"sample_rate_hz\": " << SAMPLE_RATE << ",\n";
+    os << "  \"results\": [\n";
+
+    for (std::size_t i = 0; i < results.size(); ++i)
+    {
+        const Result &r = results[i];
+        const double steps_per_sec = r.ns_per_step > 0.0 ? 1e9 / r.ns_per_step : 0.0;
+
+        os << "    {\"maneuver\": \"" << r.maneuver << "\""
+           << ", \"integrator\": \"" << r.integrator << "\""
+           << ", \"rate_hz\": " << r.rate
+           << ", \"steps\": " << r.steps
+           << ", \"ns_per_step\": " << r.ns_per_step
+           << ", \"steps_per_sec\": " << steps_per_sec
+           << ", \"us_per_sim_second\": " << r.ns_per_step * r.rate * 1e-3
+           << ", \"position_error_max_m\": " << r.position_error_max
+           << ", \"position_error_rms_m\": " << r.position_error_rms
+           << ", \"attitude_error_max_deg\": " << r.attitude_error_max
+           << ", \"attitude_error_rms_deg\": " << r.attitude_error_rms
+           << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+
+    os << "  ]\n";
+    os << "}" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *aero_path = nullptr;
+    const char *output_path = nullptr;
+    dlfdm::AttitudeMode mode = dlfdm::AttitudeMode::QUATERNION;
+    int repeat = 3;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--aero") == 0 && i + 1 < argc)
+        {
+            aero_path = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--euler") == 0)
+        {
+            mode = dlfdm::AttitudeMode::EULER;
+        }
+        else if (std::strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+        {
+            repeat = std::max(1, std::atoi(argv[++i]));
+        }
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+        {
+            output_path = argv[++i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--aero tables.aero] [--euler] [--repeat N] [-o output.json]" << std::endl;
+            return 1;
+        }
+    }
+
+    const dlfdm::AircraftParameters params = Physics::FlightDynamicsManager::loadJetTrainerModel();
+
+    dlfdm::AeroDatabase database;
+    if (aero_path && !database.load(aero_path))
+    {
+        std::cerr << "Cannot load aerodynamic database " << aero_path << std::endl;
+        return 1;
+    }
+    const dlfdm::AeroDatabase *aero = aero_path ? &database : nullptr;
+
+    Trim trim;
+    if (!dlfdm::trim_level_flight(params, aero, TRIM_SPEED, TRIM_ALTITUDE, trim.state, trim.controls))
+    {
+        std::cerr << "Cannot trim for level flight at " << TRIM_SPEED << " m/s" << std::endl;
+        return 1;
+    }
+
+    const dlfdm::IntegrationMethod methods[] = {
+        dlfdm::IntegrationMethod::EULER,
+        dlfdm::IntegrationMethod::RK2,
+        dlfdm::IntegrationMethod::RK4,
+    };
+
+    std::vector<Result> results;
+
+    for (const Maneuver &maneuver : MANEUVERS)
+    {
+        const Trajectory reference = fly(params, aero, trim, maneuver, dlfdm::IntegrationMethod::RK4, REFERENCE_RATE, mode);
+
+        for (dlfdm::IntegrationMethod method : methods)
+        {
+            for (int rate : RATES)
+            {
+                // Mejor tiempo de varias repeticiones (la trayectoria es la misma)
+                Trajectory trajectory = fly(params, aero, trim, maneuver, method, rate, mode);
+                for (int r = 1; r < repeat; ++r)
+                {
+                    trajectory.ns_per_step = std::min(trajectory.ns_per_step,
+                                                      fly(params, aero, trim, maneuver, method, rate, mode).ns_per_step);
+                }
+
+                Result result = {maneuver.name, integrator_name(method), rate, trajectory.steps, trajectory.ns_per_step,
+                                 0.0, 0.0, 0.0, 0.0};
+                compare(trajectory, reference, result);
+                results.push_back(result);
+            }
+        }
+
+        std::cerr << maneuver.name << " done" << std::endl;
+    }
+
+    const char *attitude = (mode == dlfdm::AttitudeMode::QUATERNION) ? "quaternion" : "euler";
+
+    if (output_path)
+    {
+        std::ofstream output(output_path);
+        if (!output)
+        {
+            std::cerr << "Cannot create " << output_path << std::endl;
+            return 1;
+        }
+        write_json(output, results, aero_path ? aero_path : "linear", attitude);
+    }
+    else
+    {
+        write_json(std::cout, results, aero_path ? aero_path : "linear", attitude);
+    }
+
+    return 0;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file fdr2csv.cpp
+ * @brief Convierte una grabación binaria del FlightRecorder a CSV
+ *
+ * Uso: fdr2csv <grabacion.fdr> [salida.csv]
+ * Si no se indica salida se escribe en stdout.
+ *
+ * Columnas: las de FDMSolver::log_state(), con los mismos títulos y en el
+ * mismo orden, seguidas de los mandos (throttle, elevator, aileron, rudder)
+ * y de las derivadas de los ángulos de Euler (phi_dot, theta_dot, psi_dot),
+ * calculadas a partir de la actitud y de p, q, r de cada registro.
+ */
+
+#include <fstream>
+#include <iostream>
+
+#include <dlfdm/flightrecorder.h>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <recording.fdr> [output.csv]" << std::endl;
+        return 1;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input)
+    {
+        std::cerr << "Cannot open " << argv[1] << std::endl;
+        return 1;
+    }
+
+    std::ofstream output_file;
+    if (argc > 2)
+    {
+        output_file.open(argv[2]);
+        if (!output_file)
+        {
+            std::cerr << "Cannot create " << argv[2] << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = (argc > 2) ? output_file : std::cout;
+
+    if (!dlfdm::FlightRecorder::convert_to_csv(input, output))
+    {
+        std::cerr << argv[1] << " is not a flight data recording" << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
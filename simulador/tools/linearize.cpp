@@ -0,0 +1,238 @@
+/**
+ * @file linearize.cpp
+ * @brief Matrices A y B del S-211 en puntos de vuelo nivelado equilibrado
+ *
+ * Uso: linearize [--aero tablas.aero | --linear] [--altitude H]
+ *                [--speeds MIN MAX N] [--threads T] [-o salida.csv | --binary salida.bin]
+ *
+ * Equilibra el avión con trim_level_flight() en cada velocidad, con la misma
+ * base de datos aerodinámica que el simulador (data/aero/s211.aero por
+ * defecto, --linear para el modelo lineal), y calcula los jacobianos con
+ * Linearizer::linearize_batch(). El resultado va a stdout en CSV si no se
+ * indica fichero.
+ *
+ * Cada matriz se contrasta con diferencias centradas tomadas en FDMSolver
+ * (el avión que se vuela): setState() + update() con el estado o el control
+ * perturbado y get_state_dot(). Devuelve 1 si algún punto no equilibra o la
+ * diferencia relativa supera MATCH_TOLERANCE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <dlfdm/aerodatabase.h>
+#include <dlfdm/fdmsolver.h>
+#include <dlfdm/linearizer.h>
+#include <dlfdm/trim.h>
+
+#include "flight_dynamics.h"
+
+namespace
+{
+
+constexpr int NUM_STATES = dlfdm::Linearizer::kNumStates;
+constexpr int NUM_INPUTS = dlfdm::Linearizer::kNumInputs;
+
+// Diferencia admitida entre el linealizador y el FDMSolver, relativa a cada
+// término de las matrices
+constexpr float MATCH_TOLERANCE = 1e-3f;
+constexpr float NEGLIGIBLE = 1e-4f;
+
+void solver_derivatives(dlfdm::FDMSolver &solver, const float x[NUM_STATES], const float u[NUM_INPUTS],
+                        float x_dot[NUM_STATES])
+{
+    solver.setState(dlfdm::Linearizer::unpack_state(x));
+    solver.update(dlfdm::Linearizer::unpack_controls(u));
+
+    const dlfdm::AircraftDynamics::StateDerivatives d = solver.get_state_dot();
+    const glm::vec3 rows[4] = {d.ned_position_dot, d.euler_dot, d.body_velocity_dot, d.body_omega_dot};
+    for (int i = 0; i < 4; ++i)
+    {
+        x_dot[3 * i + 0] = rows[i].x;
+        x_dot[3 * i + 1] = rows[i].y;
+        x_dot[3 * i + 2] = rows[i].z;
+    }
+}
+
+// Mayor diferencia relativa, término a término, entre las matrices del
+// linealizador y las diferencias centradas del solver (mismo paso). Los
+// términos menores que NEGLIGIBLE por el mayor de su matriz se comparan con
+// ese umbral en lugar de con su propio valor.
+float compare_with_solver(const dlfdm::AircraftParameters &params, const dlfdm::AeroDatabase *database,
+                          const dlfdm::Linearizer &linearizer, const dlfdm::Linearizer::OperatingPoint &op,
+                          const dlfdm::Linearizer::StateSpace &ss)
+{
+    dlfdm::FDMSolver solver(params);
+    solver.set_aero_database(database);
+
+    float x0[NUM_STATES];
+    float u0[NUM_INPUTS];
+    dlfdm::Linearizer::pack_state(op.state, x0);
+    dlfdm::Linearizer::pack_controls(op.controls, u0);
+
+    dlfdm::Linearizer::StateSpace reference;
+    for (int c = 0; c < NUM_STATES + NUM_INPUTS; ++c)
+    {
+        const float nominal = (c < NUM_STATES) ? x0[c] : u0[c - NUM_STATES];
+        const float h = linearizer.getRelativeStep() * std::max(1.0f, std::fabs(nominal));
+
+        float x[2][NUM_STATES];
+        float u[2][NUM_INPUTS];
+        float x_dot[2][NUM_STATES];
+        for (int s = 0; s < 2; ++s)
+        {
+            std::copy(x0, x0 + NUM_STATES, x[s]);
+            std::copy(u0, u0 + NUM_INPUTS, u[s]);
+            float &value = (c < NUM_STATES) ? x[s][c] : u[s][c - NUM_STATES];
+            value += (s == 0) ? h : -h;
+            solver_derivatives(solver, x[s], u[s], x_dot[s]);
+        }
+
+        const float applied = (c < NUM_STATES) ? x[0][c] - x[1][c] : u[0][c - NUM_STATES] - u[1][c - NUM_STATES];
+        for (int r = 0; r < NUM_STATES; ++r)
+        {
+            float &entry = (c < NUM_STATES) ? reference.A[r][c] : reference.B[r][c - NUM_STATES];
+            entry = (x_dot[0][r] - x_dot[1][r]) / applied;
+        }
+    }
+
+    float scale_A = 0.0f;
+    float scale_B = 0.0f;
+    for (int r = 0; r < NUM_STATES; ++r)
+    {
+        for (int c = 0; c < NUM_STATES; ++c) scale_A = std::max(scale_A, std::fabs(reference.A[r][c]));
+        for (int c = 0; c < NUM_INPUTS; ++c) scale_B = std::max(scale_B, std::fabs(reference.B[r][c]));
+    }
+
+    float worst = 0.0f;
+    for (int r = 0; r < NUM_STATES; ++r)
+    {
+        for (int c = 0; c < NUM_STATES; ++c)
+        {
+            const float ref = reference.A[r][c];
+            worst = std::max(worst, std::fabs(ss.A[r][c] - ref) / std::max(std::fabs(ref), NEGLIGIBLE * scale_A));
+        }
+        for (int c = 0; c < NUM_INPUTS; ++c)
+        {
+            const float ref = reference.B[r][c];
+            worst = std::max(worst, std::fabs(ss.B[r][c] - ref) / std::max(std::fabs(ref), NEGLIGIBLE * scale_B));
+        }
+    }
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    const char *aero_path = Physics::FlightDynamicsManager::AERO_DATABASE_PATH;
+    const char *output_path = nullptr;
+    bool binary = false;
+    float altitude = 1000.0f;   // [m]
+    float min_speed = 80.0f;    // [m/s]
+    float max_speed = 200.0f;   // [m/s]
+    int num_speeds = 7;
+    unsigned int num_threads = 0;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--aero") == 0 && i + 1 < argc) aero_path = argv[++i];
+        else if (std::strcmp(argv[i], "--linear") == 0) aero_path = nullptr;
+        else if (std::strcmp(argv[i], "--altitude") == 0 && i + 1 < argc) altitude = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--speeds") == 0 && i + 3 < argc)
+        {
+            min_speed = std::atof(argv[i + 1]);
+            max_speed = std::atof(argv[i + 2]);
+            num_speeds = std::atoi(argv[i + 3]);
+            i += 3;
+        }
+        else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) num_threads = std::atoi(argv[++i]);
+        else if (std::strcmp(argv[i], "-o") == 0 && i + 1 < argc) output_path = argv[++i];
+        else if (std::strcmp(argv[i], "--binary") == 0 && i + 1 < argc)
+        {
+            output_path = argv[++i];
+            binary = true;
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--aero tables.aero | --linear] [--altitude H]\n"
+                      << "       [--speeds MIN MAX N] [--threads T] [-o output.csv | --binary output.bin]" << std::endl;
+            return 1;
+        }
+    }
+
+    if (num_speeds < 1)
+    {
+        std::cerr << "Empty speed range" << std::endl;
+        return 1;
+    }
+
+    const dlfdm::AircraftParameters params = Physics::FlightDynamicsManager::loadJetTrainerModel();
+
+    dlfdm::AeroDatabase database;
+    if (aero_path && !database.load(aero_path))
+    {
+        std::cerr << "Cannot load aerodynamic database " << aero_path << std::endl;
+        return 1;
+    }
+    const dlfdm::AeroDatabase *aero = aero_path ? &database : nullptr;
+    std::cerr << "Aerodynamics: " << (aero_path ? aero_path : "linear model") << std::endl;
+
+    // Puntos de operación equilibrados
+    bool passed = true;
+    std::vector<dlfdm::Linearizer::OperatingPoint> points;
+    for (int i = 0; i < num_speeds; ++i)
+    {
+        const float speed = (num_speeds > 1) ? min_speed + (max_speed - min_speed) * i / (num_speeds - 1) : min_speed;
+
+        dlfdm::Linearizer::OperatingPoint op;
+        if (!dlfdm::trim_level_flight(params, aero, speed, altitude, op.state, op.controls))
+        {
+            std::cerr << "No trim at " << speed << " m/s, " << altitude << " m" << std::endl;
+            passed = false;
+            continue;
+        }
+        points.push_back(op);
+    }
+
+    dlfdm::Linearizer linearizer(params, num_threads);
+    linearizer.set_aero_database(aero);
+    const std::vector<dlfdm::Linearizer::StateSpace> results = linearizer.linearize_batch(points);
+
+    for (std::size_t i = 0; i < points.size(); ++i)
+    {
+        const float mismatch = compare_with_solver(params, aero, linearizer, points[i], results[i]);
+        const bool match = mismatch <= MATCH_TOLERANCE;
+        std::cerr << glm::length(points[i].state.boby_velocity) << " m/s: A, B vs FDMSolver " << mismatch
+                  << (match ? " ok" : " MISMATCH") << std::endl;
+        passed = passed && match;
+    }
+
+    std::ofstream output_file;
+    if (output_path)
+    {
+        output_file.open(output_path, binary ? std::ios::binary : std::ios::out);
+        if (!output_file)
+        {
+            std::cerr << "Cannot create " << output_path << std::endl;
+            return 1;
+        }
+    }
+    std::ostream &output = output_path ? output_file : std::cout;
+
+    if (binary)
+    {
+        dlfdm::Linearizer::write_binary(output, points, results);
+    }
+    else
+    {
+        dlfdm::Linearizer::write_csv(output, points, results);
+    }
+
+    return passed ? 0 : 1;
+}
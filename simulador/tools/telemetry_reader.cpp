@@ -0,0 +1,187 @@
+/**
+ * @file telemetry_reader.cpp
+ * @brief Lector de referencia de la telemetría en memoria compartida
+ *
+ * Uso: telemetry_reader [--all] [nombre]
+ * Sin opciones muestra el último registro publicado 10 veces por segundo.
+ * Con --all escribe en stdout cada registro como CSV y avisa en stderr de los
+ * registros perdidos (el lector fue más lento que la simulación).
+ * El nombre por defecto es /dlfdm_telemetry.
+ *
+ * Si el simulador se reinicia (el segmento se elimina y se crea de nuevo, o el
+ * contador de registros publicados retrocede) el lector vuelve a abrirlo y
+ * sigue desde el registro más antiguo del simulador nuevo que queda en el anillo.
+ */
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <dlfdm/attitude.h>
+
+#include "telemetry.h"
+
+namespace
+{
+
+// Comprobación de que el segmento sigue siendo el del simulador, en esperas
+constexpr int CHECK_INTERVAL_MS = 100;
+
+void print_csv_header(std::ostream &output)
+{
+    output << "step,time,x,y,z,u,v,w,p,q,r,phi,theta,psi,"
+              "elevator,aileron,rudder,throttle,"
+              "altitude_ft,altitude_agl_ft,speed_kt,vertical_speed_fpm,heading_deg" << std::endl;
+}
+
+void print_csv(std::ostream &output, const Physics::TelemetryRecord &record)
+{
+    const dlfdm::AircraftState &s = record.state;
+    const dlfdm::ControlInputs &c = record.controls;
+    const Physics::FlightData &f = record.flight_data;
+
+    // El simulador publica el estado tal como lo integra
+    float phi = s.phi, theta = s.theta, psi = s.psi;
+    if (record.attitude_mode == dlfdm::AttitudeMode::QUATERNION)
+    {
+        dlfdm::quat_to_euler(s.attitude, phi, theta, psi);
+    }
+
+    output << record.step << ',' << record.time << ','
+           << s.intertial_position.x << ',' << s.intertial_position.y << ',' << s.intertial_position.z << ','
+           << s.boby_velocity.x << ',' << s.boby_velocity.y << ',' << s.boby_velocity.z << ','
+           << s.body_omega.x << ',' << s.body_omega.y << ',' << s.body_omega.z << ','
+           << phi << ',' << theta << ',' << psi << ','
+           << c.elevator << ',' << c.aileron << ',' << c.rudder << ',' << c.throttle << ','
+           << f.altitude << ',' << f.altitude_agl << ',' << f.speed << ',' << f.vertical_speed << ',' << f.heading << '\n';
+}
+
+void print_summary(const Physics::TelemetryRecord &record)
+{
+    const Physics::FlightData &f = record.flight_data;
+
+    std::cout << "step " << record.step << "  t " << record.time << " s"
+              << "  alt " << f.altitude << " ft"
+              << "  agl " << f.altitude_agl << " ft"
+              << "  spd " << f.speed << " kt"
+              << "  vs " << f.vertical_speed << " ft/min"
+              << "  pitch " << f.pitch << "  roll " << f.roll << "  hdg " << f.heading
+              << "  thr " << record.controls.throttle << std::endl;
+}
+
+// Espera a que el simulador vuelva a publicar con ese nombre
+void reopen(Physics::TelemetryReader &reader, const std::string &name)
+{
+    std::cerr << "Telemetry " << name << " restarted, reopening" << std::endl;
+    reader.close();
+    while (!reader.open(name))
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL_MS));
+    }
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    bool stream_all = false;
+    std::string name = Physics::TelemetryPublisher::DEFAULT_NAME;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--all") == 0)
+        {
+            stream_all = true;
+        }
+        else if (argv[i][0] == '/')
+        {
+            name = argv[i];
+        }
+        else
+        {
+            std::cerr << "Usage: " << argv[0] << " [--all] [/shm_name]" << std::endl;
+            return 1;
+        }
+    }
+
+    Physics::TelemetryReader reader;
+    if (!reader.open(name))
+    {
+        std::cerr << "Cannot open telemetry " << name << " (is the simulator running?)" << std::endl;
+        return 1;
+    }
+
+    Physics::TelemetryRecord record;
+
+    if (!stream_all)
+    {
+        std::uint64_t last = 0;
+        for (;;)
+        {
+            std::uint64_t published = reader.getPublished();
+            if (published < last || !reader.isCurrent())
+            {
+                reopen(reader, name);
+                published = reader.getPublished();
+                last = 0;
+            }
+
+            if (published != last && reader.readLatest(record))
+            {
+                print_summary(record);
+                last = published;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(CHECK_INTERVAL_MS));
+        }
+    }
+
+    // Se empieza por el registro más reciente y se sigue cada publicación
+    print_csv_header(std::cout);
+
+    std::uint64_t next = reader.getPublished();
+    std::uint64_t lost = 0;
+    int idle_ms = 0;
+    for (;;)
+    {
+        const std::uint64_t published = reader.getPublished();
+
+        // Contador hacia atrás: el segmento se reinicializó con otro simulador.
+        // Un segmento eliminado y creado de nuevo deja de avanzar: se comprueba
+        // su identidad mientras no llegan registros.
+        if (published < next ||
+            (idle_ms >= CHECK_INTERVAL_MS && !reader.isCurrent()))
+        {
+            reopen(reader, name);
+            const std::uint64_t restarted = reader.getPublished();
+            next = (restarted > Physics::TelemetryBlock::kCapacity)
+                   ? restarted - Physics::TelemetryBlock::kCapacity + 1 : 0;
+            idle_ms = 0;
+            continue;
+        }
+
+        if (next >= published)
+        {
+            std::cout.flush();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            idle_ms = (idle_ms >= CHECK_INTERVAL_MS) ? 0 : idle_ms + 1;
+            continue;
+        }
+        idle_ms = 0;
+
+        if (reader.read(next, record))
+        {
+            print_csv(std::cout, record);
+            ++next;
+        }
+        else
+        {
+            // Sobrescrito: saltar al registro más antiguo que sigue en el anillo
+            const std::uint64_t oldest = reader.getPublished() - Physics::TelemetryBlock::kCapacity + 1;
+            lost += oldest - next;
+            std::cerr << "Lost " << oldest - next << " records (" << lost << " total)" << std::endl;
+            next = oldest;
+        }
+    }
+}
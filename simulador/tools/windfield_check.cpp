@@ -0,0 +1,129 @@
+/**
+ * @file windfield_check.cpp
+ * @brief Continuidad de la turbulencia de WindField en un perfil con cizalladura
+ *
+ * Uso: windfield_check
+ *
+ * Sube a través de un perfil de viento cuya velocidad cambia con la altitud,
+ * una vez al empezar la simulación y otra una hora después, y comprueba que:
+ *
+ * - La ráfaga no depende de la altitud: subir o bajar no desplaza el patrón.
+ * - El salto máximo de la ráfaga entre pasos no crece con el tiempo de
+ *   simulación (el avión no cruza el patrón más deprisa al final del vuelo).
+ *
+ * Devuelve 1 si alguna comprobación falla.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+#include <dlfdm/windfield.h>
+
+namespace
+{
+
+constexpr float DEG_TO_RAD = 0.017453292519943295f;
+
+constexpr float RATE = 120.0f;                 // [Hz]
+constexpr float CLIMB_TIME = 200.0f;           // [s]
+constexpr float START_ALTITUDE = 500.0f;       // [m]
+constexpr float CLIMB_RATE = 10.0f;            // [m/s]
+constexpr float GROUND_SPEED = 60.0f;          // [m/s] hacia el norte
+constexpr float LATE_START = 3600.0f;          // [s]
+
+// Cambio de la ráfaga al variar la altitud 1 m en el mismo punto y tiempo
+constexpr float ALTITUDE_TOLERANCE = 1e-4f;    // [m/s]
+// Salto máximo por paso al final del vuelo frente al del principio
+constexpr float STEP_RATIO_TOLERANCE = 1.5f;
+
+struct Climb
+{
+    float max_step;         // [m/s] mayor |ráfaga(t + dt) - ráfaga(t)|
+    float max_wind_step;    // [m/s] lo mismo con viento medio + ráfaga
+};
+
+Climb climb(const dlfdm::WindField &field, float start_time)
+{
+    const float dt = 1.0f / RATE;
+    const int steps = static_cast<int>(CLIMB_TIME * RATE);
+
+    Climb result{0.0f, 0.0f};
+    glm::vec3 previous_gust(0.0f);
+    glm::vec3 previous_wind(0.0f);
+
+    for (int i = 0; i <= steps; ++i)
+    {
+        const float t = dt * static_cast<float>(i);
+        const glm::vec3 position(GROUND_SPEED * t, 0.0f, -(START_ALTITUDE + CLIMB_RATE * t));
+
+        const glm::vec3 gust = field.gust(position, start_time + t);
+        const glm::vec3 wind = field.get(position, start_time + t);
+        if (i > 0)
+        {
+            result.max_step = std::max(result.max_step, glm::length(gust - previous_gust));
+            result.max_wind_step = std::max(result.max_wind_step, glm::length(wind - previous_wind));
+        }
+        previous_gust = gust;
+        previous_wind = wind;
+    }
+    return result;
+}
+
+float altitude_sensitivity(const dlfdm::WindField &field, float time)
+{
+    float worst = 0.0f;
+    for (int i = 0; i <= 100; ++i)
+    {
+        const float altitude = START_ALTITUDE + 20.0f * static_cast<float>(i);
+        const glm::vec3 position(37.0f * static_cast<float>(i), -11.0f * static_cast<float>(i), -altitude);
+        const glm::vec3 above = position - glm::vec3(0.0f, 0.0f, 1.0f);
+        worst = std::max(worst, glm::length(field.gust(above, time) - field.gust(position, time)));
+    }
+    return worst;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc != 1)
+    {
+        std::cerr << "Usage: " << argv[0] << std::endl;
+        return 1;
+    }
+
+    // 5 m/s del oeste en tierra, 30 m/s del noroeste a 3000 m
+    dlfdm::WindField::Turbulence turbulence;
+    turbulence.intensity = dlfdm::WindField::kModerateTurbulence;
+    turbulence.seed = 7;
+    const dlfdm::WindField field({{0.0f, 5.0f, 270.0f * DEG_TO_RAD}, {3000.0f, 30.0f, 315.0f * DEG_TO_RAD}},
+                                 turbulence);
+
+    const glm::vec3 drift = field.get_drift_wind();
+    std::cout << "Drift wind: " << drift.x << ", " << drift.y << " m/s (N, E)\n";
+
+    bool passed = true;
+
+    const float sensitivity = altitude_sensitivity(field, LATE_START);
+    const bool continuous = sensitivity <= ALTITUDE_TOLERANCE;
+    std::cout << "Gust change over 1 m of altitude at t = " << LATE_START << " s: " << sensitivity << " m/s "
+              << (continuous ? "ok" : "FAILED") << "\n";
+    passed = passed && continuous;
+
+    const Climb early = climb(field, 0.0f);
+    const Climb late = climb(field, LATE_START);
+    const bool steady = late.max_step <= STEP_RATIO_TOLERANCE * early.max_step &&
+                        late.max_wind_step <= STEP_RATIO_TOLERANCE * early.max_wind_step;
+    std::cout << "Largest step while climbing " << START_ALTITUDE << " -> "
+              << START_ALTITUDE + CLIMB_RATE * CLIMB_TIME << " m:\n"
+              << "  gust        t = 0: " << early.max_step << " m/s, t = " << LATE_START << ": " << late.max_step
+              << " m/s\n"
+              << "  mean + gust t = 0: " << early.max_wind_step << " m/s, t = " << LATE_START << ": "
+              << late.max_wind_step << " m/s " << (steady ? "ok" : "FAILED") << "\n";
+    passed = passed && steady;
+
+    std::cout << (passed ? "Wind field check passed" : "Wind field check FAILED") << std::endl;
+    return passed ? 0 : 1;
+}